@@ -521,6 +521,7 @@ typedef enum _enum_opt {
     OPT_PRE,
     OPT_CFG  = 0x002,
     OPT_SUB  = 0x004,
+    OPT_SSA  = 0x008,
     OPT_PASM = 0x100,
     OPT_J    = 0x200
 } enum_opt_t;
@@ -230,6 +230,7 @@ help(void)
     "    -w --warnings\n"
     "    -G --no-gc\n"
     "       --gc-debug\n"
+    "       --gc-ratio=PERCENT\n"
     "       --leak-test|--destroy-at-end\n"
     "    -. --wait    Read a keystroke before starting\n"
     "       --runtime-prefix\n"
@@ -285,6 +286,7 @@ included in the Parrot source tree.\n\n");
 #define OPT_HELP_DEBUG     130
 #define OPT_PBC_OUTPUT     131
 #define OPT_RUNTIME_PREFIX 132
+#define OPT_GC_RATIO       133
 
 static struct longopt_opt_decl options[] = {
     { '.', '.', (OPTION_flags)0, { "--wait" } },
@@ -300,6 +302,7 @@ static struct longopt_opt_decl options[] = {
     { '\0', OPT_DESTROY_FLAG, (OPTION_flags)0,
                                  { "--leak-test", "--destroy-at-end" } },
     { '\0', OPT_GC_DEBUG, (OPTION_flags)0, { "--gc-debug" } },
+    { '\0', OPT_GC_RATIO, OPTION_required_FLAG, { "--gc-ratio" } },
     { 'a', 'a', (OPTION_flags)0, { "--pasm" } },
     { 'c', 'c', (OPTION_flags)0, { "--pbc" } },
     { 'd', 'd', OPTION_optional_FLAG, { "--imcc-debug" } },
@@ -495,6 +498,9 @@ parseflags(PARROT_INTERP, int *argc, char **argv[])
                 if (strchr(opt.opt_arg, '2')) {
                     IMCC_INFO(interp)->optimizer_level |= (OPT_PRE | OPT_CFG);
                 }
+                if (strchr(opt.opt_arg, '3')) {
+                    IMCC_INFO(interp)->optimizer_level |= (OPT_PRE | OPT_SSA);
+                }
                 if (strchr(opt.opt_arg, 't')) {
 #ifdef HAVE_COMPUTED_GOTO
                     core = PARROT_CGP_CORE;
@@ -512,6 +518,18 @@ parseflags(PARROT_INTERP, int *argc, char **argv[])
 #endif
                 SET_FLAG(PARROT_GC_DEBUG_FLAG);
                 break;
+            case OPT_GC_RATIO:
+            {
+                char * end;
+                const unsigned long ratio = strtoul(opt.opt_arg, &end, 10);
+
+                if (end == opt.opt_arg || *end)
+                    Parrot_ex_throw_from_c_args(interp, NULL, 1,
+                        "main: --gc-ratio needs a percentage, not '%s'."
+                        "\n\nhelp: parrot -h\n", opt.opt_arg);
+                Parrot_gc_set_ratio(interp, ratio);
+                break;
+            }
             case OPT_DESTROY_FLAG:
                 SET_FLAG(PARROT_DESTROY_FLAG);
                 break;
@@ -699,7 +717,9 @@ imcc_get_optimization_description(const PARROT_INTERP, int opt_level, ARGMOD(cha
     ASSERT_ARGS(imcc_get_optimization_description)
     int i = 0;
 
-    if (opt_level & (OPT_PRE | OPT_CFG))
+    if (opt_level & OPT_SSA)
+            opt_desc[i++] = '3';
+    else if (opt_level & (OPT_PRE | OPT_CFG))
             opt_desc[i++] = '2';
     else
         if (opt_level & OPT_PRE)
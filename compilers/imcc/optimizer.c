@@ -54,12 +54,19 @@ used_once ... deletes assignments, when LHS is unused
 
 constant_propagation
 
-post_optimizer: currently pcc_optimize in pcc.c
----------------
+ssa_optimize ... with -O3, numbers the values of the I and N registers
+as in SSA form, then propagates copies and constants, replaces values
+computed twice, unboxes Integer and Float temporaries, deletes unused
+values and moves loop invariants to the loop preheader
+
+post_optimizer
+--------------
 
 runs after register allocation
 
-e.g. eliminate new Px .PerlUndef because Px where different before
+post_optimize() calls superinstructions() to replace runs of ops listed
+in src/ops/ops.super with the superinstruction doing the work of all of
+them.  Done last, so the passes above only ever see the plain ops.
 
 =head2 Functions
 
@@ -74,6 +81,93 @@ e.g. eliminate new Px .PerlUndef because Px where different before
 #include "pbc.h"
 #include "optimizer.h"
 
+/* -O3 looks at the I and N registers of a unit in SSA form.  The form is
+ * only an analysis -- each def and each phi gets a number, its value -- and
+ * all rewrites are made on the registers in place, so there is nothing to
+ * translate back out of SSA afterwards. */
+
+#define SSA_REG_HASH(r) ((unsigned int)((size_t)(r) >> 4) * 2654435761U)
+
+typedef struct ssa_value_t {
+    Instruction *def;           /* defining instruction, NULL for phis and
+                                   for the unknown values on entry */
+    SymReg      *constant;      /* the constant it is, if known */
+    int          var;           /* the register, in ssa_t.vars */
+    int          block;         /* where it is defined */
+    int          copy_of;       /* set r, s: the value copied, else -1 */
+    int          args[2];       /* pure ops: the values read, -1 for
+                                   constants, -2 for other registers */
+    int          uses;          /* reads of it in the code */
+    char         phi;
+    char         handler;       /* unknown value on entry to a handler */
+    char         live;
+} ssa_value_t;
+
+typedef struct ssa_var_t {
+    SymReg      *reg;
+    int          current;       /* the value it holds at this point of the
+                                   walk; for PMCs, nonzero while the boxed
+                                   value is known */
+    int          loop_defs;     /* defs in the loop being hoisted from */
+    char         bad;           /* keyed, lexical, ...: left alone */
+    char         keep;          /* defs must stay where they are */
+
+    /* PMCs: new p, "Integer" followed by assign p, X, only read back by
+     * set I, p or set N, p */
+    char         box_kind;      /* 'I' for Integer, 'N' for Float */
+    Instruction *box_new;
+    Instruction *box_init;
+    SymReg      *box_value;     /* X */
+    int          box_value_id;  /* its value at box_init, -1 for constants,
+                                   -2 before the walk got there */
+    int          box_region;
+    int          box_uses;
+    int          box_unboxed;
+} ssa_var_t;
+
+/* an expression for value numbering: op and operand values */
+typedef struct ssa_expr_t {
+    int          opnum;
+    int          n;
+    int          val[2];        /* operand values, or -1 */
+    SymReg      *con[2];        /* constant operands */
+    SymReg      *reg;           /* register holding the result */
+    int          value;         /* and its value */
+    unsigned int hash;
+    int          next;          /* next expr + 1 with the same hash */
+} ssa_expr_t;
+
+typedef struct ssa_t {
+    IMC_Unit     *unit;
+    int           n_blocks;
+    ssa_var_t    *vars;
+    int           n_vars, vars_size;
+    int          *var_hash;     /* var + 1, by register address */
+    unsigned int  var_mask;
+    ssa_value_t  *values;
+    int           n_values, values_size;
+    int          *phi_first;    /* the phis of block b are */
+    int          *phis;         /* phis[phi_first[b] .. phi_first[b + 1]) */
+    int          *phi_args;     /* pairs of phi, value flowing into it */
+    int          *reentry_first;/* the blocks after calls which block b */
+    int          *reentries;    /* may return to, like phis */
+    int           n_phi_args, phi_args_size;
+    int          *undo;         /* pairs of var, value it held before */
+    int           n_undo, undo_size;
+    ssa_expr_t   *exprs;
+    int           n_exprs, exprs_size;
+    int          *expr_hash;    /* last expr + 1 with that hash */
+    unsigned int  expr_mask;
+    int          *child;        /* dominator tree: first child */
+    int          *sibling;      /* and next sibling of each block */
+    char         *reached;      /* reachable from the first block */
+    char         *handler;      /* starts an exception handler */
+    char         *in_handler;   /* dominated by an exception handler */
+    int           region;       /* handler block the walk is in, or -1 */
+    int           changed;
+} ssa_t;
+
+
 /* HEADERIZER HFILE: compilers/imcc/optimizer.h */
 
 /* HEADERIZER BEGIN: static */
@@ -130,16 +224,232 @@ static int eval_ins(PARROT_INTERP,
         __attribute__nonnull__(2)
         __attribute__nonnull__(4);
 
+PARROT_CANNOT_RETURN_NULL
+static Instruction * fuse_ins(PARROT_INTERP,
+    ARGMOD(IMC_Unit *unit),
+    ARGMOD(Instruction *ins),
+    int n,
+    int op)
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2)
+        __attribute__nonnull__(3)
+        FUNC_MODIFIES(*unit)
+        FUNC_MODIFIES(*ins);
+
 static int if_branch(PARROT_INTERP, ARGMOD(IMC_Unit *unit))
         __attribute__nonnull__(1)
         __attribute__nonnull__(2)
         FUNC_MODIFIES(*unit);
 
+static int ssa_add_var(ARGMOD(ssa_t *ssa), ARGIN(SymReg *r))
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2)
+        FUNC_MODIFIES(*ssa);
+
+PARROT_WARN_UNUSED_RESULT
+static int ssa_after_call(ARGIN(const Instruction *ins))
+        __attribute__nonnull__(1);
+
+static void ssa_block(PARROT_INTERP, ARGMOD(ssa_t *ssa), int b)
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2)
+        FUNC_MODIFIES(*ssa);
+
+static int ssa_build(ARGMOD(ssa_t *ssa))
+        __attribute__nonnull__(1)
+        FUNC_MODIFIES(*ssa);
+
+static void ssa_expr_add(ARGMOD(ssa_t *ssa), ARGIN(const ssa_expr_t *e))
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2)
+        FUNC_MODIFIES(*ssa);
+
+PARROT_WARN_UNUSED_RESULT
+static int ssa_expr_find(
+    ARGIN(const ssa_t *ssa),
+    ARGIN(const ssa_expr_t *e))
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2);
+
+PARROT_WARN_UNUSED_RESULT
+static int ssa_expr_key(PARROT_INTERP,
+    ARGIN(const ssa_t *ssa),
+    ARGIN(const Instruction *ins),
+    ARGOUT(ssa_expr_t *e))
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2)
+        __attribute__nonnull__(3)
+        __attribute__nonnull__(4)
+        FUNC_MODIFIES(*e);
+
+PARROT_WARN_UNUSED_RESULT
+static int ssa_find(ARGIN(const ssa_t *ssa), ARGIN(const SymReg *r))
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2);
+
+static void ssa_flow(ARGMOD(ssa_t *ssa), int s)
+        __attribute__nonnull__(1)
+        FUNC_MODIFIES(*ssa);
+
+PARROT_WARN_UNUSED_RESULT
+static int ssa_foldable(PARROT_INTERP, ARGIN(const Instruction *ins))
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2);
+
+static void ssa_free(ARGMOD(ssa_t *ssa))
+        __attribute__nonnull__(1)
+        FUNC_MODIFIES(*ssa);
+
+PARROT_MALLOC
+PARROT_CANNOT_RETURN_NULL
+static int * ssa_group(
+    ARGIN_NULLOK(const int *pairs),
+    int n,
+    int keys,
+    ARGOUT(int **first))
+        __attribute__nonnull__(4)
+        FUNC_MODIFIES(*first);
+
+static int ssa_hoist(PARROT_INTERP, ARGMOD(ssa_t *ssa))
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2)
+        FUNC_MODIFIES(*ssa);
+
+static int ssa_new_value(
+    ARGMOD(ssa_t *ssa),
+    int var,
+    int block,
+    ARGIN_NULLOK(Instruction *def))
+        __attribute__nonnull__(1)
+        FUNC_MODIFIES(*ssa);
+
+PARROT_WARN_UNUSED_RESULT
+static int ssa_operand_cmp(
+    ARGIN(const ssa_expr_t *a),
+    int i,
+    ARGIN(const ssa_expr_t *b),
+    int j)
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(3);
+
+static int ssa_optimize(PARROT_INTERP, ARGMOD(IMC_Unit *unit))
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2)
+        FUNC_MODIFIES(*unit);
+
+PARROT_WARN_UNUSED_RESULT
+static int ssa_pcc(ARGIN(const Instruction *ins))
+        __attribute__nonnull__(1);
+
+PARROT_CANNOT_RETURN_NULL
+static Instruction * ssa_propagate(PARROT_INTERP,
+    ARGMOD(ssa_t *ssa),
+    ARGMOD(Instruction *ins),
+    int i)
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2)
+        __attribute__nonnull__(3)
+        FUNC_MODIFIES(*ssa)
+        FUNC_MODIFIES(*ins);
+
+PARROT_WARN_UNUSED_RESULT
+static int ssa_pure(PARROT_INTERP, ARGIN(const Instruction *ins))
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2);
+
+static void ssa_push(
+    ARGMOD(int **list),
+    ARGMOD(int *n),
+    ARGMOD(int *size),
+    int a,
+    int b)
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2)
+        __attribute__nonnull__(3)
+        FUNC_MODIFIES(*list)
+        FUNC_MODIFIES(*n)
+        FUNC_MODIFIES(*size);
+
+PARROT_WARN_UNUSED_RESULT
+static int ssa_reads(ARGIN(const Instruction *ins), int i)
+        __attribute__nonnull__(1);
+
+static int ssa_remove_dead(PARROT_INTERP, ARGMOD(ssa_t *ssa))
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2)
+        FUNC_MODIFIES(*ssa);
+
+static void ssa_replace(
+    ARGMOD(ssa_t *ssa),
+    ARGMOD(Instruction *ins),
+    ARGMOD(Instruction *tmp))
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2)
+        __attribute__nonnull__(3)
+        FUNC_MODIFIES(*ssa)
+        FUNC_MODIFIES(*ins)
+        FUNC_MODIFIES(*tmp);
+
+static void ssa_scan_box(
+    ARGMOD(ssa_t *ssa),
+    int v,
+    ARGIN(Instruction *ins),
+    int i)
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(3)
+        FUNC_MODIFIES(*ssa);
+
+static void ssa_set(ARGMOD(ssa_t *ssa), int var, int value)
+        __attribute__nonnull__(1)
+        FUNC_MODIFIES(*ssa);
+
+PARROT_CANNOT_RETURN_NULL
+static Instruction * ssa_unbox(PARROT_INTERP,
+    ARGMOD(ssa_t *ssa),
+    ARGMOD(Instruction *ins),
+    int p)
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2)
+        __attribute__nonnull__(3)
+        FUNC_MODIFIES(*ssa)
+        FUNC_MODIFIES(*ins);
+
+static int ssa_unlink(ARGMOD(ssa_t *ssa), ARGMOD(Instruction *ins))
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2)
+        FUNC_MODIFIES(*ssa)
+        FUNC_MODIFIES(*ins);
+
+PARROT_CANNOT_RETURN_NULL
+static Instruction * ssa_visit(PARROT_INTERP,
+    ARGMOD(ssa_t *ssa),
+    ARGMOD(Instruction *ins),
+    int b)
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2)
+        __attribute__nonnull__(3)
+        FUNC_MODIFIES(*ssa)
+        FUNC_MODIFIES(*ins);
+
+static void ssa_walk(PARROT_INTERP, ARGMOD(ssa_t *ssa))
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2)
+        FUNC_MODIFIES(*ssa);
+
+PARROT_WARN_UNUSED_RESULT
+static int ssa_writes(ARGIN(const Instruction *ins), int i)
+        __attribute__nonnull__(1);
+
 static int strength_reduce(PARROT_INTERP, ARGMOD(IMC_Unit *unit))
         __attribute__nonnull__(1)
         __attribute__nonnull__(2)
         FUNC_MODIFIES(*unit);
 
+static int superinstructions(PARROT_INTERP, ARGMOD(IMC_Unit *unit))
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2)
+        FUNC_MODIFIES(*unit);
+
 PARROT_WARN_UNUSED_RESULT
 static int unused_label(PARROT_INTERP, ARGMOD(IMC_Unit *unit))
         __attribute__nonnull__(1)
@@ -176,12 +486,106 @@ static int used_once(PARROT_INTERP, ARGMOD(IMC_Unit *unit))
        PARROT_ASSERT_ARG(interp) \
     , PARROT_ASSERT_ARG(op) \
     , PARROT_ASSERT_ARG(r))
+#define ASSERT_ARGS_fuse_ins __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp) \
+    , PARROT_ASSERT_ARG(unit) \
+    , PARROT_ASSERT_ARG(ins))
 #define ASSERT_ARGS_if_branch __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
        PARROT_ASSERT_ARG(interp) \
     , PARROT_ASSERT_ARG(unit))
+#define ASSERT_ARGS_ssa_add_var __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(ssa) \
+    , PARROT_ASSERT_ARG(r))
+#define ASSERT_ARGS_ssa_after_call __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(ins))
+#define ASSERT_ARGS_ssa_block __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp) \
+    , PARROT_ASSERT_ARG(ssa))
+#define ASSERT_ARGS_ssa_build __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(ssa))
+#define ASSERT_ARGS_ssa_expr_add __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(ssa) \
+    , PARROT_ASSERT_ARG(e))
+#define ASSERT_ARGS_ssa_expr_find __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(ssa) \
+    , PARROT_ASSERT_ARG(e))
+#define ASSERT_ARGS_ssa_expr_key __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp) \
+    , PARROT_ASSERT_ARG(ssa) \
+    , PARROT_ASSERT_ARG(ins) \
+    , PARROT_ASSERT_ARG(e))
+#define ASSERT_ARGS_ssa_find __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(ssa) \
+    , PARROT_ASSERT_ARG(r))
+#define ASSERT_ARGS_ssa_flow __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(ssa))
+#define ASSERT_ARGS_ssa_foldable __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp) \
+    , PARROT_ASSERT_ARG(ins))
+#define ASSERT_ARGS_ssa_free __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(ssa))
+#define ASSERT_ARGS_ssa_group __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(first))
+#define ASSERT_ARGS_ssa_hoist __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp) \
+    , PARROT_ASSERT_ARG(ssa))
+#define ASSERT_ARGS_ssa_new_value __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(ssa))
+#define ASSERT_ARGS_ssa_operand_cmp __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(a) \
+    , PARROT_ASSERT_ARG(b))
+#define ASSERT_ARGS_ssa_optimize __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp) \
+    , PARROT_ASSERT_ARG(unit))
+#define ASSERT_ARGS_ssa_pcc __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(ins))
+#define ASSERT_ARGS_ssa_propagate __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp) \
+    , PARROT_ASSERT_ARG(ssa) \
+    , PARROT_ASSERT_ARG(ins))
+#define ASSERT_ARGS_ssa_pure __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp) \
+    , PARROT_ASSERT_ARG(ins))
+#define ASSERT_ARGS_ssa_push __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(list) \
+    , PARROT_ASSERT_ARG(n) \
+    , PARROT_ASSERT_ARG(size))
+#define ASSERT_ARGS_ssa_reads __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(ins))
+#define ASSERT_ARGS_ssa_remove_dead __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp) \
+    , PARROT_ASSERT_ARG(ssa))
+#define ASSERT_ARGS_ssa_replace __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(ssa) \
+    , PARROT_ASSERT_ARG(ins) \
+    , PARROT_ASSERT_ARG(tmp))
+#define ASSERT_ARGS_ssa_scan_box __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(ssa) \
+    , PARROT_ASSERT_ARG(ins))
+#define ASSERT_ARGS_ssa_set __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(ssa))
+#define ASSERT_ARGS_ssa_unbox __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp) \
+    , PARROT_ASSERT_ARG(ssa) \
+    , PARROT_ASSERT_ARG(ins))
+#define ASSERT_ARGS_ssa_unlink __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(ssa) \
+    , PARROT_ASSERT_ARG(ins))
+#define ASSERT_ARGS_ssa_visit __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp) \
+    , PARROT_ASSERT_ARG(ssa) \
+    , PARROT_ASSERT_ARG(ins))
+#define ASSERT_ARGS_ssa_walk __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp) \
+    , PARROT_ASSERT_ARG(ssa))
+#define ASSERT_ARGS_ssa_writes __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(ins))
 #define ASSERT_ARGS_strength_reduce __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
        PARROT_ASSERT_ARG(interp) \
     , PARROT_ASSERT_ARG(unit))
+#define ASSERT_ARGS_superinstructions __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp) \
+    , PARROT_ASSERT_ARG(unit))
 #define ASSERT_ARGS_unused_label __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
        PARROT_ASSERT_ARG(interp) \
     , PARROT_ASSERT_ARG(unit))
@@ -256,6 +660,9 @@ cfg_optimize(PARROT_INTERP, ARGMOD(IMC_Unit *unit))
 
 =item C<int optimize(PARROT_INTERP, IMC_Unit *unit)>
 
+Runs the optimizations needing the CFG: those of -O2, then those of -O3
+once the others are done.  Returns TRUE if any optimization was performed.
+
 =cut
 
 */
@@ -271,11 +678,38 @@ optimize(PARROT_INTERP, ARGMOD(IMC_Unit *unit))
         if (used_once(interp, unit))
             return 1;
     }
+    if (!any && (IMCC_INFO(interp)->optimizer_level & OPT_SSA))
+        any = ssa_optimize(interp, unit);
     return any;
 }
 
 /*
 
+=item C<int post_optimize(PARROT_INTERP, IMC_Unit *unit)>
+
+Handles optimizations occuring after register allocation.  Returns TRUE if
+any optimization was performed.
+
+=cut
+
+*/
+
+int
+post_optimize(PARROT_INTERP, ARGMOD(IMC_Unit *unit))
+{
+    ASSERT_ARGS(post_optimize)
+    int changed = 0;
+
+    if (IMCC_INFO(interp)->optimizer_level & OPT_PRE) {
+        IMCC_info(interp, 2, "post_optimize\n");
+        if (!IMCC_INFO(interp)->dont_optimize)
+            changed += superinstructions(interp, unit);
+    }
+    return changed;
+}
+
+/*
+
 =item C<const char * get_neg_op(const char *op, int *n)>
 
 Get negated form of operator. If no negated form is known, return NULL.
@@ -1575,6 +2009,1894 @@ used_once(PARROT_INTERP, ARGMOD(IMC_Unit *unit))
 
 /*
 
+=item C<static int ssa_optimize(PARROT_INTERP, IMC_Unit *unit)>
+
+The -O3 optimizations.  Numbers the values of the I and N registers
+(see C<ssa_build()>), then walks the dominator tree once, propagating
+copies and constants, replacing recomputed values with copies and
+unboxing Integer and Float temporaries.  Afterwards it deletes defs
+whose values nobody reads.  If nothing else changed, it moves loop
+invariants out to the loop preheader.
+
+Returns TRUE if any optimizations were performed. Otherwise, returns
+FALSE.
+
+=cut
+
+*/
+
+static int
+ssa_optimize(PARROT_INTERP, ARGMOD(IMC_Unit *unit))
+{
+    ASSERT_ARGS(ssa_optimize)
+    ssa_t ssa;
+    int   changed = 0;
+
+    IMCC_info(interp, 2, "\tssa_optimize\n");
+
+    memset(&ssa, 0, sizeof (ssa));
+    ssa.unit     = unit;
+    ssa.n_blocks = unit->n_basic_blocks;
+
+    if (ssa_build(&ssa)) {
+        ssa_walk(interp, &ssa);
+        changed = ssa_remove_dead(interp, &ssa) || ssa.changed;
+
+        if (!changed)
+            changed = ssa_hoist(interp, &ssa);
+    }
+
+    ssa_free(&ssa);
+    return changed;
+}
+
+/*
+
+=item C<static int ssa_build(ssa_t *ssa)>
+
+Collects the registers and the dominator tree, then places phis at the
+iterated dominance frontiers of each register's defs.
+
+Returns FALSE for units it can't model.  These are units whose
+dominator tree doesn't hold up, and units with C<local_return>,
+C<cleari> or C<clearn>, whose effect on registers the CFG doesn't show.
+
+=cut
+
+*/
+
+static int
+ssa_build(ARGMOD(ssa_t *ssa))
+{
+    ASSERT_ARGS(ssa_build)
+    IMC_Unit * const unit = ssa->unit;
+    const int        n    = ssa->n_blocks;
+    int             *stack, *work, *in_work, *has_phi, *handlers;
+    int             *defs = NULL, *frontier = NULL, *phis = NULL, *reentries = NULL;
+    int             *def_first, *def_list, *df_first, *df_list;
+    int              n_defs = 0, defs_size = 0, n_frontier = 0, frontier_size = 0;
+    int              n_phis = 0, phis_size = 0, n_reentries = 0, reentries_size = 0;
+    int              ok = 1, sp, b, i, k, v, n_handlers, n_ins = 0;
+    unsigned int     size;
+    const Instruction *eh;
+
+    if (!n || !unit->idoms || !unit->dominators || unit->bb_list[0]->pred_list)
+        return 0;
+
+    ssa->reached    = mem_allocate_n_zeroed_typed(n, char);
+    ssa->handler    = mem_allocate_n_zeroed_typed(n, char);
+    ssa->in_handler = mem_allocate_n_zeroed_typed(n, char);
+    ssa->child      = mem_allocate_n_typed(n, int);
+    ssa->sibling    = mem_allocate_n_typed(n, int);
+    stack           = mem_allocate_n_typed(n, int);
+
+    ssa->reached[0] = 1;
+    stack[0]        = 0;
+    sp              = 1;
+
+    while (sp) {
+        const Edge *e;
+
+        for (e = unit->bb_list[stack[--sp]]->succ_list; e; e = e->succ_next) {
+            if (!ssa->reached[e->to->index]) {
+                ssa->reached[e->to->index] = 1;
+                stack[sp++]                = e->to->index;
+            }
+        }
+    }
+
+    /* the dominator tree over the reached blocks; go on only if each idom
+     * dominates the block's predecessors, and the block's dominators are
+     * those of its idom and itself */
+    for (b = 0; b < n; b++)
+        ssa->child[b] = ssa->sibling[b] = -1;
+
+    for (b = n - 1; ok && b > 0; b--) {
+        const int   d = unit->idoms[b];
+        const Edge *e;
+        int         x;
+
+        if (!ssa->reached[b])
+            continue;
+
+        if (d == b || !ssa->reached[d])
+            ok = 0;
+
+        for (e = unit->bb_list[b]->pred_list; ok && e; e = e->pred_next)
+            if (ssa->reached[e->from->index]
+            && !set_contains(unit->dominators[e->from->index], d))
+                ok = 0;
+
+        for (x = 0; ok && x < n; x++)
+            if (!set_contains(unit->dominators[b], x)
+             != !(x == b || set_contains(unit->dominators[d], x)))
+                ok = 0;
+
+        ssa->sibling[b] = ssa->child[d];
+        ssa->child[d]   = b;
+    }
+
+    /* and it has to span them all */
+    if (ok) {
+        int missing = 0;
+
+        for (b = 0; b < n; b++)
+            missing += ssa->reached[b];
+
+        stack[0] = 0;
+        sp       = 1;
+
+        while (sp) {
+            missing--;
+            for (b = ssa->child[stack[--sp]]; b >= 0; b = ssa->sibling[b])
+                stack[sp++] = b;
+        }
+
+        ok = !missing;
+    }
+
+    if (!ok) {
+        mem_sys_free(stack);
+        return 0;
+    }
+
+    /* handlers are entered from anywhere in their try block, which the CFG
+     * only approximates: by edges from the first and the last block for a
+     * set_addr label, by one from the push_eh for a push_eh label */
+    for (b = 0; b < n; b++)
+        if (unit->bb_list[b]->start->type & ITADDR)
+            ssa->handler[b] = 1;
+
+    for (eh = unit->instructions; eh; eh = eh->next) {
+        if (eh->opnum != PARROT_OP_push_eh_ic)
+            continue;
+
+        for (b = 0; b < n; b++) {
+            const Instruction * const start = unit->bb_list[b]->start;
+
+            if ((start->type & ITLABEL)
+            &&   STREQ(start->symregs[0]->name, eh->symregs[0]->name))
+                ssa->handler[b] = 1;
+        }
+    }
+
+    handlers   = mem_allocate_n_typed(n, int);
+    n_handlers = 0;
+
+    for (b = 0; b < n; b++) {
+        int h;
+
+        if (!ssa->reached[b])
+            continue;
+
+        if (ssa->handler[b])
+            handlers[n_handlers++] = b;
+
+        for (h = b; ; h = unit->idoms[h]) {
+            if (ssa->handler[h]) {
+                ssa->in_handler[b] = 1;
+                break;
+            }
+            if (!h)
+                break;
+        }
+    }
+
+    /* a continuation taken by a call returns to the block after it, with
+     * the registers as they are when it is invoked: as if each block
+     * reachable from there had an edge back to it */
+    has_phi = mem_allocate_n_typed(n, int);
+
+    for (b = 0; b < n; b++)
+        has_phi[b] = -1;
+
+    for (b = 1; b < n; b++) {
+        if (!ssa->reached[b] || !ssa_after_call(unit->bb_list[b]->start))
+            continue;
+
+        has_phi[b] = b;
+        stack[0]   = b;
+        sp         = 1;
+
+        while (sp) {
+            const int   x = stack[--sp];
+            const Edge *e;
+
+            ssa_push(&reentries, &n_reentries, &reentries_size, x, b);
+
+            for (e = unit->bb_list[x]->succ_list; e; e = e->succ_next)
+                if (has_phi[e->to->index] != b) {
+                    has_phi[e->to->index] = b;
+                    stack[sp++]           = e->to->index;
+                }
+        }
+    }
+
+    ssa->reentries = ssa_group(reentries, n_reentries, n, &ssa->reentry_first);
+    mem_sys_free(reentries);
+    mem_sys_free(stack);
+
+    for (size = 16; size < 2 * unit->hash.entries; size <<= 1)
+        ;
+
+    ssa->var_mask  = size - 1;
+    ssa->var_hash  = mem_allocate_n_zeroed_typed(size, int);
+    ssa->vars_size = 16;
+    ssa->vars      = mem_allocate_n_zeroed_typed(ssa->vars_size, ssa_var_t);
+
+    /* the registers, the blocks defining them and how the PMCs are used */
+    for (b = 0; ok && b < n; b++) {
+        Basic_block * const bb = unit->bb_list[b];
+        Instruction        *ins;
+
+        for (ins = bb->start; ins; ins = ins->next) {
+            if (ins->opnum == PARROT_OP_local_return_p
+            ||  ins->opnum == PARROT_OP_cleari
+            ||  ins->opnum == PARROT_OP_clearn) {
+                ok = 0;
+                break;
+            }
+
+            for (i = 0; i < ins->symreg_count; i++) {
+                SymReg * const r = ins->symregs[i];
+
+                if (r->set == 'K') {
+                    const SymReg *key;
+
+                    for (key = r->nextkey; key; key = key->nextkey)
+                        if (key->reg && (v = ssa_add_var(ssa, key->reg)) >= 0)
+                            ssa->vars[v].bad = 1;
+                    continue;
+                }
+
+                if ((v = ssa_add_var(ssa, r)) < 0)
+                    continue;
+
+                if (r->set == 'P')
+                    ssa_scan_box(ssa, v, ins, i);
+                else if (i >= 16 && !ssa_pcc(ins))
+                    ssa->vars[v].bad = 1;
+                else if (!ssa->reached[b]) {
+                    if (ssa_reads(ins, i))
+                        ssa->vars[v].keep = 1;
+                }
+                else if (ssa_writes(ins, i)) {
+                    if (ssa->in_handler[b])
+                        ssa->vars[v].bad = 1;
+                    else
+                        ssa_push(&defs, &n_defs, &defs_size, v, b);
+                }
+            }
+
+            n_ins++;
+
+            if (ins == bb->end)
+                break;
+        }
+    }
+
+    if (!ok) {
+        mem_sys_free(handlers);
+        mem_sys_free(has_phi);
+        mem_sys_free(defs);
+        return 0;
+    }
+
+    for (v = 0; v < ssa->n_vars; v++) {
+        ssa_var_t * const var = ssa->vars + v;
+
+        if (var->reg->set == 'P' && !var->bad
+        && (!var->box_new || !var->box_init
+        ||   var->box_new->next != var->box_init
+        ||   var->box_init->symregs[1]->set != var->box_kind))
+            var->bad = 1;
+    }
+
+    /* dominance frontiers as in compute_dominance_frontiers(), but over
+     * the reached blocks only */
+    in_work = mem_allocate_n_typed(n, int);
+    work    = mem_allocate_n_typed(n, int);
+
+    for (b = 0; b < n; b++)
+        has_phi[b] = in_work[b] = -1;
+
+    for (b = 1; b < n; b++) {
+        const Edge *e;
+        int         preds = 0;
+
+        if (!ssa->reached[b])
+            continue;
+
+        for (e = unit->bb_list[b]->pred_list; e; e = e->pred_next)
+            preds += ssa->reached[e->from->index];
+
+        if (preds < 2)
+            continue;
+
+        for (e = unit->bb_list[b]->pred_list; e; e = e->pred_next) {
+            int runner = e->from->index;
+
+            if (!ssa->reached[runner])
+                continue;
+
+            while (runner != unit->idoms[b] && has_phi[runner] != b) {
+                has_phi[runner] = b;
+                ssa_push(&frontier, &n_frontier, &frontier_size, runner, b);
+
+                if (!runner)
+                    break;
+
+                runner = unit->idoms[runner];
+            }
+        }
+    }
+
+    df_list  = ssa_group(frontier, n_frontier, n, &df_first);
+    def_list = ssa_group(defs, n_defs, ssa->n_vars, &def_first);
+
+    for (b = 0; b < n; b++)
+        has_phi[b] = -1;
+
+    /* a handler block counts as a def of every register */
+    for (v = 0; v < ssa->n_vars; v++) {
+        int wn = 0;
+
+        if (ssa->vars[v].bad || ssa->vars[v].reg->set == 'P')
+            continue;
+
+        for (i = def_first[v]; i < def_first[v + 1]; i++)
+            if (in_work[def_list[i]] != v) {
+                in_work[def_list[i]] = v;
+                work[wn++]           = def_list[i];
+            }
+
+        for (i = 0; i < n_handlers; i++)
+            if (in_work[handlers[i]] != v) {
+                in_work[handlers[i]] = v;
+                work[wn++]           = handlers[i];
+            }
+
+        /* phis go to the dominance frontiers and to the blocks after calls
+         * which can be reentered from there */
+        while (wn) {
+            const int x = work[--wn];
+
+            for (k = 0; k < 2; k++) {
+                const int * const first = k ? ssa->reentry_first : df_first;
+                const int * const list  = k ? ssa->reentries     : df_list;
+
+                for (i = first[x]; i < first[x + 1]; i++) {
+                    const int y = list[i];
+
+                    if (has_phi[y] == v)
+                        continue;
+
+                    has_phi[y] = v;
+
+                    if (!ssa->handler[y])
+                        ssa_push(&phis, &n_phis, &phis_size, y, v);
+
+                    if (in_work[y] != v) {
+                        in_work[y] = v;
+                        work[wn++] = y;
+                    }
+                }
+            }
+        }
+    }
+
+    ssa->values_size = 2 * ssa->n_vars + n_phis / 2 + 64;
+    ssa->values      = mem_allocate_n_typed(ssa->values_size, ssa_value_t);
+    ssa->phis        = ssa_group(phis, n_phis, n, &ssa->phi_first);
+
+    for (b = 0; b < n; b++)
+        for (i = ssa->phi_first[b]; i < ssa->phi_first[b + 1]; i++) {
+            const int phi = ssa_new_value(ssa, ssa->phis[i], b, NULL);
+
+            ssa->values[phi].phi = 1;
+            ssa->phis[i]         = phi;
+        }
+
+    for (size = 16; size < (unsigned int)n_ins; size <<= 1)
+        ;
+
+    ssa->expr_mask = size - 1;
+    ssa->expr_hash = mem_allocate_n_zeroed_typed(size, int);
+
+    mem_sys_free(handlers);
+    mem_sys_free(has_phi);
+    mem_sys_free(in_work);
+    mem_sys_free(work);
+    mem_sys_free(defs);
+    mem_sys_free(frontier);
+    mem_sys_free(phis);
+    mem_sys_free(df_first);
+    mem_sys_free(df_list);
+    mem_sys_free(def_first);
+    mem_sys_free(def_list);
+
+    return 1;
+}
+
+/*
+
+=item C<static void ssa_scan_box(ssa_t *ssa, int v, Instruction *ins, int i)>
+
+Notes how the PMC register C<v> is used as argument C<i> of C<ins>.
+A boxed temporary is created with C<new p, "Integer"> or C<new p,
+"Float">, set by the very next instruction and otherwise only read by
+C<set I, p> or C<set N, p>.  Any other use of the register marks it
+bad.
+
+=cut
+
+*/
+
+static void
+ssa_scan_box(ARGMOD(ssa_t *ssa), int v, ARGIN(Instruction *ins), int i)
+{
+    ASSERT_ARGS(ssa_scan_box)
+    ssa_var_t * const var = ssa->vars + v;
+
+    if (i == 0 && ins->opnum == PARROT_OP_new_p_sc && !var->box_new) {
+        const char * const name = ins->symregs[1]->name;
+
+        if (*name == '"' || *name == '\'') {
+            if (strncmp(name + 1, "Integer", 7) == 0 && name[8] == *name && !name[9])
+                var->box_kind = 'I';
+            else if (strncmp(name + 1, "Float", 5) == 0 && name[6] == *name && !name[7])
+                var->box_kind = 'N';
+        }
+
+        if (var->box_kind) {
+            var->box_new = ins;
+            return;
+        }
+    }
+    else if (i == 0 && !var->box_init
+         && (ins->opnum == PARROT_OP_assign_p_i || ins->opnum == PARROT_OP_assign_p_ic
+         ||  ins->opnum == PARROT_OP_assign_p_n || ins->opnum == PARROT_OP_assign_p_nc
+         ||  ins->opnum == PARROT_OP_set_p_i    || ins->opnum == PARROT_OP_set_p_ic
+         ||  ins->opnum == PARROT_OP_set_p_n    || ins->opnum == PARROT_OP_set_p_nc)) {
+        var->box_init = ins;
+        return;
+    }
+    else if (i == 1
+         && (ins->opnum == PARROT_OP_set_i_p || ins->opnum == PARROT_OP_set_n_p)) {
+        var->box_uses++;
+        return;
+    }
+
+    var->bad = 1;
+}
+
+/*
+
+=item C<static void ssa_walk(PARROT_INTERP, ssa_t *ssa)>
+
+Visits the blocks in dominator tree order, so each read sees the value
+of the def or phi dominating it.  The values of the registers and the
+expressions numbered in a block are dropped again once its subtree is
+done.
+
+=cut
+
+*/
+
+static void
+ssa_walk(PARROT_INTERP, ARGMOD(ssa_t *ssa))
+{
+    ASSERT_ARGS(ssa_walk)
+    /* frames of block, next child or -2 on entry, undo, exprs, region */
+    int * const stack = mem_allocate_n_typed(5 * ssa->n_blocks, int);
+    int         sp    = 1;
+    int         v;
+
+    ssa->region = -1;
+
+    for (v = 0; v < ssa->n_vars; v++)
+        if (!ssa->vars[v].bad && ssa->vars[v].reg->set != 'P')
+            ssa->vars[v].current = ssa_new_value(ssa, v, 0, NULL);
+
+    stack[0] = 0;
+    stack[1] = -2;
+
+    while (sp) {
+        int * const f = stack + 5 * (sp - 1);
+
+        if (f[1] == -2) {
+            f[2] = ssa->n_undo;
+            f[3] = ssa->n_exprs;
+            f[4] = ssa->region;
+            ssa_block(interp, ssa, f[0]);
+            f[1] = ssa->child[f[0]];
+        }
+        else if (f[1] >= 0) {
+            f[5]  = f[1];
+            f[6]  = -2;
+            f[1]  = ssa->sibling[f[1]];
+            sp++;
+        }
+        else {
+            while (ssa->n_undo > f[2]) {
+                ssa->n_undo                           -= 2;
+                ssa->vars[ssa->undo[ssa->n_undo]].current = ssa->undo[ssa->n_undo + 1];
+            }
+
+            while (ssa->n_exprs > f[3]) {
+                const ssa_expr_t * const e = ssa->exprs + --ssa->n_exprs;
+                ssa->expr_hash[e->hash & ssa->expr_mask] = e->next;
+            }
+
+            ssa->region = f[4];
+            sp--;
+        }
+    }
+
+    mem_sys_free(stack);
+}
+
+/*
+
+=item C<static void ssa_block(PARROT_INTERP, ssa_t *ssa, int b)>
+
+Visits block C<b>: its phis, its instructions, then the values its
+successors' phis get from it, including the blocks after calls it may
+return to.  At a handler any register may hold any
+value, so each gets a fresh one.
+
+=cut
+
+*/
+
+static void
+ssa_block(PARROT_INTERP, ARGMOD(ssa_t *ssa), int b)
+{
+    ASSERT_ARGS(ssa_block)
+    Basic_block * const bb = ssa->unit->bb_list[b];
+    Instruction        *ins;
+    const Edge         *e;
+    int                 i, v;
+
+    if (ssa->handler[b]) {
+        ssa->region = b;
+
+        for (v = 0; v < ssa->n_vars; v++)
+            if (!ssa->vars[v].bad && ssa->vars[v].reg->set != 'P') {
+                const int value = ssa_new_value(ssa, v, b, NULL);
+
+                ssa->values[value].handler = 1;
+                ssa_set(ssa, v, value);
+            }
+    }
+
+    for (i = ssa->phi_first[b]; i < ssa->phi_first[b + 1]; i++)
+        ssa_set(ssa, ssa->values[ssa->phis[i]].var, ssa->phis[i]);
+
+    for (ins = bb->start; ins; ins = ins->next) {
+        ins = ssa_visit(interp, ssa, ins, b);
+
+        if (ins == bb->end)
+            break;
+    }
+
+    for (e = bb->succ_list; e; e = e->succ_next)
+        ssa_flow(ssa, e->to->index);
+
+    for (i = ssa->reentry_first[b]; i < ssa->reentry_first[b + 1]; i++)
+        ssa_flow(ssa, ssa->reentries[i]);
+}
+
+/*
+
+=item C<static void ssa_flow(ssa_t *ssa, int s)>
+
+Records the values the phis of block C<s> get from the current block.
+
+=cut
+
+*/
+
+static void
+ssa_flow(ARGMOD(ssa_t *ssa), int s)
+{
+    ASSERT_ARGS(ssa_flow)
+    int i;
+
+    for (i = ssa->phi_first[s]; i < ssa->phi_first[s + 1]; i++) {
+        const int phi = ssa->phis[i];
+
+        ssa_push(&ssa->phi_args, &ssa->n_phi_args, &ssa->phi_args_size,
+                phi, ssa->vars[ssa->values[phi].var].current);
+    }
+}
+
+/*
+
+=item C<static Instruction * ssa_visit(PARROT_INTERP, ssa_t *ssa, Instruction
+*ins, int b)>
+
+Rewrites the reads of C<ins> with what is known about their values,
+replaces it with a copy if its value is already in a register, then
+records the values it reads and defines.  Returns C<ins>, or the
+instruction that replaced it.
+
+=cut
+
+*/
+
+PARROT_CANNOT_RETURN_NULL
+static Instruction *
+ssa_visit(PARROT_INTERP, ARGMOD(ssa_t *ssa), ARGMOD(Instruction *ins), int b)
+{
+    ASSERT_ARGS(ssa_visit)
+    ssa_expr_t expr;
+    int        args[2];
+    int        i, v, numbered;
+
+    if (ins->opnum < 0 || (ins->type & ITLABEL))
+        return ins;
+
+    /* rewriting a read may turn ins into another op: then start over */
+    for (i = 0; i < ins->symreg_count; i++) {
+        Instruction *tmp = ins;
+
+        if (!ssa_reads(ins, i) || ssa_writes(ins, i)
+        ||  (v = ssa_find(ssa, ins->symregs[i])) < 0)
+            continue;
+
+        if (ssa->vars[v].reg->set != 'P')
+            tmp = ssa_propagate(interp, ssa, ins, i);
+        else if (i == 1
+             && (ins->opnum == PARROT_OP_set_i_p || ins->opnum == PARROT_OP_set_n_p))
+            tmp = ssa_unbox(interp, ssa, ins, v);
+
+        if (tmp != ins) {
+            ins = tmp;
+            i   = -1;
+        }
+    }
+
+    numbered = ssa_expr_key(interp, ssa, ins, &expr);
+
+    if (numbered) {
+        const int e = ssa_expr_find(ssa, &expr);
+
+        if (e >= 0) {
+            SymReg      *regs[2];
+            Instruction *tmp;
+
+            regs[0] = ins->symregs[0];
+            regs[1] = ssa->exprs[e].reg;
+            tmp     = INS(interp, ssa->unit, "set", "", regs, 2, 0, 0);
+
+            IMCC_debug(interp, DEBUG_OPT2, "value of %I already in %s\n",
+                    ins, regs[1]->name);
+            ssa_replace(ssa, ins, tmp);
+
+            ins      = tmp;
+            numbered = 0;
+            ssa->unit->ostat.values_numbered++;
+            ssa->changed = 1;
+        }
+    }
+
+    for (i = 0; i < 2; i++)
+        args[i] = i + 1 >= ins->symreg_count
+               || (ins->symregs[i + 1]->type & VTCONST) ? -1 : -2;
+
+    for (i = 0; i < ins->symreg_count; i++) {
+        if (!ssa_reads(ins, i)
+        ||  (v = ssa_find(ssa, ins->symregs[i])) < 0
+        ||  ssa->vars[v].reg->set == 'P')
+            continue;
+
+        ssa->values[ssa->vars[v].current].uses++;
+
+        if (i == 1 || i == 2)
+            args[i - 1] = ssa->vars[v].current;
+    }
+
+    for (i = 0; i < ins->symreg_count; i++) {
+        int value;
+
+        if (!ssa_writes(ins, i)
+        ||  (v = ssa_find(ssa, ins->symregs[i])) < 0
+        ||  ssa->vars[v].reg->set == 'P')
+            continue;
+
+        value = ssa_new_value(ssa, v, b, ins);
+
+        if (i == 0 && ssa_pure(interp, ins)) {
+            ssa_value_t * const def = ssa->values + value;
+            SymReg      * const src = ins->symreg_count > 1 ? ins->symregs[1] : NULL;
+
+            def->args[0] = args[0];
+            def->args[1] = args[1];
+
+            if (ins->opnum == PARROT_OP_null_i || ins->opnum == PARROT_OP_null_n)
+                def->constant = mk_const(interp, "0", ins->symregs[0]->set);
+            else if (src && STREQ(ins->opname, "set")
+                 &&  src->set == ins->symregs[0]->set) {
+                if (src->type & VTCONST)
+                    def->constant = src;
+                else if (args[0] >= 0)
+                    def->copy_of = args[0];
+            }
+        }
+
+        ssa_set(ssa, v, value);
+    }
+
+    if (numbered) {
+        expr.value = ssa->vars[ssa_find(ssa, expr.reg)].current;
+        ssa_expr_add(ssa, &expr);
+    }
+
+    /* the box is known from its set on */
+    if (ins->symreg_count == 2
+    && (v = ssa_find(ssa, ins->symregs[0])) >= 0
+    &&  ssa->vars[v].box_init == ins) {
+        ssa_var_t * const box = ssa->vars + v;
+        const int         x   = ssa_find(ssa, ins->symregs[1]);
+
+        if (x >= 0 || (ins->symregs[1]->type & VTCONST)) {
+            box->box_value    = ins->symregs[1];
+            box->box_value_id = x >= 0 ? ssa->vars[x].current : -1;
+            box->box_region   = ssa->region;
+            ssa_set(ssa, v, 1);
+        }
+    }
+
+    return ins;
+}
+
+/*
+
+=item C<static Instruction * ssa_propagate(PARROT_INTERP, ssa_t *ssa,
+Instruction *ins, int i)>
+
+Rewrites the read of argument C<i> of C<ins>.  If the value is a
+constant, the constant replaces the register where an op for that
+exists; an integer op with all constant arguments is folded.  If the
+value is a copy, the read goes to the register it was copied from, as
+long as that still holds it.
+
+=cut
+
+*/
+
+PARROT_CANNOT_RETURN_NULL
+static Instruction *
+ssa_propagate(PARROT_INTERP, ARGMOD(ssa_t *ssa), ARGMOD(Instruction *ins), int i)
+{
+    ASSERT_ARGS(ssa_propagate)
+    SymReg * const     old   = ins->symregs[i];
+    const ssa_value_t *value = ssa->values + ssa->vars[ssa_find(ssa, old)].current;
+    const ssa_value_t *c     = value;
+
+    while (!c->constant && c->copy_of >= 0)
+        c = ssa->values + c->copy_of;
+
+    if (c->constant) {
+        char fullname[128];
+        int  op;
+
+        /* the call signatures are built from the arguments */
+        if (ssa_pcc(ins) || (ins->keys & (1 << i)))
+            return ins;
+
+        ins->symregs[i] = c->constant;
+        op = check_op(interp, fullname, ins->opname, ins->symregs,
+                ins->symreg_count, ins->keys);
+
+        if (op >= 0) {
+            ins->opnum = op;
+            --old->use_count;
+            IMCC_debug(interp, DEBUG_OPT2, "propagated constant -> %I\n", ins);
+            ssa->unit->ostat.constants_propagated++;
+            ssa->changed = 1;
+            return ins;
+        }
+
+        if (ssa_foldable(interp, ins)) {
+            SymReg      *regs[3];
+            Instruction *tmp;
+            int          j, ok = 0;
+
+            for (j = 0; j < ins->symreg_count; j++)
+                regs[j] = ins->symregs[j];
+
+            tmp = IMCC_subst_constants(interp, ssa->unit, ins->opname, regs,
+                    ins->opsize, &ok);
+
+            if (ok && tmp) {
+                --old->use_count;
+                ssa_replace(ssa, ins, tmp);
+                ssa->unit->ostat.constants_propagated++;
+                ssa->changed = 1;
+                return tmp;
+            }
+        }
+
+        ins->symregs[i] = old;
+        return ins;
+    }
+
+    while (value->copy_of >= 0) {
+        const ssa_var_t * const src = ssa->vars + ssa->values[value->copy_of].var;
+
+        if (src->current != value->copy_of)
+            break;
+
+        ins->symregs[i] = src->reg;
+        value           = ssa->values + value->copy_of;
+    }
+
+    if (ins->symregs[i] != old) {
+        --old->use_count;
+        ++ins->symregs[i]->use_count;
+        IMCC_debug(interp, DEBUG_OPT2, "propagated copy -> %I\n", ins);
+        ssa->unit->ostat.copies_propagated++;
+        ssa->changed = 1;
+    }
+
+    return ins;
+}
+
+/*
+
+=item C<static Instruction * ssa_unbox(PARROT_INTERP, ssa_t *ssa, Instruction
+*ins, int p)>
+
+Replaces C<set I, p> or C<set N, p> of the boxed temporary C<p> by a
+C<set> from the value it was boxed from.  This needs the box's C<set>
+to dominate C<ins> in the same handler region, and the value to still be
+in its register.  Returns the new instruction, or C<ins> if it couldn't
+be replaced.
+
+=cut
+
+*/
+
+PARROT_CANNOT_RETURN_NULL
+static Instruction *
+ssa_unbox(PARROT_INTERP, ARGMOD(ssa_t *ssa), ARGMOD(Instruction *ins), int p)
+{
+    ASSERT_ARGS(ssa_unbox)
+    ssa_var_t * const box = ssa->vars + p;
+    SymReg           *regs[2];
+    Instruction      *tmp;
+
+    if (!box->current || box->box_region != ssa->region)
+        return ins;
+
+    if (!(box->box_value->type & VTCONST)) {
+        const int x = ssa_find(ssa, box->box_value);
+
+        if (x < 0 || ssa->vars[x].current != box->box_value_id)
+            return ins;
+    }
+
+    regs[0] = ins->symregs[0];
+    regs[1] = box->box_value;
+    tmp     = INS(interp, ssa->unit, "set", "", regs, 2, 0, 0);
+
+    IMCC_debug(interp, DEBUG_OPT2, "unboxed %I => %I\n", ins, tmp);
+    ssa_replace(ssa, ins, tmp);
+
+    box->box_unboxed++;
+    ssa->unit->ostat.unboxed++;
+    ssa->changed = 1;
+
+    return tmp;
+}
+
+/*
+
+=item C<static int ssa_expr_key(PARROT_INTERP, const ssa_t *ssa, const
+Instruction *ins, ssa_expr_t *e)>
+
+Fills in C<e> for the pure op C<ins>: the op and the values of its
+arguments, looking through copies and ordered for commutative ops.
+Returns FALSE for everything else, including plain copies and
+constants.
+
+=cut
+
+*/
+
+PARROT_WARN_UNUSED_RESULT
+static int
+ssa_expr_key(PARROT_INTERP, ARGIN(const ssa_t *ssa), ARGIN(const Instruction *ins),
+        ARGOUT(ssa_expr_t *e))
+{
+    ASSERT_ARGS(ssa_expr_key)
+    PARROT_OBSERVER const char * const commutative[] = {
+        "add", "band", "bor", "bxor", "iseq", "isne", "mul"
+    };
+    size_t j;
+    int    i;
+
+    if (ins->symreg_count < 2 || !ssa_pure(interp, ins)
+    ||  (STREQ(ins->opname, "set") && ins->symregs[1]->set == ins->symregs[0]->set)
+    ||  ssa_find(ssa, ins->symregs[0]) < 0)
+        return 0;
+
+    e->opnum  = ins->opnum;
+    e->n      = ins->symreg_count - 1;
+    e->reg    = ins->symregs[0];
+    e->val[0] = e->val[1] = -1;
+    e->con[0] = e->con[1] = NULL;
+
+    for (i = 0; i < e->n; i++) {
+        SymReg * const r = ins->symregs[i + 1];
+
+        if (r->type & VTCONST)
+            e->con[i] = r;
+        else {
+            const int          v = ssa_find(ssa, r);
+            const ssa_value_t *value;
+
+            if (v < 0)
+                return 0;
+
+            value = ssa->values + ssa->vars[v].current;
+
+            while (!value->constant && value->copy_of >= 0)
+                value = ssa->values + value->copy_of;
+
+            if (value->constant)
+                e->con[i] = value->constant;
+            else
+                e->val[i] = value - ssa->values;
+        }
+    }
+
+    if (e->n == 2 && ssa_operand_cmp(e, 0, e, 1) > 0) {
+        for (j = 0; j < N_ELEMENTS(commutative); j++) {
+            if (STREQ(ins->opname, commutative[j])) {
+                SymReg * const con = e->con[0];
+                const int      val = e->val[0];
+
+                e->con[0] = e->con[1];
+                e->val[0] = e->val[1];
+                e->con[1] = con;
+                e->val[1] = val;
+                break;
+            }
+        }
+    }
+
+    e->hash = (unsigned int)e->opnum;
+
+    for (i = 0; i < e->n; i++) {
+        if (e->con[i]) {
+            const char *s;
+
+            for (s = e->con[i]->name; *s; s++)
+                e->hash = e->hash * 31 + (unsigned char)*s;
+        }
+        else
+            e->hash = e->hash * 31 + (unsigned int)e->val[i] * 7919;
+    }
+
+    return 1;
+}
+
+/*
+
+=item C<static int ssa_operand_cmp(const ssa_expr_t *a, int i, const ssa_expr_t
+*b, int j)>
+
+Orders argument C<i> of C<a> against argument C<j> of C<b>: values
+before constants, and 0 if they are the same.
+
+=cut
+
+*/
+
+PARROT_WARN_UNUSED_RESULT
+static int
+ssa_operand_cmp(ARGIN(const ssa_expr_t *a), int i, ARGIN(const ssa_expr_t *b), int j)
+{
+    ASSERT_ARGS(ssa_operand_cmp)
+
+    if (a->con[i] && b->con[j]) {
+        if (a->con[i]->set != b->con[j]->set)
+            return a->con[i]->set - b->con[j]->set;
+
+        return strcmp(a->con[i]->name, b->con[j]->name);
+    }
+
+    if (a->con[i])
+        return 1;
+
+    if (b->con[j])
+        return -1;
+
+    return a->val[i] - b->val[j];
+}
+
+/*
+
+=item C<static int ssa_expr_find(const ssa_t *ssa, const ssa_expr_t *e)>
+
+Looks for an expression computed earlier on the way down the dominator
+tree that is the same as C<e> and whose register still holds the result.
+Returns its index, or -1.
+
+=cut
+
+*/
+
+PARROT_WARN_UNUSED_RESULT
+static int
+ssa_expr_find(ARGIN(const ssa_t *ssa), ARGIN(const ssa_expr_t *e))
+{
+    ASSERT_ARGS(ssa_expr_find)
+    int i;
+
+    for (i = ssa->expr_hash[e->hash & ssa->expr_mask] - 1; i >= 0;
+         i = ssa->exprs[i].next - 1) {
+        const ssa_expr_t * const x = ssa->exprs + i;
+        int                      k;
+
+        if (x->hash != e->hash || x->opnum != e->opnum || x->reg == e->reg)
+            continue;
+
+        for (k = 0; k < e->n; k++)
+            if (ssa_operand_cmp(x, k, e, k))
+                break;
+
+        if (k == e->n && ssa->vars[ssa_find(ssa, x->reg)].current == x->value)
+            return i;
+    }
+
+    return -1;
+}
+
+/*
+
+=item C<static void ssa_expr_add(ssa_t *ssa, const ssa_expr_t *e)>
+
+Adds C<e> to the expressions known in the current block and the ones
+it dominates.
+
+=cut
+
+*/
+
+static void
+ssa_expr_add(ARGMOD(ssa_t *ssa), ARGIN(const ssa_expr_t *e))
+{
+    ASSERT_ARGS(ssa_expr_add)
+    const unsigned int slot = e->hash & ssa->expr_mask;
+
+    if (ssa->n_exprs == ssa->exprs_size) {
+        ssa->exprs_size = ssa->exprs_size ? 2 * ssa->exprs_size : 64;
+        mem_realloc_n_typed(ssa->exprs, ssa->exprs_size, ssa_expr_t);
+    }
+
+    ssa->exprs[ssa->n_exprs]      = *e;
+    ssa->exprs[ssa->n_exprs].next = ssa->expr_hash[slot];
+    ssa->expr_hash[slot]          = ++ssa->n_exprs;
+}
+
+/*
+
+=item C<static int ssa_remove_dead(PARROT_INTERP, ssa_t *ssa)>
+
+Marks the values read anywhere, directly or through phis, as live.
+Pure defs of dead values are deleted, as are boxes whose every read
+has been unboxed.  A register that is read with the unknown value a
+handler starts with must keep all its defs.
+
+Returns TRUE if anything was deleted.
+
+=cut
+
+*/
+
+static int
+ssa_remove_dead(PARROT_INTERP, ARGMOD(ssa_t *ssa))
+{
+    ASSERT_ARGS(ssa_remove_dead)
+    IMC_Unit * const unit    = ssa->unit;
+    int              changed = 0;
+    int              again   = 1;
+    int              i;
+
+    for (i = 0; i < ssa->n_values; i++)
+        ssa->values[i].live = ssa->values[i].uses > 0;
+
+    while (again) {
+        again = 0;
+
+        for (i = 0; i < ssa->n_phi_args; i += 2) {
+            if (ssa->values[ssa->phi_args[i]].live
+            && !ssa->values[ssa->phi_args[i + 1]].live) {
+                ssa->values[ssa->phi_args[i + 1]].live = 1;
+                again = 1;
+            }
+        }
+    }
+
+    for (i = 0; i < ssa->n_values; i++)
+        if (ssa->values[i].live && ssa->values[i].handler)
+            ssa->vars[ssa->values[i].var].keep = 1;
+
+    for (i = 0; i < ssa->n_values; i++) {
+        ssa_value_t * const value = ssa->values + i;
+
+        if (value->live || !value->def || ssa->vars[value->var].keep
+        ||  !ssa_pure(interp, value->def))
+            continue;
+
+        IMCC_debug(interp, DEBUG_OPT2, "dead '%I' deleted\n", value->def);
+        ssa_unlink(ssa, value->def);
+        free_ins(value->def);
+        value->def = NULL;
+
+        unit->ostat.deleted_ins++;
+        changed = 1;
+    }
+
+    for (i = 0; i < ssa->n_vars; i++) {
+        ssa_var_t * const box = ssa->vars + i;
+
+        if (box->reg->set != 'P' || box->bad || box->box_value_id == -2
+        ||  box->box_unboxed != box->box_uses)
+            continue;
+
+        IMCC_debug(interp, DEBUG_OPT2, "unused box %s deleted\n", box->reg->name);
+        ssa_unlink(ssa, box->box_init);
+        ssa_unlink(ssa, box->box_new);
+        free_ins(box->box_init);
+        free_ins(box->box_new);
+
+        unit->ostat.deleted_ins += 2;
+        changed = 1;
+    }
+
+    return changed;
+}
+
+/*
+
+=item C<static int ssa_hoist(PARROT_INTERP, ssa_t *ssa)>
+
+Moves pure defs out of loops with a natural preheader.  A def moves if
+its block is dominated by the loop header and its arguments are defined
+outside the loop.  Its register must have no other def in the loop, and
+the value the register has on entering the loop must be dead.
+
+Returns TRUE if anything was moved.
+
+=cut
+
+*/
+
+static int
+ssa_hoist(PARROT_INTERP, ARGMOD(ssa_t *ssa))
+{
+    ASSERT_ARGS(ssa_hoist)
+    IMC_Unit * const unit    = ssa->unit;
+    char     * const moved   = mem_allocate_n_zeroed_typed(ssa->n_values + 1, char);
+    char     * const emptied = mem_allocate_n_zeroed_typed(ssa->n_blocks, char);
+    int              changed = 0;
+    int              l;
+
+    for (l = 0; l < unit->n_loops; l++) {
+        const Loop_info * const loop   = unit->loop_info[l];
+        const int               header = loop->header;
+        const int               pre    = (int)loop->preheader;
+        Basic_block            *to;
+        int                     i;
+
+        if (pre < 0 || !ssa->reached[header] || !ssa->reached[pre] || emptied[pre])
+            continue;
+
+        to = unit->bb_list[pre];
+
+        /* the new code goes before the preheader's branch to the loop, or
+         * after its last instruction, which must go on to the header */
+        if (to->end->opnum != PARROT_OP_branch_ic && (to->end->type & ITBRANCH))
+            continue;
+
+        for (i = 0; i < ssa->n_vars; i++)
+            ssa->vars[i].loop_defs = 0;
+
+        for (i = 0; i < ssa->n_values; i++)
+            if (ssa->values[i].def && set_contains(loop->loop, ssa->values[i].block))
+                ssa->vars[ssa->values[i].var].loop_defs++;
+
+        for (i = 0; i < ssa->n_values; i++) {
+            ssa_value_t * const value = ssa->values + i;
+            Instruction * const ins   = value->def;
+            int                 k, phi;
+
+            if (!ins || moved[i]
+            ||  !set_contains(loop->loop, value->block)
+            ||  !set_contains(unit->dominators[value->block], header)
+            ||  ssa->vars[value->var].keep
+            ||  ssa->vars[value->var].loop_defs != 1
+            ||  !ssa_pure(interp, ins))
+                continue;
+
+            for (k = 0; k < 2; k++)
+                if (value->args[k] == -2
+                || (value->args[k] >= 0
+                &&  set_contains(loop->loop, ssa->values[value->args[k]].block)))
+                    break;
+
+            if (k < 2)
+                continue;
+
+            for (phi = ssa->phi_first[header]; phi < ssa->phi_first[header + 1]; phi++)
+                if (ssa->values[ssa->phis[phi]].var == value->var)
+                    break;
+
+            if (phi == ssa->phi_first[header + 1] || ssa->values[ssa->phis[phi]].live)
+                continue;
+
+            IMCC_debug(interp, DEBUG_OPT2, "invariant '%I' moved out of loop\n", ins);
+
+            if (ssa_unlink(ssa, ins))
+                emptied[ins->bbindex] = 1;
+
+            if (to->end->opnum == PARROT_OP_branch_ic)
+                prepend_ins(unit, to->end, ins);
+            else {
+                insert_ins(unit, to->end, ins);
+                to->end = ins;
+            }
+
+            ins->bbindex = pre;
+            moved[i]     = 1;
+
+            unit->ostat.invariants_moved++;
+            changed = 1;
+        }
+    }
+
+    mem_sys_free(moved);
+    mem_sys_free(emptied);
+
+    return changed;
+}
+
+/*
+
+=item C<static int ssa_pure(PARROT_INTERP, const Instruction *ins)>
+
+Returns TRUE if C<ins> computes an I or N register from I and N
+arguments alone, can't throw and has no other effect.
+
+=cut
+
+*/
+
+PARROT_WARN_UNUSED_RESULT
+static int
+ssa_pure(PARROT_INTERP, ARGIN(const Instruction *ins))
+{
+    ASSERT_ARGS(ssa_pure)
+    PARROT_OBSERVER const char * const pure[] = {
+        "abs", "add", "band", "bnot", "bor", "bxor", "ceil", "cmp", "floor",
+        "iseq", "isge", "isgt", "isle", "islt", "isne", "lsr", "mul", "neg",
+        "not", "null", "set", "shl", "shr", "sqrt", "sub"
+    };
+    const op_info_t *info;
+    size_t           j;
+    int              i;
+
+    if (ins->opnum < 0 || ins->keys || (ins->type & ITBRANCH)
+    ||  ins->symreg_count < 1 || ins->symreg_count > 3)
+        return 0;
+
+    info = &interp->op_info_table[ins->opnum];
+
+    if (info->op_count != ins->symreg_count + 1)
+        return 0;
+
+    for (i = 0; i < ins->symreg_count; i++) {
+        const arg_type_t t = (arg_type_t)info->types[i];
+
+        if (info->dirs[i] != (i ? PARROT_ARGDIR_IN : PARROT_ARGDIR_OUT))
+            return 0;
+
+        if (t != PARROT_ARG_I && t != PARROT_ARG_N
+        && (!i || (t != PARROT_ARG_IC && t != PARROT_ARG_NC)))
+            return 0;
+    }
+
+    for (j = 0; j < N_ELEMENTS(pure); j++)
+        if (STREQ(info->name, pure[j]))
+            return 1;
+
+    return 0;
+}
+
+/*
+
+=item C<static int ssa_foldable(PARROT_INTERP, const Instruction *ins)>
+
+Returns TRUE if C<ins> is an integer op with only constant arguments
+that C<IMCC_subst_constants()> may evaluate.  Numeric results are left
+alone: their constants would be printed with less than full precision.
+
+=cut
+
+*/
+
+PARROT_WARN_UNUSED_RESULT
+static int
+ssa_foldable(PARROT_INTERP, ARGIN(const Instruction *ins))
+{
+    ASSERT_ARGS(ssa_foldable)
+    char name[64];
+    int  i;
+
+    if (ins->symreg_count < 2 || ins->symreg_count > 3 || ins->keys
+    ||  (ins->type & ITBRANCH))
+        return 0;
+
+    for (i = 0; i < ins->symreg_count; i++)
+        if (ins->symregs[i]->set != 'I'
+        || (i && !(ins->symregs[i]->type & VTCONST)))
+            return 0;
+
+    snprintf(name, sizeof (name), ins->symreg_count == 2 ? "%s_i_i" : "%s_i_i_i",
+            ins->opname);
+
+    return interp->op_lib->op_code(name, 1) >= 0;
+}
+
+/*
+
+=item C<static int ssa_after_call(const Instruction *ins)>
+
+Returns TRUE if C<ins>, the start of a block, follows a sub call, as in
+C<analyse_life_symbol()>.
+
+=cut
+
+*/
+
+PARROT_WARN_UNUSED_RESULT
+static int
+ssa_after_call(ARGIN(const Instruction *ins))
+{
+    ASSERT_ARGS(ssa_after_call)
+    const Instruction * const prev = ins->prev;
+
+    if (!prev)
+        return 0;
+
+    return ((prev->type & (ITPCCSUB | ITPCCYIELD)) && prev->opnum != PARROT_OP_tailcall_p)
+        ||  prev->opnum == PARROT_OP_invoke_p_p
+        ||  prev->opnum == PARROT_OP_invokecc_p;
+}
+
+/*
+
+=item C<static int ssa_pcc(const Instruction *ins)>
+
+Returns TRUE if C<ins> passes arguments or results of a call.
+
+=cut
+
+*/
+
+PARROT_WARN_UNUSED_RESULT
+static int
+ssa_pcc(ARGIN(const Instruction *ins))
+{
+    ASSERT_ARGS(ssa_pcc)
+
+    return ins->opnum == PARROT_OP_set_args_pc
+        || ins->opnum == PARROT_OP_get_results_pc
+        || ins->opnum == PARROT_OP_get_params_pc
+        || ins->opnum == PARROT_OP_set_returns_pc;
+}
+
+/*
+
+=item C<static int ssa_reads(const Instruction *ins, int i)>
+
+Returns TRUE if C<ins> reads its argument C<i>.
+
+=cut
+
+*/
+
+PARROT_WARN_UNUSED_RESULT
+static int
+ssa_reads(ARGIN(const Instruction *ins), int i)
+{
+    ASSERT_ARGS(ssa_reads)
+
+    switch (ins->opnum) {
+        case PARROT_OP_set_args_pc:
+        case PARROT_OP_set_returns_pc:
+            return i > 0;
+        case PARROT_OP_get_params_pc:
+        case PARROT_OP_get_results_pc:
+            return 0;
+        default:
+            return i < 16 && (ins->flags & (1U << i));
+    }
+}
+
+/*
+
+=item C<static int ssa_writes(const Instruction *ins, int i)>
+
+Returns TRUE if C<ins> writes its argument C<i>.
+
+=cut
+
+*/
+
+PARROT_WARN_UNUSED_RESULT
+static int
+ssa_writes(ARGIN(const Instruction *ins), int i)
+{
+    ASSERT_ARGS(ssa_writes)
+
+    switch (ins->opnum) {
+        case PARROT_OP_set_args_pc:
+        case PARROT_OP_set_returns_pc:
+            return 0;
+        case PARROT_OP_get_params_pc:
+        case PARROT_OP_get_results_pc:
+            return i > 0;
+        default:
+            return i < 16 && (ins->flags & (1U << (16 + i)));
+    }
+}
+
+/*
+
+=item C<static void ssa_replace(ssa_t *ssa, Instruction *ins, Instruction *tmp)>
+
+Replaces C<ins> with C<tmp> in the code and in its basic block.
+
+=cut
+
+*/
+
+static void
+ssa_replace(ARGMOD(ssa_t *ssa), ARGMOD(Instruction *ins), ARGMOD(Instruction *tmp))
+{
+    ASSERT_ARGS(ssa_replace)
+    Basic_block * const bb = ssa->unit->bb_list[ins->bbindex];
+
+    tmp->bbindex = ins->bbindex;
+    tmp->index   = ins->index;
+
+    if (bb->start == ins)
+        bb->start = tmp;
+
+    if (bb->end == ins)
+        bb->end = tmp;
+
+    subst_ins(ssa->unit, ins, tmp, 1);
+}
+
+/*
+
+=item C<static int ssa_unlink(ssa_t *ssa, Instruction *ins)>
+
+Takes C<ins> out of the code and out of its basic block, without freeing
+it.  Returns TRUE if that leaves the block empty.
+
+=cut
+
+*/
+
+static int
+ssa_unlink(ARGMOD(ssa_t *ssa), ARGMOD(Instruction *ins))
+{
+    ASSERT_ARGS(ssa_unlink)
+    Basic_block * const bb   = ssa->unit->bb_list[ins->bbindex];
+    Instruction * const prev = ins->prev;
+    Instruction * const next = _delete_ins(ssa->unit, ins);
+
+    if (bb->start == ins && bb->end == ins)
+        return 1;
+
+    if (bb->start == ins)
+        bb->start = next;
+    else if (bb->end == ins)
+        bb->end = prev;
+
+    return 0;
+}
+
+/*
+
+=item C<static int ssa_add_var(ssa_t *ssa, SymReg *r)>
+
+Returns the index of register C<r> in C<ssa-E<gt>vars>, adding it if
+needed, or -1 if C<r> is no I, N or PMC register.  Registers which are
+lexicals, C<:unique_reg> or have a fixed number start out bad.
+
+=cut
+
+*/
+
+static int
+ssa_add_var(ARGMOD(ssa_t *ssa), ARGIN(SymReg *r))
+{
+    ASSERT_ARGS(ssa_add_var)
+    ssa_var_t   *var;
+    unsigned int h;
+
+    if (!REG_NEEDS_ALLOC(r) || (r->set != 'I' && r->set != 'N' && r->set != 'P'))
+        return -1;
+
+    for (h = SSA_REG_HASH(r) & ssa->var_mask; ssa->var_hash[h];
+         h = (h + 1) & ssa->var_mask)
+        if (ssa->vars[ssa->var_hash[h] - 1].reg == r)
+            return ssa->var_hash[h] - 1;
+
+    if (2 * (unsigned int)(ssa->n_vars + 1) > ssa->var_mask) {
+        const unsigned int size = 2 * (ssa->var_mask + 1);
+        int                v;
+
+        mem_sys_free(ssa->var_hash);
+        ssa->var_mask = size - 1;
+        ssa->var_hash = mem_allocate_n_zeroed_typed(size, int);
+
+        for (v = 0; v < ssa->n_vars; v++) {
+            for (h = SSA_REG_HASH(ssa->vars[v].reg) & ssa->var_mask; ssa->var_hash[h];
+                 h = (h + 1) & ssa->var_mask)
+                ;
+            ssa->var_hash[h] = v + 1;
+        }
+
+        for (h = SSA_REG_HASH(r) & ssa->var_mask; ssa->var_hash[h];
+             h = (h + 1) & ssa->var_mask)
+            ;
+    }
+
+    if (ssa->n_vars == ssa->vars_size) {
+        ssa->vars = (ssa_var_t *)mem_sys_realloc_zeroed(ssa->vars,
+                2 * ssa->vars_size * sizeof (ssa_var_t),
+                ssa->vars_size * sizeof (ssa_var_t));
+        ssa->vars_size *= 2;
+    }
+
+    ssa->var_hash[h]  = ssa->n_vars + 1;
+    var               = ssa->vars + ssa->n_vars;
+    var->reg          = r;
+    var->box_value_id = -2;
+    var->bad          = (r->type & ~(VTREG | VTIDENTIFIER))
+                     || (r->usage & (U_LEXICAL | U_UNIQUE_REG))
+                     ||  r->reg;
+
+    return ssa->n_vars++;
+}
+
+/*
+
+=item C<static int ssa_find(const ssa_t *ssa, const SymReg *r)>
+
+Returns the index of register C<r> in C<ssa-E<gt>vars>, or -1 if it is
+unknown or bad.
+
+=cut
+
+*/
+
+PARROT_WARN_UNUSED_RESULT
+static int
+ssa_find(ARGIN(const ssa_t *ssa), ARGIN(const SymReg *r))
+{
+    ASSERT_ARGS(ssa_find)
+    unsigned int h;
+
+    for (h = SSA_REG_HASH(r) & ssa->var_mask; ssa->var_hash[h];
+         h = (h + 1) & ssa->var_mask) {
+        const ssa_var_t * const var = ssa->vars + ssa->var_hash[h] - 1;
+
+        if (var->reg == r)
+            return var->bad ? -1 : ssa->var_hash[h] - 1;
+    }
+
+    return -1;
+}
+
+/*
+
+=item C<static int ssa_new_value(ssa_t *ssa, int var, int block, Instruction
+*def)>
+
+Returns a new value of register C<var>, defined by C<def> in C<block>.
+
+=cut
+
+*/
+
+static int
+ssa_new_value(ARGMOD(ssa_t *ssa), int var, int block, ARGIN_NULLOK(Instruction *def))
+{
+    ASSERT_ARGS(ssa_new_value)
+    ssa_value_t *value;
+
+    if (ssa->n_values == ssa->values_size) {
+        ssa->values_size *= 2;
+        mem_realloc_n_typed(ssa->values, ssa->values_size, ssa_value_t);
+    }
+
+    value = ssa->values + ssa->n_values;
+    memset(value, 0, sizeof (ssa_value_t));
+
+    value->def     = def;
+    value->var     = var;
+    value->block   = block;
+    value->copy_of = -1;
+    value->args[0] = value->args[1] = -2;
+
+    return ssa->n_values++;
+}
+
+/*
+
+=item C<static void ssa_set(ssa_t *ssa, int var, int value)>
+
+Sets the current value of C<var>, to be undone when the walk leaves the
+current block's subtree.
+
+=cut
+
+*/
+
+static void
+ssa_set(ARGMOD(ssa_t *ssa), int var, int value)
+{
+    ASSERT_ARGS(ssa_set)
+
+    ssa_push(&ssa->undo, &ssa->n_undo, &ssa->undo_size, var, ssa->vars[var].current);
+    ssa->vars[var].current = value;
+}
+
+/*
+
+=item C<static void ssa_push(int **list, int *n, int *size, int a, int b)>
+
+Appends the pair C<a>, C<b> to C<list>, growing it as needed.
+
+=cut
+
+*/
+
+static void
+ssa_push(ARGMOD(int **list), ARGMOD(int *n), ARGMOD(int *size), int a, int b)
+{
+    ASSERT_ARGS(ssa_push)
+
+    if (*n + 2 > *size) {
+        *size = *size ? 2 * *size : 64;
+        mem_realloc_n_typed(*list, *size, int);
+    }
+
+    (*list)[(*n)++] = a;
+    (*list)[(*n)++] = b;
+}
+
+/*
+
+=item C<static int * ssa_group(const int *pairs, int n, int keys, int **first)>
+
+Groups the second elements of the C<n> ints of C<pairs> by their first
+element, which is below C<keys>.  Returns them in a new array, where
+the ones for key C<k> are from C<(*first)[k]> up to C<(*first)[k + 1]>.
+
+=cut
+
+*/
+
+PARROT_MALLOC
+PARROT_CANNOT_RETURN_NULL
+static int *
+ssa_group(ARGIN_NULLOK(const int *pairs), int n, int keys, ARGOUT(int **first))
+{
+    ASSERT_ARGS(ssa_group)
+    int * const f    = mem_allocate_n_zeroed_typed(keys + 1, int);
+    int * const list = mem_allocate_n_typed(n / 2 + 1, int);
+    int         i;
+
+    for (i = 0; i < n; i += 2)
+        f[pairs[i] + 1]++;
+
+    for (i = 0; i < keys; i++)
+        f[i + 1] += f[i];
+
+    for (i = 0; i < n; i += 2)
+        list[f[pairs[i]]++] = pairs[i + 1];
+
+    for (i = keys; i > 0; i--)
+        f[i] = f[i - 1];
+
+    f[0]   = 0;
+    *first = f;
+
+    return list;
+}
+
+/*
+
+=item C<static void ssa_free(ssa_t *ssa)>
+
+Frees everything C<ssa_optimize()> allocated.
+
+=cut
+
+*/
+
+static void
+ssa_free(ARGMOD(ssa_t *ssa))
+{
+    ASSERT_ARGS(ssa_free)
+
+    mem_sys_free(ssa->vars);
+    mem_sys_free(ssa->var_hash);
+    mem_sys_free(ssa->values);
+    mem_sys_free(ssa->phi_first);
+    mem_sys_free(ssa->phis);
+    mem_sys_free(ssa->phi_args);
+    mem_sys_free(ssa->reentry_first);
+    mem_sys_free(ssa->reentries);
+    mem_sys_free(ssa->undo);
+    mem_sys_free(ssa->exprs);
+    mem_sys_free(ssa->expr_hash);
+    mem_sys_free(ssa->child);
+    mem_sys_free(ssa->sibling);
+    mem_sys_free(ssa->reached);
+    mem_sys_free(ssa->handler);
+    mem_sys_free(ssa->in_handler);
+}
+
+/* the superinstructions from src/ops/ops.super */
+typedef struct super_op_t {
+    int super;                              /* the superinstruction */
+    int ops[PARROT_SUPER_OPS_MAX_LEN + 1];  /* the ops it replaces, then -1 */
+} super_op_t;
+
+static const super_op_t super_ops[] = { PARROT_SUPER_OPS };
+
+/*
+
+=item C<static int superinstructions(PARROT_INTERP, IMC_Unit *unit)>
+
+Replaces each run of ops in the table generated from F<src/ops/ops.super>
+with its superinstruction.  Labels and other directives between the ops
+stop the match, so nothing ever branches into the middle of one.
+
+Returns TRUE if any optimizations were performed. Otherwise, returns
+FALSE.
+
+=cut
+
+*/
+
+static int
+superinstructions(PARROT_INTERP, ARGMOD(IMC_Unit *unit))
+{
+    ASSERT_ARGS(superinstructions)
+    Instruction *ins;
+    int changed = 0;
+
+    IMCC_info(interp, 2, "\tsuperinstructions\n");
+    for (ins = unit->instructions; ins; ins = ins->next) {
+        const super_op_t *s;
+
+        if (ins->opnum < 0)
+            continue;
+
+        for (s = super_ops; s->super >= 0; s++) {
+            Instruction *tmp = ins;
+            int          n;
+
+            if (s->ops[0] != ins->opnum)
+                continue;
+
+            for (n = 1; s->ops[n] >= 0; n++) {
+                tmp = tmp->next;
+                if (!tmp || tmp->opnum != s->ops[n])
+                    break;
+            }
+
+            if (s->ops[n] < 0) {
+                ins = fuse_ins(interp, unit, ins, n, s->super);
+                unit->ostat.deleted_ins += n - 1;
+                changed = 1;
+                break;
+            }
+        }
+    }
+    return changed;
+}
+
+/*
+
+=item C<static Instruction * fuse_ins(PARROT_INTERP, IMC_Unit *unit, Instruction
+*ins, int n, int op)>
+
+Replaces C<ins> and the C<n - 1> instructions after it with one
+instruction of op number C<op>, whose arguments are theirs in order.
+Returns the new instruction.
+
+=cut
+
+*/
+
+PARROT_CANNOT_RETURN_NULL
+static Instruction *
+fuse_ins(PARROT_INTERP, ARGMOD(IMC_Unit *unit), ARGMOD(Instruction *ins),
+        int n, int op)
+{
+    ASSERT_ARGS(fuse_ins)
+    op_info_t * const op_info = &interp->op_info_table[op];
+    SymReg      *regs[IMCC_MAX_FIX_REGS];
+    char         format[128];
+    Instruction *tmp, *fused;
+    int          i, j, nargs = 0, keys = 0;
+
+    *format = '\0';
+
+    for (tmp = ins, i = 0; i < n; tmp = tmp->next, i++) {
+        if (*format)
+            strcat(format, ", ");
+        strcat(format, tmp->format);
+
+        for (j = 0; j < tmp->symreg_count; j++)
+            regs[nargs + j] = tmp->symregs[j];
+
+        keys  |= tmp->keys << nargs;
+        nargs += tmp->symreg_count;
+    }
+
+    /* INS() finds the op by name and sets up flags and branch bits */
+    fused       = INS(interp, unit, op_info->name, format, regs, nargs, keys, 0);
+    PARROT_ASSERT(fused && fused->opnum == op);
+    fused->line = ins->line;
+
+    IMCC_debug(interp, DEBUG_OPT1, "superinstruction %s at line %d\n",
+            op_info->full_name, ins->line);
+
+    subst_ins(unit, ins, fused, 1);
+    for (tmp = fused->next, i = 1; i < n; i++)
+        tmp = delete_ins(unit, tmp);
+
+    return fused;
+}
+
+/*
+
 =back
 
 =cut
@@ -322,6 +322,7 @@ imc_reg_alloc(PARROT_INTERP, ARGIN_NULLOK(IMC_Unit *unit))
 {
     ASSERT_ARGS(imc_reg_alloc)
     const char *function;
+    int         first = 1;
 
     if (!unit)
         return;
@@ -354,7 +355,9 @@ imc_reg_alloc(PARROT_INTERP, ARGIN_NULLOK(IMC_Unit *unit))
     IMCC_debug(interp, DEBUG_IMC, "processing sub %s\n", function);
     IMCC_debug(interp, DEBUG_IMC, "------------------------\n\n");
 
-    if (IMCC_INFO(interp)->optimizer_level == OPT_PRE && unit->pasm_file) {
+    /* the SSA optimizations of -O3 leave PASM's fixed registers alone */
+    if ((IMCC_INFO(interp)->optimizer_level & ~OPT_SSA) == OPT_PRE
+    &&  unit->pasm_file) {
         while (pre_optimize(interp, unit))
             ;
         goto done;
@@ -365,7 +368,6 @@ imc_reg_alloc(PARROT_INTERP, ARGIN_NULLOK(IMC_Unit *unit))
 
     /* build CFG and life info, and optimize iteratively */
     do {
-        int first = 1;
         do {
             while (pre_optimize(interp, unit)) { };
 
@@ -407,6 +409,9 @@ imc_reg_alloc(PARROT_INTERP, ARGIN_NULLOK(IMC_Unit *unit))
         dump_instructions(interp, unit);
 
   done:
+    /* superinstructions only once all registers have their colors */
+    post_optimize(interp, unit);
+
     if (IMCC_INFO(interp)->verbose  || (IMCC_INFO(interp)->debug & DEBUG_IMC))
         print_stat(interp, unit);
     else
@@ -582,6 +587,10 @@ print_stat(PARROT_INTERP, ARGMOD(IMC_Unit *unit))
               unit->ostat.used_once);
     IMCC_info(interp, 1, "\t%d invariants_moved\n",
               unit->ostat.invariants_moved);
+    IMCC_info(interp, 1, "\t%d values numbered, %d copies and %d constants "
+              "propagated, %d unboxed\n",
+              unit->ostat.values_numbered, unit->ostat.copies_propagated,
+              unit->ostat.constants_propagated, unit->ostat.unboxed);
     IMCC_info(interp, 1, "\tregisters needed:\t I%d, N%d, S%d, P%d\n",
             sets[0], sets[1], sets[2], sets[3]);
     IMCC_info(interp, 1,
@@ -308,7 +308,7 @@ set_union(ARGIN(const Set *s1), ARGIN(const Set *s2))
     if (s1->length != s2->length)
         fatal(1, "set_union", "Sets don't have the same length\n");
 
-    for (i = 0; i < BYTE_IN_SET(s1->length); i++) {
+    for (i = 0; i < NUM_BYTES(s1->length); i++) {
         s->bmp[i] = s1->bmp[i] | s2->bmp[i];
     }
 
@@ -341,7 +341,7 @@ set_intersec(ARGIN(const Set *s1), ARGIN(const Set *s2))
     if (s1->length != s2->length)
         fatal(1, "set_intersec", "Sets don't have the same length\n");
 
-    for (i = 0; i < BYTE_IN_SET(s1->length); i++) {
+    for (i = 0; i < NUM_BYTES(s1->length); i++) {
         s->bmp[i] = s1->bmp[i] & s2->bmp[i];
     }
 
@@ -369,7 +369,7 @@ set_intersec_inplace(ARGMOD(Set *s1), ARGIN(const Set *s2))
     if (s1->length != s2->length)
         fatal(1, "set_intersec_inplace", "Sets don't have the same length\n");
 
-    for (i = 0; i < BYTE_IN_SET(s1->length); i++) {
+    for (i = 0; i < NUM_BYTES(s1->length); i++) {
         s1->bmp[i] &= s2->bmp[i];
     }
 }
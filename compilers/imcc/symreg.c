@@ -682,7 +682,7 @@ mk_ident_ur(PARROT_INTERP, ARGIN(const char *name), int t)
 {
     ASSERT_ARGS(mk_ident_ur)
     SymReg * const r = mk_ident(interp, name, t);
-    r->usage        |= U_NON_VOLATILE;
+    r->usage        |= U_NON_VOLATILE | U_UNIQUE_REG;
 
     return r;
 }
@@ -56,7 +56,8 @@ enum USAGE {
     U_LEXICAL       = 1 << 4,       /* symbol is lexical */
     U_FIXUP         = 1 << 5,       /* maybe not global, force fixup */
     U_NON_VOLATILE  = 1 << 6,       /* needs preserving */
-    U_SUBID_LOOKUP  = 1 << 7        /* .const 'Sub' lookup is done by subid */
+    U_SUBID_LOOKUP  = 1 << 7,       /* .const 'Sub' lookup is done by subid */
+    U_UNIQUE_REG    = 1 << 8        /* declared :unique_reg */
 };
 
 typedef struct _SymReg {
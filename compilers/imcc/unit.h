@@ -30,6 +30,10 @@ struct imcc_ostat {
     int invariants_moved;
     int deleted_ins;
     int used_once;
+    int values_numbered;
+    int copies_propagated;
+    int constants_propagated;
+    int unboxed;
 } ;
 
 struct IMC_Unit {
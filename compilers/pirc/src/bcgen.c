@@ -718,7 +718,7 @@ store_key_bytecode(ARGIN(bytecode * const bc), ARGIN(opcode_t * key))
     const opcode_t      *rc;
     int                  index;
 
-    pfc   = mem_allocate_typed(PackFile_Constant);
+    pfc   = mem_allocate_zeroed_typed(PackFile_Constant);
     rc    = PackFile_Constant_unpack_key(bc->interp, bc->interp->code->const_table, pfc, key);
 
     if (!rc) {
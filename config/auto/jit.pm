@@ -7,10 +7,12 @@ config/auto/jit - JIT Capability
 
 =head1 DESCRIPTION
 
-Determines whether there is JIT capability available.  Use the
-C<--jitcapable> and C<--execcapable> options to override the default
-value calculated specifically for your CPU architecture and operating
-system.
+Determines whether there is JIT capability available, which is whether
+the exec runcore can generate native code.  It can for x86-64 on systems
+using the System V calling convention, with 8 byte INTVALs, FLOATVALs and
+opcodes.  Use the C<--jitcapable> and C<--execcapable> options to override
+the default value calculated specifically for your CPU architecture and
+operating system.
 
 Code formerly found in this step class used to determine characteristics
 of the CPU has been moved into the preceding step class, auto::arch.
@@ -38,12 +40,19 @@ sub runstep {
     my $osname  = $conf->data->get('osname');
     my $cpuarch = $conf->data->get('cpuarch');
 
+    # The exec core generates x86-64 code for the System V calling
+    # convention, which needs 8 byte INTVALs, FLOATVALs and opcodes.
+    my $jitcapable = $conf->options->get('jitcapable');
+    $jitcapable = _native_exec_core_buildable($conf, $cpuarch, $osname)
+        unless defined $jitcapable;
+    $jitcapable = $jitcapable ? 1 : 0;
+
     $conf->data->set(
-        jitarchname    => 'nojit',
+        jitarchname    => $jitcapable ? "$cpuarch-$osname" : 'nojit',
         jitcpuarch     => $cpuarch,
         jitcpu         => $cpuarch,
         jitosname      => $osname,
-        jitcapable     => 0,
+        jitcapable     => $jitcapable,
         execcapable    => 0,
         cc_hasjit      => '',
         TEMP_jit_o     => '',
@@ -52,7 +61,21 @@ sub runstep {
         TEMP_exec_dep  => '',
         asmfun_o       => '',
     );
-    $self->set_result('no');
+    $self->set_result($jitcapable ? 'yes' : 'no');
+    return 1;
+}
+
+sub _native_exec_core_buildable {
+    my ($conf, $cpuarch, $osname) = @_;
+
+    return 0 unless $cpuarch eq 'amd64';
+    return 0 if $osname =~ /^(MSWin32|cygwin)$/;
+
+    foreach my $size (qw( intvalsize nvsize opcode_t_size ptrsize )) {
+        my $value = $conf->data->get($size);
+        return 0 unless defined $value && $value == 8;
+    }
+
     return 1;
 }
 
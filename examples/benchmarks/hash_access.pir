@@ -0,0 +1,203 @@
+# Copyright (C) 2009, Parrot Foundation.
+# $Id$
+
+=head1 NAME
+
+examples/benchmarks/hash_access.pir - benchmark Hash inserts and lookups
+
+=head1 SYNOPSIS
+
+    ./parrot examples/benchmarks/hash_access.pir [keys [rounds [prefix [encoding]]]]
+
+=head1 DESCRIPTION
+
+Inserts C<keys> string keys (default 100000) into a C<Hash>, then looks
+each of them up C<rounds> times (default 10), looks up as many keys which
+aren't there, deletes every other key and inserts them again. Prints the
+time taken and the operations per second of each phase.
+
+Keys are a number after a prefix of C<prefix> characters (default 3), so
+long keys time the string hash rather than the table.  With C<encoding>,
+the keys are transcoded to it first.
+
+Unless the C<PARROT_HASH_INDEX> environment variable picks the bucket index
+of the hash, the benchmark runs once with the chained index and once with
+the open addressing one, each in a new parrot, so that their times can be
+compared.
+
+=cut
+
+.include 'iglobals.pasm'
+
+.sub 'main' :main
+    .param pmc argv
+
+    .local pmc env
+    env = new ['Env']
+    $S0 = env['PARROT_HASH_INDEX']
+    if $S0 == '' goto compare
+    print 'PARROT_HASH_INDEX='
+    say $S0
+    'run'(argv)
+    .return ()
+
+  compare:
+    .local pmc interp
+    .local string cmd
+    interp = getinterp
+    $P0    = interp[.IGLOBALS_EXECUTABLE]
+    cmd    = $P0
+    $I0    = 0
+    $I1    = elements argv
+  add_arg:
+    cmd .= ' '
+    $S0  = argv[$I0]
+    cmd .= $S0
+    inc $I0
+    if $I0 < $I1 goto add_arg
+
+    env['PARROT_HASH_INDEX'] = 'chained'
+    spawnw $I0, cmd
+    env['PARROT_HASH_INDEX'] = 'open'
+    spawnw $I0, cmd
+.end
+
+.sub 'run'
+    .param pmc argv
+
+    .local int n_keys, rounds, prefix_len
+    .local string encoding
+    n_keys     = 100000
+    rounds     = 10
+    prefix_len = 3
+    encoding   = ''
+
+    $I0 = elements argv
+    if $I0 < 2 goto args_done
+    $S0    = argv[1]
+    n_keys = $S0
+    if $I0 < 3 goto args_done
+    $S0    = argv[2]
+    rounds = $S0
+    if $I0 < 4 goto args_done
+    $S0        = argv[3]
+    prefix_len = $S0
+    if $I0 < 5 goto args_done
+    encoding   = argv[4]
+  args_done:
+
+    # make the keys up front, so that only the hash is timed
+    .local pmc keys, missing
+    .local string prefix
+    .local int enc
+    keys    = new ['ResizableStringArray']
+    missing = new ['ResizableStringArray']
+    prefix  = repeat 'k', prefix_len
+    enc     = -1
+    if encoding == '' goto prefix_done
+    enc     = find_encoding encoding
+  prefix_done:
+    $I0 = 0
+  make_keys:
+    $S0 = $I0
+    $S1 = concat prefix, $S0
+    $S2 = concat 'no', $S1
+    if enc < 0 goto push_keys
+    $S1 = trans_encoding $S1, enc
+    $S2 = trans_encoding $S2, enc
+  push_keys:
+    push keys, $S1
+    push missing, $S2
+    inc $I0
+    if $I0 < n_keys goto make_keys
+
+    .local pmc h
+    .local num start
+    .local int i, r
+    h = new ['Hash']
+
+    start = time
+    i = 0
+  insert:
+    $S0 = keys[i]
+    h[$S0] = i
+    inc i
+    if i < n_keys goto insert
+    report('insert', start, n_keys)
+
+    start = time
+    r = 0
+  hit_round:
+    i = 0
+  hit:
+    $S0 = keys[i]
+    $I0 = h[$S0]
+    inc i
+    if i < n_keys goto hit
+    inc r
+    if r < rounds goto hit_round
+    $I0 = n_keys * rounds
+    report('lookup hit', start, $I0)
+
+    start = time
+    r = 0
+  miss_round:
+    i = 0
+  miss:
+    $S0 = missing[i]
+    $I0 = exists h[$S0]
+    inc i
+    if i < n_keys goto miss
+    inc r
+    if r < rounds goto miss_round
+    $I0 = n_keys * rounds
+    report('lookup miss', start, $I0)
+
+    start = time
+    i = 0
+  delete:
+    $S0 = keys[i]
+    delete h[$S0]
+    i += 2
+    if i < n_keys goto delete
+    i = 0
+  reinsert:
+    $S0 = keys[i]
+    h[$S0] = i
+    i += 2
+    if i < n_keys goto reinsert
+    report('delete+insert', start, n_keys)
+
+    $I0 = elements h
+    if $I0 == n_keys goto done
+    print 'lost keys: '
+    say $I0
+  done:
+.end
+
+.sub 'report'
+    .param string phase
+    .param num start
+    .param int ops
+
+    .local num span
+    span = time
+    span -= start
+
+    $P0 = new ['ResizablePMCArray']
+    push $P0, phase
+    push $P0, span
+    $N0 = ops
+    if span <= 0.0 goto rate
+    $N0 /= span
+  rate:
+    push $P0, $N0
+    $S0 = sprintf "%-14s %8.3fs %12.0f ops/s\n", $P0
+    print $S0
+.end
+
+# Local Variables:
+#   mode: pir
+#   fill-column: 100
+# End:
+# vim: expandtab shiftwidth=4 ft=pir:
@@ -0,0 +1,168 @@
+# Copyright (C) 2009, Parrot Foundation.
+# $Id$
+
+=head1 NAME
+
+examples/benchmarks/safepoints.pir - Loop throughput and timer latency
+
+=head1 SYNOPSIS
+
+    % time ./parrot examples/benchmarks/safepoints.pir [iterations]
+
+=head1 DESCRIPTION
+
+Runs a loop of integer ops and sub calls twice: once alone, and once while a
+Timer fires 10000 times a second.  The interpreter only looks at pending
+events at safepoints -- backward branches and sub calls -- so the first run
+shows what the checks cost a tight loop, and the second how late the timer
+handler runs and how much the handling slows the loop down.
+
+The latency is the time between two runs of the handler beyond the timer's
+interval, as the next round of a repeating timer is scheduled when the
+handler runs.
+
+=cut
+
+.include 'timer.pasm'
+
+.const num INTERVAL = 0.0001
+
+.sub main :main
+    .param pmc argv
+    .local int n
+    .local num plain, timed
+
+    n = 10000000
+    $I0 = elements argv
+    if $I0 < 2 goto run
+    $S0 = argv[1]
+    n   = $S0
+
+  run:
+    plain = run_loop(n)
+    print 'loop alone:       '
+    report_rate(n, plain)
+
+    $P0 = new ['Integer']
+    set_global 'fired', $P0
+    $P0 = new ['Float']
+    set_global 'max_delay', $P0
+    $N0 = time
+    $P0 = new ['Float']
+    $P0 = $N0
+    set_global 'last', $P0
+
+    .local pmc timer
+    timer = new ['Timer']
+    $P0 = get_global 'tick'
+    timer[.PARROT_TIMER_HANDLER]  = $P0
+    timer[.PARROT_TIMER_NSEC]     = INTERVAL
+    timer[.PARROT_TIMER_INTERVAL] = INTERVAL
+    timer[.PARROT_TIMER_REPEAT]   = -1
+    timer[.PARROT_TIMER_RUNNING]  = 1
+
+    timed = run_loop(n)
+    timer[.PARROT_TIMER_RUNNING]  = 0
+
+    print 'loop with timers: '
+    report_rate(n, timed)
+
+    .local int fired
+    $P0   = get_global 'fired'
+    fired = $P0
+    print 'timer events:     '
+    print fired
+    print ' ('
+    $N0 = fired / timed
+    $I0 = $N0
+    print $I0
+    print "/s)\n"
+    if fired == 0 goto done
+
+    print 'mean latency:     '
+    $N0 = timed / fired
+    $N0 -= INTERVAL
+    report_usec($N0)
+    print 'max latency:      '
+    $P0 = get_global 'max_delay'
+    $N0 = $P0
+    report_usec($N0)
+  done:
+.end
+
+.sub run_loop
+    .param int n
+    .local int i, sum
+    .local num start
+
+    start = time
+    i     = 0
+    sum   = 0
+  loop:
+    sum  += i
+    $I0   = i % 7
+    sum  -= $I0
+    $I1   = i % 1000
+    if $I1 goto next
+    sum   = twice(sum)
+  next:
+    inc i
+    if i < n goto loop
+
+    $N0 = time
+    $N0 -= start
+    .return ($N0)
+.end
+
+.sub twice
+    .param int x
+    x += x
+    .return (x)
+.end
+
+.sub tick
+    .local pmc fired, last, max_delay
+    fired     = get_global 'fired'
+    last      = get_global 'last'
+    max_delay = get_global 'max_delay'
+    inc fired
+
+    $N0 = time
+    $N1 = last
+    last = $N0
+    $N0 -= $N1
+    $N0 -= INTERVAL
+    $N1 = max_delay
+    if $N0 <= $N1 goto done
+    max_delay = $N0
+  done:
+.end
+
+.sub report_rate
+    .param int n
+    .param num secs
+    $N0 = n / secs
+    $N0 /= 1000000
+    $P0 = new ['FixedFloatArray']
+    $P0 = 2
+    $P0[0] = secs
+    $P0[1] = $N0
+    $S0 = sprintf "%.3fs, %.1fM iterations/s\n", $P0
+    print $S0
+.end
+
+.sub report_usec
+    .param num secs
+    $N0 = secs * 1000000
+    $P0 = new ['FixedFloatArray']
+    $P0 = 1
+    $P0[0] = $N0
+    $S0 = sprintf "%.1f us\n", $P0
+    print $S0
+.end
+
+# Local Variables:
+#   mode: pir
+#   fill-column: 100
+# End:
+# vim: expandtab shiftwidth=4 ft=pir:
@@ -0,0 +1,151 @@
+# Copyright (C) 2009, Parrot Foundation.
+# $Id$
+
+=head1 NAME
+
+examples/benchmarks/string_ops.pir - benchmark common string operations
+
+=head1 SYNOPSIS
+
+    ./parrot examples/benchmarks/string_ops.pir [length [rounds]]
+
+=head1 DESCRIPTION
+
+Hashes, compares, searches and upcases strings of C<length> characters
+(default 1000), C<rounds> times each (default 20000).  Each operation is
+timed on an ASCII string, on the same text in UTF-8, and on a UTF-8 string
+with a non-ASCII character in every ten (upcased only if Parrot has ICU),
+and the time taken and the operations per second are printed.
+
+=cut
+
+.include 'iglobals.pasm'
+
+.sub 'main' :main
+    .param pmc argv
+
+    .local int length, rounds
+    length = 1000
+    rounds = 20000
+
+    $I0 = elements argv
+    if $I0 < 2 goto args_done
+    $S0    = argv[1]
+    length = $S0
+    if $I0 < 3 goto args_done
+    $S0    = argv[2]
+    rounds = $S0
+  args_done:
+
+    .local int utf8, reps
+    utf8 = find_encoding 'utf8'
+    reps = length / 10
+
+    .local string ascii, ascii_copy
+    ascii      = repeat 'abcdefghij', reps
+    ascii_copy = repeat 'abcdefghij', reps
+    'bench'('ascii', ascii, ascii_copy, rounds, 1)
+
+    $S0 = trans_encoding ascii, utf8
+    $S1 = trans_encoding ascii_copy, utf8
+    'bench'('utf8 ascii', $S0, $S1, rounds, 1)
+
+    $S2 = unicode:"abcdefghi\xe9"
+    $S0 = repeat $S2, reps
+    $S1 = repeat $S2, reps
+
+    # upcasing non-ASCII characters needs ICU
+    $P0 = getinterp
+    $P0 = $P0[.IGLOBALS_CONFIG_HASH]
+    $I0 = $P0['has_icu']
+    'bench'('utf8 latin', $S0, $S1, rounds, $I0)
+.end
+
+.sub 'bench'
+    .param string kind
+    .param string s
+    .param string copy
+    .param int rounds
+    .param int caseable
+
+    .local num start
+    .local int i, len
+    len = length s
+
+    # fresh headers, so that the hash value isn't cached
+    .local pmc h
+    h = new ['Hash']
+    h['x'] = 1
+    start = time
+    i = 0
+  hash:
+    $S0 = substr s, 0, len
+    $I0 = exists h[$S0]
+    inc i
+    if i < rounds goto hash
+    report(kind, 'hash', start, rounds)
+
+    start = time
+    i = 0
+  equal:
+    $I0 = iseq s, copy
+    inc i
+    if i < rounds goto equal
+    report(kind, 'equal', start, rounds)
+
+    start = time
+    i = 0
+  compare:
+    $I0 = cmp s, copy
+    inc i
+    if i < rounds goto compare
+    report(kind, 'compare', start, rounds)
+
+    # not there, so that the whole string is searched
+    start = time
+    i = 0
+  search:
+    $I0 = index s, 'jihg'
+    inc i
+    if i < rounds goto search
+    report(kind, 'index', start, rounds)
+
+    unless caseable goto done
+    start = time
+    i = 0
+  upcase:
+    $S0 = upcase s
+    inc i
+    if i < rounds goto upcase
+    report(kind, 'upcase', start, rounds)
+  done:
+.end
+
+.sub 'report'
+    .param string kind
+    .param string op
+    .param num start
+    .param int ops
+
+    .local num span
+    span = time
+    span -= start
+
+    $P0 = new 'ResizablePMCArray'
+    push $P0, kind
+    push $P0, op
+    push $P0, span
+    $N0 = ops
+    if span <= 0.0 goto rate
+    $N0 /= span
+  rate:
+    push $P0, $N0
+    $S0 = sprintf "%-10s %-8s %8.3fs %12.0f ops/s\n", $P0
+    print $S0
+.end
+
+# Local Variables:
+#   mode: pir
+#   fill-column: 100
+# End:
+# vim: expandtab shiftwidth=4 ft=pir:
@@ -27,6 +27,24 @@ typedef struct _meth_cache_entry {
     struct _meth_cache_entry *next;
 } Meth_cache_entry;
 
+/*
+ * cache of a callmethod, getattribute or setattribute op, see
+ * Parrot_find_method_at_call_site and Parrot_get_attr_at_call_site
+ */
+#define CALL_SITE_CACHE_SIZE 4
+
+typedef struct _call_site_cache {
+    size_t   offset;            /* op offset of the call site in the code */
+    UINTVAL  epoch;             /* class epoch the entries are valid in */
+    STRING  *name;              /* the constant method or attribute name */
+    UINTVAL  used;              /* entries in use */
+    struct {
+        const void *type;       /* the class of objects, else the vtable */
+        PMC        *method;     /* the method sub pmc */
+        INTVAL      slot;       /* or the index in the attribute store */
+    } entries[CALL_SITE_CACHE_SIZE];
+} Call_site_cache;
+
 /*
  * method cache, continuation freelist, stack chunk freelist, regsave cache
  */
@@ -34,6 +52,7 @@ typedef struct _Caches {
     UINTVAL mc_size;            /* sizeof table */
     Meth_cache_entry ***idx;    /* bufstart idx */
     /* PMC **hash */            /* for non-constant keys */
+    UINTVAL epoch;              /* class epoch, bumped when methods change */
 } Caches;
 
 #endif   /* PARROT_CACHES_H_GUARD */
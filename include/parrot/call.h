@@ -700,7 +700,7 @@ void runops(PARROT_INTERP, size_t offs)
             *(pc) == PARROT_OP_get_results_pc || \
             *(pc) == PARROT_OP_get_params_pc || \
             *(pc) == PARROT_OP_set_returns_pc) { \
-        PMC * const sig = (seg)->const_table->constants[(pc)[1]]->u.key; \
+        PMC * const sig = PF_CONST_PMC((interp), (seg)->const_table->constants[(pc)[1]]); \
         (n) += VTABLE_elements((interp), sig); \
     } \
 } while (0)
@@ -1105,6 +1105,9 @@ PMC * Parrot_push_context(PARROT_INTERP, ARGIN(const INTVAL *n_regs_used))
 void create_initial_context(PARROT_INTERP)
         __attribute__nonnull__(1);
 
+void destroy_context(PARROT_INTERP)
+        __attribute__nonnull__(1);
+
 PARROT_CANNOT_RETURN_NULL
 PARROT_WARN_UNUSED_RESULT
 PMC * Parrot_alloc_context(PARROT_INTERP,
@@ -1113,10 +1116,20 @@ PMC * Parrot_alloc_context(PARROT_INTERP,
         __attribute__nonnull__(1)
         __attribute__nonnull__(2);
 
+void Parrot_free_context(PARROT_INTERP, ARGMOD(Parrot_Context *ctx))
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2)
+        FUNC_MODIFIES(*ctx);
+
 size_t Parrot_pcc_calculate_context_size(SHIM_INTERP,
     ARGIN(const UINTVAL *number_regs_used))
         __attribute__nonnull__(2);
 
+void Parrot_release_context(PARROT_INTERP, ARGMOD(PMC *pmcctx))
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2)
+        FUNC_MODIFIES(*pmcctx);
+
 PARROT_CANNOT_RETURN_NULL
 PARROT_WARN_UNUSED_RESULT
 PMC * Parrot_set_new_context(PARROT_INTERP,
@@ -1315,12 +1328,20 @@ PMC * Parrot_set_new_context(PARROT_INTERP,
     , PARROT_ASSERT_ARG(n_regs_used))
 #define ASSERT_ARGS_create_initial_context __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
        PARROT_ASSERT_ARG(interp))
+#define ASSERT_ARGS_destroy_context __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp))
 #define ASSERT_ARGS_Parrot_alloc_context __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
        PARROT_ASSERT_ARG(interp) \
     , PARROT_ASSERT_ARG(number_regs_used))
+#define ASSERT_ARGS_Parrot_free_context __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp) \
+    , PARROT_ASSERT_ARG(ctx))
 #define ASSERT_ARGS_Parrot_pcc_calculate_context_size \
      __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
        PARROT_ASSERT_ARG(number_regs_used))
+#define ASSERT_ARGS_Parrot_release_context __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp) \
+    , PARROT_ASSERT_ARG(pmcctx))
 #define ASSERT_ARGS_Parrot_set_new_context __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
        PARROT_ASSERT_ARG(interp) \
     , PARROT_ASSERT_ARG(number_regs_used))
@@ -223,6 +223,14 @@ void Parrot_str_internal_register_encoding_names(PARROT_INTERP)
 #define ENCODING_FIND_CCLASS(i, src, typetable, flags, pos, end) \
     ((src)->encoding)->find_cclass((i), (src), (typetable), (flags), (pos), (end))
 
+/* Each character is the single byte holding its codepoint: fixed_8 strings
+ * and UTF-8 strings of ASCII characters only.  Such strings can be hashed,
+ * compared and searched byte by byte. */
+#define STRING_IS_SINGLE_BYTE(src) \
+    ((src)->encoding == Parrot_fixed_8_encoding_ptr \
+    || ((src)->encoding == Parrot_utf8_encoding_ptr \
+        && (src)->bufused == (src)->strlen))
+
 #endif /* PARROT_ENCODING_H_GUARD */
 
 /*
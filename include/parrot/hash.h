@@ -40,8 +40,8 @@ typedef UINTVAL BucketIndex;
 #define INITBucketIndex ((BucketIndex)-2)
 
 #define N_BUCKETS(n) ((n) - (n)/4)
-#define HASH_ALLOC_SIZE(n) (N_BUCKETS(n) * sizeof (HashBucket) + \
-                                     (n) * sizeof (HashBucket *))
+#define HASH_ALLOC_SIZE(n, slot_size) (N_BUCKETS(n) * sizeof (HashBucket) + \
+                                     (n) * (slot_size))
 
 typedef int (*hash_comp_fn)(PARROT_INTERP, const void *const, const void *const);
 typedef void (*hash_mark_key_fn)(PARROT_INTERP, PObj *);
@@ -57,17 +57,45 @@ typedef enum {
 } Hash_key_type;
 /* &end_gen */
 
+/* The bucket index of new hashes, chosen with PARROT_HASH_INDEX */
+typedef enum {
+    Hash_index_chained,         /* chains of buckets, the default */
+    Hash_index_open             /* open addressing, Robin Hood order */
+} Hash_index_type;
+
 typedef struct _hashbucket {
-    struct _hashbucket *next;
+    struct _hashbucket *next;   /* next bucket in the chain or free list;
+                                   NULL in use with an open index */
     void *key;
     void *value;
 } HashBucket;
 
+/* A slot of the open addressing index. Keeping the hash value next to the
+ * bucket offset lets a probe skip other keys without touching their bucket */
+typedef struct _hashindex {
+    Parrot_UInt4 hashval;       /* mixed hash value of the key */
+    Parrot_UInt4 bucket;        /* offset of the bucket in bs plus 1, 0 if
+                                   free, HASH_SLOT_DELETED if deleted */
+} HashIndex;
+
+#define HASH_SLOT_DELETED ((Parrot_UInt4)-1)
+#define HASH_SLOT_USED(s) ((s)->bucket && (s)->bucket != HASH_SLOT_DELETED)
+
+/* The first bucket at position i of the index. The buckets after it are
+ * linked by next, so a walk over the index works for both kinds: an open
+ * addressing slot holds at most one bucket. */
+#define HASH_INDEX_BUCKET(h, i) ((h)->slots \
+    ? (HASH_SLOT_USED((h)->slots + (i)) \
+        ? (h)->bs + (h)->slots[(i)].bucket - 1 : NULL) \
+    : (h)->bi[(i)])
+
 struct _hash {
     HashBucket *bs;             /* store of buckets */
-    HashBucket **bi;            /* list of Bucket pointers */
+    HashBucket **bi;            /* list of Bucket pointers, if chained */
+    HashIndex  *slots;          /* open addressing index, if not chained */
     HashBucket *free_list;      /* empty buckets */
     UINTVAL entries;            /* Number of values stored in hashtable */
+    UINTVAL deleted;            /* deleted slots in the open index */
     UINTVAL mask;               /* alloced - 1 */
     PMC *container;             /* e.g. the PerlHash PMC */
     Hash_key_type key_type;     /* cstring, ascii-string, utf8-string */
@@ -151,17 +151,10 @@ struct _imc_info_t;
 
 struct _Thread_data;    /* in thread.h */
 struct _Caches;         /* caches .h */
-
-typedef struct _Prederef_branch {       /* item for recording branches */
-    size_t offs;                        /* offset in code */
-    void  *op;                          /* opcode at that position */
-} Prederef_branch;
+struct _utf8_index_cache; /* encoding/utf8.c */
 
 typedef struct _Prederef {
     void **code;                        /* prederefed code */
-    Prederef_branch *branches;          /* list of branches in code */
-    size_t n_branches;                  /* entries in that list */
-    size_t n_allocated;                 /* allocated size of it */
 } Prederef;
 
 /*
@@ -180,6 +173,7 @@ typedef struct _Prederef {
 
 typedef struct _context_mem {
     void **free_list;               /* array of free-lists, per size free slots */
+    int   *n_free;                  /* number of contexts on each free-list */
     int n_free_slots;               /* amount of allocated */
 } context_mem;
 
@@ -188,6 +182,7 @@ struct _handler_node_t; /* forward def - exit.h */
 /* The actual interpreter structure */
 struct parrot_interp_t {
     PMC           *ctx;                       /* current Context */
+    context_mem    ctx_mem;                   /* free lists of Context frames */
 
     struct Memory_Pools *mem_pools;                /* Pointer to this interpreter's
                                                * arena */
@@ -215,8 +210,9 @@ struct parrot_interp_t {
                                                 * the interpreter is currently
                                                 * running */
 
-    op_func_t *evc_func_table;                /* event check opcode dispatch */
-    op_func_t *save_func_table;               /* for restoring op_func_table */
+    volatile int safepoint_requested;         /* set async to have the ops
+                                               * handle pending tasks at the
+                                               * next safepoint */
 
     int         n_libs;                       /* count of libs below */
     op_lib_t  **all_op_libs;                  /* all loaded opcode libraries */
@@ -254,6 +250,8 @@ struct parrot_interp_t {
     INTVAL world_inited;                      /* world_init_once() is done */
 
     UINTVAL hash_seed;                        /* STRING hash seed */
+    INTVAL  hash_index_type;                  /* Hash_index_type of new
+                                               * hashes */
 
     PMC *iglobals;                      /* FixedPMCArray of PMCs, containing: */
     /* 0:   PMC *Parrot_base_classname_hash; hash containing name->base_type */
@@ -280,6 +278,7 @@ struct parrot_interp_t {
 
     STRING     **const_cstring_table;         /* CONST_STRING(x) items */
     Hash        *const_cstring_hash;          /* cache of const_string items */
+    struct _utf8_index_cache *utf8_index_cache; /* see encoding/utf8.c */
 
     struct QUEUE* task_queue;                 /* per interpreter queue */
     struct _handler_node_t *exit_handler_list;/* exit.c */
@@ -584,8 +583,6 @@ PARROT_EXPORT void dynop_register(PARROT_INTERP, PMC *op_lib);
 /* interpreter.pmc */
 void clone_interpreter(Parrot_Interp dest, Parrot_Interp self, INTVAL flags);
 
-void Parrot_setup_event_func_ptrs(PARROT_INTERP);
-
 PARROT_EXPORT void disable_event_checking(PARROT_INTERP);
 PARROT_EXPORT void enable_event_checking(PARROT_INTERP);
 
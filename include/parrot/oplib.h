@@ -49,8 +49,8 @@ typedef enum {
     CORE_OPS_noop,              /* do nothing */
     CORE_OPS_cpu_ret,           /* __asm("ret") */
     CORE_OPS_check_events,      /* explicit event check */
-    CORE_OPS_check_events__,    /* inserted into op dispatch when an event
-                                   got scheduled */
+    CORE_OPS_check_events__,    /* handles the pending tasks, like a
+                                   safepoint */
     CORE_OPS_wrapper__,         /* inserted by dynop_register for new ops */
     CORE_OPS_prederef__         /* inserted by dynop_register for new ops */
         /* 2 more reserved */
@@ -19,6 +19,10 @@
 #define PF_NCONST(pf)  ((pf)->const_table->const_count)
 #define PF_CONST(pf, i) ((pf)->const_table->constants[(i)])
 
+/* The PMC of a PMC constant, which may not have been thawed yet */
+#define PF_CONST_PMC(interp, c) \
+    ((c)->frozen ? PackFile_Constant_thaw_pmc((interp), (c)) : (c)->u.key)
+
 #define DIRECTORY_SEGMENT_NAME   "DIRECTORY"
 #define FIXUP_TABLE_SEGMENT_NAME "FIXUP"
 #define CONSTANT_SEGMENT_NAME    "CONSTANT"
@@ -57,11 +61,13 @@
 **   parrot, pbc_merge, parrot_debugger use 0
 **   pbc_dump, pbc_disassemble use 1 to skip the version check
 **   pbc_dump -h requires 2
+**   Parrot_pbc_read() adds 32 when it can thaw PMC constants lazily
 **   The rest is for TRACE_PACKFILE debugging with switch -D in pbc_dump
 */
 #define PFOPT_NONE  0
 #define PFOPT_UTILS 1
 #define PFOPT_HEADERONLY 2
+#define PFOPT_LAZY  32
 #if TRACE_PACKFILE
 #  define PFOPT_DEBUG 4
 #  define PFOPT_ALIGN 8
@@ -138,6 +144,8 @@ typedef struct PackFile_Constant {
         STRING *string;
         PMC *key;
     } u;
+    const opcode_t *frozen;             /* image of a PMC not thawed yet */
+    struct PackFile_ConstTable *table;  /* ... and the table it's from */
 } PackFile_Constant;
 
 /*
@@ -231,6 +239,7 @@ typedef struct PackFile_FixupTable {
     opcode_t                     fixup_count;
     PackFile_FixupEntry        **fixups;
     PackFile_ByteCode           *code;   /* where this segment belongs to */
+    Hash                        *index;  /* name => first entry, built lazily */
 } PackFile_FixupTable;
 
 
@@ -269,6 +278,9 @@ struct PackFile_ByteCode {
     PackFile_ConstTable   *const_table;
     PackFile_FixupTable   *fixups;
     struct PackFile_Annotations *annotations;
+    struct _call_site_cache    **call_sites;    /* method caches of callmethod ops */
+    size_t                       call_site_mask; /* size of call_sites - 1 */
+    struct _exec_code           *exec_code;      /* native code of the exec core */
 };
 
 typedef struct PackFile_DebugFilenameMapping {
@@ -510,6 +522,14 @@ size_t PackFile_Constant_pack_size(PARROT_INTERP,
         __attribute__nonnull__(1)
         __attribute__nonnull__(2);
 
+PARROT_EXPORT
+PARROT_CANNOT_RETURN_NULL
+PMC * PackFile_Constant_thaw_pmc(PARROT_INTERP,
+    ARGMOD(PackFile_Constant *self))
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2)
+        FUNC_MODIFIES(*self);
+
 PARROT_EXPORT
 PARROT_WARN_UNUSED_RESULT
 PARROT_CAN_RETURN_NULL
@@ -854,6 +874,9 @@ void Parrot_trace_eprintf(ARGIN(const char *s), ...)
 #define ASSERT_ARGS_PackFile_Constant_pack_size __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
        PARROT_ASSERT_ARG(interp) \
     , PARROT_ASSERT_ARG(self))
+#define ASSERT_ARGS_PackFile_Constant_thaw_pmc __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp) \
+    , PARROT_ASSERT_ARG(self))
 #define ASSERT_ARGS_PackFile_Constant_unpack __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
        PARROT_ASSERT_ARG(interp) \
     , PARROT_ASSERT_ARG(constt) \
@@ -140,6 +140,9 @@ typedef enum PObj_enum {
     PObj_is_string_FLAG         = POBJ_FLAG(8),
     /* PObj is a PMC */
     PObj_is_PMC_FLAG            = POBJ_FLAG(9),
+    /* Private flag for the generational GC: the old PMC is in the
+     * remembered set */
+    b_PObj_GC_remembered_FLAG   = POBJ_FLAG(10),
     /* the PMC is a shared PMC */
     PObj_is_PMC_shared_FLAG     = POBJ_FLAG(11), /* Same as PObj_is_shared_FLAG */
     /* PObj is otherwise shared */
@@ -175,6 +178,9 @@ typedef enum PObj_enum {
     PObj_custom_destroy_FLAG    = POBJ_FLAG(22),
     /* For debugging, report when this buffer gets moved around */
     PObj_report_FLAG            = POBJ_FLAG(23),
+    /* Private flag for the generational GC: the PObj survived a collection
+     * and has been promoted out of the nursery */
+    b_PObj_GC_old_FLAG          = POBJ_FLAG(24),
 
 /* PMC specific FLAGs */
     /* call object finalizer */
@@ -207,6 +213,8 @@ typedef enum PObj_enum {
 #  define PObj_live_FLAG              b_PObj_live_FLAG
 #  define PObj_on_free_list_FLAG      b_PObj_on_free_list_FLAG
 #  define PObj_is_special_PMC_FLAG    b_PObj_is_special_PMC_FLAG
+#  define PObj_GC_old_FLAG            b_PObj_GC_old_FLAG
+#  define PObj_GC_remembered_FLAG     b_PObj_GC_remembered_FLAG
 
 #  define gc_flag_TEST(flag, o)      PObj_flag_TEST(flag, o)
 #  define gc_flag_SET(flag, o)       PObj_flag_SET(flag, o)
@@ -253,6 +261,14 @@ typedef enum PObj_enum {
 #define PObj_live_SET(o) gc_flag_SET(live, o)
 #define PObj_live_CLEAR(o) gc_flag_CLEAR(live, o)
 
+#define PObj_GC_old_TEST(o) gc_flag_TEST(GC_old, o)
+#define PObj_GC_old_SET(o) gc_flag_SET(GC_old, o)
+#define PObj_GC_old_CLEAR(o) gc_flag_CLEAR(GC_old, o)
+
+#define PObj_GC_remembered_TEST(o) gc_flag_TEST(GC_remembered, o)
+#define PObj_GC_remembered_SET(o) gc_flag_SET(GC_remembered, o)
+#define PObj_GC_remembered_CLEAR(o) gc_flag_CLEAR(GC_remembered, o)
+
 #define PObj_is_string_TEST(o) PObj_flag_TEST(is_string, o)
 #define PObj_is_string_SET(o) PObj_flag_SET(is_string, o)
 #define PObj_is_string_CLEAR(o) PObj_flag_CLEAR(is_string, o)
@@ -100,6 +100,10 @@ PARROT_EXPORT
 void Parrot_cx_runloop_end(PARROT_INTERP)
         __attribute__nonnull__(1);
 
+PARROT_EXPORT
+void Parrot_cx_safepoint(PARROT_INTERP)
+        __attribute__nonnull__(1);
+
 PARROT_EXPORT
 void Parrot_cx_schedule_callback(PARROT_INTERP,
     ARGIN(PMC *user_data),
@@ -164,6 +168,10 @@ void Parrot_cx_runloop_wake(PARROT_INTERP, ARGMOD(PMC *scheduler))
         __attribute__nonnull__(2)
         FUNC_MODIFIES(*scheduler);
 
+void Parrot_cx_stop_alarm(SHIM_INTERP, ARGMOD(PMC *scheduler))
+        __attribute__nonnull__(2)
+        FUNC_MODIFIES(*scheduler);
+
 void Parrot_cx_timer_invoke(PARROT_INTERP, ARGIN(PMC *timer))
         __attribute__nonnull__(1)
         __attribute__nonnull__(2);
@@ -216,6 +224,8 @@ void Parrot_cx_timer_invoke(PARROT_INTERP, ARGIN(PMC *timer))
        PARROT_ASSERT_ARG(interp))
 #define ASSERT_ARGS_Parrot_cx_runloop_end __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
        PARROT_ASSERT_ARG(interp))
+#define ASSERT_ARGS_Parrot_cx_safepoint __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp))
 #define ASSERT_ARGS_Parrot_cx_schedule_callback __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
        PARROT_ASSERT_ARG(interp) \
     , PARROT_ASSERT_ARG(user_data) \
@@ -247,12 +257,21 @@ void Parrot_cx_timer_invoke(PARROT_INTERP, ARGIN(PMC *timer))
 #define ASSERT_ARGS_Parrot_cx_runloop_wake __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
        PARROT_ASSERT_ARG(interp) \
     , PARROT_ASSERT_ARG(scheduler))
+#define ASSERT_ARGS_Parrot_cx_stop_alarm __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(scheduler))
 #define ASSERT_ARGS_Parrot_cx_timer_invoke __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
        PARROT_ASSERT_ARG(interp) \
     , PARROT_ASSERT_ARG(timer))
 /* Don't modify between HEADERIZER BEGIN / HEADERIZER END.  Your changes will be lost. */
 /* HEADERIZER END: src/scheduler.c */
 
+/* Safepoints: the ops handle the tasks requested by enable_event_checking()
+ * at backward branches and at jumps to an address (sub calls and returns) */
+#define PARROT_SAFEPOINT(interp) \
+    ((interp)->safepoint_requested ? Parrot_cx_safepoint(interp) : (void)0)
+#define PARROT_SAFEPOINT_BRANCH(interp, offset) \
+    ((offset) <= 0 ? PARROT_SAFEPOINT(interp) : (void)0)
+
 /* Timer PMC interface constants */
 /* &gen_from_enum(timer.pasm) */
 typedef enum {
@@ -42,6 +42,13 @@ typedef enum {
 #define SCHEDULER_terminate_requested_SET(o)   SCHEDULER_flag_SET(terminate_requested, o)
 #define SCHEDULER_terminate_requested_CLEAR(o) SCHEDULER_flag_CLEAR(terminate_requested, o)
 
+/* States of the scheduler's alarm thread */
+typedef enum {
+    SCHEDULER_ALARM_NOT_STARTED,
+    SCHEDULER_ALARM_RUNNING,
+    SCHEDULER_ALARM_STOPPED
+} scheduler_alarm_enum;
+
 /*
  * Task private flags
  */
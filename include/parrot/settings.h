@@ -38,6 +38,9 @@
  * GC_DEFAULT_TYPE selection
  * MS  -- stop-the-world mark & sweep
  * INF -- infinite memory "collector"
+ * GMS -- generational mark & sweep
+ *
+ * The PARROT_GC_CORE environment variable overrides this at startup.
  */
 #define PARROT_GC_DEFAULT_TYPE MS
 
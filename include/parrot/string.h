@@ -27,6 +27,11 @@ typedef enum Forward_flag {
     Buffer_moved_FLAG = 1 << 0
 } Forward_flags;
 
+typedef enum {
+    /* may have a codepoint index, see src/string/encoding/utf8.c */
+    STRING_indexed_FLAG = PObj_private0_FLAG
+} String_flags;
+
 /* String iterator */
 typedef struct string_iterator_t {
     const STRING *str;
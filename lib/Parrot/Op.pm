@@ -111,6 +111,87 @@ sub new {
     return bless $self, $class;
 }
 
+=item C<fuse(@ops)>
+
+Returns a new op, a I<superinstruction>, which does the work of C<@ops> one
+after the other with a single dispatch.  Its arguments are the arguments of
+C<@ops> in order, and its name is C<super_> followed by the names of C<@ops>:
+C<inc_i> and C<lt_i_i_ic> fuse into C<super_inc_lt_i_i_i_ic>.
+
+All but the last op must simply go on to the next op: they may not branch,
+take a label, restart, or look at their own opcode.  The last op may branch;
+its offsets are relative to the start of the superinstruction, as IMCC
+computes them.  Dies if C<@ops> can't be fused.
+
+=cut
+
+sub fuse {
+    my ( $class, @ops ) = @_;
+    my $names = join ' ', map { $_->full_name } @ops;
+
+    die "can't fuse '$names': a superinstruction needs two ops or more\n"
+        if @ops < 2;
+
+    my $size = 1;
+    $size += $_->size - 1 for @ops;
+    die "can't fuse '$names': too many arguments\n"
+        if $size - 1 > 8;    # PARROT_MAX_ARGS
+
+    my ( @args, @argdirs, @labels, %flags );
+    my $body   = '';
+    my $inline = 1;
+
+    for my $i ( 0 .. $#ops ) {
+        my $op      = $ops[$i];
+        my $op_size = $op->size;
+        my $shift   = scalar @args;
+        my $code    = $op->body;
+
+        die "can't fuse '$names': " . $op->full_name . " looks at its own opcode\n"
+            if $code =~ /\b(?:CUR_OPCODE|cur_opcode)\b|\{\{\@0\}\}|\{\{=0,/;
+
+        if ( $i < $#ops ) {
+            die "can't fuse '$names': " . $op->full_name . " branches\n"
+                if $op->jump || grep { $_ } $op->labels;
+
+            # drop the goto NEXT() make_op appended; nothing else may jump
+            die "can't fuse '$names': " . $op->full_name . " changes the flow\n"
+                unless $code =~ s/\n?\{\{\+=$op_size\}\};\s*\z//
+                    && $code !~ /\{\{[-+=^]/;
+        }
+        else {
+            # NEXT() and OP_SIZE now refer to the superinstruction
+            my $bad = 0;
+            $code =~ s/\{\{(\+=|\^\+|\^)(\d+)\}\}/
+                $2 == $op_size ? "{{$1$size}}" : ( $bad = "{{$1$2}}" ) /ge;
+            die "can't fuse '$names': " . $op->full_name . " has a fixed offset\n"
+                if $bad;
+        }
+
+        $code =~ s/\{\{\@(\d+)\}\}/'{{@' . ( $1 + $shift ) . '}}'/ge;
+        $body .= "{\n$code\n}\n";
+
+        push @args,    $op->arg_types;
+        push @argdirs, $op->arg_dirs;
+        push @labels,  $op->labels;
+        %flags = ( %flags, %{ $op->flags || {} } );
+        $inline &&= $op->type eq 'inline';
+    }
+
+    my $last  = $ops[-1];
+    my $super = $class->new(
+        -1, ( $inline ? 'inline' : 'function' ),
+        join( '_', 'super', map { $_->name } @ops ),
+        \@args, \@argdirs, \@labels, \%flags
+    );
+
+    $super->body($body);
+    $super->jump( $last->jump );
+    $super->{FUSED} = [ map { $_->full_name } @ops ];
+
+    return $super;
+}
+
 =back
 
 =head2 Instance Methods
@@ -231,6 +312,19 @@ sub labels {
     return @{ $self->{LABELS} };
 }
 
+=item C<fused_ops()>
+
+For a superinstruction made by C<fuse()>, returns the full names of the ops
+it does the work of.  Returns an empty list for other ops.
+
+=cut
+
+sub fused_ops {
+    my $self = shift;
+
+    return @{ $self->{FUSED} || [] };
+}
+
 =item C<flags(@flags)>
 
 =item C<flags()>
@@ -81,6 +81,36 @@ sub gen_goto {
     return "return (opcode_t *)$where_str";
 }
 
+=item C<goto_address($address)>
+
+Reimplements the superclass method so that the jump passes a safepoint,
+where the pending tasks are handled (see C<PARROT_SAFEPOINT> in
+F<include/parrot/scheduler.h>).
+
+=cut
+
+sub goto_address {
+    my ( $self, $addr ) = @_;
+
+    return $self->gen_goto('0') if $addr eq '0';
+
+    return $self->gen_goto( "(PARROT_SAFEPOINT(interp), " . $self->expr_address($addr) . ")" );
+}
+
+=item C<goto_offset($offset)>
+
+Reimplements the superclass method so that backward branches pass a
+safepoint.
+
+=cut
+
+sub goto_offset {
+    my ( $self, $offset ) = @_;
+
+    return $self->gen_goto(
+        "(PARROT_SAFEPOINT_BRANCH(interp, $offset), " . $self->expr_offset($offset) . ")" );
+}
+
 =item C<expr_address($address)>
 
 Returns the C code for C<ADDRESS($address)>. Called by C<goto_address()>.
@@ -117,7 +147,7 @@ our %arg_maps = (
 
     'ic'  => "cur_opcode[%ld]",
     'nc'  => "CONST(%ld)->u.number",
-    'pc'  => "CONST(%ld)->u.key",
+    'pc'  => "PF_CONST_PMC(interp, CONST(%ld))",
     'sc'  => "CONST(%ld)->u.string",
     'kc'  => "CONST(%ld)->u.key",
     'kic' => "cur_opcode[%ld]"
@@ -90,7 +90,7 @@ sub goto_address {
     else {
         return "if ($addr == 0)
           return 0;
-   Parrot_cx_handle_tasks(interp, interp->scheduler);
+   PARROT_SAFEPOINT(interp);
    _reg_base = (char*)Parrot_pcc_get_regs_ni(interp, CURRENT_CONTEXT(interp))->regs_i;
    goto **(void **)(cur_opcode = opcode_to_prederef(interp, $addr))";
     }
@@ -108,6 +108,7 @@ sub goto_offset {
 
     # this must be a single expression, in case it's in a single-statement if
     return "do {\nParrot_pcc_set_pc(interp, CURRENT_CONTEXT(interp), CUR_OPCODE + $offset);\n"
+    .      "PARROT_SAFEPOINT_BRANCH(interp, $offset);\n"
     .      "goto **(void **)(cur_opcode += $offset);\n} while (1)";
 }
 
@@ -144,6 +144,7 @@ sub goto_address {
     else {
         return "if ((opcode_t *) $addr == 0)
           return 0;
+    PARROT_SAFEPOINT(interp);
     goto *ops_addr[*(cur_opcode = (opcode_t *)$addr)]";
     }
 }
@@ -171,7 +172,7 @@ relevant C code.
 sub goto_offset {
     my ( $self, $offset ) = @_;
 
-    return "goto *ops_addr[*(cur_opcode += $offset)]";
+    return "goto *ops_addr[*(PARROT_SAFEPOINT_BRANCH(interp, $offset), cur_opcode += $offset)]";
 }
 
 my %arg_maps = (
@@ -186,7 +187,7 @@ my %arg_maps = (
 
     'ic'  => "cur_opcode[%ld]",
     'nc'  => "CONST(%ld)->u.number",
-    'pc'  => "CONST(%ld)->u.key",
+    'pc'  => "PF_CONST_PMC(interp, CONST(%ld))",
     'sc'  => "CONST(%ld)->u.string",
     'kc'  => "CONST(%ld)->u.key",
     'kic' => "cur_opcode[%ld]"
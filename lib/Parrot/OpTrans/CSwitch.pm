@@ -99,6 +99,7 @@ sub goto_address {
         return <<EOC;
             {
                cur_opcode = opcode_to_prederef(interp, $addr);
+               PARROT_SAFEPOINT(interp);
                goto SWITCH_RELOAD;
             }
 EOC
@@ -114,7 +115,7 @@ relevant C code.
 
 sub goto_offset {
     my ( $self, $offset ) = @_;
-    return "{ cur_opcode += $offset; goto SWITCH_AGAIN; }";
+    return "{ PARROT_SAFEPOINT_BRANCH(interp, $offset); cur_opcode += $offset; goto SWITCH_AGAIN; }";
 }
 
 =item C<init_func_init1($base)>
@@ -157,7 +158,6 @@ SWITCH_RELOAD:
     _reg_base = (char*)Parrot_pcc_get_regs_ni(interp, CURRENT_CONTEXT(interp))->regs_i;
     do {
 SWITCH_AGAIN:
-    Parrot_cx_handle_tasks(interp, interp->scheduler);
     if (!cur_opcode)
         break;
     switch (*(opcode_t*)cur_opcode) {
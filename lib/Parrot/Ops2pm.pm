@@ -451,6 +451,29 @@ END_C
     print $OUT <<END_C;
 } parrot_opcode_enums;
 
+END_C
+
+    # the superinstructions, each followed by the ops it does the work of
+    my @super   = grep { $_->fused_ops } @OPS;
+    my $max_len = 2;
+    for my $el (@super) {
+        my $len = () = $el->fused_ops;
+        $max_len = $len if $len > $max_len;
+    }
+
+    print $OUT <<END_C;
+/* Superinstructions from src/ops/ops.super, as
+ * { super op, { the ops it does the work of, -1 } }, up to { -1, { -1 } } */
+#define PARROT_SUPER_OPS_MAX_LEN $max_len
+#define PARROT_SUPER_OPS \\
+END_C
+    for my $el (@super) {
+        printf $OUT "    { PARROT_OP_%s, { %s, -1 } }, \\\n", $el->full_name,
+            join( ', ', map { "PARROT_OP_$_" } $el->fused_ops );
+    }
+    print $OUT <<END_C;
+    { -1, { -1 } }
+
 #endif /* PARROT_OPS_H_GUARD */
 
 END_C
@@ -4,6 +4,7 @@ package Parrot::Ops2pm::Base;
 use strict;
 use warnings;
 use lib qw ( lib );
+use Parrot::Op;
 use Parrot::OpsFile;
 
 =head1 NAME
@@ -25,6 +26,7 @@ Parrot::Ops2pm::Base - Methods inherited by Parrot::Ops2pm and Parrot::OpsRenumb
     } );
 
     $self->prepare_ops();
+    $self->prepare_super_ops();
 
 =cut
 
@@ -94,6 +96,7 @@ sub new {
     $argsref->{argv} = \@argv;
     $argsref->{num_file}    = "src/ops/ops.num";
     $argsref->{skip_file}   = "src/ops/ops.skip";
+    $argsref->{super_file}  = "src/ops/ops.super";
     return bless $argsref, $class;
 }
 
@@ -176,6 +179,63 @@ sub prepare_ops {
     $self->{ops} = $ops;
 }
 
+=head2 C<prepare_super_ops()>
+
+=over 4
+
+=item * Purpose
+
+Adds the superinstructions listed in F<src/ops/ops.super> to the ops read by
+C<prepare_ops()>.  Each line of that file names two or more ops by their full
+names; C<Parrot::Op::fuse()> makes one op of them.
+
+=item * Arguments
+
+None.  (Implicitly requires that C<prepare_ops()> has been called.)
+
+=item * Return Value
+
+Returns true value upon success.  Dies if a listed op doesn't exist or the
+ops can't be fused.  Does nothing if there is no F<src/ops/ops.super>.
+
+=back
+
+=cut
+
+sub prepare_super_ops {
+    my $self = shift;
+    my $file = $self->{super_file};
+
+    return 1 unless -e $file;
+
+    my %op_named = map { $_->full_name => $_ } @{ $self->{ops}{OPS} };
+    my %seen;
+
+    open my $SUPER, '<', $file
+        or die "Can't open $file: $!";
+    while (<$SUPER>) {
+        s/#.*$//;
+        s/\s*$//;
+        s/^\s*//;
+        next unless $_;
+
+        my @ops = map {
+            $op_named{$_} or die "$file:$.: unknown op '$_'\n"
+        } split /\s+/;
+        my $super = eval { Parrot::Op->fuse(@ops) }
+            or die "$file:$.: $@";
+
+        die "$file:$.: " . $super->full_name . " is listed twice\n"
+            if $seen{ $super->full_name }++ or $op_named{ $super->full_name };
+        $super->{experimental} = 1 if grep { $_->{experimental} } @ops;
+
+        push @{ $self->{ops}{OPS} }, $super;
+    }
+    close $SUPER;
+
+    return 1;
+}
+
 1;
 
 # Local Variables:
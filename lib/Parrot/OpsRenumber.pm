@@ -139,7 +139,7 @@ sub renum_op_map_file {
         # index, then print the index on that same line.
 
         elsif ( $seen{ $_->full_name } ) {
-            printf $OP "%-31s%4d\n", $_->full_name, ++$n;
+            printf $OP "%-30s %4d\n", $_->full_name, ++$n;
         }
     }
     close $OP;
@@ -222,10 +222,16 @@ EOA
 EOA
     }
 
+    # storing a GCable pointer into an old PMC needs the write barrier
+    my $barrier = ( $attrtype =~ $isptrtostring || $attrtype =~ $isptrtopmc )
+                ? " \\\n            GC_WRITE_BARRIER(interp, pmc, NULL, NULL);"
+                : '';
+
     $decl .= <<"EOA";
         } \\
-        else \\
-            ((Parrot_${pmcname}_attributes *)PMC_data(pmc))->$attrname = (value); \\
+        else { \\
+            ((Parrot_${pmcname}_attributes *)PMC_data(pmc))->$attrname = (value);${barrier} \\
+        } \\
     } while (0)
 
 EOA
@@ -49,7 +49,17 @@ sub generate_body {
 
     $emit->( $self->decl( $pmc, 'CFILE' ) );
     $emit->("{\n");
-    $emit->($body);
+
+    if ( $self->needs_write_barrier($pmc) ) {
+        $emit->("    GC_WRITE_BARRIER(interp, pmc, NULL, NULL);\n");
+        $emit->("    {\n");
+        $emit->($body);
+        $emit->("    }\n");
+    }
+    else {
+        $emit->($body);
+    }
+
     $emit->("}\n");
 
     if ( $self->mmds ) {
@@ -75,6 +85,23 @@ sub generate_headers {
     return $hout;
 }
 
+=item C<needs_write_barrier($pmc)>
+
+Returns true if the vtable method is marked C<:write>, so that the
+generational GC must be told before the body stores into C<pmc>. Other
+stores go through C<SETATTR> or call C<GC_WRITE_BARRIER> themselves.
+
+=cut
+
+sub needs_write_barrier {
+    my ( $self, $pmc ) = @_;
+
+    return 0 if $self->pmc_unused || !$self->is_vtable;
+
+    return $pmc->vtable->get_method( $self->name )
+        && $pmc->vtable_method_does_write( $self->name ) ? 1 : 0;
+}
+
 =item C<decl($classname, $method, $for_header)>
 
 Returns the C code for the PMC method declaration. C<$for_header>
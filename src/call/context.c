@@ -43,17 +43,26 @@ The macro CONTEXT() hides these details
 
 =head2 Allocation Size
 
-Round register allocation size up to the nearest multiple of 8. A granularity
-of 8 is arbitrary, it could have been some bigger power of 2. A "slot" is an
-index into the free_list array. Each slot in free_list has a linked list of
+Round register allocation size up to the nearest multiple of 64 bytes, eight
+registers on most platforms, so that subs using about the same number of
+registers share context sizes. A "slot" is an index into the free_list array
+of C<interp-E<gt>ctx_mem>. Each slot in free_list has a linked list of
 pointers to already allocated contexts available for (re)use.  The slot where
 an available context is stored corresponds to the size of the context.
 
+A context is put on its free list when its sub returns, unless something
+still refers to it (see C<Parrot_release_context>), or else when the GC
+destroys its Context PMC. The next context of that size is taken from the
+head of the list, so the frames of a recursion are reused LIFO and calls
+don't go to C<malloc>. A free list holds at most C<MAX_FREE_CONTEXTS>
+contexts; when the GC destroys many Contexts at once, the rest are freed.
+
 =cut
 
 */
 
-#define SLOT_CHUNK_SIZE 8
+#define SLOT_CHUNK_SIZE 64
+#define MAX_FREE_CONTEXTS 64
 
 #define ROUND_ALLOC_SIZE(size) ((((size) + SLOT_CHUNK_SIZE - 1) \
         / SLOT_CHUNK_SIZE) * SLOT_CHUNK_SIZE)
@@ -202,7 +211,7 @@ Parrot_pcc_get_pmc_constant(PARROT_INTERP, ARGIN(PMC *ctx), INTVAL idx)
 {
     ASSERT_ARGS(Parrot_pcc_get_pmc_constant)
     Parrot_Context const * c = get_context_struct_fast(interp, ctx);
-    return c->constants[idx]->u.key;
+    return PF_CONST_PMC(interp, c->constants[idx]);
 }
 
 
@@ -1050,6 +1059,13 @@ create_initial_context(PARROT_INTERP)
     /* Create some initial free_list slots. */
 
 #define INITIAL_FREE_SLOTS 8
+    /* The first interpreter gets here twice, see F<src/global_setup.c> */
+    if (!interp->ctx_mem.free_list) {
+        interp->ctx_mem.n_free_slots = INITIAL_FREE_SLOTS;
+        interp->ctx_mem.free_list    = mem_allocate_n_zeroed_typed(INITIAL_FREE_SLOTS, void *);
+        interp->ctx_mem.n_free       = mem_allocate_n_zeroed_typed(INITIAL_FREE_SLOTS, int);
+    }
+
     /* For now create context with 32 regs each. Some src tests (and maybe
      * other extenders) assume the presence of these registers */
     ignored = Parrot_set_new_context(interp, num_regs);
@@ -1153,6 +1169,7 @@ init_context(PARROT_INTERP, ARGMOD(PMC *pmcctx), ARGIN_NULLOK(PMC *pmcold))
     ctx->results_signature = NULL;
     ctx->lex_pad           = PMCNULL;
     ctx->outer_ctx         = NULL;
+    ctx->current_sub       = NULL;
     ctx->current_cont      = NULL;
     ctx->current_object    = NULL;
     ctx->handlers          = PMCNULL;
@@ -1297,12 +1314,15 @@ Parrot_alloc_context(PARROT_INTERP, ARGIN(const INTVAL *number_regs_used),
     const size_t reg_alloc     = ROUND_ALLOC_SIZE(all_regs_size);
 
     const size_t to_alloc = reg_alloc + ALIGNED_CTX_SIZE;
+    const int    slot     = CALCULATE_SLOT_NUM(reg_alloc);
 
-#ifdef GC_USE_FIXED_SIZE_ALLOCATOR
-    ctx  = (Parrot_Context *)Parrot_gc_allocate_fixed_size_storage(interp, to_alloc);
-#else
-    ctx  = (Parrot_Context *)mem_sys_allocate(to_alloc);
-#endif
+    if (slot < interp->ctx_mem.n_free_slots && interp->ctx_mem.free_list[slot]) {
+        ctx = (Parrot_Context *)interp->ctx_mem.free_list[slot];
+        interp->ctx_mem.free_list[slot] = *(void **)ctx;
+        --interp->ctx_mem.n_free[slot];
+    }
+    else
+        ctx = (Parrot_Context *)mem_sys_allocate(to_alloc);
 
     ctx->n_regs_used[REGNO_INT] = number_regs_used[REGNO_INT];
     ctx->n_regs_used[REGNO_NUM] = number_regs_used[REGNO_NUM];
@@ -1327,6 +1347,110 @@ Parrot_alloc_context(PARROT_INTERP, ARGIN(const INTVAL *number_regs_used),
 }
 
 
+/*
+
+=item C<void Parrot_free_context(PARROT_INTERP, Parrot_Context *ctx)>
+
+Puts a context allocated by C<Parrot_alloc_context> on the free list for its
+size, to be reused by the next allocation of that size, or frees it if that
+list is full.  Called when the GC destroys the Context PMC, and by
+C<Parrot_release_context>.
+
+=cut
+
+*/
+
+void
+Parrot_free_context(PARROT_INTERP, ARGMOD(Parrot_Context *ctx))
+{
+    ASSERT_ARGS(Parrot_free_context)
+    const size_t reg_alloc =
+        Parrot_pcc_calculate_context_size(interp, ctx->n_regs_used) - ALIGNED_CTX_SIZE;
+    const int    slot      = CALCULATE_SLOT_NUM(reg_alloc);
+
+    if (slot >= interp->ctx_mem.n_free_slots) {
+        const int n = slot + 1;
+
+        interp->ctx_mem.free_list = (void **)mem_sys_realloc_zeroed(
+                interp->ctx_mem.free_list, n * sizeof (void *),
+                interp->ctx_mem.n_free_slots * sizeof (void *));
+        interp->ctx_mem.n_free = (int *)mem_sys_realloc_zeroed(
+                interp->ctx_mem.n_free, n * sizeof (int),
+                interp->ctx_mem.n_free_slots * sizeof (int));
+        interp->ctx_mem.n_free_slots = n;
+    }
+
+    if (interp->ctx_mem.n_free[slot] >= MAX_FREE_CONTEXTS) {
+        mem_sys_free(ctx);
+        return;
+    }
+
+    *(void **)ctx                   = interp->ctx_mem.free_list[slot];
+    interp->ctx_mem.free_list[slot] = ctx;
+    ++interp->ctx_mem.n_free[slot];
+}
+
+
+/*
+
+=item C<void Parrot_release_context(PARROT_INTERP, PMC *pmcctx)>
+
+Gives the register frame of C<pmcctx> back to the free list when its sub has
+returned, instead of waiting for the GC to destroy the Context PMC.  Called
+by C<RetContinuation.invoke>.  The caller makes sure that nothing else refers
+to the context any more: creating a Continuation, calling an outer sub or a
+Coroutine, and throwing an exception all turn the return continuations up
+the call chain into true Continuations, which don't release anything.
+
+=cut
+
+*/
+
+void
+Parrot_release_context(PARROT_INTERP, ARGMOD(PMC *pmcctx))
+{
+    ASSERT_ARGS(Parrot_release_context)
+    Parrot_Context * const ctx = get_context_struct_fast(interp, pmcctx);
+
+    PMC_data(pmcctx) = NULL;
+    Parrot_free_context(interp, ctx);
+}
+
+
+/*
+
+=item C<void destroy_context(PARROT_INTERP)>
+
+Frees the contexts on the free lists, and the free lists.
+
+=cut
+
+*/
+
+void
+destroy_context(PARROT_INTERP)
+{
+    ASSERT_ARGS(destroy_context)
+    int slot;
+
+    for (slot = 0; slot < interp->ctx_mem.n_free_slots; ++slot) {
+        void *ptr = interp->ctx_mem.free_list[slot];
+
+        while (ptr) {
+            void * const next = *(void **)ptr;
+            mem_sys_free(ptr);
+            ptr = next;
+        }
+    }
+
+    mem_sys_free(interp->ctx_mem.free_list);
+    mem_sys_free(interp->ctx_mem.n_free);
+    interp->ctx_mem.free_list    = NULL;
+    interp->ctx_mem.n_free       = NULL;
+    interp->ctx_mem.n_free_slots = 0;
+}
+
+
 /*
 
 =item C<PMC * Parrot_set_new_context(PARROT_INTERP, const INTVAL
@@ -3071,6 +3071,10 @@ Parrot_pcc_invoke_from_sig_object(PARROT_INTERP, ARGIN(PMC *sub_obj),
        caller's context */
     set_context_sig_returns(interp, ctx, indexes, ret_x, result_list);
 
+    /* Don't leave the context pointing at the freed signature */
+    if (Parrot_pcc_get_results_signature(interp, ctx) == results_sig)
+        Parrot_pcc_set_results_signature(interp, ctx, NULL);
+
     temporary_pmc_free(interp, args_sig);
     temporary_pmc_free(interp, results_sig);
 
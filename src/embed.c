@@ -553,6 +553,10 @@ again:
     /* Make the cmdline option available to the unpackers */
     pf->options = debug;
 
+    /* Thaw PMC constants when first used, unless a tool wants them all */
+    if (!(debug & PFOPT_UTILS))
+        pf->options |= PFOPT_LAZY;
+
     if (!PackFile_unpack(interp, pf, (opcode_t *)program_code,
             (size_t)program_size)) {
         Parrot_io_eprintf(interp, "Parrot VM: Can't unpack packfile %s.\n",
@@ -907,9 +911,11 @@ print_constant_table(PARROT_INTERP)
                 Parrot_io_printf(interp, "\n");
                 break;
             case PFC_PMC: {
+                PMC * const pmc = PF_CONST_PMC(interp,
+                        interp->code->const_table->constants[i]);
                 Parrot_io_printf(interp, "PMC_CONST(%d): ", i);
 
-                switch (c->u.key->vtable->base_type) {
+                switch (pmc->vtable->base_type) {
                     /* each PBC file has a ParrotInterpreter, but it can't
                      * stringify by itself */
                     case enum_class_ParrotInterpreter:
@@ -918,12 +924,12 @@ print_constant_table(PARROT_INTERP)
 
                     /* FixedIntegerArrays used for signatures, handy to print */
                     case enum_class_FixedIntegerArray: {
-                        INTVAL n = VTABLE_elements(interp, c->u.key);
+                        INTVAL n = VTABLE_elements(interp, pmc);
                         INTVAL i;
                         Parrot_io_printf(interp, "[");
 
                         for (i = 0; i < n; ++i) {
-                            INTVAL val = VTABLE_get_integer_keyed_int(interp, c->u.key, i);
+                            INTVAL val = VTABLE_get_integer_keyed_int(interp, pmc, i);
                             Parrot_io_printf(interp, "%d", val);
                             if (i < n - 1)
                                 Parrot_io_printf(interp, ",");
@@ -936,14 +942,14 @@ print_constant_table(PARROT_INTERP)
                     case enum_class_Key:
                     case enum_class_ResizableStringArray:
                         {
-                            /*Parrot_print_p(interp, c->u.key);*/
-                            STRING * const s = VTABLE_get_string(interp, c->u.key);
+                            /*Parrot_print_p(interp, pmc);*/
+                            STRING * const s = VTABLE_get_string(interp, pmc);
                             if (s)
                                 Parrot_io_printf(interp, "%Ss", s);
                             break;
                         }
                     case enum_class_Sub:
-                        Parrot_io_printf(interp, "%S", VTABLE_get_string(interp, c->u.key));
+                        Parrot_io_printf(interp, "%S", VTABLE_get_string(interp, pmc));
                         break;
                     default:
                         Parrot_io_printf(interp, "(PMC constant)");
@@ -1507,9 +1507,9 @@ do_event(PARROT_INTERP, ARGIN(parrot_event* event), ARGIN_NULLOK(opcode_t *next)
 =item C<opcode_t * Parrot_do_handle_events(PARROT_INTERP, int restore, opcode_t
 *next)>
 
-Called by the C<check_event__> opcode from run loops or from above. When
-called from the C<check_events__> opcode, we have to restore the
-C<op_func_table>.
+Handle the events in the interpreter's task queue.  If C<restore> is true,
+the request for a safepoint made when the events were scheduled is withdrawn
+first (see C<enable_event_checking()>).
 
 =cut
 
@@ -37,6 +37,9 @@ static PMC * build_exception_from_args(PARROT_INTERP,
         __attribute__nonnull__(1)
         __attribute__nonnull__(3);
 
+static void keep_call_chain(PARROT_INTERP)
+        __attribute__nonnull__(1);
+
 PARROT_CAN_RETURN_NULL
 static opcode_t * pass_exception_args(PARROT_INTERP,
     ARGIN(const char *sig),
@@ -51,6 +54,8 @@ static opcode_t * pass_exception_args(PARROT_INTERP,
 #define ASSERT_ARGS_build_exception_from_args __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
        PARROT_ASSERT_ARG(interp) \
     , PARROT_ASSERT_ARG(format))
+#define ASSERT_ARGS_keep_call_chain __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp))
 #define ASSERT_ARGS_pass_exception_args __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
        PARROT_ASSERT_ARG(interp) \
     , PARROT_ASSERT_ARG(sig) \
@@ -195,6 +200,29 @@ Parrot_ex_add_c_handler(PARROT_INTERP, ARGIN(Parrot_runloop *jp))
 
 /*
 
+=item C<static void keep_call_chain(PARROT_INTERP)>
+
+Turns the return continuations up the call chain into true continuations, so
+that the contexts of the subs stay valid after the subs return. The exception
+keeps the thrower, and the handler search keeps the context it stopped at.
+
+=cut
+
+*/
+
+static void
+keep_call_chain(PARROT_INTERP)
+{
+    ASSERT_ARGS(keep_call_chain)
+    PMC * const cont = Parrot_pcc_get_continuation(interp, CURRENT_CONTEXT(interp));
+
+    if (!PMC_IS_NULL(cont)
+    &&  cont->vtable->base_type == enum_class_RetContinuation)
+        invalidate_retc_context(interp, cont);
+}
+
+/*
+
 =item C<opcode_t * Parrot_ex_throw_from_op(PARROT_INTERP, PMC *exception, void
 *dest)>
 
@@ -215,7 +243,10 @@ Parrot_ex_throw_from_op(PARROT_INTERP, ARGIN(PMC *exception), ARGIN_NULLOK(void
 {
     ASSERT_ARGS(Parrot_ex_throw_from_op)
     opcode_t   *address;
-    PMC * const handler = Parrot_cx_find_handler_local(interp, exception);
+    PMC        *handler;
+
+    keep_call_chain(interp);
+    handler = Parrot_cx_find_handler_local(interp, exception);
     if (PMC_IS_NULL(handler)) {
         STRING * const message     = VTABLE_get_string(interp, exception);
         const INTVAL   severity    = VTABLE_get_integer_keyed_str(interp, exception, CONST_STRING(interp, "severity"));
@@ -357,8 +388,10 @@ Parrot_ex_throw_from_c(PARROT_INTERP, ARGIN(PMC *exception))
 
     Parrot_runloop    *return_point = interp->current_runloop;
     opcode_t *address;
-    PMC        * const handler      =
-                             Parrot_cx_find_handler_local(interp, exception);
+    PMC      *handler;
+
+    keep_call_chain(interp);
+    handler = Parrot_cx_find_handler_local(interp, exception);
 
     if (PMC_IS_NULL(handler))
         die_from_exception(interp, exception);
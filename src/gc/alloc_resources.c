@@ -32,8 +32,18 @@ Functions to manage non-PObj memory, including strings and buffers.
 
 #define POOL_SIZE 65536 * 2
 
+/* evacuate blocks in which at most this fraction of the used bytes is live */
+#define EVACUATION_FACTOR 0.5
+
 typedef void (*compact_f) (Interp *, Variable_Size_Pool *);
 
+/* live bytes of a memory block, gathered by evacuate_fragmented_blocks */
+typedef struct Block_Usage {
+    Memory_Block *block;
+    size_t        live;
+    int           evacuate;
+} Block_Usage;
+
 /* HEADERIZER HFILE: src/gc/gc_private.h */
 
 /* HEADERIZER BEGIN: static */
@@ -48,6 +58,10 @@ static void alloc_new_block(PARROT_INTERP,
         __attribute__nonnull__(4)
         FUNC_MODIFIES(*pool);
 
+static int block_usage_cmp(ARGIN(const void *a), ARGIN(const void *b))
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2);
+
 PARROT_CANNOT_RETURN_NULL
 PARROT_WARN_UNUSED_RESULT
 static const char* buffer_location(PARROT_INTERP, ARGIN(const PObj *b))
@@ -69,6 +83,24 @@ static void debug_print_buf(PARROT_INTERP, ARGIN(const Buffer *b))
         __attribute__nonnull__(1)
         __attribute__nonnull__(2);
 
+PARROT_CAN_RETURN_NULL
+PARROT_WARN_UNUSED_RESULT
+static Block_Usage * find_block_usage(ARGIN(Block_Usage *usage),
+    size_t n,
+    ARGIN(const char *ptr))
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(3);
+
+PARROT_CANNOT_RETURN_NULL
+PARROT_WARN_UNUSED_RESULT
+static char * move_buffer(PARROT_INTERP,
+    ARGMOD(Buffer *b),
+    ARGIN(char *cur_spot))
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2)
+        __attribute__nonnull__(3)
+        FUNC_MODIFIES(*b);
+
 PARROT_MALLOC
 PARROT_CANNOT_RETURN_NULL
 static Variable_Size_Pool * new_memory_pool(
@@ -79,6 +111,9 @@ static Variable_Size_Pool * new_memory_pool(
        PARROT_ASSERT_ARG(interp) \
     , PARROT_ASSERT_ARG(pool) \
     , PARROT_ASSERT_ARG(why))
+#define ASSERT_ARGS_block_usage_cmp __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(a) \
+    , PARROT_ASSERT_ARG(b))
 #define ASSERT_ARGS_buffer_location __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
        PARROT_ASSERT_ARG(interp) \
     , PARROT_ASSERT_ARG(b))
@@ -91,6 +126,13 @@ static Variable_Size_Pool * new_memory_pool(
 #define ASSERT_ARGS_debug_print_buf __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
        PARROT_ASSERT_ARG(interp) \
     , PARROT_ASSERT_ARG(b))
+#define ASSERT_ARGS_find_block_usage __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(usage) \
+    , PARROT_ASSERT_ARG(ptr))
+#define ASSERT_ARGS_move_buffer __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp) \
+    , PARROT_ASSERT_ARG(b) \
+    , PARROT_ASSERT_ARG(cur_spot))
 #define ASSERT_ARGS_new_memory_pool __attribute__unused__ int _ASSERT_ARGS_CHECK = (0)
 /* Don't modify between HEADERIZER BEGIN / HEADERIZER END.  Your changes will be lost. */
 /* HEADERIZER END: static */
@@ -207,6 +249,11 @@ mem_allocate(PARROT_INTERP, size_t size, ARGMOD(Variable_Size_Pool *pool))
 
     /* If not enough room, try to find some */
     if (pool->top_block->free < size) {
+        /* over the maximum heap size, always collect and compact first */
+        const int at_max = Parrot_gc_heap_exceeds_max(interp,
+                size > pool->minimum_block_size
+                    ? size : pool->minimum_block_size);
+
         /*
          * force a GC mark run to get live flags set
          * for incremental M&S collection is run from there
@@ -215,7 +262,7 @@ mem_allocate(PARROT_INTERP, size_t size, ARGMOD(Variable_Size_Pool *pool))
          *      so that collection can be skipped if needed
          */
         if (!interp->mem_pools->gc_mark_block_level
-        &&   interp->mem_pools->mem_allocs_since_last_collect) {
+        &&  (interp->mem_pools->mem_allocs_since_last_collect || at_max)) {
             Parrot_gc_mark_and_sweep(interp, GC_trace_stack_FLAG);
 
             if (interp->gc_sys->sys_type != INF) {
@@ -223,14 +270,15 @@ mem_allocate(PARROT_INTERP, size_t size, ARGMOD(Variable_Size_Pool *pool))
                 if (pool->compact) {
                     /* don't bother reclaiming if it's only a small amount */
                     if ((pool->possibly_reclaimable * pool->reclaim_factor +
-                         pool->guaranteed_reclaimable) > size) {
+                         pool->guaranteed_reclaimable) > size
+                    ||  (at_max && pool->possibly_reclaimable)) {
                         (*pool->compact) (interp, pool);
                     }
                 }
             }
         }
         if (pool->top_block->free < size) {
-            if (pool->minimum_block_size < 65536 * 16)
+            if (pool->minimum_block_size < 65536 * 16 && !at_max)
                 pool->minimum_block_size *= 2;
             /*
              * TODO - Big blocks
@@ -320,6 +368,108 @@ debug_print_buf(PARROT_INTERP, ARGIN(const Buffer *b))
 
 =over 4
 
+=item C<static char * move_buffer(PARROT_INTERP, Buffer *b, char *cur_spot)>
+
+Copies the memory of the movable Buffer C<b> to C<cur_spot> and points the
+header at the copy. A COW buffer which was already moved for another header
+is not copied again. Returns where the next buffer goes.
+
+=cut
+
+*/
+
+PARROT_CANNOT_RETURN_NULL
+PARROT_WARN_UNUSED_RESULT
+static char *
+move_buffer(PARROT_INTERP, ARGMOD(Buffer *b), ARGIN(char *cur_spot))
+{
+    ASSERT_ARGS(move_buffer)
+    INTVAL   *ref_count = NULL;
+    ptrdiff_t offset    = 0;
+#if RESOURCE_DEBUG
+    if (Buffer_buflen(b) >= RESOURCE_DEBUG_SIZE)
+        debug_print_buf(interp, b);
+#endif
+
+    /* we can't perform the math all the time, because
+     * strstart might be in unallocated memory */
+    if (PObj_is_COWable_TEST(b)) {
+        ref_count = Buffer_bufrefcountptr(b);
+
+        if (PObj_is_string_TEST(b)) {
+            offset = (ptrdiff_t)((STRING *)b)->strstart -
+                (ptrdiff_t)Buffer_bufstart(b);
+        }
+    }
+
+    /* buffer has already been moved; just change the header */
+    if (PObj_COW_TEST(b) &&
+        (ref_count && *ref_count & Buffer_moved_FLAG)) {
+        /* Find out who else references our data */
+        Buffer * const hdr = *((Buffer **)Buffer_bufstart(b));
+
+
+        PARROT_ASSERT(PObj_is_COWable_TEST(b));
+
+        /* Make sure they know that we own it too */
+        PObj_COW_SET(hdr);
+
+        /* TODO incr ref_count, after fixing string too
+         * Now make sure we point to where the other guy does */
+        Buffer_bufstart(b) = Buffer_bufstart(hdr);
+
+        /* And if we're a string, update strstart */
+        /* Somewhat of a hack, but if we get per-pool
+         * collections, it should help ease the pain */
+        if (PObj_is_string_TEST(b)) {
+            ((STRING *)b)->strstart = (char *)Buffer_bufstart(b) +
+                    offset;
+        }
+    }
+    else {
+        cur_spot = aligned_mem(b, cur_spot);
+
+        if (PObj_is_COWable_TEST(b)) {
+            INTVAL * const new_ref_count = ((INTVAL*) cur_spot) - 1;
+            *new_ref_count        = 2;
+        }
+
+        /* Copy our memory to the new pool */
+        memcpy(cur_spot, Buffer_bufstart(b), Buffer_buflen(b));
+
+        /* If we're COW */
+        if (PObj_COW_TEST(b)) {
+            PARROT_ASSERT(PObj_is_COWable_TEST(b));
+
+            /* Let the old buffer know how to find us */
+            *((Buffer **)Buffer_bufstart(b)) = b;
+
+            /* No guarantees that our data is still COW, so
+             * assume not, and let the above code fix-up */
+            PObj_COW_CLEAR(b);
+
+            /* Finally, let the tail know that we've moved, so
+             * that any other references can know to look for
+             * us and not re-copy */
+            if (ref_count)
+                *ref_count |= Buffer_moved_FLAG;
+        }
+
+        Buffer_bufstart(b) = cur_spot;
+
+        if (PObj_is_string_TEST(b)) {
+            ((STRING *)b)->strstart = (char *)Buffer_bufstart(b) +
+                    offset;
+        }
+
+        cur_spot += Buffer_buflen(b);
+    }
+
+    return cur_spot;
+}
+
+/*
+
 =item C<void compact_pool(PARROT_INTERP, Variable_Size_Pool *pool)>
 
 Compact the string buffer pool. Does not perform a GC scan, or mark items
@@ -341,11 +491,13 @@ compact_pool(PARROT_INTERP, ARGMOD(Variable_Size_Pool *pool))
 
     Fixed_Size_Arena *cur_buffer_arena;
     Memory_Pools * const      mem_pools = interp->mem_pools;
+    GC_Event                 *event;
 
     /* Bail if we're blocked */
     if (mem_pools->gc_sweep_block_level)
         return;
 
+    event = Parrot_gc_event_begin(interp, GC_EVENT_COMPACT);
     ++mem_pools->gc_sweep_block_level;
 
     /* We're collecting */
@@ -420,90 +572,10 @@ compact_pool(PARROT_INTERP, ARGMOD(Variable_Size_Pool *pool))
             const size_t objects_end = cur_buffer_arena->used;
 
             for (i = objects_end; i; --i) {
-                INTVAL *ref_count = NULL;
-
                 /* ! (on_free_list | constant | external | sysmem) */
-                if (Buffer_buflen(b) && PObj_is_movable_TESTALL(b)) {
-                    ptrdiff_t offset = 0;
-#if RESOURCE_DEBUG
-                    if (Buffer_buflen(b) >= RESOURCE_DEBUG_SIZE)
-                        debug_print_buf(interp, b);
-#endif
-
-                    /* we can't perform the math all the time, because
-                     * strstart might be in unallocated memory */
-                    if (PObj_is_COWable_TEST(b)) {
-                        ref_count = Buffer_bufrefcountptr(b);
-
-                        if (PObj_is_string_TEST(b)) {
-                            offset = (ptrdiff_t)((STRING *)b)->strstart -
-                                (ptrdiff_t)Buffer_bufstart(b);
-                        }
-                    }
-
-                    /* buffer has already been moved; just change the header */
-                    if (PObj_COW_TEST(b) &&
-                        (ref_count && *ref_count & Buffer_moved_FLAG)) {
-                        /* Find out who else references our data */
-                        Buffer * const hdr = *((Buffer **)Buffer_bufstart(b));
-
-
-                        PARROT_ASSERT(PObj_is_COWable_TEST(b));
-
-                        /* Make sure they know that we own it too */
-                        PObj_COW_SET(hdr);
+                if (Buffer_buflen(b) && PObj_is_movable_TESTALL(b))
+                    cur_spot = move_buffer(interp, b, cur_spot);
 
-                        /* TODO incr ref_count, after fixing string too
-                         * Now make sure we point to where the other guy does */
-                        Buffer_bufstart(b) = Buffer_bufstart(hdr);
-
-                        /* And if we're a string, update strstart */
-                        /* Somewhat of a hack, but if we get per-pool
-                         * collections, it should help ease the pain */
-                        if (PObj_is_string_TEST(b)) {
-                            ((STRING *)b)->strstart = (char *)Buffer_bufstart(b) +
-                                    offset;
-                        }
-                    }
-                    else {
-                        cur_spot = aligned_mem(b, cur_spot);
-
-                        if (PObj_is_COWable_TEST(b)) {
-                            INTVAL * const new_ref_count = ((INTVAL*) cur_spot) - 1;
-                            *new_ref_count        = 2;
-                        }
-
-                        /* Copy our memory to the new pool */
-                        memcpy(cur_spot, Buffer_bufstart(b), Buffer_buflen(b));
-
-                        /* If we're COW */
-                        if (PObj_COW_TEST(b)) {
-                            PARROT_ASSERT(PObj_is_COWable_TEST(b));
-
-                            /* Let the old buffer know how to find us */
-                            *((Buffer **)Buffer_bufstart(b)) = b;
-
-                            /* No guarantees that our data is still COW, so
-                             * assume not, and let the above code fix-up */
-                            PObj_COW_CLEAR(b);
-
-                            /* Finally, let the tail know that we've moved, so
-                             * that any other references can know to look for
-                             * us and not re-copy */
-                            if (ref_count)
-                                *ref_count |= Buffer_moved_FLAG;
-                        }
-
-                        Buffer_bufstart(b) = cur_spot;
-
-                        if (PObj_is_string_TEST(b)) {
-                            ((STRING *)b)->strstart = (char *)Buffer_bufstart(b) +
-                                    offset;
-                        }
-
-                        cur_spot += Buffer_buflen(b);
-                    }
-                }
                 b = (Buffer *)((char *)b + object_size);
             }
         }
@@ -549,6 +621,236 @@ compact_pool(PARROT_INTERP, ARGMOD(Variable_Size_Pool *pool))
     pool->possibly_reclaimable   = 0;
 
     --mem_pools->gc_sweep_block_level;
+    Parrot_gc_event_end(interp, event);
+}
+
+/*
+
+=item C<void evacuate_fragmented_blocks(PARROT_INTERP, Variable_Size_Pool
+*pool)>
+
+An alternative to C<compact_pool>, selected with the C<PARROT_GC_COMPACT>
+environment variable. Instead of copying every live buffer into one new
+block, it adds up the live bytes of each block and only moves the buffers
+out of blocks of which at most C<EVACUATION_FACTOR> is still live; the
+other blocks stay where they are. The cost of a compaction and the memory
+it needs on top of the heap are thus proportional to the fragmentation,
+not to the size of the heap. Does not perform a GC scan.
+
+=cut
+
+*/
+
+void
+evacuate_fragmented_blocks(PARROT_INTERP, ARGMOD(Variable_Size_Pool *pool))
+{
+    ASSERT_ARGS(evacuate_fragmented_blocks)
+    Memory_Pools * const mem_pools = interp->mem_pools;
+    Block_Usage  *usage;
+    Memory_Block *cur_block;
+    Memory_Block *new_block;
+    char         *cur_spot;
+    size_t        num_blocks    = 0;
+    size_t        evacuated     = 0;
+    size_t        to_move       = 0;
+    int           top_evacuated = 0;
+    size_t        i;
+    int           pass;
+    GC_Event     *event;
+
+    /* Bail if we're blocked */
+    if (mem_pools->gc_sweep_block_level)
+        return;
+
+    event = Parrot_gc_event_begin(interp, GC_EVENT_COMPACT);
+    ++mem_pools->gc_sweep_block_level;
+
+    mem_pools->mem_allocs_since_last_collect    = 0;
+    mem_pools->header_allocs_since_last_collect = 0;
+    mem_pools->gc_collect_runs++;
+
+    for (cur_block = pool->top_block; cur_block; cur_block = cur_block->prev)
+        ++num_blocks;
+
+    usage = mem_allocate_n_zeroed_typed(num_blocks, Block_Usage);
+
+    for (i = 0, cur_block = pool->top_block; cur_block;
+            cur_block = cur_block->prev)
+        usage[i++].block = cur_block;
+
+    qsort(usage, num_blocks, sizeof (Block_Usage), block_usage_cmp);
+
+    /* the first pass counts the live bytes of each block, the second one
+     * moves the buffers of the blocks chosen in between */
+    new_block = NULL;
+    cur_spot  = NULL;
+
+    for (pass = 0; pass < 2; ++pass) {
+        INTVAL j;
+
+        for (j = (INTVAL)mem_pools->num_sized - 1; j >= 0; --j) {
+            Fixed_Size_Pool * const header_pool =
+                mem_pools->sized_header_pools[j];
+            Fixed_Size_Arena *arena;
+
+            if (!header_pool)
+                continue;
+
+            for (arena = header_pool->last_Arena; arena; arena = arena->prev) {
+                Buffer *b = (Buffer *)arena->start_objects;
+                size_t  k;
+
+                for (k = arena->used; k; --k) {
+                    if (Buffer_buflen(b) && PObj_is_movable_TESTALL(b)) {
+                        Block_Usage * const u = find_block_usage(usage,
+                                num_blocks, (char *)Buffer_bufstart(b));
+
+                        /* COW buffers are counted once for every header,
+                         * which errs on the side of not evacuating */
+                        if (!u)
+                            ; /* not in this pool */
+                        else if (!pass)
+                            u->live += aligned_size(b, Buffer_buflen(b))
+                                + (PObj_aligned_TEST(b) ? BUFFER_ALIGN_1 : 0);
+                        else if (u->evacuate)
+                            cur_spot = move_buffer(interp, b, cur_spot);
+                    }
+
+                    b = (Buffer *)((char *)b + header_pool->object_size);
+                }
+            }
+        }
+
+        if (pass)
+            break;
+
+        for (i = 0; i < num_blocks; ++i) {
+            Memory_Block * const block = usage[i].block;
+            const size_t         used  = block->size - block->free;
+
+            /* an empty top block is where the next allocations go */
+            if (block == pool->top_block && !used)
+                continue;
+
+            if (usage[i].live <= used * EVACUATION_FACTOR) {
+                usage[i].evacuate = 1;
+                to_move          += usage[i].live;
+                ++evacuated;
+
+                if (block == pool->top_block)
+                    top_evacuated = 1;
+            }
+        }
+
+        if (!evacuated)
+            break;
+
+        /* the new block becomes the top block; it is not in the table, so
+         * nothing is moved twice */
+        if (to_move || top_evacuated) {
+            alloc_new_block(interp, to_move + BUFFER_ALIGN_1, pool,
+                    "inside evacuation");
+            new_block = pool->top_block;
+            cur_spot  = new_block->start;
+        }
+
+        /* the evacuated blocks only hold garbage */
+        if (!to_move)
+            break;
+    }
+
+    if (new_block) {
+        new_block->top  = cur_spot;
+        new_block->free = new_block->size - (cur_spot - new_block->start);
+
+        PARROT_ASSERT(new_block->size >= (size_t)(cur_spot - new_block->start));
+
+        mem_pools->memory_collected += cur_spot - new_block->start;
+    }
+
+    /* free the evacuated blocks */
+    for (i = 0; i < num_blocks; ++i) {
+        Memory_Block * const block = usage[i].block;
+
+        if (!usage[i].evacuate)
+            continue;
+
+        if (block->prev)
+            block->prev->next = block->next;
+        if (block->next)
+            block->next->prev = block->prev;
+
+        PARROT_ASSERT(block != pool->top_block);
+
+        mem_pools->memory_allocated -= block->size;
+        pool->total_allocated       -= block->size;
+        mem_internal_free(block);
+    }
+
+    mem_sys_free(usage);
+
+    pool->guaranteed_reclaimable = 0;
+    pool->possibly_reclaimable   = 0;
+
+    --mem_pools->gc_sweep_block_level;
+    Parrot_gc_event_end(interp, event);
+}
+
+/*
+
+=item C<static int block_usage_cmp(const void *a, const void *b)>
+
+C<qsort> comparison function ordering C<Block_Usage> entries by the address
+of their blocks.
+
+=cut
+
+*/
+
+static int
+block_usage_cmp(ARGIN(const void *a), ARGIN(const void *b))
+{
+    ASSERT_ARGS(block_usage_cmp)
+    const char * const start_a = ((const Block_Usage *)a)->block->start;
+    const char * const start_b = ((const Block_Usage *)b)->block->start;
+
+    return start_a < start_b ? -1 : start_a > start_b;
+}
+
+/*
+
+=item C<static Block_Usage * find_block_usage(Block_Usage *usage, size_t n,
+const char *ptr)>
+
+Returns the entry of the sorted C<usage> table whose block contains C<ptr>,
+or NULL if none does.
+
+=cut
+
+*/
+
+PARROT_CAN_RETURN_NULL
+PARROT_WARN_UNUSED_RESULT
+static Block_Usage *
+find_block_usage(ARGIN(Block_Usage *usage), size_t n, ARGIN(const char *ptr))
+{
+    ASSERT_ARGS(find_block_usage)
+    size_t lo = 0;
+    size_t hi = n;
+
+    while (lo < hi) {
+        const size_t        mid   = lo + (hi - lo) / 2;
+        const Memory_Block *block = usage[mid].block;
+
+        if (ptr < block->start)
+            hi = mid;
+        else if (ptr >= block->start + block->size)
+            lo = mid + 1;
+        else
+            return usage + mid;
+    }
+
+    return NULL;
 }
 
 /*
@@ -48,17 +48,18 @@ This file implements handling logic for strings and arbitrary-sized memory
 buffers. String storage is managed by special Variable_Size_Pool structures, and use
 a separate compacting garbage collector to keep track of them.
 
-=item F<src/gc/incremental_ms.c>
+=item F<src/gc/gc_ms.c>
 
-=item F<src/gc/generational_ms.c>
+=item F<src/gc/gc_gms.c>
 
-=item F<src/gc/gc_ms.c>
+=item F<src/gc/gc_inf.c>
 
 These files are the individual GC cores which implement the primary tracing
 and sweeping logic. gc_ms.c is the mark & sweep collector core which is used in
-Parrot by default. generational_ms.c is an experimental and incomplete
-generational core.  incremental_ms.c is an experimental and incomplete
-incremental collector core.
+Parrot by default. gc_gms.c is a generational mark & sweep core built on top
+of it, which only traces young objects on most runs. gc_inf.c is the
+"infinite memory" core, which never collects anything. A core other than the
+default can be chosen with the C<PARROT_GC_CORE> environment variable.
 
 =item F<src/gc/mark_sweep.c>
 
@@ -95,6 +96,7 @@ implementation, and malloc wrappers for various purposes. These are unused.
 #include "parrot/parrot.h"
 #include "parrot/gc_api.h"
 #include "gc_private.h"
+#include "../string/encoding/utf8.h"
 
 /* HEADERIZER HFILE: include/parrot/gc_api.h */
 
@@ -118,6 +120,11 @@ static void * get_free_buffer(PARROT_INTERP, ARGIN(Fixed_Size_Pool *pool))
         __attribute__nonnull__(1)
         __attribute__nonnull__(2);
 
+static int get_evacuate_from_env(void);
+static UINTVAL get_gc_ratio_from_env(void);
+static gc_sys_type_enum get_gc_sys_type_from_env(void);
+static int get_lazy_sweep_from_env(void);
+static size_t get_max_heap_from_env(void);
 static void Parrot_gc_merge_buffer_pools(PARROT_INTERP,
     ARGMOD(Fixed_Size_Pool *dest),
     ARGMOD(Fixed_Size_Pool *source))
@@ -152,6 +159,11 @@ static int sweep_cb_pmc(PARROT_INTERP,
 #define ASSERT_ARGS_get_free_buffer __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
        PARROT_ASSERT_ARG(interp) \
     , PARROT_ASSERT_ARG(pool))
+#define ASSERT_ARGS_get_evacuate_from_env __attribute__unused__ int _ASSERT_ARGS_CHECK = (0)
+#define ASSERT_ARGS_get_gc_ratio_from_env __attribute__unused__ int _ASSERT_ARGS_CHECK = (0)
+#define ASSERT_ARGS_get_gc_sys_type_from_env __attribute__unused__ int _ASSERT_ARGS_CHECK = (0)
+#define ASSERT_ARGS_get_lazy_sweep_from_env __attribute__unused__ int _ASSERT_ARGS_CHECK = (0)
+#define ASSERT_ARGS_get_max_heap_from_env __attribute__unused__ int _ASSERT_ARGS_CHECK = (0)
 #define ASSERT_ARGS_Parrot_gc_merge_buffer_pools __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
        PARROT_ASSERT_ARG(interp) \
     , PARROT_ASSERT_ARG(dest) \
@@ -206,6 +218,10 @@ Parrot_gc_mark_PObj_alive(PARROT_INTERP, ARGMOD(PObj *obj))
 
 #  endif
 #endif
+    if (interp->mem_pools->mark_workers
+    &&  Parrot_gc_parallel_mark_PObj(interp, obj))
+        return;
+
     /* mark it live */
     PObj_live_SET(obj);
 
@@ -250,6 +266,10 @@ Parrot_gc_mark_PMC_alive_fun(PARROT_INTERP, ARGMOD_NULLOK(PMC *obj))
         if (PObj_is_live_or_free_TESTALL(obj))
             return;
 
+        if (interp->mem_pools->mark_workers
+        &&  Parrot_gc_parallel_mark_PObj(interp, (PObj *)obj))
+            return;
+
         /* mark it live */
         PObj_live_SET(obj);
 
@@ -287,6 +307,85 @@ Parrot_gc_mark_STRING_alive_fun(PARROT_INTERP, ARGMOD_NULLOK(STRING *obj))
 
 /*
 
+=item C<void Parrot_gc_set_ratio(PARROT_INTERP, UINTVAL ratio)>
+
+Sets how far the PMC pool may grow between two collections, in percent of
+the PMCs which survived the last one; see F<src/gc/pacing.c>. A ratio of 0
+returns to the fixed heuristics. Used by the I<--gc-ratio> option.
+
+=cut
+
+*/
+
+PARROT_EXPORT
+void
+Parrot_gc_set_ratio(PARROT_INTERP, UINTVAL ratio)
+{
+    ASSERT_ARGS(Parrot_gc_set_ratio)
+    Parrot_gc_pacing_set_ratio(interp, ratio);
+}
+
+/*
+
+=item C<PMC * Parrot_gc_event_log(PARROT_INTERP)>
+
+Returns an array of hashes describing the most recent collections and
+compactions, oldest first, if C<PARROT_GC_LOG> or C<PARROT_GC_LOG_SIZE> is
+set; see F<src/gc/event_log.c>. The array is empty otherwise.
+
+=item C<void Parrot_gc_write_event_log(PARROT_INTERP)>
+
+Appends the logged collections to the file named by C<PARROT_GC_LOG>.
+Called when the interpreter is destroyed.
+
+=cut
+
+*/
+
+PARROT_EXPORT
+PARROT_WARN_UNUSED_RESULT
+PARROT_CANNOT_RETURN_NULL
+PMC *
+Parrot_gc_event_log(PARROT_INTERP)
+{
+    ASSERT_ARGS(Parrot_gc_event_log)
+    return Parrot_gc_event_log_pmc(interp);
+}
+
+void
+Parrot_gc_write_event_log(PARROT_INTERP)
+{
+    ASSERT_ARGS(Parrot_gc_write_event_log)
+    Parrot_gc_event_log_write(interp);
+}
+
+/*
+
+=item C<void Parrot_gc_write_barrier(PARROT_INTERP, PMC *agg, PMC *old, PMC
+*_new)>
+
+The slow path of the C<GC_WRITE_BARRIER> macro, called when C<_new> has been
+stored into an aggregate C<agg> that a generational GC core has promoted to
+the old generation. Hands C<agg> to the current GC core, so that the next
+collection traces it again.
+
+=cut
+
+*/
+
+PARROT_EXPORT
+void
+Parrot_gc_write_barrier(PARROT_INTERP, ARGIN(PMC *agg),
+    SHIM(PMC *old), SHIM(PMC *_new))
+{
+    ASSERT_ARGS(Parrot_gc_write_barrier)
+
+    if (interp->gc_sys->write_barrier)
+        interp->gc_sys->write_barrier(interp, agg);
+}
+
+/*
+
 =item C<void Parrot_gc_initialize(PARROT_INTERP, void *stacktop)>
 
 Initializes the memory allocator and the garbage collection subsystem.
@@ -310,16 +409,17 @@ Parrot_gc_initialize(PARROT_INTERP, ARGIN(void *stacktop))
     interp->mem_pools->num_attribs = 0;
     interp->mem_pools->attrib_pools = NULL;
     interp->mem_pools->sized_header_pools = NULL;
+    interp->mem_pools->max_heap = get_max_heap_from_env();
+    Parrot_gc_pacing_set_ratio(interp, get_gc_ratio_from_env());
+    Parrot_gc_event_log_init(interp);
 
     interp->lo_var_ptr                     = stacktop;
 
     interp->gc_sys = mem_allocate_zeroed_typed(GC_Subsystem);
 
-    /*TODO: add ability to specify GC core at command line w/ --gc= */
-    if (0) /*If they chose sys_type with the --gc command line switch,*/
-        ; /* set sys_type to value they gave */
-    else
-        interp->gc_sys->sys_type = PARROT_GC_DEFAULT_TYPE;
+    /* The GC is up before the command line is parsed, so the core is
+     * chosen through the environment */
+    interp->gc_sys->sys_type = get_gc_sys_type_from_env();
 
     /*Call appropriate initialization function for GC subsystem*/
     switch (interp->gc_sys->sys_type) {
@@ -329,13 +429,210 @@ Parrot_gc_initialize(PARROT_INTERP, ARGIN(void *stacktop))
       case INF:
         Parrot_gc_inf_init(interp);
         break;
+      case GMS:
+        Parrot_gc_gms_init(interp);
+        break;
       default:
         /*die horribly because of invalid GC core specified*/
         break;
     }
 
+    if (interp->gc_sys->sys_type == MS) {
+        Parrot_gc_parallel_mark_init(interp);
+        interp->mem_pools->lazy_sweep = get_lazy_sweep_from_env();
+    }
+
     initialize_var_size_pools(interp);
     initialize_fixed_size_pools(interp);
+
+    if (get_evacuate_from_env())
+        interp->mem_pools->memory_pool->compact = evacuate_fragmented_blocks;
+}
+
+/*
+
+=item C<static gc_sys_type_enum get_gc_sys_type_from_env(void)>
+
+Returns the GC core named by the C<PARROT_GC_CORE> environment variable:
+C<ms>, C<gms> or C<inf>. Returns C<PARROT_GC_DEFAULT_TYPE> if the variable
+is unset or names an unknown core.
+
+=cut
+
+*/
+
+static gc_sys_type_enum
+get_gc_sys_type_from_env(void)
+{
+    ASSERT_ARGS(get_gc_sys_type_from_env)
+    gc_sys_type_enum type = PARROT_GC_DEFAULT_TYPE;
+    int              free_it;
+    char * const     name = Parrot_getenv("PARROT_GC_CORE", &free_it);
+
+    if (!name)
+        return type;
+
+    if (STREQ(name, "ms"))
+        type = MS;
+    else if (STREQ(name, "gms"))
+        type = GMS;
+    else if (STREQ(name, "inf"))
+        type = INF;
+    else if (*name)
+        fprintf(stderr, "PARROT_GC_CORE: unknown GC core '%s' ignored\n",
+                name);
+
+    if (free_it)
+        mem_sys_free(name);
+
+    return type;
+}
+
+/*
+
+=item C<static int get_evacuate_from_env(void)>
+
+Returns whether the C<PARROT_GC_COMPACT> environment variable asks for the
+string memory to be compacted by evacuating fragmented blocks (C<evacuate>)
+rather than by copying all of it (C<copy>, the default).
+
+=cut
+
+*/
+
+static int
+get_evacuate_from_env(void)
+{
+    ASSERT_ARGS(get_evacuate_from_env)
+    int          free_it;
+    char * const name = Parrot_getenv("PARROT_GC_COMPACT", &free_it);
+    int          evacuate = 0;
+
+    if (!name)
+        return 0;
+
+    if (STREQ(name, "evacuate"))
+        evacuate = 1;
+    else if (*name && !STREQ(name, "copy"))
+        fprintf(stderr, "PARROT_GC_COMPACT: unknown compaction '%s' ignored\n",
+                name);
+
+    if (free_it)
+        mem_sys_free(name);
+
+    return evacuate;
+}
+
+/*
+
+=item C<static UINTVAL get_gc_ratio_from_env(void)>
+
+Returns the PMC pool growth ratio in percent given by the C<PARROT_GC_RATIO>
+environment variable, or 0 for the fixed heuristics if it is unset.
+
+=cut
+
+*/
+
+static UINTVAL
+get_gc_ratio_from_env(void)
+{
+    ASSERT_ARGS(get_gc_ratio_from_env)
+    int          free_it;
+    char * const value = Parrot_getenv("PARROT_GC_RATIO", &free_it);
+    int          ratio;
+
+    if (!value)
+        return 0;
+
+    ratio = atoi(value);
+
+    if (ratio < 0) {
+        fprintf(stderr, "PARROT_GC_RATIO: negative ratio '%s' ignored\n",
+                value);
+        ratio = 0;
+    }
+
+    if (free_it)
+        mem_sys_free(value);
+
+    return (UINTVAL)ratio;
+}
+
+/*
+
+=item C<static int get_lazy_sweep_from_env(void)>
+
+Returns whether the C<PARROT_GC_LAZY_SWEEP> environment variable asks the MS
+core to sweep lazily.
+
+=cut
+
+*/
+
+static int
+get_lazy_sweep_from_env(void)
+{
+    ASSERT_ARGS(get_lazy_sweep_from_env)
+    int          free_it;
+    char * const value = Parrot_getenv("PARROT_GC_LAZY_SWEEP", &free_it);
+    int          lazy;
+
+    if (!value)
+        return 0;
+
+    lazy = atoi(value) != 0;
+
+    if (free_it)
+        mem_sys_free(value);
+
+    return lazy;
+}
+
+/*
+
+=item C<static size_t get_max_heap_from_env(void)>
+
+Returns the maximum heap size in bytes given by the C<PARROT_GC_MAX_HEAP>
+environment variable, which may end in C<k>, C<m> or C<g>. Returns 0, no
+limit, if the variable is unset.
+
+=cut
+
+*/
+
+static size_t
+get_max_heap_from_env(void)
+{
+    ASSERT_ARGS(get_max_heap_from_env)
+    int          free_it;
+    char * const value = Parrot_getenv("PARROT_GC_MAX_HEAP", &free_it);
+    char        *end;
+    size_t       max_heap;
+
+    if (!value)
+        return 0;
+
+    max_heap = strtoul(value, &end, 10);
+
+    switch (*end) {
+      case 'g': case 'G':
+        max_heap *= 1024;
+        /* fall through */
+      case 'm': case 'M':
+        max_heap *= 1024;
+        /* fall through */
+      case 'k': case 'K':
+        max_heap *= 1024;
+        break;
+      default:
+        break;
+    }
+
+    if (free_it)
+        mem_sys_free(value);
+
+    return max_heap;
 }
 
 /*
@@ -343,7 +640,7 @@ Parrot_gc_initialize(PARROT_INTERP, ARGIN(void *stacktop))
 =item C<void Parrot_gc_finalize(PARROT_INTERP)>
 
 Finalize the GC system, if the current GC core has defined a finalization
-routine.
+routine. Stops the threads for parallel marking and frees the event log.
 
 =cut
 
@@ -355,6 +652,9 @@ Parrot_gc_finalize(PARROT_INTERP)
     ASSERT_ARGS(Parrot_gc_finalize)
     if (interp->gc_sys->finalize_gc_system)
         interp->gc_sys->finalize_gc_system(interp);
+
+    Parrot_gc_parallel_mark_destroy(interp);
+    Parrot_gc_event_log_destroy(interp);
 }
 
 
@@ -523,6 +823,9 @@ void
 Parrot_gc_free_string_header(PARROT_INTERP, ARGMOD(STRING *s))
 {
     ASSERT_ARGS(Parrot_gc_free_string_header)
+    if (PObj_get_FLAGS(s) & STRING_indexed_FLAG)
+        Parrot_utf8_forget_index(interp, s);
+
     if (!PObj_constant_TEST(s)) {
         Fixed_Size_Pool * const pool = interp->mem_pools->string_header_pool;
         pool->add_free_object(interp, pool, s);
@@ -854,7 +1157,8 @@ Parrot_gc_mark_and_sweep(PARROT_INTERP, UINTVAL flags)
 
 Scan the string pools and compact them. This does not perform a GC mark or
 sweep run, and does not check whether string buffers are still alive.
-Redirects to C<compact_pool>.
+Redirects to the compaction function of the memory pool, C<compact_pool>
+or C<evacuate_fragmented_blocks>.
 
 =cut
 
@@ -864,7 +1168,9 @@ void
 Parrot_gc_compact_memory_pool(PARROT_INTERP)
 {
     ASSERT_ARGS(Parrot_gc_compact_memory_pool)
-    compact_pool(interp, interp->mem_pools->memory_pool);
+    Variable_Size_Pool * const pool = interp->mem_pools->memory_pool;
+
+    (*pool->compact)(interp, pool);
 }
 
 /*
@@ -889,6 +1195,9 @@ Parrot_gc_merge_header_pools(ARGMOD(Interp *dest_interp),
     Memory_Pools * const source_arena = source_interp->mem_pools;
     UINTVAL        i;
 
+    if (source_arena->lazy_sweep)
+        Parrot_gc_finish_lazy_sweeps(source_interp);
+
     /* heavily borrowed from forall_header_pools */
     fix_pmc_syncs(dest_interp, source_arena->constant_pmc_pool);
     Parrot_gc_merge_buffer_pools(dest_interp, dest_arena->constant_pmc_pool,
@@ -926,7 +1235,8 @@ Parrot_gc_merge_header_pools(ARGMOD(Interp *dest_interp),
 *dest, Fixed_Size_Pool *source)>
 
 Merge pool C<source> into pool C<dest>. Combines the free lists directly,
-moves all arenas to the new pool, and remove the old pool. To merge, the
+moves all arenas to the new pool, and remove the old pool. The bump region
+of C<dest> is closed, as its arena is no longer the newest one. To merge, the
 two pools must have the same object size, and the same name (if they have
 names).
 
@@ -948,6 +1258,23 @@ Parrot_gc_merge_buffer_pools(PARROT_INTERP,
 
     dest->total_objects += source->total_objects;
 
+#if GC_USE_LAZY_ALLOCATOR
+    /* the source arenas go after the one holding the bump region of dest,
+     * which thus has to move the rest of its objects to the free list */
+    if (dest->newfree) {
+        Fixed_Size_Arena * const arena = dest->last_Arena;
+        char                    *obj   = (char *)dest->newfree;
+
+        while (obj < (char *)dest->newlast) {
+            arena->used++;
+            dest->add_free_object(interp, dest, obj);
+            obj += dest->object_size;
+        }
+
+        dest->newfree = NULL;
+    }
+#endif
+
     /* append new free_list to old */
     /* XXX this won't work with, e.g., gc_gms */
     free_list_end = dest->free_list;
@@ -973,7 +1300,7 @@ Parrot_gc_merge_buffer_pools(PARROT_INTERP,
         total_objects   = cur_arena->total_objects;
 
         Parrot_append_arena_in_pool(interp, dest, cur_arena,
-            cur_arena->total_objects);
+            cur_arena->total_objects * dest->object_size);
 
         /* XXX needed? */
         cur_arena->total_objects = total_objects;
@@ -1315,7 +1642,8 @@ Parrot_gc_get_pmc_index(PARROT_INTERP, ARGIN(PMC* pmc))
 
 =item C<int Parrot_gc_active_sized_buffers(PARROT_INTERP)>
 
-Returns the number of actively used sized buffers.
+Returns the number of actively used sized buffers. Finishes a pending lazy
+sweep first, so that the count is exact.
 
 =cut
 
@@ -1327,6 +1655,10 @@ Parrot_gc_active_sized_buffers(PARROT_INTERP)
     ASSERT_ARGS(Parrot_gc_active_sized_buffers)
     int j, ret = 0;
     const Memory_Pools * const mem_pools = interp->mem_pools;
+
+    if (mem_pools->lazy_sweep)
+        Parrot_gc_finish_lazy_sweeps(interp);
+
     for (j = 0; j < (INTVAL)mem_pools->num_sized; j++) {
         Fixed_Size_Pool * const header_pool =
             mem_pools->sized_header_pools[j];
@@ -1366,7 +1698,8 @@ Parrot_gc_total_sized_buffers(PARROT_INTERP)
 
 =item C<int Parrot_gc_active_pmcs(PARROT_INTERP)>
 
-Return the number of actively used PMCs.
+Return the number of actively used PMCs. Finishes a pending lazy sweep
+first, so that the count is exact.
 
 =cut
 
@@ -1376,7 +1709,11 @@ int
 Parrot_gc_active_pmcs(PARROT_INTERP)
 {
     ASSERT_ARGS(Parrot_gc_active_pmcs)
-    const Memory_Pools * const mem_pools = interp->mem_pools;
+    Memory_Pools * const mem_pools = interp->mem_pools;
+
+    if (mem_pools->pmc_pool->sweep_arena)
+        Parrot_gc_lazy_sweep_finish(interp, mem_pools->pmc_pool);
+
     return mem_pools->pmc_pool->total_objects -
            mem_pools->pmc_pool->num_free_objects;
 }
@@ -1413,6 +1750,16 @@ Return the number of collect runs the GC has performed.
 
 Return the number of lazy mark runs the GC has performed.
 
+=item C<size_t Parrot_gc_count_lazy_sweep_arenas(PARROT_INTERP)>
+
+Return the number of arenas swept on allocation by a lazy sweep.
+
+=item C<size_t Parrot_gc_count_forced_sweep_arenas(PARROT_INTERP)>
+
+Return the number of arenas whose lazy sweep had to be finished by the next
+collection or by a statistics request, because allocation did not get to
+them first.
+
 =item C<size_t Parrot_gc_total_memory_allocated(PARROT_INTERP)>
 
 Return the total number of memory allocations made by the GC.
@@ -1431,6 +1778,23 @@ Return the number of memory allocations made since the last collection run.
 
 Returns the number of PMCs that are marked as needing timely destruction.
 
+=item C<UINTVAL Parrot_gc_ratio(PARROT_INTERP)>
+
+Returns the heap growth ratio set with C<Parrot_gc_set_ratio>, 0 if the
+fixed heuristics decide when to collect.
+
+=item C<UINTVAL Parrot_gc_survival_rate(PARROT_INTERP)>
+
+Returns the percentage of the PMCs in use when the last sweep began which
+survived it.
+
+=item C<size_t Parrot_gc_pmc_threshold(PARROT_INTERP)>
+
+Returns the number of PMC headers at which the ratio pacer collects next, 0
+if the fixed heuristics decide.
+
+Both finish a pending lazy sweep first, as the sweep sets them.
+
 */
 
 size_t
@@ -1457,6 +1821,22 @@ Parrot_gc_count_lazy_mark_runs(PARROT_INTERP)
     return mem_pools->gc_lazy_mark_runs;;
 }
 
+size_t
+Parrot_gc_count_lazy_sweep_arenas(PARROT_INTERP)
+{
+    ASSERT_ARGS(Parrot_gc_count_lazy_sweep_arenas)
+    const Memory_Pools * const mem_pools = interp->mem_pools;
+    return mem_pools->gc_lazy_sweep_arenas;
+}
+
+size_t
+Parrot_gc_count_forced_sweep_arenas(PARROT_INTERP)
+{
+    ASSERT_ARGS(Parrot_gc_count_forced_sweep_arenas)
+    const Memory_Pools * const mem_pools = interp->mem_pools;
+    return mem_pools->gc_forced_sweep_arenas;
+}
+
 size_t
 Parrot_gc_total_memory_allocated(PARROT_INTERP)
 {
@@ -1497,6 +1877,44 @@ Parrot_gc_impatient_pmcs(PARROT_INTERP)
     return mem_pools->num_early_gc_PMCs;
 }
 
+UINTVAL
+Parrot_gc_ratio(PARROT_INTERP)
+{
+    ASSERT_ARGS(Parrot_gc_ratio)
+    const Memory_Pools * const mem_pools = interp->mem_pools;
+    return mem_pools->gc_ratio;
+}
+
+UINTVAL
+Parrot_gc_survival_rate(PARROT_INTERP)
+{
+    ASSERT_ARGS(Parrot_gc_survival_rate)
+    const Memory_Pools * const mem_pools = interp->mem_pools;
+
+    if (mem_pools->lazy_sweep)
+        Parrot_gc_finish_lazy_sweeps(interp);
+
+    if (!mem_pools->gc_headers_in_use)
+        return 0;
+
+    return mem_pools->gc_headers_survived * 100 / mem_pools->gc_headers_in_use;
+}
+
+size_t
+Parrot_gc_pmc_threshold(PARROT_INTERP)
+{
+    ASSERT_ARGS(Parrot_gc_pmc_threshold)
+    const Memory_Pools * const mem_pools = interp->mem_pools;
+
+    if (!mem_pools->gc_ratio)
+        return 0;
+
+    if (mem_pools->lazy_sweep)
+        Parrot_gc_finish_lazy_sweeps(interp);
+
+    return mem_pools->pmc_pool->gc_threshold;
+}
+
 /*
 
 =item C<void Parrot_block_GC_mark(PARROT_INTERP)>
@@ -0,0 +1,435 @@
+/*
+Copyright (C) 2001-2009, Parrot Foundation.
+$Id$
+
+=head1 NAME
+
+src/gc/event_log.c - A log of garbage collections
+
+=head1 DESCRIPTION
+
+The counters of F<src/gc/api.c> tell how much the collector did in total,
+but not when. To find out whether a latency spike was a collection, the MS
+and GMS cores can log every collection and memory compaction as an
+I<event>: when it started and ended, the PMC and buffer headers and the
+buffer memory before and after it, the bytes compacted, and the headers
+found on the C stack.
+
+The events are kept in a ring buffer, so a long running program keeps the
+most recent ones. The log is disabled by default. The C<PARROT_GC_LOG_SIZE>
+environment variable enables it and sets the number of events kept, 1024
+if only C<PARROT_GC_LOG> is set. C<PARROT_GC_LOG> names a file the events
+are appended to when the interpreter exits, one line per event.
+
+PIR reads the events through C<interpinfo .INTERPINFO_GC_EVENTS>, which
+returns an array of hashes, oldest event first. The keys of a hash are the
+columns of the log file:
+
+=over 4
+
+=item number
+
+Sequence number of the event, counting from 0.
+
+=item type
+
+C<mark> for a collection, C<lazy mark> for a collection which may stop as
+soon as all PMCs needing timely destruction are found, C<compact> for a
+compaction of the buffer memory. A collection compacts the memory before
+its mark; that compaction is part of the collection's event.
+
+=item start, end
+
+Seconds since the epoch, as returned by the C<time> op.
+
+=item pmcs_before, pmcs_after, buffers_before, buffers_after
+
+PMC and buffer headers in the pools, whether in use or free.
+
+=item pmcs_freed, buffers_freed
+
+Headers freed. With C<PARROT_GC_LAZY_SWEEP> most arenas are swept after the
+collection, and their headers don't count here.
+
+=item memory_before, memory_after
+
+Bytes allocated for buffer memory.
+
+=item bytes_copied
+
+Buffer memory moved by the compaction.
+
+=item stack_roots
+
+Words on the C stack and in the registers which looked like pointers to
+headers, and kept them alive.
+
+=back
+
+=cut
+
+*/
+
+#include "parrot/parrot.h"
+#include "gc_private.h"
+#include "event_log.str"
+
+/* HEADERIZER HFILE: src/gc/gc_private.h */
+
+/* Events kept if PARROT_GC_LOG is set, but not PARROT_GC_LOG_SIZE */
+#define GC_EVENT_LOG_DEFAULT_SIZE 1024
+
+#define GC_EVENT_FREED(before, after) \
+    ((before) > (after) ? (before) - (after) : 0)
+
+static const char * const event_type_names[] = {
+    "mark",
+    "lazy mark",
+    "compact"
+};
+
+/* HEADERIZER BEGIN: static */
+/* Don't modify between HEADERIZER BEGIN / HEADERIZER END.  Your changes will be lost. */
+
+static void take_heap_stats(PARROT_INTERP, ARGOUT(GC_Heap_Stats *stats))
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2)
+        FUNC_MODIFIES(*stats);
+
+#define ASSERT_ARGS_take_heap_stats __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp) \
+    , PARROT_ASSERT_ARG(stats))
+/* Don't modify between HEADERIZER BEGIN / HEADERIZER END.  Your changes will be lost. */
+/* HEADERIZER END: static */
+
+/*
+
+=head2 Functions
+
+=over 4
+
+=item C<void Parrot_gc_event_log_init(PARROT_INTERP)>
+
+Reads C<PARROT_GC_LOG> and C<PARROT_GC_LOG_SIZE> and, if either is set,
+allocates the ring buffer of events.
+
+=cut
+
+*/
+
+void
+Parrot_gc_event_log_init(PARROT_INTERP)
+{
+    ASSERT_ARGS(Parrot_gc_event_log_init)
+    int           free_file, free_size;
+    char * const  file  = Parrot_getenv("PARROT_GC_LOG", &free_file);
+    char * const  value = Parrot_getenv("PARROT_GC_LOG_SIZE", &free_size);
+    long          size  = value ? atol(value) : GC_EVENT_LOG_DEFAULT_SIZE;
+    GC_Event_Log *log;
+
+    if (free_size)
+        mem_sys_free(value);
+
+    if (!file && !value)
+        return;
+
+    if (size < 1)
+        size = 1;
+
+    log         = mem_internal_allocate_zeroed_typed(GC_Event_Log);
+    log->size   = (size_t)size;
+    log->events = (GC_Event *)mem_internal_allocate_zeroed(
+                        log->size * sizeof (GC_Event));
+
+    if (file && *file)
+        log->file = mem_sys_strdup(file);
+
+    if (free_file)
+        mem_sys_free(file);
+
+    interp->mem_pools->event_log = log;
+}
+
+/*
+
+=item C<void Parrot_gc_event_log_destroy(PARROT_INTERP)>
+
+Frees the event log.
+
+=cut
+
+*/
+
+void
+Parrot_gc_event_log_destroy(PARROT_INTERP)
+{
+    ASSERT_ARGS(Parrot_gc_event_log_destroy)
+    GC_Event_Log * const log = interp->mem_pools->event_log;
+
+    if (!log)
+        return;
+
+    if (log->file)
+        mem_sys_free(log->file);
+
+    mem_internal_free(log->events);
+    mem_internal_free(log);
+    interp->mem_pools->event_log = NULL;
+}
+
+/*
+
+=item C<GC_Event * Parrot_gc_event_begin(PARROT_INTERP, GC_Event_type type)>
+
+Starts an event of the given type in the next slot of the ring buffer,
+overwriting the oldest event if the buffer is full. Returns the event to
+pass to C<Parrot_gc_event_end>, or C<NULL> if the log is disabled or
+another event is in progress, which then includes this one.
+
+=cut
+
+*/
+
+PARROT_CAN_RETURN_NULL
+GC_Event *
+Parrot_gc_event_begin(PARROT_INTERP, GC_Event_type type)
+{
+    ASSERT_ARGS(Parrot_gc_event_begin)
+    GC_Event_Log * const log = interp->mem_pools->event_log;
+    GC_Event            *event;
+
+    if (!log || log->current)
+        return NULL;
+
+    event         = &log->events[log->num_events % log->size];
+    event->type   = type;
+    event->number = log->num_events++;
+    event->end    = 0.0;
+    take_heap_stats(interp, &event->before);
+    event->start  = Parrot_floatval_time();
+    log->current  = event;
+
+    return event;
+}
+
+/*
+
+=item C<void Parrot_gc_event_end(PARROT_INTERP, GC_Event *event)>
+
+Ends an event returned by C<Parrot_gc_event_begin>. Does nothing if
+C<event> is C<NULL>.
+
+=cut
+
+*/
+
+void
+Parrot_gc_event_end(PARROT_INTERP, ARGMOD_NULLOK(GC_Event *event))
+{
+    ASSERT_ARGS(Parrot_gc_event_end)
+
+    if (!event)
+        return;
+
+    event->end = Parrot_floatval_time();
+    take_heap_stats(interp, &event->after);
+    interp->mem_pools->event_log->current = NULL;
+}
+
+/*
+
+=item C<void Parrot_gc_event_log_write(PARROT_INTERP)>
+
+Appends the events in the log to the file named by C<PARROT_GC_LOG>, if
+any. The events are preceded by a comment naming the interpreter and a
+comment naming the tab separated columns.
+
+=cut
+
+*/
+
+void
+Parrot_gc_event_log_write(PARROT_INTERP)
+{
+    ASSERT_ARGS(Parrot_gc_event_log_write)
+    GC_Event_Log * const log = interp->mem_pools->event_log;
+    FILE                *out;
+    UINTVAL              n;
+
+    if (!log || !log->file)
+        return;
+
+    out = fopen(log->file, "a");
+
+    if (!out) {
+        fprintf(stderr, "PARROT_GC_LOG: can't write to '%s'\n", log->file);
+        return;
+    }
+
+    fprintf(out, "# GC events of interpreter %p\n", (void *)interp);
+    fprintf(out, "# number\ttype\tstart\tend"
+            "\tpmcs_before\tpmcs_after\tpmcs_freed"
+            "\tbuffers_before\tbuffers_after\tbuffers_freed"
+            "\tmemory_before\tmemory_after\tbytes_copied\tstack_roots\n");
+
+    n = log->num_events > log->size ? log->num_events - log->size : 0;
+
+    for (; n < log->num_events; ++n) {
+        const GC_Event * const e = &log->events[n % log->size];
+
+        fprintf(out, "%lu\t%s\t%.6f\t%.6f"
+                "\t%lu\t%lu\t%lu\t%lu\t%lu\t%lu\t%lu\t%lu\t%lu\t%lu\n",
+                (unsigned long)e->number, event_type_names[e->type],
+                (double)e->start, (double)e->end,
+                (unsigned long)e->before.pmcs, (unsigned long)e->after.pmcs,
+                (unsigned long)GC_EVENT_FREED(e->before.pmcs_in_use,
+                                              e->after.pmcs_in_use),
+                (unsigned long)e->before.buffers,
+                (unsigned long)e->after.buffers,
+                (unsigned long)GC_EVENT_FREED(e->before.buffers_in_use,
+                                              e->after.buffers_in_use),
+                (unsigned long)e->before.memory, (unsigned long)e->after.memory,
+                (unsigned long)(e->after.copied - e->before.copied),
+                (unsigned long)(e->after.stack_roots - e->before.stack_roots));
+    }
+
+    fclose(out);
+}
+
+/*
+
+=item C<PMC * Parrot_gc_event_log_pmc(PARROT_INTERP)>
+
+Returns a new array holding a hash for each event in the log, oldest first.
+The array is empty if the log is disabled.
+
+=cut
+
+*/
+
+PARROT_CANNOT_RETURN_NULL
+PMC *
+Parrot_gc_event_log_pmc(PARROT_INTERP)
+{
+    ASSERT_ARGS(Parrot_gc_event_log_pmc)
+    GC_Event_Log * const log    = interp->mem_pools->event_log;
+    PMC          * const events = pmc_new(interp, enum_class_ResizablePMCArray);
+    UINTVAL              n;
+
+    if (!log)
+        return events;
+
+    /* a collection now would overwrite the events not copied yet */
+    Parrot_block_GC_mark(interp);
+    Parrot_block_GC_sweep(interp);
+
+    n = log->num_events > log->size ? log->num_events - log->size : 0;
+
+    for (; n < log->num_events; ++n) {
+        const GC_Event * const e     = &log->events[n % log->size];
+        PMC            * const event = pmc_new(interp, enum_class_Hash);
+        STRING         * const type  =
+            Parrot_str_new_constant(interp, event_type_names[e->type]);
+
+        const INTVAL pmcs_freed    = GC_EVENT_FREED(e->before.pmcs_in_use,
+                                                    e->after.pmcs_in_use);
+        const INTVAL buffers_freed = GC_EVENT_FREED(e->before.buffers_in_use,
+                                                    e->after.buffers_in_use);
+        const INTVAL copied        = e->after.copied - e->before.copied;
+        const INTVAL roots         = e->after.stack_roots - e->before.stack_roots;
+
+        VTABLE_set_integer_keyed_str(interp, event, CONST_STRING(interp, "number"),
+            e->number);
+        VTABLE_set_string_keyed_str(interp, event, CONST_STRING(interp, "type"), type);
+        VTABLE_set_number_keyed_str(interp, event, CONST_STRING(interp, "start"),
+            e->start);
+        VTABLE_set_number_keyed_str(interp, event, CONST_STRING(interp, "end"),
+            e->end);
+        VTABLE_set_integer_keyed_str(interp, event, CONST_STRING(interp, "pmcs_before"),
+            e->before.pmcs);
+        VTABLE_set_integer_keyed_str(interp, event, CONST_STRING(interp, "pmcs_after"),
+            e->after.pmcs);
+        VTABLE_set_integer_keyed_str(interp, event, CONST_STRING(interp, "pmcs_freed"),
+            pmcs_freed);
+        VTABLE_set_integer_keyed_str(interp, event, CONST_STRING(interp, "buffers_before"),
+            e->before.buffers);
+        VTABLE_set_integer_keyed_str(interp, event, CONST_STRING(interp, "buffers_after"),
+            e->after.buffers);
+        VTABLE_set_integer_keyed_str(interp, event, CONST_STRING(interp, "buffers_freed"),
+            buffers_freed);
+        VTABLE_set_integer_keyed_str(interp, event, CONST_STRING(interp, "memory_before"),
+            e->before.memory);
+        VTABLE_set_integer_keyed_str(interp, event, CONST_STRING(interp, "memory_after"),
+            e->after.memory);
+        VTABLE_set_integer_keyed_str(interp, event, CONST_STRING(interp, "bytes_copied"),
+            copied);
+        VTABLE_set_integer_keyed_str(interp, event, CONST_STRING(interp, "stack_roots"),
+            roots);
+
+        VTABLE_push_pmc(interp, events, event);
+    }
+
+    Parrot_unblock_GC_sweep(interp);
+    Parrot_unblock_GC_mark(interp);
+
+    return events;
+}
+
+/*
+
+=item C<static void take_heap_stats(PARROT_INTERP, GC_Heap_Stats *stats)>
+
+Fills C<stats> with the current size of the heap and the running totals of
+bytes copied and stack roots found.
+
+=cut
+
+*/
+
+static void
+take_heap_stats(PARROT_INTERP, ARGOUT(GC_Heap_Stats *stats))
+{
+    ASSERT_ARGS(take_heap_stats)
+    const Memory_Pools    * const mem_pools = interp->mem_pools;
+    const Fixed_Size_Pool * const pmc_pool  = mem_pools->pmc_pool;
+    size_t                        i;
+
+    stats->pmcs           = pmc_pool->total_objects;
+    stats->pmcs_in_use    = pmc_pool->total_objects - pmc_pool->num_free_objects;
+    stats->buffers        = 0;
+    stats->buffers_in_use = 0;
+
+    for (i = 0; i < mem_pools->num_sized; ++i) {
+        const Fixed_Size_Pool * const pool = mem_pools->sized_header_pools[i];
+
+        if (!pool)
+            continue;
+
+        stats->buffers        += pool->total_objects;
+        stats->buffers_in_use += pool->total_objects - pool->num_free_objects;
+    }
+
+    stats->memory      = mem_pools->memory_allocated;
+    stats->copied      = mem_pools->memory_collected;
+    stats->stack_roots = mem_pools->gc_stack_roots;
+}
+
+/*
+
+=back
+
+=head1 SEE ALSO
+
+F<src/gc/gc_ms.c>, F<src/gc/alloc_resources.c>, F<docs/running.pod>
+
+=cut
+
+*/
+
+
+/*
+ * Local variables:
+ *   c-file-style: "parrot"
+ * End:
+ * vim: expandtab shiftwidth=4:
+ */
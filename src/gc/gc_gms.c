@@ -0,0 +1,976 @@
+/*
+Copyright (C) 2001-2009, Parrot Foundation.
+$Id$
+
+=head1 NAME
+
+src/gc/gc_gms.c - Generational mark & sweep garbage collector
+
+=head1 DESCRIPTION
+
+This code implements a generational mark and sweep collector (GMS) on top of
+the allocator of the MS core in F<src/gc/gc_ms.c>.
+
+Every object that survives a collection is promoted to the old generation
+by setting C<PObj_GC_old_FLAG>. Old objects keep their live bit between
+runs ("sticky mark bits"), so tracing stops as soon as it reaches one of
+them. Objects allocated since the last run are logged in a per-pool
+I<nursery>. A I<minor> collection clears and sets the live bits of the
+nursery only, traces the root set and the I<remembered set>, and then
+sweeps the nursery instead of every arena.
+
+The remembered set holds the old PMCs which may point to young objects. PMCs
+are added to it by C<GC_WRITE_BARRIER>, which follows the stores in the
+C<SETATTR> accessors, in C<set_attrib_num()>, after C<init> in C<pmc_new()>,
+and in the code which stores into attribute structs directly. As pmc2c emits
+the barrier on entry to C<:write> vtable methods, before their stores, a PMC
+stays in the set for one run after the run in which it was added. Old
+C<Context> PMCs are traced by every minor run, as their registers are written
+without any barrier.
+
+A I<major> collection is a full trace and sweep of all the pools, like a
+run of the MS core. It happens for explicit requests (runs not triggered by
+allocation, such as C<sweep 1> or timely destruction), and whenever the old
+generation has grown by C<GMS_MAJOR_GROWTH_FACTOR> since the last major run.
+
+To enable this core, set the C<PARROT_GC_CORE> environment variable to
+C<gms>.
+
+=cut
+
+*/
+
+#include "parrot/parrot.h"
+#include "gc_private.h"
+
+/* HEADERIZER HFILE: src/gc/gc_private.h */
+
+/* Initial number of entries in a nursery or remembered set */
+#define GMS_LIST_INITIAL_SIZE   1024
+
+/* Run a major collection once the old generation has grown by this factor
+ * since the last one ... */
+#define GMS_MAJOR_GROWTH_FACTOR 2
+
+/* ... but not before it holds this many objects */
+#define GMS_MAJOR_MIN_OBJECTS   65536
+
+/* A growable list of objects, used for nurseries and remembered sets */
+typedef struct GMS_Object_List {
+    PObj   **objects;
+    size_t   count;
+    size_t   size;
+} GMS_Object_List;
+
+/* Private state of the GMS core, kept in C<< mem_pools->gc_private >> */
+typedef struct GMS_Private {
+    GMS_Object_List remembered;  /* old PMCs written to during this cycle */
+    GMS_Object_List retained;    /* old PMCs written to during the last one */
+    GMS_Object_List contexts;    /* old Context PMCs */
+
+    size_t num_old;              /* size of the old generation */
+    size_t major_threshold;      /* do a major run at this num_old */
+    int    nursery_ready;        /* nurseries exist after the first run */
+
+    /* the MS hook that GMS builds upon */
+    void  (*ms_init_pool)(PARROT_INTERP, struct Fixed_Size_Pool *);
+} GMS_Private;
+
+#define GMS_PRIVATE(interp) ((GMS_Private *)(interp)->mem_pools->gc_private)
+
+/* The MS allocator, which the GMS one calls. This outlives the GMS state:
+ * the constant pools have no nursery, and keep the GMS allocator. */
+static get_free_object_fn_type gms_ms_get_free_object;
+
+/* HEADERIZER BEGIN: static */
+/* Don't modify between HEADERIZER BEGIN / HEADERIZER END.  Your changes will be lost. */
+
+static int gc_gms_add_nursery_cb(SHIM_INTERP,
+    ARGMOD(Fixed_Size_Pool *pool),
+    SHIM(int flag),
+    SHIM(void *arg))
+        __attribute__nonnull__(2)
+        FUNC_MODIFIES(*pool);
+
+static int gc_gms_clear_live_cb(PARROT_INTERP,
+    ARGMOD(Fixed_Size_Pool *pool),
+    SHIM(int flag),
+    SHIM(void *arg))
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2)
+        FUNC_MODIFIES(*pool);
+
+static int gc_gms_clear_nursery_cb(SHIM_INTERP,
+    ARGMOD(Fixed_Size_Pool *pool),
+    SHIM(int flag),
+    SHIM(void *arg))
+        __attribute__nonnull__(2)
+        FUNC_MODIFIES(*pool);
+
+static void gc_gms_deinit(PARROT_INTERP)
+        __attribute__nonnull__(1);
+
+static int gc_gms_deinit_pool_cb(SHIM_INTERP,
+    ARGMOD(Fixed_Size_Pool *pool),
+    SHIM(int flag),
+    SHIM(void *arg))
+        __attribute__nonnull__(2)
+        FUNC_MODIFIES(*pool);
+
+static void gc_gms_drop_nursery(
+    ARGMOD(GMS_Object_List *nursery),
+    size_t count)
+        __attribute__nonnull__(1)
+        FUNC_MODIFIES(*nursery);
+
+static void gc_gms_finalize(PARROT_INTERP,
+    ARGIN(Memory_Pools * const mem_pools))
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2);
+
+PARROT_CANNOT_RETURN_NULL
+PARROT_WARN_UNUSED_RESULT
+static void * gc_gms_get_free_object(PARROT_INTERP,
+    ARGMOD(Fixed_Size_Pool *pool))
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2)
+        FUNC_MODIFIES(*pool);
+
+PARROT_WARN_UNUSED_RESULT
+static int gc_gms_is_dead_shared(PARROT_INTERP, ARGIN(const PObj *obj))
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2);
+
+static void gc_gms_list_push(
+    ARGMOD(GMS_Object_List *list),
+    ARGIN(PObj *obj))
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2)
+        FUNC_MODIFIES(*list);
+
+static void gc_gms_major_collection(PARROT_INTERP,
+    ARGMOD(GMS_Private *gms),
+    Parrot_gc_trace_type trace)
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2)
+        FUNC_MODIFIES(*gms);
+
+static void gc_gms_mark_and_sweep(PARROT_INTERP, UINTVAL flags)
+        __attribute__nonnull__(1);
+
+static void gc_gms_minor_collection(PARROT_INTERP,
+    ARGMOD(GMS_Private *gms),
+    Parrot_gc_trace_type trace)
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2)
+        FUNC_MODIFIES(*gms);
+
+static void gc_gms_pool_init(PARROT_INTERP, ARGMOD(Fixed_Size_Pool *pool))
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2)
+        FUNC_MODIFIES(*pool);
+
+static void gc_gms_promote(ARGMOD(GMS_Private *gms), ARGMOD(PObj *obj))
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2)
+        FUNC_MODIFIES(*gms)
+        FUNC_MODIFIES(*obj);
+
+static void gc_gms_rotate_remembered(ARGMOD(GMS_Private *gms))
+        __attribute__nonnull__(1)
+        FUNC_MODIFIES(*gms);
+
+static int gc_gms_sweep_cb(PARROT_INTERP,
+    ARGMOD(Fixed_Size_Pool *pool),
+    SHIM(int flag),
+    ARGMOD(void *arg))
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2)
+        __attribute__nonnull__(4)
+        FUNC_MODIFIES(*pool)
+        FUNC_MODIFIES(*arg);
+
+static int gc_gms_sweep_nursery_cb(PARROT_INTERP,
+    ARGMOD(Fixed_Size_Pool *pool),
+    SHIM(int flag),
+    ARGMOD(void *arg))
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2)
+        __attribute__nonnull__(4)
+        FUNC_MODIFIES(*pool)
+        FUNC_MODIFIES(*arg);
+
+static void gc_gms_trace_list(PARROT_INTERP,
+    ARGIN(const GMS_Object_List *list))
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2);
+
+static void gc_gms_write_barrier(PARROT_INTERP, ARGMOD(PMC *agg))
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2)
+        FUNC_MODIFIES(*agg);
+
+#define ASSERT_ARGS_gc_gms_add_nursery_cb __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(pool))
+#define ASSERT_ARGS_gc_gms_clear_live_cb __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp) \
+    , PARROT_ASSERT_ARG(pool))
+#define ASSERT_ARGS_gc_gms_clear_nursery_cb __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(pool))
+#define ASSERT_ARGS_gc_gms_deinit __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp))
+#define ASSERT_ARGS_gc_gms_deinit_pool_cb __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(pool))
+#define ASSERT_ARGS_gc_gms_drop_nursery __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(nursery))
+#define ASSERT_ARGS_gc_gms_finalize __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp) \
+    , PARROT_ASSERT_ARG(mem_pools))
+#define ASSERT_ARGS_gc_gms_get_free_object __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp) \
+    , PARROT_ASSERT_ARG(pool))
+#define ASSERT_ARGS_gc_gms_is_dead_shared __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp) \
+    , PARROT_ASSERT_ARG(obj))
+#define ASSERT_ARGS_gc_gms_list_push __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(list) \
+    , PARROT_ASSERT_ARG(obj))
+#define ASSERT_ARGS_gc_gms_major_collection __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp) \
+    , PARROT_ASSERT_ARG(gms))
+#define ASSERT_ARGS_gc_gms_mark_and_sweep __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp))
+#define ASSERT_ARGS_gc_gms_minor_collection __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp) \
+    , PARROT_ASSERT_ARG(gms))
+#define ASSERT_ARGS_gc_gms_pool_init __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp) \
+    , PARROT_ASSERT_ARG(pool))
+#define ASSERT_ARGS_gc_gms_promote __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(gms) \
+    , PARROT_ASSERT_ARG(obj))
+#define ASSERT_ARGS_gc_gms_rotate_remembered __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(gms))
+#define ASSERT_ARGS_gc_gms_sweep_cb __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp) \
+    , PARROT_ASSERT_ARG(pool) \
+    , PARROT_ASSERT_ARG(arg))
+#define ASSERT_ARGS_gc_gms_sweep_nursery_cb __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp) \
+    , PARROT_ASSERT_ARG(pool) \
+    , PARROT_ASSERT_ARG(arg))
+#define ASSERT_ARGS_gc_gms_trace_list __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp) \
+    , PARROT_ASSERT_ARG(list))
+#define ASSERT_ARGS_gc_gms_write_barrier __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp) \
+    , PARROT_ASSERT_ARG(agg))
+/* Don't modify between HEADERIZER BEGIN / HEADERIZER END.  Your changes will be lost. */
+/* HEADERIZER END: static */
+
+/*
+
+=head2 Primary GMS Functions
+
+=over 4
+
+=item C<void Parrot_gc_gms_init(PARROT_INTERP)>
+
+Initializes the GMS core. Installs the MS core first, and then replaces the
+hooks that GMS needs to change.
+
+=cut
+
+*/
+
+void
+Parrot_gc_gms_init(PARROT_INTERP)
+{
+    ASSERT_ARGS(Parrot_gc_gms_init)
+    GMS_Private * const gms = mem_internal_allocate_zeroed_typed(GMS_Private);
+
+    Parrot_gc_ms_init(interp);
+
+    gms->ms_init_pool     = interp->gc_sys->init_pool;
+    gms->major_threshold  = GMS_MAJOR_MIN_OBJECTS;
+
+    interp->mem_pools->gc_private      = gms;
+    interp->gc_sys->do_gc_mark         = gc_gms_mark_and_sweep;
+    interp->gc_sys->finalize_gc_system = gc_gms_deinit;
+    interp->gc_sys->init_pool          = gc_gms_pool_init;
+    interp->gc_sys->write_barrier      = gc_gms_write_barrier;
+}
+
+/*
+
+=item C<static void gc_gms_deinit(PARROT_INTERP)>
+
+Frees the GMS data structures and reinstalls the MS core, which takes over
+for the rest of the interpreter's life.
+
+=cut
+
+*/
+
+static void
+gc_gms_deinit(PARROT_INTERP)
+{
+    ASSERT_ARGS(gc_gms_deinit)
+    GMS_Private * const gms = GMS_PRIVATE(interp);
+
+    /* only the pools with a nursery are handed back, see gc_gms_pool_init */
+    header_pools_iterate_callback(interp, POOL_PMC | POOL_BUFFER, NULL,
+        gc_gms_deinit_pool_cb);
+
+    mem_internal_free(gms->remembered.objects);
+    mem_internal_free(gms->retained.objects);
+    mem_internal_free(gms->contexts.objects);
+    mem_internal_free(gms);
+
+    interp->mem_pools->gc_private = NULL;
+    Parrot_gc_ms_init(interp);
+}
+
+/*
+
+=item C<static void gc_gms_mark_and_sweep(PARROT_INTERP, UINTVAL flags)>
+
+Runs a minor or a major collection, see above.
+
+=cut
+
+*/
+
+static void
+gc_gms_mark_and_sweep(PARROT_INTERP, UINTVAL flags)
+{
+    ASSERT_ARGS(gc_gms_mark_and_sweep)
+    Memory_Pools * const mem_pools = interp->mem_pools;
+    GMS_Private  * const gms       = GMS_PRIVATE(interp);
+    const Parrot_gc_trace_type trace = (flags & GC_trace_stack_FLAG)
+                                     ? GC_TRACE_FULL : GC_TRACE_ROOT_ONLY;
+    GC_Event *event;
+
+    if (mem_pools->gc_mark_block_level)
+        return;
+
+    if (flags & GC_finish_FLAG) {
+        gc_gms_finalize(interp, mem_pools);
+        return;
+    }
+
+    event = Parrot_gc_event_begin(interp, GC_EVENT_MARK);
+
+    ++mem_pools->gc_mark_block_level;
+
+    /* every run is completed, so that the sticky live bits stay valid */
+    mem_pools->lazy_gc = 0;
+
+    /* tell the threading system that we're doing GC mark */
+    pt_gc_start_mark(interp);
+    Parrot_gc_run_init(interp);
+
+    /* Runs which are not triggered by allocation are explicit requests to
+     * find every dead object. The debugger may have set live bits, too. */
+    if (!gms->nursery_ready
+    ||  !(flags & GC_trace_stack_FLAG)
+    ||  (interp->pdb && interp->pdb->debugger)
+    ||  gms->num_old >= gms->major_threshold)
+        gc_gms_major_collection(interp, gms, trace);
+    else
+        gc_gms_minor_collection(interp, gms, trace);
+
+    gc_gms_rotate_remembered(gms);
+
+    pt_gc_stop_mark(interp);
+
+    /* Note it */
+    mem_pools->gc_mark_runs++;
+    --mem_pools->gc_mark_block_level;
+
+    Parrot_gc_event_end(interp, event);
+}
+
+/*
+
+=item C<static void gc_gms_minor_collection(PARROT_INTERP, GMS_Private *gms,
+Parrot_gc_trace_type trace)>
+
+Collects the young generation: traces the root set, the remembered set and
+the old contexts, then sweeps the nurseries.
+
+=cut
+
+*/
+
+static void
+gc_gms_minor_collection(PARROT_INTERP, ARGMOD(GMS_Private *gms),
+    Parrot_gc_trace_type trace)
+{
+    ASSERT_ARGS(gc_gms_minor_collection)
+
+    /* new STRINGs are born live, so start the nursery afresh */
+    header_pools_iterate_callback(interp, POOL_PMC | POOL_BUFFER, NULL,
+        gc_gms_clear_nursery_cb);
+
+    Parrot_gc_trace_root(interp, trace);
+    pt_gc_mark_root_finished(interp);
+
+    gc_gms_trace_list(interp, &gms->contexts);
+    gc_gms_trace_list(interp, &gms->retained);
+    gc_gms_trace_list(interp, &gms->remembered);
+
+    header_pools_iterate_callback(interp, POOL_PMC | POOL_BUFFER, gms,
+        gc_gms_sweep_nursery_cb);
+}
+
+/*
+
+=item C<static void gc_gms_major_collection(PARROT_INTERP, GMS_Private *gms,
+Parrot_gc_trace_type trace)>
+
+Collects both generations with a full trace and a sweep of all the arenas,
+and promotes every survivor.
+
+=cut
+
+*/
+
+static void
+gc_gms_major_collection(PARROT_INTERP, ARGMOD(GMS_Private *gms),
+    Parrot_gc_trace_type trace)
+{
+    ASSERT_ARGS(gc_gms_major_collection)
+
+    if (!gms->nursery_ready) {
+        header_pools_iterate_callback(interp, POOL_PMC | POOL_BUFFER, NULL,
+            gc_gms_add_nursery_cb);
+        gms->nursery_ready = 1;
+    }
+
+    /* compact STRING pools to collect free headers and allocated buffers */
+    Parrot_gc_compact_memory_pool(interp);
+
+    /* the old generation is rebuilt from the survivors of this run */
+    header_pools_iterate_callback(interp, POOL_PMC | POOL_BUFFER, NULL,
+        gc_gms_clear_live_cb);
+    gms->contexts.count = 0;
+    gms->num_old        = 0;
+
+    Parrot_gc_trace_root(interp, trace);
+    pt_gc_mark_root_finished(interp);
+
+    header_pools_iterate_callback(interp, POOL_PMC | POOL_BUFFER, gms,
+        gc_gms_sweep_cb);
+
+    gms->major_threshold = gms->num_old * GMS_MAJOR_GROWTH_FACTOR;
+
+    if (gms->major_threshold < GMS_MAJOR_MIN_OBJECTS)
+        gms->major_threshold = GMS_MAJOR_MIN_OBJECTS;
+}
+
+/*
+
+=item C<static void gc_gms_finalize(PARROT_INTERP, Memory_Pools * const
+mem_pools)>
+
+Performs the finalization run, freeing all PMCs. This is the same as for the
+MS core.
+
+=cut
+
+*/
+
+static void
+gc_gms_finalize(PARROT_INTERP, ARGIN(Memory_Pools * const mem_pools))
+{
+    ASSERT_ARGS(gc_gms_finalize)
+    Parrot_gc_clear_live_bits(interp, mem_pools->pmc_pool);
+    Parrot_gc_clear_live_bits(interp, mem_pools->constant_pmc_pool);
+
+    /* keep the scheduler and its kids alive for Task-like PMCs to destroy
+     * themselves; run a sweep to collect them */
+    if (interp->scheduler) {
+        Parrot_gc_mark_PMC_alive(interp, interp->scheduler);
+        VTABLE_mark(interp, interp->scheduler);
+        Parrot_gc_sweep_pool(interp, interp->mem_pools->pmc_pool);
+    }
+
+    /* now sweep everything that's left */
+    Parrot_gc_sweep_pool(interp, interp->mem_pools->pmc_pool);
+    Parrot_gc_sweep_pool(interp, interp->mem_pools->constant_pmc_pool);
+}
+
+/*
+
+=item C<static void gc_gms_write_barrier(PARROT_INTERP, PMC *agg)>
+
+Adds the old PMC C<agg> to the remembered set.
+
+=cut
+
+*/
+
+static void
+gc_gms_write_barrier(PARROT_INTERP, ARGMOD(PMC *agg))
+{
+    ASSERT_ARGS(gc_gms_write_barrier)
+
+    PObj_GC_remembered_SET(agg);
+    gc_gms_list_push(&GMS_PRIVATE(interp)->remembered, (PObj *)agg);
+}
+
+/*
+
+=back
+
+=head2 GMS Helper Functions
+
+=over 4
+
+=item C<static void gc_gms_promote(GMS_Private *gms, PObj *obj)>
+
+Moves the surviving object C<obj> to the old generation.
+
+=cut
+
+*/
+
+static void
+gc_gms_promote(ARGMOD(GMS_Private *gms), ARGMOD(PObj *obj))
+{
+    ASSERT_ARGS(gc_gms_promote)
+
+    PObj_get_FLAGS(obj) |= PObj_GC_old_FLAG | PObj_live_FLAG;
+    PObj_get_FLAGS(obj) &= ~PObj_custom_GC_FLAG;
+    ++gms->num_old;
+
+    if (PObj_is_PMC_TEST(obj)) {
+        const PMC * const pmc = (PMC *)obj;
+
+        if (pmc->vtable && pmc->vtable->base_type == enum_class_Context)
+            gc_gms_list_push(&gms->contexts, obj);
+    }
+}
+
+/*
+
+=item C<static void gc_gms_trace_list(PARROT_INTERP, const GMS_Object_List
+*list)>
+
+Marks the children of the old PMCs in C<list>. Entries for PMCs which have
+been freed since they were added are skipped.
+
+=cut
+
+*/
+
+static void
+gc_gms_trace_list(PARROT_INTERP, ARGIN(const GMS_Object_List *list))
+{
+    ASSERT_ARGS(gc_gms_trace_list)
+    size_t i;
+
+    for (i = 0; i < list->count; i++) {
+        PMC * const pmc = (PMC *)list->objects[i];
+
+        if (!PObj_GC_old_TEST(pmc) || !PObj_is_PMC_TEST(pmc))
+            continue;
+
+        if (PObj_is_special_PMC_TEST(pmc))
+            mark_special(interp, pmc);
+        else if (PMC_metadata(pmc))
+            Parrot_gc_mark_PMC_alive(interp, PMC_metadata(pmc));
+    }
+}
+
+/*
+
+=item C<static void gc_gms_rotate_remembered(GMS_Private *gms)>
+
+Ends a collection cycle: the PMCs remembered during this cycle are retained
+for the next run, and the barrier is rearmed for them.
+
+=cut
+
+*/
+
+static void
+gc_gms_rotate_remembered(ARGMOD(GMS_Private *gms))
+{
+    ASSERT_ARGS(gc_gms_rotate_remembered)
+    GMS_Object_List tmp;
+    size_t          i;
+
+    for (i = 0; i < gms->remembered.count; i++)
+        PObj_GC_remembered_CLEAR(gms->remembered.objects[i]);
+
+    tmp                   = gms->retained;
+    gms->retained         = gms->remembered;
+    gms->remembered       = tmp;
+    gms->remembered.count = 0;
+}
+
+/*
+
+=item C<static void gc_gms_list_push(GMS_Object_List *list, PObj *obj)>
+
+Appends C<obj> to C<list>, growing it as needed.
+
+=cut
+
+*/
+
+static void
+gc_gms_list_push(ARGMOD(GMS_Object_List *list), ARGIN(PObj *obj))
+{
+    ASSERT_ARGS(gc_gms_list_push)
+
+    if (list->count == list->size) {
+        list->size    = list->size ? list->size * 2 : GMS_LIST_INITIAL_SIZE;
+        list->objects = (PObj **)mem_internal_realloc(list->objects,
+                            list->size * sizeof (PObj *));
+    }
+
+    list->objects[list->count++] = obj;
+}
+
+/*
+
+=item C<static void gc_gms_drop_nursery(GMS_Object_List *nursery, size_t count)>
+
+Removes the first C<count> entries of a swept C<nursery>, keeping the objects
+allocated while sweeping.
+
+=cut
+
+*/
+
+static void
+gc_gms_drop_nursery(ARGMOD(GMS_Object_List *nursery), size_t count)
+{
+    ASSERT_ARGS(gc_gms_drop_nursery)
+
+    if (nursery->count > count)
+        memmove(nursery->objects, nursery->objects + count,
+            (nursery->count - count) * sizeof (PObj *));
+
+    nursery->count -= count;
+}
+
+/*
+
+=item C<static int gc_gms_is_dead_shared(PARROT_INTERP, const PObj *obj)>
+
+Returns true if the unmarked C<obj> is shared and must be kept alive, because
+not all the interpreters sharing it have been suspended for this run.
+
+=cut
+
+*/
+
+PARROT_WARN_UNUSED_RESULT
+static int
+gc_gms_is_dead_shared(PARROT_INTERP, ARGIN(const PObj *obj))
+{
+    ASSERT_ARGS(gc_gms_is_dead_shared)
+
+    return PObj_is_shared_TEST(obj)
+        && !(interp->thread_data
+        &&  (interp->thread_data->state & THREAD_STATE_SUSPENDED_GC));
+}
+
+/*
+
+=back
+
+=head2 GMS Pool Callbacks
+
+These are called through C<header_pools_iterate_callback()>.
+
+=over 4
+
+=item C<static int gc_gms_clear_nursery_cb(PARROT_INTERP, Fixed_Size_Pool *pool,
+int flag, void *arg)>
+
+Clears the live bits of the young objects in the nursery of C<pool>.
+
+=cut
+
+*/
+
+static int
+gc_gms_clear_nursery_cb(SHIM_INTERP, ARGMOD(Fixed_Size_Pool *pool),
+    SHIM(int flag), SHIM(void *arg))
+{
+    ASSERT_ARGS(gc_gms_clear_nursery_cb)
+    const GMS_Object_List * const nursery = (GMS_Object_List *)pool->gc_private;
+    size_t i;
+
+    for (i = 0; i < nursery->count; i++) {
+        PObj * const obj = nursery->objects[i];
+
+        if (!PObj_GC_old_TEST(obj))
+            PObj_live_CLEAR(obj);
+    }
+
+    return 0;
+}
+
+/*
+
+=item C<static int gc_gms_sweep_nursery_cb(PARROT_INTERP, Fixed_Size_Pool *pool,
+int flag, void *arg)>
+
+Sweeps the nursery of C<pool> after a minor trace: promotes the marked
+objects and frees the rest. Entries for objects which have been freed or
+promoted already are skipped.
+
+=cut
+
+*/
+
+static int
+gc_gms_sweep_nursery_cb(PARROT_INTERP, ARGMOD(Fixed_Size_Pool *pool),
+    SHIM(int flag), ARGMOD(void *arg))
+{
+    ASSERT_ARGS(gc_gms_sweep_nursery_cb)
+    GMS_Private     * const gms       = (GMS_Private *)arg;
+    GMS_Object_List * const nursery   = (GMS_Object_List *)pool->gc_private;
+    const gc_object_fn_type gc_object = pool->gc_object;
+    const size_t            count     = nursery->count;
+    size_t i;
+
+    for (i = 0; i < count; i++) {
+        /* don't cache the list: freeing an object may allocate */
+        PObj * const obj = nursery->objects[i];
+
+        if (PObj_get_FLAGS(obj) & (PObj_on_free_list_FLAG | PObj_GC_old_FLAG))
+            continue;
+
+        if (PObj_live_TEST(obj) || gc_gms_is_dead_shared(interp, obj))
+            gc_gms_promote(gms, obj);
+        else {
+            if (gc_object)
+                gc_object(interp, pool, obj);
+
+            pool->add_free_object(interp, pool, obj);
+            ++pool->num_free_objects;
+        }
+    }
+
+    gc_gms_drop_nursery(nursery, count);
+
+    return 0;
+}
+
+/*
+
+=item C<static int gc_gms_sweep_cb(PARROT_INTERP, Fixed_Size_Pool *pool, int
+flag, void *arg)>
+
+Sweeps all the arenas of C<pool> after a major trace: promotes the marked
+objects and frees the rest. Unlike C<Parrot_gc_sweep_pool()>, this leaves
+the live bits of the survivors set.
+
+=cut
+
+*/
+
+static int
+gc_gms_sweep_cb(PARROT_INTERP, ARGMOD(Fixed_Size_Pool *pool),
+    SHIM(int flag), ARGMOD(void *arg))
+{
+    ASSERT_ARGS(gc_gms_sweep_cb)
+    GMS_Private     * const gms         = (GMS_Private *)arg;
+    GMS_Object_List * const nursery     = (GMS_Object_List *)pool->gc_private;
+    const size_t            nursery_end = nursery->count;
+    const gc_object_fn_type gc_object   = pool->gc_object;
+    const size_t            object_size = pool->object_size;
+    UINTVAL                 total_used  = 0;
+    Fixed_Size_Arena       *cur_arena;
+
+    for (cur_arena = pool->last_Arena; cur_arena; cur_arena = cur_arena->prev) {
+        PObj *obj = (PObj *)cur_arena->start_objects;
+        UINTVAL i;
+
+        for (i = cur_arena->used; i; i--) {
+            if (PObj_on_free_list_TEST(obj))
+                ; /* if it's on free list, do nothing */
+            else if (PObj_live_TEST(obj) || gc_gms_is_dead_shared(interp, obj)) {
+                total_used++;
+                gc_gms_promote(gms, obj);
+            }
+            else {
+                if (gc_object)
+                    gc_object(interp, pool, obj);
+
+                pool->add_free_object(interp, pool, obj);
+            }
+
+            obj = (PObj *)((char *)obj + object_size);
+        }
+    }
+
+    pool->num_free_objects = pool->total_objects - total_used;
+
+    /* everything allocated before this run has been swept */
+    gc_gms_drop_nursery(nursery, nursery_end);
+
+    return 0;
+}
+
+/*
+
+=item C<static int gc_gms_clear_live_cb(PARROT_INTERP, Fixed_Size_Pool *pool,
+int flag, void *arg)>
+
+Clears all the live bits of C<pool>.
+
+=cut
+
+*/
+
+static int
+gc_gms_clear_live_cb(PARROT_INTERP, ARGMOD(Fixed_Size_Pool *pool),
+    SHIM(int flag), SHIM(void *arg))
+{
+    ASSERT_ARGS(gc_gms_clear_live_cb)
+    Parrot_gc_clear_live_bits(interp, pool);
+    return 0;
+}
+
+/*
+
+=item C<static int gc_gms_add_nursery_cb(PARROT_INTERP, Fixed_Size_Pool *pool,
+int flag, void *arg)>
+
+Gives C<pool> a nursery. Only non-constant pools have one.
+
+=cut
+
+*/
+
+static int
+gc_gms_add_nursery_cb(SHIM_INTERP, ARGMOD(Fixed_Size_Pool *pool),
+    SHIM(int flag), SHIM(void *arg))
+{
+    ASSERT_ARGS(gc_gms_add_nursery_cb)
+
+    if (!pool->gc_private)
+        pool->gc_private = mem_internal_allocate_zeroed_typed(GMS_Object_List);
+
+    return 0;
+}
+
+/*
+
+=item C<static int gc_gms_deinit_pool_cb(PARROT_INTERP, Fixed_Size_Pool *pool,
+int flag, void *arg)>
+
+Frees the nursery of C<pool> and hands its allocation back to the MS core.
+
+=cut
+
+*/
+
+static int
+gc_gms_deinit_pool_cb(SHIM_INTERP, ARGMOD(Fixed_Size_Pool *pool),
+    SHIM(int flag), SHIM(void *arg))
+{
+    ASSERT_ARGS(gc_gms_deinit_pool_cb)
+    GMS_Object_List * const nursery = (GMS_Object_List *)pool->gc_private;
+
+    if (nursery) {
+        mem_internal_free(nursery->objects);
+        mem_internal_free(nursery);
+        pool->gc_private = NULL;
+    }
+
+    pool->get_free_object = gms_ms_get_free_object;
+
+    return 0;
+}
+
+/*
+
+=back
+
+=head2 GMS Pool Functions
+
+=over 4
+
+=item C<static void gc_gms_pool_init(PARROT_INTERP, Fixed_Size_Pool *pool)>
+
+Initializes a memory pool for the GMS core. The pool gets the MS functions,
+except that new objects are also logged in the nursery. Pools created after
+the first run get a nursery right away: the constant pools are created at
+startup, and never get one. Their allocator only calls the MS one, so that
+C<gc_gms_deinit> leaves it in place.
+
+=cut
+
+*/
+
+static void
+gc_gms_pool_init(PARROT_INTERP, ARGMOD(Fixed_Size_Pool *pool))
+{
+    ASSERT_ARGS(gc_gms_pool_init)
+    GMS_Private * const gms = GMS_PRIVATE(interp);
+
+    gms->ms_init_pool(interp, pool);
+
+    gms_ms_get_free_object = pool->get_free_object;
+    pool->get_free_object  = gc_gms_get_free_object;
+
+    if (gms->nursery_ready)
+        gc_gms_add_nursery_cb(interp, pool, 0, NULL);
+}
+
+/*
+
+=item C<static void * gc_gms_get_free_object(PARROT_INTERP, Fixed_Size_Pool
+*pool)>
+
+Gets a free object from the MS allocator, and logs it in the nursery of
+C<pool>, if it has one.
+
+=cut
+
+*/
+
+PARROT_CANNOT_RETURN_NULL
+PARROT_WARN_UNUSED_RESULT
+static void *
+gc_gms_get_free_object(PARROT_INTERP, ARGMOD(Fixed_Size_Pool *pool))
+{
+    ASSERT_ARGS(gc_gms_get_free_object)
+    void * const ptr = gms_ms_get_free_object(interp, pool);
+
+    /* the allocation may have run the GC, which creates the nurseries */
+    GMS_Object_List * const nursery = (GMS_Object_List *)pool->gc_private;
+
+    if (nursery)
+        gc_gms_list_push(nursery, (PObj *)ptr);
+
+    return ptr;
+}
+
+/*
+
+=back
+
+=head1 SEE ALSO
+
+F<src/gc/gc_ms.c>, F<docs/pdds/pdd09_gc.pod>.
+
+=cut
+
+*/
+
+/*
+ * Local variables:
+ *   c-file-style: "parrot"
+ * End:
+ * vim: expandtab shiftwidth=4:
+ */
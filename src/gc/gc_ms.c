@@ -48,6 +48,14 @@ static void * gc_ms_get_free_object(PARROT_INTERP,
         __attribute__nonnull__(2)
         FUNC_MODIFIES(*pool);
 
+PARROT_CAN_RETURN_NULL
+PARROT_WARN_UNUSED_RESULT
+static void * gc_ms_get_swept_object(PARROT_INTERP,
+    ARGMOD(Fixed_Size_Pool *pool))
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2)
+        FUNC_MODIFIES(*pool);
+
 static void gc_ms_mark_and_sweep(PARROT_INTERP, UINTVAL flags)
         __attribute__nonnull__(1);
 
@@ -87,6 +95,9 @@ static int gc_ms_trace_active_PMCs(PARROT_INTERP,
 #define ASSERT_ARGS_gc_ms_get_free_object __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
        PARROT_ASSERT_ARG(interp) \
     , PARROT_ASSERT_ARG(pool))
+#define ASSERT_ARGS_gc_ms_get_swept_object __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp) \
+    , PARROT_ASSERT_ARG(pool))
 #define ASSERT_ARGS_gc_ms_mark_and_sweep __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
        PARROT_ASSERT_ARG(interp))
 #define ASSERT_ARGS_gc_ms_more_traceable_objects __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
@@ -147,10 +158,15 @@ gc_ms_mark_and_sweep(PARROT_INTERP, UINTVAL flags)
     ASSERT_ARGS(gc_ms_mark_and_sweep)
     Memory_Pools * const mem_pools = interp->mem_pools;
     int total_free = 0;
+    GC_Event *event;
 
     if (mem_pools->gc_mark_block_level)
         return;
 
+    /* the mark relies on the live bits being cleared by the last sweep */
+    if (mem_pools->lazy_sweep)
+        Parrot_gc_finish_lazy_sweeps(interp);
+
     if (interp->pdb && interp->pdb->debugger) {
         /* The debugger could have performed a mark. Make sure everything is
            marked dead here, so that when we sweep it all gets collected */
@@ -162,6 +178,9 @@ gc_ms_mark_and_sweep(PARROT_INTERP, UINTVAL flags)
         return;
     }
 
+    event = Parrot_gc_event_begin(interp,
+            flags & GC_lazy_FLAG ? GC_EVENT_LAZY_MARK : GC_EVENT_MARK);
+
     ++mem_pools->gc_mark_block_level;
     mem_pools->lazy_gc = flags & GC_lazy_FLAG;
 
@@ -198,6 +217,8 @@ gc_ms_mark_and_sweep(PARROT_INTERP, UINTVAL flags)
     mem_pools->gc_mark_runs++;
     --mem_pools->gc_mark_block_level;
 
+    Parrot_gc_event_end(interp, event);
+
     return;
 }
 
@@ -242,6 +263,9 @@ Performs a full trace run and marks all the PMCs as active if they
 are. Returns whether the run completed, that is, whether it's safe
 to proceed with GC.
 
+The mark is spread over several threads if C<PARROT_GC_MARK_THREADS> asks
+for it; see F<src/gc/mark_parallel.c>.
+
 =cut
 
 */
@@ -250,8 +274,14 @@ static int
 gc_ms_trace_active_PMCs(PARROT_INTERP, Parrot_gc_trace_type trace)
 {
     ASSERT_ARGS(gc_ms_trace_active_PMCs)
+    const int parallel = Parrot_gc_parallel_mark_begin(interp);
+    const int complete = Parrot_gc_trace_root(interp, trace);
+
+    /* the roots are only collected so far; mark their children */
+    if (parallel)
+        Parrot_gc_parallel_mark_finish(interp);
 
-    if (!Parrot_gc_trace_root(interp, trace))
+    if (!complete)
         return 0;
 
     pt_gc_mark_root_finished(interp);
@@ -269,6 +299,10 @@ Sweeps the given pool for the MS collector. This function also ends
 the profiling timer, if profiling is enabled. Returns the total number
 of objects freed.
 
+With C<PARROT_GC_LAZY_SWEEP> set, the sweep of most arenas is left to the
+allocator, unless PMCs need timely destruction. A full sweep may give
+empty arenas back to the system, see C<Parrot_gc_release_empty_arenas>.
+
 =cut
 
 */
@@ -279,8 +313,17 @@ gc_ms_sweep_cb(PARROT_INTERP, ARGMOD(Fixed_Size_Pool *pool), int flag,
 {
     ASSERT_ARGS(gc_ms_sweep_cb)
     int * const total_free = (int *) arg;
+    const Memory_Pools * const mem_pools = interp->mem_pools;
 
-    Parrot_gc_sweep_pool(interp, pool);
+    if (mem_pools->lazy_sweep
+    && !mem_pools->lazy_gc
+    && !mem_pools->num_early_gc_PMCs)
+        Parrot_gc_lazy_sweep_pool(interp, pool);
+    else {
+        Parrot_gc_sweep_pool(interp, pool);
+        Parrot_gc_release_empty_arenas(interp, pool);
+        Parrot_gc_pacing_swept(interp, pool);
+    }
 
     *total_free += pool->num_free_objects;
 
@@ -321,7 +364,11 @@ gc_ms_pool_init(SHIM_INTERP, ARGMOD(Fixed_Size_Pool *pool))
 *pool)>
 
 We're out of traceable objects. First we try a GC run to free some up. If
-that doesn't work, allocate a new arena.
+that doesn't work, allocate a new arena. A lazy sweep started by the GC run
+sweeps just enough arenas to decide that. The pacer may skip the GC run or
+ask for the arena anyway, see F<src/gc/pacing.c>. If the new arena would
+take the heap over C<PARROT_GC_MAX_HEAP>, the GC run is never skipped and
+the arena is only allocated once no free object is left.
 
 =cut
 
@@ -332,23 +379,34 @@ gc_ms_more_traceable_objects(PARROT_INTERP, ARGMOD(Fixed_Size_Pool *pool))
 {
     ASSERT_ARGS(gc_ms_more_traceable_objects)
 
-    if (pool->skip)
+    const GC_Pacer * const pacer  = interp->mem_pools->pacer;
+    const size_t           growth = pool->object_size * pool->objects_per_alloc;
+    const int              at_max = Parrot_gc_heap_exceeds_max(interp, growth);
+
+    if (pool->skip && !at_max)
         pool->skip = 0;
     else {
         Fixed_Size_Arena * const arena = pool->last_Arena;
         if (arena
-        &&  arena->used == arena->total_objects)
+        &&  arena->used == arena->total_objects
+        &&  (at_max || pacer->collect_headers(interp, pool)))
                 Parrot_gc_mark_and_sweep(interp, GC_trace_stack_FLAG);
     }
 
+    while (pool->sweep_arena
+    &&    (!pool->swept_list || pool->num_free_objects < pool->replenish_level))
+        Parrot_gc_lazy_sweep_step(interp, pool);
+
     /* requires that num_free_objects be updated in Parrot_gc_mark_and_sweep.
        If gc is disabled, then we must check the free list directly. */
 #if GC_USE_LAZY_ALLOCATOR
-    if ((!pool->free_list || pool->num_free_objects < pool->replenish_level)
+    if (((!pool->free_list && !pool->swept_list)
+        || (!at_max && pacer->grow_headers(interp, pool)))
         && !pool->newfree)
         (*pool->alloc_objects) (interp, pool);
 #else
-    if (!pool->free_list || pool->num_free_objects < pool->replenish_level)
+    if ((!pool->free_list && !pool->swept_list)
+        || (!at_max && pacer->grow_headers(interp, pool)))
     (*pool->alloc_objects) (interp, pool);
 #endif
 }
@@ -388,6 +446,15 @@ free objects, call C<gc_ms_add_free_object> to either free them up with a
 GC run, or allocate new objects. If there are objects available on the
 free list, pop it off and return it.
 
+With the lazy allocator, objects are first taken from the bump region at
+the end of the newest arena, so that successive allocations are adjacent
+in memory. The free list is only used once that region is exhausted.
+
+While a lazy sweep of the pool is pending, objects come from the arenas
+swept so far, sweeping the next one whenever they run out. The free list
+is left alone until the sweep is done, as it may hold objects of arenas
+not swept yet.
+
 =cut
 
 */
@@ -398,16 +465,24 @@ static void *
 gc_ms_get_free_object(PARROT_INTERP, ARGMOD(Fixed_Size_Pool *pool))
 {
     ASSERT_ARGS(gc_ms_get_free_object)
-    PObj *ptr;
-    PObj *free_list = (PObj *)pool->free_list;
+    PObj *ptr = NULL;
 
 #if GC_USE_LAZY_ALLOCATOR
-    if (!free_list && !pool->newfree) {
-        (*pool->more_objects)(interp, pool);
-        free_list = (PObj *)pool->free_list;
+    if (!pool->newfree) {
+        if (pool->sweep_arena)
+            ptr = (PObj *)gc_ms_get_swept_object(interp, pool);
+
+        if (!ptr && !pool->free_list) {
+            (*pool->more_objects)(interp, pool);
+
+            if (!pool->newfree && pool->sweep_arena)
+                ptr = (PObj *)gc_ms_get_swept_object(interp, pool);
+        }
     }
 
-    if (!free_list) {
+    if (ptr)
+        ; /* found in a swept arena */
+    else if (pool->newfree) {
         Fixed_Size_Arena * const arena = pool->last_Arena;
         ptr           = (PObj *)pool->newfree;
         pool->newfree = (void *)((char *)pool->newfree + pool->object_size);
@@ -419,18 +494,29 @@ gc_ms_get_free_object(PARROT_INTERP, ARGMOD(Fixed_Size_Pool *pool))
         PARROT_ASSERT(ptr < (PObj *)pool->newlast);
     }
     else {
-        ptr             = free_list;
+        ptr             = (PObj *)pool->free_list;
         pool->free_list = ((GC_MS_PObj_Wrapper *)ptr)->next_ptr;
     }
 #else
+    PObj *free_list;
+
+    if (pool->sweep_arena)
+        ptr = (PObj *)gc_ms_get_swept_object(interp, pool);
+
+    free_list = (PObj *)pool->free_list;
+
     /* if we don't have any objects */
-    if (!free_list) {
+    if (!ptr && !free_list) {
         (*pool->more_objects)(interp, pool);
+        if (pool->sweep_arena)
+            ptr = (PObj *)gc_ms_get_swept_object(interp, pool);
         free_list = (PObj *)pool->free_list;
     }
 
-    ptr             = free_list;
-    pool->free_list = ((GC_MS_PObj_Wrapper*)ptr)->next_ptr;
+    if (!ptr) {
+        ptr             = free_list;
+        pool->free_list = ((GC_MS_PObj_Wrapper*)ptr)->next_ptr;
+    }
 #endif
 
     /* PObj_flags_SETTO(ptr, 0); */
@@ -442,6 +528,41 @@ gc_ms_get_free_object(PARROT_INTERP, ARGMOD(Fixed_Size_Pool *pool))
 }
 
 
+/*
+
+=item C<static void * gc_ms_get_swept_object(PARROT_INTERP, Fixed_Size_Pool
+*pool)>
+
+Pops an object off the list of objects found by a pending lazy sweep,
+sweeping further arenas until one turns up. Returns NULL once the sweep is
+done; the remaining free objects are on the free list then.
+
+=cut
+
+*/
+
+PARROT_CAN_RETURN_NULL
+PARROT_WARN_UNUSED_RESULT
+static void *
+gc_ms_get_swept_object(PARROT_INTERP, ARGMOD(Fixed_Size_Pool *pool))
+{
+    ASSERT_ARGS(gc_ms_get_swept_object)
+    GC_MS_PObj_Wrapper *object;
+
+    while (!pool->swept_list) {
+        if (!pool->sweep_arena)
+            return NULL;
+
+        Parrot_gc_lazy_sweep_step(interp, pool);
+    }
+
+    object           = pool->swept_list;
+    pool->swept_list = object->next_ptr;
+
+    return object;
+}
+
+
 /*
 
 =item C<static void gc_ms_alloc_objects(PARROT_INTERP, Fixed_Size_Pool *pool)>
@@ -46,6 +46,11 @@ extern void *flush_reg_store(void);
 
 #define POOL_MAX_BYTES                         65536 * 128
 
+/* empty arenas are released after this many sweeps in a row which left at
+ * most 1/GC_RELEASE_OCCUPANCY of the pool in use */
+#define GC_RELEASE_AFTER_SWEEPS                3
+#define GC_RELEASE_OCCUPANCY                   4
+
 #ifndef GC_IS_MALLOC
 #  define PMC_HEADERS_PER_ALLOC     4096 * 10 / sizeof (PMC)
 #  define BUFFER_HEADERS_PER_ALLOC  4096      / sizeof (Buffer)
@@ -57,6 +62,14 @@ extern void *flush_reg_store(void);
 #endif /* GC_IS_MALLOC */
 
 #define CONSTANT_PMC_HEADERS_PER_ALLOC 4096 / sizeof (PMC)
+
+/* Parallel marking needs threads, plus the atomic builtins and thread local
+ * storage of GCC */
+#if defined(PARROT_HAS_THREADS) && defined(__GNUC__) && !defined(_WIN32)
+#  define PARROT_GC_PARALLEL_MARK 1
+#else
+#  define PARROT_GC_PARALLEL_MARK 0
+#endif
 #define GET_SIZED_POOL_IDX(x) ((x) / sizeof (void *))
 
 
@@ -89,7 +102,8 @@ typedef struct GC_MS_PObj_Wrapper {
 
 typedef enum _gc_sys_type_enum {
     MS,  /*mark and sweep*/
-    INF /*infinite memory core*/
+    INF, /*infinite memory core*/
+    GMS  /*generational mark and sweep*/
 } gc_sys_type_enum;
 
 typedef struct GC_Subsystem {
@@ -106,6 +120,9 @@ typedef struct GC_Subsystem {
      *These will be called via the GC API functions Parrot_gc_func_name
      *e.g. read barrier && write barrier hooks can go here later ...*/
 
+    /* Called by Parrot_gc_write_barrier when an old PMC is written to */
+    void (*write_barrier)(PARROT_INTERP, PMC *);
+
     /* Holds system-specific data structures
      * unused right now, but this is where it should go if we need them ...
       union {
@@ -185,6 +202,12 @@ typedef struct Fixed_Size_Pool {
 
     int skip;
     size_t replenish_level;
+    size_t low_occupancy_sweeps; /* consecutive sweeps which left the pool
+                                    mostly empty */
+    size_t in_use_at_sweep;     /* objects in use when the last sweep began */
+    size_t swept_live;          /* objects it found alive so far */
+    size_t gc_threshold;        /* collect once the pool holds this many
+                                   objects; set by the ratio pacer */
 
     add_free_object_fn_type     add_free_object; /* adds a free object to
                                                     the pool's free list  */
@@ -195,11 +218,17 @@ typedef struct Fixed_Size_Pool {
     alloc_objects_fn_type       more_objects;
     gc_object_fn_type           gc_object;
 
-    /* Contains GC system-specific data structures ... unused at the moment,
-     * but this is where it should go when we need it ...
-    union {
-    } gc_private;
-    */
+    /* Contains GC system-specific data structures, e.g. the nursery of
+     * the GMS core */
+    void *gc_private;
+
+    /* Lazy sweeping (MS core): the next arena still to be swept since the
+     * last mark, and the free objects found by sweeping so far. While a
+     * sweep is pending, objects are only allocated from swept_list; the
+     * free_list may hold objects of arenas not swept yet. */
+    Fixed_Size_Arena   *sweep_arena;
+    GC_MS_PObj_Wrapper *swept_list;
+    GC_MS_PObj_Wrapper *swept_last;
 
 #if GC_USE_LAZY_ALLOCATOR
     void *newfree;
@@ -208,6 +237,51 @@ typedef struct Fixed_Size_Pool {
 
 } Fixed_Size_Pool;
 
+/* Decides between a collection and more memory, see src/gc/pacing.c */
+typedef struct GC_Pacer {
+    const char *name;
+    /* collect a pool out of free objects before it gets another arena? */
+    int  (*collect_headers)(PARROT_INTERP, struct Fixed_Size_Pool *);
+    /* give a pool another arena although some objects are free? */
+    int  (*grow_headers)(PARROT_INTERP, struct Fixed_Size_Pool *);
+    /* the sweep of a pool is complete */
+    void (*swept)(PARROT_INTERP, struct Fixed_Size_Pool *);
+} GC_Pacer;
+
+/* The log of collections, see src/gc/event_log.c */
+typedef enum {
+    GC_EVENT_MARK,
+    GC_EVENT_LAZY_MARK,
+    GC_EVENT_COMPACT
+} GC_Event_type;
+
+typedef struct GC_Heap_Stats {
+    size_t pmcs;                /* headers in the PMC pool */
+    size_t pmcs_in_use;
+    size_t buffers;             /* headers in the sized pools */
+    size_t buffers_in_use;
+    size_t memory;              /* bytes allocated for buffer memory */
+    size_t copied;              /* memory_collected */
+    size_t stack_roots;         /* gc_stack_roots */
+} GC_Heap_Stats;
+
+typedef struct GC_Event {
+    GC_Event_type type;
+    UINTVAL       number;
+    FLOATVAL      start;
+    FLOATVAL      end;
+    GC_Heap_Stats before;
+    GC_Heap_Stats after;
+} GC_Event;
+
+typedef struct GC_Event_Log {
+    GC_Event *events;           /* ring buffer */
+    size_t    size;
+    UINTVAL   num_events;       /* events logged so far */
+    GC_Event *current;          /* the event in progress, if any */
+    char     *file;             /* written on exit, if set */
+} GC_Event_Log;
+
 typedef struct Memory_Pools {
     Variable_Size_Pool *memory_pool;
     Variable_Size_Pool *constant_string_pool;
@@ -243,6 +317,20 @@ typedef struct Memory_Pools {
                                    * anything */
     UINTVAL memory_collected;     /* Total amount of memory copied
                                      during collection */
+    size_t  header_memory_allocated; /* bytes in the arenas of the
+                                        fixed-size header pools */
+    size_t  max_heap;             /* collect before growing the heap past
+                                     this many bytes; 0 for no limit */
+    const GC_Pacer *pacer;        /* when to collect */
+    UINTVAL gc_ratio;             /* heap growth between collections in
+                                     percent of the live data; 0 for the
+                                     fixed pacer */
+    size_t  gc_headers_in_use;    /* PMCs in use when the last sweep of
+                                     the PMC pool began */
+    size_t  gc_headers_survived;  /* how many of them survived it */
+    size_t  gc_stack_roots;       /* headers found on the C stack by all
+                                     collections */
+    GC_Event_Log *event_log;      /* NULL unless PARROT_GC_LOG is set */
     UINTVAL num_early_gc_PMCs;    /* how many PMCs want immediate destruction */
     UINTVAL num_early_PMCs_seen;  /* how many such PMCs has GC seen */
     PMC* gc_mark_start;           /* first PMC marked during a GC run */
@@ -250,6 +338,11 @@ typedef struct Memory_Pools {
     PMC* gc_trace_ptr;            /* last PMC trace_children was called on */
     int lazy_gc;                  /* flag that indicates whether we should stop
                                      when we've seen all impatient PMCs */
+    int lazy_sweep;               /* sweep arenas on allocation instead of
+                                     at the end of a collection */
+    size_t gc_lazy_sweep_arenas;  /* arenas swept on allocation */
+    size_t gc_forced_sweep_arenas; /* arenas whose lazy sweep was finished
+                                      by the next collection */
     /*
      * GC blocking
      */
@@ -261,6 +354,9 @@ typedef struct Memory_Pools {
      * private data for the GC subsystem
      */
     void *  gc_private;           /* gc subsystem data */
+
+    /* worker threads for parallel marking, see src/gc/mark_parallel.c */
+    struct GC_Mark_Workers *mark_workers;
 } Memory_Pools;
 
 
@@ -331,6 +427,9 @@ void Parrot_gc_clear_live_bits(PARROT_INTERP,
         __attribute__nonnull__(1)
         __attribute__nonnull__(2);
 
+void Parrot_gc_finish_lazy_sweeps(PARROT_INTERP)
+        __attribute__nonnull__(1);
+
 void Parrot_gc_free_attributes_from_pool(PARROT_INTERP,
     ARGMOD(PMC_Attribute_Pool * pool),
     ARGMOD(void *data))
@@ -352,6 +451,32 @@ void * Parrot_gc_get_attributes_from_pool(PARROT_INTERP,
         __attribute__nonnull__(2)
         FUNC_MODIFIES(* pool);
 
+PARROT_WARN_UNUSED_RESULT
+int Parrot_gc_heap_exceeds_max(PARROT_INTERP, size_t growth)
+        __attribute__nonnull__(1);
+
+void Parrot_gc_lazy_sweep_finish(PARROT_INTERP,
+    ARGMOD(Fixed_Size_Pool *pool))
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2)
+        FUNC_MODIFIES(*pool);
+
+void Parrot_gc_lazy_sweep_pool(PARROT_INTERP, ARGMOD(Fixed_Size_Pool *pool))
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2)
+        FUNC_MODIFIES(*pool);
+
+void Parrot_gc_lazy_sweep_step(PARROT_INTERP, ARGMOD(Fixed_Size_Pool *pool))
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2)
+        FUNC_MODIFIES(*pool);
+
+void Parrot_gc_release_empty_arenas(PARROT_INTERP,
+    ARGMOD(Fixed_Size_Pool *pool))
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2)
+        FUNC_MODIFIES(*pool);
+
 void Parrot_gc_run_init(PARROT_INTERP)
         __attribute__nonnull__(1);
 
@@ -388,6 +513,8 @@ int Parrot_gc_trace_root(PARROT_INTERP, Parrot_gc_trace_type trace)
 #define ASSERT_ARGS_Parrot_gc_clear_live_bits __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
        PARROT_ASSERT_ARG(interp) \
     , PARROT_ASSERT_ARG(pool))
+#define ASSERT_ARGS_Parrot_gc_finish_lazy_sweeps __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp))
 #define ASSERT_ARGS_Parrot_gc_free_attributes_from_pool \
      __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
        PARROT_ASSERT_ARG(interp) \
@@ -399,6 +526,22 @@ int Parrot_gc_trace_root(PARROT_INTERP, Parrot_gc_trace_type trace)
      __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
        PARROT_ASSERT_ARG(interp) \
     , PARROT_ASSERT_ARG(pool))
+#define ASSERT_ARGS_Parrot_gc_heap_exceeds_max __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp))
+#define ASSERT_ARGS_Parrot_gc_lazy_sweep_finish \
+     __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp) \
+    , PARROT_ASSERT_ARG(pool))
+#define ASSERT_ARGS_Parrot_gc_lazy_sweep_pool __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp) \
+    , PARROT_ASSERT_ARG(pool))
+#define ASSERT_ARGS_Parrot_gc_lazy_sweep_step __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp) \
+    , PARROT_ASSERT_ARG(pool))
+#define ASSERT_ARGS_Parrot_gc_release_empty_arenas \
+     __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp) \
+    , PARROT_ASSERT_ARG(pool))
 #define ASSERT_ARGS_Parrot_gc_run_init __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
        PARROT_ASSERT_ARG(interp))
 #define ASSERT_ARGS_Parrot_gc_sweep_pool __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
@@ -467,6 +610,12 @@ void compact_pool(PARROT_INTERP, ARGMOD(Variable_Size_Pool *pool))
         __attribute__nonnull__(2)
         FUNC_MODIFIES(*pool);
 
+void evacuate_fragmented_blocks(PARROT_INTERP,
+    ARGMOD(Variable_Size_Pool *pool))
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2)
+        FUNC_MODIFIES(*pool);
+
 void initialize_var_size_pools(PARROT_INTERP)
         __attribute__nonnull__(1);
 
@@ -499,6 +648,9 @@ void merge_pools(
 #define ASSERT_ARGS_compact_pool __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
        PARROT_ASSERT_ARG(interp) \
     , PARROT_ASSERT_ARG(pool))
+#define ASSERT_ARGS_evacuate_fragmented_blocks __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp) \
+    , PARROT_ASSERT_ARG(pool))
 #define ASSERT_ARGS_initialize_var_size_pools __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
        PARROT_ASSERT_ARG(interp))
 #define ASSERT_ARGS_mem_allocate __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
@@ -522,6 +674,118 @@ void Parrot_gc_ms_init(PARROT_INTERP)
 /* Don't modify between HEADERIZER BEGIN / HEADERIZER END.  Your changes will be lost. */
 /* HEADERIZER END: src/gc/gc_ms.c */
 
+/* HEADERIZER BEGIN: src/gc/gc_gms.c */
+/* Don't modify between HEADERIZER BEGIN / HEADERIZER END.  Your changes will be lost. */
+
+void Parrot_gc_gms_init(PARROT_INTERP)
+        __attribute__nonnull__(1);
+
+#define ASSERT_ARGS_Parrot_gc_gms_init __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp))
+/* Don't modify between HEADERIZER BEGIN / HEADERIZER END.  Your changes will be lost. */
+/* HEADERIZER END: src/gc/gc_gms.c */
+
+/* HEADERIZER BEGIN: src/gc/event_log.c */
+/* Don't modify between HEADERIZER BEGIN / HEADERIZER END.  Your changes will be lost. */
+
+PARROT_CAN_RETURN_NULL
+GC_Event * Parrot_gc_event_begin(PARROT_INTERP, GC_Event_type type)
+        __attribute__nonnull__(1);
+
+void Parrot_gc_event_end(PARROT_INTERP, ARGMOD_NULLOK(GC_Event *event))
+        __attribute__nonnull__(1)
+        FUNC_MODIFIES(*event);
+
+void Parrot_gc_event_log_destroy(PARROT_INTERP)
+        __attribute__nonnull__(1);
+
+void Parrot_gc_event_log_init(PARROT_INTERP)
+        __attribute__nonnull__(1);
+
+PARROT_CANNOT_RETURN_NULL
+PMC * Parrot_gc_event_log_pmc(PARROT_INTERP)
+        __attribute__nonnull__(1);
+
+void Parrot_gc_event_log_write(PARROT_INTERP)
+        __attribute__nonnull__(1);
+
+#define ASSERT_ARGS_Parrot_gc_event_begin __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp))
+#define ASSERT_ARGS_Parrot_gc_event_end __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp))
+#define ASSERT_ARGS_Parrot_gc_event_log_destroy __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp))
+#define ASSERT_ARGS_Parrot_gc_event_log_init __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp))
+#define ASSERT_ARGS_Parrot_gc_event_log_pmc __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp))
+#define ASSERT_ARGS_Parrot_gc_event_log_write __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp))
+/* Don't modify between HEADERIZER BEGIN / HEADERIZER END.  Your changes will be lost. */
+/* HEADERIZER END: src/gc/event_log.c */
+
+/* HEADERIZER BEGIN: src/gc/mark_parallel.c */
+/* Don't modify between HEADERIZER BEGIN / HEADERIZER END.  Your changes will be lost. */
+
+int Parrot_gc_parallel_mark_begin(PARROT_INTERP)
+        __attribute__nonnull__(1);
+
+void Parrot_gc_parallel_mark_destroy(PARROT_INTERP)
+        __attribute__nonnull__(1);
+
+void Parrot_gc_parallel_mark_finish(PARROT_INTERP)
+        __attribute__nonnull__(1);
+
+int Parrot_gc_parallel_mark_flags(SHIM_INTERP,
+    ARGMOD(PObj *obj),
+    UINTVAL set,
+    UINTVAL clear)
+        __attribute__nonnull__(2)
+        FUNC_MODIFIES(*obj);
+
+void Parrot_gc_parallel_mark_init(PARROT_INTERP)
+        __attribute__nonnull__(1);
+
+int Parrot_gc_parallel_mark_PObj(SHIM_INTERP, ARGMOD(PObj *obj))
+        __attribute__nonnull__(2)
+        FUNC_MODIFIES(*obj);
+
+#define ASSERT_ARGS_Parrot_gc_parallel_mark_begin __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp))
+#define ASSERT_ARGS_Parrot_gc_parallel_mark_destroy \
+     __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp))
+#define ASSERT_ARGS_Parrot_gc_parallel_mark_finish \
+     __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp))
+#define ASSERT_ARGS_Parrot_gc_parallel_mark_flags __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(obj))
+#define ASSERT_ARGS_Parrot_gc_parallel_mark_init __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp))
+#define ASSERT_ARGS_Parrot_gc_parallel_mark_PObj __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(obj))
+/* Don't modify between HEADERIZER BEGIN / HEADERIZER END.  Your changes will be lost. */
+/* HEADERIZER END: src/gc/mark_parallel.c */
+
+/* HEADERIZER BEGIN: src/gc/pacing.c */
+/* Don't modify between HEADERIZER BEGIN / HEADERIZER END.  Your changes will be lost. */
+
+void Parrot_gc_pacing_set_ratio(PARROT_INTERP, UINTVAL ratio)
+        __attribute__nonnull__(1);
+
+void Parrot_gc_pacing_swept(PARROT_INTERP, ARGMOD(Fixed_Size_Pool *pool))
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2)
+        FUNC_MODIFIES(*pool);
+
+#define ASSERT_ARGS_Parrot_gc_pacing_set_ratio __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp))
+#define ASSERT_ARGS_Parrot_gc_pacing_swept __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp) \
+    , PARROT_ASSERT_ARG(pool))
+/* Don't modify between HEADERIZER BEGIN / HEADERIZER END.  Your changes will be lost. */
+/* HEADERIZER END: src/gc/pacing.c */
+
 /* HEADERIZER BEGIN: src/gc/gc_inf.c */
 /* Don't modify between HEADERIZER BEGIN / HEADERIZER END.  Your changes will be lost. */
 
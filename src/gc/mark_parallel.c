@@ -0,0 +1,695 @@
+/*
+Copyright (C) 2001-2009, Parrot Foundation.
+$Id$
+
+=head1 NAME
+
+src/gc/mark_parallel.c - Parallel mark phase for the MS core
+
+=head1 DESCRIPTION
+
+This code spreads the mark phase of the MS collector in F<src/gc/gc_ms.c>
+over a pool of worker threads. It is disabled by default; to enable it, set
+the C<PARROT_GC_MARK_THREADS> environment variable to the number of threads
+that should mark, counting the interpreter's own thread.
+
+While a parallel mark is in progress, C<Parrot_gc_mark_PObj_alive> and
+C<Parrot_gc_mark_PMC_alive> don't recurse into the children of a PMC. They
+set the live bit with an atomic I<fetch and or>, and the thread which set it
+pushes the PMC onto its own I<grey stack>. So every PMC is scanned exactly
+once, by the thread that won the race for its live bit.
+
+The mark runs in two steps. The interpreter's thread traces the root set
+first, as in a serial run, collecting the grey roots. These are dealt out to
+all the workers, which then scan their grey stacks. Each worker keeps a
+private stack which needs no locking, and moves some entries to a shared
+stack when it has plenty of them. A worker whose stacks are empty steals
+from the shared stack of another worker. The mark ends when all the workers
+are idle and every shared stack is empty. A shared stack, even its count, is
+only looked at with its worker's lock held, and the count of idle workers
+with the pool's lock held.
+
+Other flags a worker changes on the PMCs it scans are changed atomically as
+well, as other workers may be setting the live bit of the same PMC.
+
+The sweep is still done by the interpreter's thread. Lazy runs, which stop
+as soon as every object needing timely destruction has been found, are
+always serial.
+
+Parallel marking needs the GCC atomic builtins and thread local storage. On
+other platforms C<PARROT_GC_MARK_THREADS> is ignored.
+
+=cut
+
+*/
+
+#include "parrot/parrot.h"
+#include "gc_private.h"
+
+/* HEADERIZER HFILE: src/gc/gc_private.h */
+
+/* Upper limit for PARROT_GC_MARK_THREADS */
+#define GC_MARK_MAX_THREADS      64
+
+/* Initial size of a grey stack */
+#define GC_MARK_STACK_SIZE       1024
+
+/* A worker shares part of its private stack when it holds more than this
+ * many objects ... */
+#define GC_MARK_SHARE_THRESHOLD  64
+
+/* ... and then moves this many */
+#define GC_MARK_SHARE_CHUNK      32
+
+/* A stack of grey objects: marked live, but their children not yet */
+typedef struct GC_Mark_Stack {
+    PObj   **objects;
+    size_t   count;
+    size_t   size;
+} GC_Mark_Stack;
+
+typedef struct GC_Mark_Worker {
+    struct GC_Mark_Workers *pool;
+    Parrot_thread           thread;
+    GC_Mark_Stack           local;   /* private grey objects, no locking */
+    GC_Mark_Stack           shared;  /* grey objects others may steal */
+    Parrot_mutex            lock;    /* protects shared */
+    size_t                  index;
+} GC_Mark_Worker;
+
+typedef struct GC_Mark_Workers {
+    Interp         *interp;
+    GC_Mark_Worker *workers;         /* workers[0] is the interpreter thread */
+    size_t          num_workers;
+    Parrot_mutex    lock;            /* protects all the fields below */
+    Parrot_cond     start_cond;      /* signalled when a mark starts */
+    Parrot_cond     work_cond;       /* signalled when work is shared */
+    Parrot_cond     done_cond;       /* signalled when the workers are done */
+    UINTVAL         mark_runs;       /* number of parallel marks started */
+    size_t          idle;            /* workers waiting for work */
+    size_t          running;         /* threads still in the current mark */
+    int             quit;
+} GC_Mark_Workers;
+
+#if PARROT_GC_PARALLEL_MARK
+/* The worker of the current thread, while it takes part in a mark */
+static __thread GC_Mark_Worker *current_worker;
+#endif
+
+/* HEADERIZER BEGIN: static */
+/* Don't modify between HEADERIZER BEGIN / HEADERIZER END.  Your changes will be lost. */
+
+PARROT_WARN_UNUSED_RESULT
+static int gc_parallel_has_work(ARGIN(const GC_Mark_Workers *pool))
+        __attribute__nonnull__(1);
+
+static void gc_parallel_mark_drain(PARROT_INTERP,
+    ARGMOD(GC_Mark_Worker *worker))
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2)
+        FUNC_MODIFIES(*worker);
+
+static int gc_parallel_mark_refill(ARGMOD(GC_Mark_Worker *worker))
+        __attribute__nonnull__(1)
+        FUNC_MODIFIES(*worker);
+
+static void gc_parallel_mark_share(ARGMOD(GC_Mark_Worker *worker))
+        __attribute__nonnull__(1)
+        FUNC_MODIFIES(*worker);
+
+static void gc_parallel_stack_push(
+    ARGMOD(GC_Mark_Stack *stack),
+    ARGIN(PObj *obj))
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2)
+        FUNC_MODIFIES(*stack);
+
+PARROT_CAN_RETURN_NULL
+static void * gc_parallel_worker_main(ARGIN(void *arg))
+        __attribute__nonnull__(1);
+
+#define ASSERT_ARGS_gc_parallel_has_work __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(pool))
+#define ASSERT_ARGS_gc_parallel_mark_drain __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp) \
+    , PARROT_ASSERT_ARG(worker))
+#define ASSERT_ARGS_gc_parallel_mark_refill __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(worker))
+#define ASSERT_ARGS_gc_parallel_mark_share __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(worker))
+#define ASSERT_ARGS_gc_parallel_stack_push __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(stack) \
+    , PARROT_ASSERT_ARG(obj))
+#define ASSERT_ARGS_gc_parallel_worker_main __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(arg))
+/* Don't modify between HEADERIZER BEGIN / HEADERIZER END.  Your changes will be lost. */
+/* HEADERIZER END: static */
+
+/*
+
+=head2 Functions
+
+=over 4
+
+=item C<void Parrot_gc_parallel_mark_init(PARROT_INTERP)>
+
+Reads C<PARROT_GC_MARK_THREADS> and, if it asks for more than one thread,
+starts the worker threads for parallel marking.
+
+=cut
+
+*/
+
+void
+Parrot_gc_parallel_mark_init(PARROT_INTERP)
+{
+    ASSERT_ARGS(Parrot_gc_parallel_mark_init)
+    int          free_it;
+    char * const value = Parrot_getenv("PARROT_GC_MARK_THREADS", &free_it);
+    long         num_threads;
+
+    if (!value)
+        return;
+
+    num_threads = atol(value);
+
+    if (free_it)
+        mem_sys_free(value);
+
+    if (num_threads <= 1)
+        return;
+
+#if PARROT_GC_PARALLEL_MARK
+    {
+        GC_Mark_Workers * const pool =
+            mem_internal_allocate_zeroed_typed(GC_Mark_Workers);
+        size_t i;
+
+        if (num_threads > GC_MARK_MAX_THREADS)
+            num_threads = GC_MARK_MAX_THREADS;
+
+        pool->interp      = interp;
+        pool->num_workers = (size_t)num_threads;
+        pool->workers     = (GC_Mark_Worker *)mem_internal_allocate_zeroed(
+                                pool->num_workers * sizeof (GC_Mark_Worker));
+
+        MUTEX_INIT(pool->lock);
+        COND_INIT(pool->start_cond);
+        COND_INIT(pool->work_cond);
+        COND_INIT(pool->done_cond);
+
+        for (i = 0; i < pool->num_workers; ++i) {
+            GC_Mark_Worker * const worker = &pool->workers[i];
+
+            worker->pool  = pool;
+            worker->index = i;
+            MUTEX_INIT(worker->lock);
+        }
+
+        /* the interpreter's thread is worker 0 */
+        for (i = 1; i < pool->num_workers; ++i)
+            THREAD_CREATE_JOINABLE(pool->workers[i].thread,
+                    gc_parallel_worker_main, &pool->workers[i]);
+
+        interp->mem_pools->mark_workers = pool;
+    }
+#else
+    fprintf(stderr,
+            "PARROT_GC_MARK_THREADS: parallel marking is not available\n");
+#endif
+}
+
+/*
+
+=item C<void Parrot_gc_parallel_mark_destroy(PARROT_INTERP)>
+
+Stops the worker threads started by C<Parrot_gc_parallel_mark_init> and
+frees their stacks. Later marks are serial.
+
+=cut
+
+*/
+
+void
+Parrot_gc_parallel_mark_destroy(PARROT_INTERP)
+{
+    ASSERT_ARGS(Parrot_gc_parallel_mark_destroy)
+    GC_Mark_Workers * const pool = interp->mem_pools->mark_workers;
+    size_t i;
+
+    if (!pool)
+        return;
+
+    LOCK(pool->lock);
+    pool->quit = 1;
+    COND_BROADCAST(pool->start_cond);
+    UNLOCK(pool->lock);
+
+    for (i = 1; i < pool->num_workers; ++i) {
+        void *result;
+        JOIN(pool->workers[i].thread, result);
+        UNUSED(result);
+    }
+
+    for (i = 0; i < pool->num_workers; ++i) {
+        GC_Mark_Worker * const worker = &pool->workers[i];
+
+        MUTEX_DESTROY(worker->lock);
+        mem_internal_free(worker->local.objects);
+        mem_internal_free(worker->shared.objects);
+    }
+
+    COND_DESTROY(pool->start_cond);
+    COND_DESTROY(pool->work_cond);
+    COND_DESTROY(pool->done_cond);
+    MUTEX_DESTROY(pool->lock);
+
+    mem_internal_free(pool->workers);
+    mem_internal_free(pool);
+    interp->mem_pools->mark_workers = NULL;
+}
+
+/*
+
+=item C<int Parrot_gc_parallel_mark_begin(PARROT_INTERP)>
+
+Called before the root set is traced. Returns 1 if the mark is parallel. In
+this case, the PMCs reached from the roots are collected on the grey stack
+of the interpreter's thread, until C<Parrot_gc_parallel_mark_finish> scans
+them. Returns 0 if the mark is serial.
+
+=cut
+
+*/
+
+int
+Parrot_gc_parallel_mark_begin(PARROT_INTERP)
+{
+    ASSERT_ARGS(Parrot_gc_parallel_mark_begin)
+#if PARROT_GC_PARALLEL_MARK
+    GC_Mark_Workers * const pool = interp->mem_pools->mark_workers;
+
+    if (!pool || interp->mem_pools->lazy_gc)
+        return 0;
+
+    current_worker = &pool->workers[0];
+    return 1;
+#else
+    UNUSED(interp);
+    return 0;
+#endif
+}
+
+/*
+
+=item C<void Parrot_gc_parallel_mark_finish(PARROT_INTERP)>
+
+Deals out the grey roots to the workers, and marks everything reachable
+from them with all the workers. Returns when the mark is complete.
+
+=cut
+
+*/
+
+void
+Parrot_gc_parallel_mark_finish(PARROT_INTERP)
+{
+    ASSERT_ARGS(Parrot_gc_parallel_mark_finish)
+#if PARROT_GC_PARALLEL_MARK
+    GC_Mark_Workers * const pool  = interp->mem_pools->mark_workers;
+    GC_Mark_Worker  * const self  = &pool->workers[0];
+    GC_Mark_Stack   * const roots = &self->local;
+    size_t i;
+
+    /* the workers are all waiting for a new run, so no locking is needed
+     * until they are started */
+    for (i = 0; roots->count > 0; i = (i + 1) % pool->num_workers)
+        gc_parallel_stack_push(&pool->workers[i].shared,
+                roots->objects[--roots->count]);
+
+    LOCK(pool->lock);
+    pool->idle    = 0;
+    pool->running = pool->num_workers - 1;
+    pool->mark_runs++;
+    COND_BROADCAST(pool->start_cond);
+    UNLOCK(pool->lock);
+
+    gc_parallel_mark_drain(interp, self);
+
+    LOCK(pool->lock);
+    while (pool->running)
+        COND_WAIT(pool->done_cond, pool->lock);
+    UNLOCK(pool->lock);
+
+    current_worker = NULL;
+#else
+    UNUSED(interp);
+#endif
+}
+
+/*
+
+=item C<int Parrot_gc_parallel_mark_PObj(PARROT_INTERP, PObj *obj)>
+
+Marks C<obj> live for a parallel mark, and pushes it onto the grey stack of
+the current thread if it has children. Returns 0 without doing anything if
+the current thread doesn't take part in a parallel mark, so that the caller
+marks C<obj> serially.
+
+=cut
+
+*/
+
+int
+Parrot_gc_parallel_mark_PObj(SHIM_INTERP, ARGMOD(PObj *obj))
+{
+    ASSERT_ARGS(Parrot_gc_parallel_mark_PObj)
+#if PARROT_GC_PARALLEL_MARK
+    GC_Mark_Worker * const worker = current_worker;
+    Parrot_UInt            old_flags;
+
+    if (!worker)
+        return 0;
+
+    old_flags = __sync_fetch_and_or(&PObj_get_FLAGS(obj),
+                    (Parrot_UInt)PObj_live_FLAG);
+
+    /* another thread was first, or it is a free object */
+    if (old_flags & (PObj_live_FLAG | PObj_on_free_list_FLAG))
+        return 1;
+
+    if (PObj_is_PMC_TEST(obj)
+    && (PObj_is_special_PMC_TEST(obj) || PMC_metadata((PMC *)obj))) {
+        gc_parallel_stack_push(&worker->local, obj);
+
+        /* offer a chunk at most once per chunk pushed, to keep the locking
+         * off the common path */
+        if (worker->local.count > GC_MARK_SHARE_THRESHOLD
+        &&  worker->local.count % GC_MARK_SHARE_CHUNK == 0)
+            gc_parallel_mark_share(worker);
+    }
+
+    return 1;
+#else
+    UNUSED(obj);
+    return 0;
+#endif
+}
+
+/*
+
+=item C<int Parrot_gc_parallel_mark_flags(PARROT_INTERP, PObj *obj, UINTVAL set,
+UINTVAL clear)>
+
+Sets the flags C<set> and clears the flags C<clear> of C<obj> atomically,
+if the current thread takes part in a parallel mark. Returns 0 without doing
+anything otherwise, so that the caller changes the flags itself.
+
+=cut
+
+*/
+
+int
+Parrot_gc_parallel_mark_flags(SHIM_INTERP, ARGMOD(PObj *obj), UINTVAL set,
+        UINTVAL clear)
+{
+    ASSERT_ARGS(Parrot_gc_parallel_mark_flags)
+#if PARROT_GC_PARALLEL_MARK
+    if (!current_worker)
+        return 0;
+
+    if (set)
+        (void)__sync_fetch_and_or(&PObj_get_FLAGS(obj), (Parrot_UInt)set);
+
+    if (clear)
+        (void)__sync_fetch_and_and(&PObj_get_FLAGS(obj), ~(Parrot_UInt)clear);
+
+    return 1;
+#else
+    UNUSED(obj);
+    UNUSED(set);
+    UNUSED(clear);
+    return 0;
+#endif
+}
+
+/*
+
+=back
+
+=head2 Static Functions
+
+=over 4
+
+=item C<static void * gc_parallel_worker_main(void *arg)>
+
+The main loop of a worker thread. Waits for a mark to start, takes part in
+it, and waits for the next one, until C<Parrot_gc_parallel_mark_destroy>
+stops it.
+
+=cut
+
+*/
+
+PARROT_CAN_RETURN_NULL
+static void *
+gc_parallel_worker_main(ARGIN(void *arg))
+{
+    ASSERT_ARGS(gc_parallel_worker_main)
+#if PARROT_GC_PARALLEL_MARK
+    GC_Mark_Worker  * const worker = (GC_Mark_Worker *)arg;
+    GC_Mark_Workers * const pool   = worker->pool;
+    UINTVAL                 seen   = 0;
+
+    LOCK(pool->lock);
+
+    for (;;) {
+        while (pool->mark_runs == seen && !pool->quit)
+            COND_WAIT(pool->start_cond, pool->lock);
+
+        if (pool->quit)
+            break;
+
+        seen = pool->mark_runs;
+        UNLOCK(pool->lock);
+
+        current_worker = worker;
+        gc_parallel_mark_drain(pool->interp, worker);
+        current_worker = NULL;
+
+        LOCK(pool->lock);
+        if (--pool->running == 0)
+            COND_SIGNAL(pool->done_cond);
+    }
+
+    UNLOCK(pool->lock);
+#else
+    UNUSED(arg);
+#endif
+    return NULL;
+}
+
+/*
+
+=item C<static void gc_parallel_mark_drain(PARROT_INTERP, GC_Mark_Worker
+*worker)>
+
+Scans grey objects until there are none left in any of the stacks, and all
+the other workers are idle too.
+
+=cut
+
+*/
+
+static void
+gc_parallel_mark_drain(PARROT_INTERP, ARGMOD(GC_Mark_Worker *worker))
+{
+    ASSERT_ARGS(gc_parallel_mark_drain)
+    GC_Mark_Workers * const pool = worker->pool;
+
+    for (;;) {
+        while (worker->local.count > 0) {
+            PMC * const pmc = (PMC *)worker->local.objects[--worker->local.count];
+
+            if (PObj_is_special_PMC_TEST(pmc))
+                mark_special(interp, pmc);
+            else
+                Parrot_gc_mark_PMC_alive(interp, PMC_metadata(pmc));
+        }
+
+        if (gc_parallel_mark_refill(worker))
+            continue;
+
+        /* Nothing left here. A worker only goes idle with empty stacks, and
+         * an idle worker finds no new work, so once all of them are idle
+         * the mark is complete. */
+        LOCK(pool->lock);
+        pool->idle++;
+
+        while (pool->idle < pool->num_workers && !gc_parallel_has_work(pool))
+            COND_WAIT(pool->work_cond, pool->lock);
+
+        if (pool->idle == pool->num_workers) {
+            COND_BROADCAST(pool->work_cond);
+            UNLOCK(pool->lock);
+            return;
+        }
+
+        pool->idle--;
+        UNLOCK(pool->lock);
+    }
+}
+
+/*
+
+=item C<static int gc_parallel_mark_refill(GC_Mark_Worker *worker)>
+
+Refills the empty private stack of C<worker>, first from its own shared
+stack, then by stealing half of the shared stack of another worker. Returns
+0 if there was nothing to take.
+
+=cut
+
+*/
+
+static int
+gc_parallel_mark_refill(ARGMOD(GC_Mark_Worker *worker))
+{
+    ASSERT_ARGS(gc_parallel_mark_refill)
+    GC_Mark_Workers * const pool = worker->pool;
+    size_t i;
+
+    for (i = 0; i < pool->num_workers; ++i) {
+        GC_Mark_Worker * const victim =
+            &pool->workers[(worker->index + i) % pool->num_workers];
+        size_t take;
+
+        LOCK(victim->lock);
+        take = victim == worker
+             ? victim->shared.count
+             : (victim->shared.count + 1) / 2;
+
+        while (take-- > 0)
+            gc_parallel_stack_push(&worker->local,
+                    victim->shared.objects[--victim->shared.count]);
+        UNLOCK(victim->lock);
+
+        if (worker->local.count > 0)
+            return 1;
+    }
+
+    return 0;
+}
+
+/*
+
+=item C<static void gc_parallel_mark_share(GC_Mark_Worker *worker)>
+
+Moves some grey objects from the private stack of C<worker> to its shared
+stack, if that is empty, and wakes up idle workers to steal them.
+
+=cut
+
+*/
+
+static void
+gc_parallel_mark_share(ARGMOD(GC_Mark_Worker *worker))
+{
+    ASSERT_ARGS(gc_parallel_mark_share)
+    GC_Mark_Workers * const pool = worker->pool;
+    size_t i;
+
+    LOCK(worker->lock);
+
+    if (worker->shared.count > 0) {
+        UNLOCK(worker->lock);
+        return;
+    }
+
+    for (i = 0; i < GC_MARK_SHARE_CHUNK; ++i)
+        gc_parallel_stack_push(&worker->shared,
+                worker->local.objects[--worker->local.count]);
+    UNLOCK(worker->lock);
+
+    /* a worker going idle after this looks at the shared stacks first */
+    LOCK(pool->lock);
+    if (pool->idle > 0)
+        COND_BROADCAST(pool->work_cond);
+    UNLOCK(pool->lock);
+}
+
+/*
+
+=item C<static int gc_parallel_has_work(const GC_Mark_Workers *pool)>
+
+Returns 1 if any shared stack holds grey objects. Called with the pool's
+lock held; takes each worker's lock in turn.
+
+=cut
+
+*/
+
+PARROT_WARN_UNUSED_RESULT
+static int
+gc_parallel_has_work(ARGIN(const GC_Mark_Workers *pool))
+{
+    ASSERT_ARGS(gc_parallel_has_work)
+    size_t i;
+
+    for (i = 0; i < pool->num_workers; ++i) {
+        GC_Mark_Worker * const worker = &pool->workers[i];
+        size_t                 count;
+
+        LOCK(worker->lock);
+        count = worker->shared.count;
+        UNLOCK(worker->lock);
+
+        if (count > 0)
+            return 1;
+    }
+
+    return 0;
+}
+
+/*
+
+=item C<static void gc_parallel_stack_push(GC_Mark_Stack *stack, PObj *obj)>
+
+Pushes C<obj> onto C<stack>, growing it if needed.
+
+=cut
+
+*/
+
+static void
+gc_parallel_stack_push(ARGMOD(GC_Mark_Stack *stack), ARGIN(PObj *obj))
+{
+    ASSERT_ARGS(gc_parallel_stack_push)
+
+    if (stack->count == stack->size) {
+        stack->size    = stack->size ? stack->size * 2 : GC_MARK_STACK_SIZE;
+        stack->objects = (PObj **)mem_internal_realloc(stack->objects,
+                            stack->size * sizeof (PObj *));
+    }
+
+    stack->objects[stack->count++] = obj;
+}
+
+/*
+
+=back
+
+=head1 SEE ALSO
+
+F<src/gc/gc_ms.c>, F<src/gc/mark_sweep.c>
+
+=cut
+
+*/
+
+/*
+ * Local variables:
+ *   c-file-style: "parrot"
+ * End:
+ * vim: expandtab shiftwidth=4:
+ */
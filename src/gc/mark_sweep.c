@@ -25,23 +25,47 @@ throughout the rest of Parrot.
 
 #include "parrot/parrot.h"
 #include "gc_private.h"
+#include "../string/encoding/utf8.h"
 
 /* HEADERIZER HFILE: src/gc/gc_private.h */
 
 /* HEADERIZER BEGIN: static */
 /* Don't modify between HEADERIZER BEGIN / HEADERIZER END.  Your changes will be lost. */
 
-static void free_buffer(SHIM_INTERP,
+static void add_swept_object(
+    ARGMOD(Fixed_Size_Pool *pool),
+    ARGMOD(PObj *obj))
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2)
+        FUNC_MODIFIES(*pool)
+        FUNC_MODIFIES(*obj);
+
+static void end_lazy_sweep(PARROT_INTERP, ARGMOD(Fixed_Size_Pool *pool))
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2)
+        FUNC_MODIFIES(*pool);
+
+static int finish_lazy_sweep_cb(PARROT_INTERP,
+    ARGMOD(Fixed_Size_Pool *pool),
+    SHIM(int flag),
+    SHIM(void *arg))
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2)
+        FUNC_MODIFIES(*pool);
+
+static void free_buffer(PARROT_INTERP,
     ARGMOD(Fixed_Size_Pool *pool),
     ARGMOD(Buffer *b))
+        __attribute__nonnull__(1)
         __attribute__nonnull__(2)
         __attribute__nonnull__(3)
         FUNC_MODIFIES(*pool)
         FUNC_MODIFIES(*b);
 
-static void free_buffer_malloc(SHIM_INTERP,
+static void free_buffer_malloc(PARROT_INTERP,
     SHIM(Fixed_Size_Pool *pool),
     ARGMOD(Buffer *b))
+        __attribute__nonnull__(1)
         __attribute__nonnull__(3)
         FUNC_MODIFIES(*b);
 
@@ -85,11 +109,41 @@ static PMC_Attribute_Pool * Parrot_gc_create_attrib_pool(PARROT_INTERP,
     size_t attrib_size)
         __attribute__nonnull__(1);
 
-#define ASSERT_ARGS_free_buffer __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+static UINTVAL reclaim_arena_tail(PARROT_INTERP,
+    ARGMOD(Fixed_Size_Pool *pool),
+    ARGMOD(Fixed_Size_Arena *arena))
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2)
+        __attribute__nonnull__(3)
+        FUNC_MODIFIES(*pool)
+        FUNC_MODIFIES(*arena);
+
+static UINTVAL sweep_arena(PARROT_INTERP,
+    ARGMOD(Fixed_Size_Pool *pool),
+    ARGMOD(Fixed_Size_Arena *arena),
+    int lazy)
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2)
+        __attribute__nonnull__(3)
+        FUNC_MODIFIES(*pool)
+        FUNC_MODIFIES(*arena);
+
+#define ASSERT_ARGS_add_swept_object __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
        PARROT_ASSERT_ARG(pool) \
+    , PARROT_ASSERT_ARG(obj))
+#define ASSERT_ARGS_end_lazy_sweep __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp) \
+    , PARROT_ASSERT_ARG(pool))
+#define ASSERT_ARGS_finish_lazy_sweep_cb __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp) \
+    , PARROT_ASSERT_ARG(pool))
+#define ASSERT_ARGS_free_buffer __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp) \
+    , PARROT_ASSERT_ARG(pool) \
     , PARROT_ASSERT_ARG(b))
 #define ASSERT_ARGS_free_buffer_malloc __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
-       PARROT_ASSERT_ARG(b))
+       PARROT_ASSERT_ARG(interp) \
+    , PARROT_ASSERT_ARG(b))
 #define ASSERT_ARGS_free_pmc_in_pool __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
        PARROT_ASSERT_ARG(interp) \
     , PARROT_ASSERT_ARG(p))
@@ -106,6 +160,14 @@ static PMC_Attribute_Pool * Parrot_gc_create_attrib_pool(PARROT_INTERP,
     , PARROT_ASSERT_ARG(pool))
 #define ASSERT_ARGS_Parrot_gc_create_attrib_pool __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
        PARROT_ASSERT_ARG(interp))
+#define ASSERT_ARGS_reclaim_arena_tail __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp) \
+    , PARROT_ASSERT_ARG(pool) \
+    , PARROT_ASSERT_ARG(arena))
+#define ASSERT_ARGS_sweep_arena __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp) \
+    , PARROT_ASSERT_ARG(pool) \
+    , PARROT_ASSERT_ARG(arena))
 /* Don't modify between HEADERIZER BEGIN / HEADERIZER END.  Your changes will be lost. */
 /* HEADERIZER END: static */
 
@@ -254,7 +316,8 @@ Parrot_gc_trace_root(PARROT_INTERP, Parrot_gc_trace_type trace)
 
 Puts any buffers/PMCs that are marked as "dead" or "black" onto the pool
 free list. If C<GC_IS_MALLOC>, bufstart gets freed too, if possible. Avoids
-buffers that are immune from collection (i.e. constant).
+buffers that are immune from collection (i.e. constant). Finishes a pending
+lazy sweep of the pool first.
 
 =cut
 
@@ -264,13 +327,14 @@ void
 Parrot_gc_sweep_pool(PARROT_INTERP, ARGMOD(Fixed_Size_Pool *pool))
 {
     ASSERT_ARGS(Parrot_gc_sweep_pool)
-    PObj *b;
-    UINTVAL i;
-    UINTVAL total_used        = 0;
-    const UINTVAL object_size = pool->object_size;
-
+    UINTVAL total_used = 0;
     Fixed_Size_Arena *cur_arena;
-    gc_object_fn_type   gc_object = pool->gc_object;
+
+    if (pool->sweep_arena)
+        Parrot_gc_lazy_sweep_finish(interp, pool);
+
+    pool->in_use_at_sweep = pool->total_objects - pool->num_free_objects;
+    pool->swept_live      = 0;
 
 #if GC_VERBOSE
     if (Interp_trace_TEST(interp, 1)) {
@@ -287,59 +351,337 @@ Parrot_gc_sweep_pool(PARROT_INTERP, ARGMOD(Fixed_Size_Pool *pool))
 #endif
 
     /* Run through all the PObj header pools and mark */
-    for (cur_arena = pool->last_Arena; cur_arena; cur_arena = cur_arena->prev) {
-        const size_t objects_end = cur_arena->used;
-        UINTVAL i;
-        b = (PObj *)cur_arena->start_objects;
+    for (cur_arena = pool->last_Arena; cur_arena; cur_arena = cur_arena->prev)
+        total_used += sweep_arena(interp, pool, cur_arena, 0);
 
-        /* loop only while there are objects in the arena */
-        for (i = objects_end; i; i--) {
+    pool->num_free_objects = pool->total_objects - total_used;
+}
 
-            if (PObj_on_free_list_TEST(b))
-                ; /* if it's on free list, do nothing */
-            else if (PObj_live_TEST(b)) {
-                total_used++;
-                PObj_live_CLEAR(b);
-                PObj_get_FLAGS(b) &= ~PObj_custom_GC_FLAG;
-            }
-            else {
-                /* it must be dead */
+
+/*
+
+=item C<static UINTVAL sweep_arena(PARROT_INTERP, Fixed_Size_Pool *pool,
+Fixed_Size_Arena *arena, int lazy)>
+
+Sweeps a single arena of the pool and returns the number of objects in use.
+Dead objects go onto the free list; for a C<lazy> sweep they go onto the
+pool's C<swept_list> instead and are counted as free. Dead PMCs at the end
+of the newest arena are handed back to the bump allocator instead, see
+C<reclaim_arena_tail>.
+
+=cut
+
+*/
+
+static UINTVAL
+sweep_arena(PARROT_INTERP, ARGMOD(Fixed_Size_Pool *pool),
+        ARGMOD(Fixed_Size_Arena *arena), int lazy)
+{
+    ASSERT_ARGS(sweep_arena)
+    const UINTVAL     object_size = pool->object_size;
+    gc_object_fn_type gc_object   = pool->gc_object;
+    PObj             *b;
+    UINTVAL           total_used  = 0;
+    UINTVAL           total_freed = 0;
+    UINTVAL           i;
+
+#if GC_USE_LAZY_ALLOCATOR
+    /* not worth it for STRING headers, whose cost is in compacting the
+     * buffers they point to */
+    if (arena == pool->last_Arena && pool == interp->mem_pools->pmc_pool)
+        total_freed += reclaim_arena_tail(interp, pool, arena);
+#endif
+
+    /* walk the arena backwards, so that the dead objects come out on the
+     * free list in address order */
+    b = (PObj *)((char *)arena->start_objects + arena->used * object_size);
+
+    /* loop only while there are objects in the arena */
+    for (i = arena->used; i; i--) {
+        b = (PObj *)((char *)b - object_size);
+
+        if (PObj_on_free_list_TEST(b))
+            ; /* if it's on free list, do nothing */
+        else if (PObj_live_TEST(b)) {
+            total_used++;
+            PObj_live_CLEAR(b);
+            PObj_get_FLAGS(b) &= ~PObj_custom_GC_FLAG;
+        }
+        else {
+            /* it must be dead */
 
 #if GC_VERBOSE
-                if (Interp_trace_TEST(interp, 1)) {
-                    fprintf(stderr, "Freeing pobject %p\n", b);
-                    if (PObj_is_PMC_TEST(b)) {
-                        fprintf(stderr, "\t = PMC type %s\n",
-                                (char*) ((PMC*)b)->vtable->whoami->strstart);
-                    }
+            if (Interp_trace_TEST(interp, 1)) {
+                fprintf(stderr, "Freeing pobject %p\n", b);
+                if (PObj_is_PMC_TEST(b)) {
+                    fprintf(stderr, "\t = PMC type %s\n",
+                            (char*) ((PMC*)b)->vtable->whoami->strstart);
                 }
+            }
 #endif
 
-                if (PObj_is_shared_TEST(b)) {
-                    /* only mess with shared objects if we
-                     * (and thus everyone) is suspended for
-                     * a GC run.
-                     * XXX wrong thing to do with "other" GCs
-                     */
-                    if (!(interp->thread_data &&
-                            (interp->thread_data->state &
-                            THREAD_STATE_SUSPENDED_GC))) {
-                        ++total_used;
-                        goto next;
-                    }
+            if (PObj_is_shared_TEST(b)) {
+                /* only mess with shared objects if we
+                 * (and thus everyone) is suspended for
+                 * a GC run.
+                 * XXX wrong thing to do with "other" GCs
+                 */
+                if (!(interp->thread_data &&
+                        (interp->thread_data->state &
+                        THREAD_STATE_SUSPENDED_GC))) {
+                    ++total_used;
+                    continue;
                 }
+            }
 
-                if (gc_object)
-                    gc_object(interp, pool, b);
+            if (gc_object)
+                gc_object(interp, pool, b);
 
-                pool->add_free_object(interp, pool, b);
+            if (lazy) {
+                add_swept_object(pool, b);
+                total_freed++;
             }
-next:
-            b = (PObj *)((char *)b + object_size);
+            else
+                pool->add_free_object(interp, pool, b);
         }
     }
 
-    pool->num_free_objects = pool->total_objects - total_used;
+    if (lazy)
+        pool->num_free_objects += total_freed;
+
+    pool->swept_live += total_used;
+
+    return total_used;
+}
+
+
+/*
+
+=item C<static UINTVAL reclaim_arena_tail(PARROT_INTERP, Fixed_Size_Pool
+*pool, Fixed_Size_Arena *arena)>
+
+Frees the run of dead objects at the end of the used part of C<arena>, the
+newest arena of the pool, and gives it back to the bump region of the lazy
+allocator. Objects allocated after the sweep are then adjacent again,
+instead of being scattered over the free list. Returns the number of
+objects reclaimed.
+
+=cut
+
+*/
+
+static UINTVAL
+reclaim_arena_tail(PARROT_INTERP, ARGMOD(Fixed_Size_Pool *pool),
+        ARGMOD(Fixed_Size_Arena *arena))
+{
+    ASSERT_ARGS(reclaim_arena_tail)
+    const size_t object_size = pool->object_size;
+    char        *end         = (char *)arena->start_objects
+                             + arena->used * object_size;
+    UINTVAL      reclaimed   = 0;
+
+    while (arena->used) {
+        PObj * const b = (PObj *)(end - object_size);
+
+        if (PObj_on_free_list_TEST(b)
+        ||  PObj_live_TEST(b)
+        ||  PObj_is_shared_TEST(b))
+            break;
+
+        if (pool->gc_object)
+            pool->gc_object(interp, pool, b);
+
+        end -= object_size;
+        arena->used--;
+        reclaimed++;
+    }
+
+    if (reclaimed) {
+        pool->newfree = end;
+        pool->newlast = (char *)arena->start_objects
+                      + arena->total_objects * object_size;
+    }
+
+    return reclaimed;
+}
+
+
+/*
+
+=item C<static void add_swept_object(Fixed_Size_Pool *pool, PObj *obj)>
+
+Adds an object freed by a lazy sweep to the pool's C<swept_list>.
+
+=cut
+
+*/
+
+static void
+add_swept_object(ARGMOD(Fixed_Size_Pool *pool), ARGMOD(PObj *obj))
+{
+    ASSERT_ARGS(add_swept_object)
+    GC_MS_PObj_Wrapper * const object = (GC_MS_PObj_Wrapper *)obj;
+
+    PObj_flags_SETTO(object, PObj_on_free_list_FLAG);
+
+    if (!pool->swept_list)
+        pool->swept_last = object;
+
+    object->next_ptr = pool->swept_list;
+    pool->swept_list = object;
+}
+
+
+/*
+
+=item C<void Parrot_gc_lazy_sweep_pool(PARROT_INTERP, Fixed_Size_Pool *pool)>
+
+Starts a lazy sweep of the pool after a mark. Only the newest arena, which
+the allocator may still be handing out fresh objects from, is swept right
+away. The other arenas are left to C<Parrot_gc_lazy_sweep_step>, called by
+the allocator when it runs out of swept objects, so the cost of the sweep
+is spread over the allocations following the collection.
+
+=cut
+
+*/
+
+void
+Parrot_gc_lazy_sweep_pool(PARROT_INTERP, ARGMOD(Fixed_Size_Pool *pool))
+{
+    ASSERT_ARGS(Parrot_gc_lazy_sweep_pool)
+    Fixed_Size_Arena * const arena = pool->last_Arena;
+
+    /* the previous sweep has to finish before the next mark */
+    PARROT_ASSERT(!pool->sweep_arena);
+
+    if (!arena)
+        return;
+
+    pool->in_use_at_sweep = pool->total_objects - pool->num_free_objects;
+    pool->swept_live      = 0;
+
+    sweep_arena(interp, pool, arena, 1);
+    pool->sweep_arena = arena->prev;
+
+    if (!pool->sweep_arena)
+        end_lazy_sweep(interp, pool);
+}
+
+
+/*
+
+=item C<void Parrot_gc_lazy_sweep_step(PARROT_INTERP, Fixed_Size_Pool *pool)>
+
+Sweeps the next arena of a pending lazy sweep.
+
+=item C<void Parrot_gc_lazy_sweep_finish(PARROT_INTERP, Fixed_Size_Pool *pool)>
+
+Sweeps all arenas left by a pending lazy sweep.
+
+=cut
+
+*/
+
+void
+Parrot_gc_lazy_sweep_step(PARROT_INTERP, ARGMOD(Fixed_Size_Pool *pool))
+{
+    ASSERT_ARGS(Parrot_gc_lazy_sweep_step)
+    Fixed_Size_Arena * const arena = pool->sweep_arena;
+
+    if (!arena)
+        return;
+
+    pool->sweep_arena = arena->prev;
+    sweep_arena(interp, pool, arena, 1);
+    interp->mem_pools->gc_lazy_sweep_arenas++;
+
+    if (!pool->sweep_arena)
+        end_lazy_sweep(interp, pool);
+}
+
+void
+Parrot_gc_lazy_sweep_finish(PARROT_INTERP, ARGMOD(Fixed_Size_Pool *pool))
+{
+    ASSERT_ARGS(Parrot_gc_lazy_sweep_finish)
+
+    if (!pool->sweep_arena)
+        return;
+
+    while (pool->sweep_arena) {
+        Fixed_Size_Arena * const arena = pool->sweep_arena;
+
+        pool->sweep_arena = arena->prev;
+        sweep_arena(interp, pool, arena, 1);
+        interp->mem_pools->gc_forced_sweep_arenas++;
+    }
+
+    end_lazy_sweep(interp, pool);
+}
+
+
+/*
+
+=item C<static void end_lazy_sweep(PARROT_INTERP, Fixed_Size_Pool *pool)>
+
+Ends a lazy sweep of the pool by putting the remaining swept objects in
+front of the free list, which is safe to allocate from again. As after a
+full sweep, empty arenas may be given back to the system, and the pacer
+learns about the survivors.
+
+=cut
+
+*/
+
+static void
+end_lazy_sweep(PARROT_INTERP, ARGMOD(Fixed_Size_Pool *pool))
+{
+    ASSERT_ARGS(end_lazy_sweep)
+
+    if (pool->swept_list) {
+        pool->swept_last->next_ptr = pool->free_list;
+        pool->free_list            = pool->swept_list;
+    }
+
+    pool->swept_list = NULL;
+    pool->swept_last = NULL;
+
+    Parrot_gc_release_empty_arenas(interp, pool);
+    Parrot_gc_pacing_swept(interp, pool);
+}
+
+
+/*
+
+=item C<void Parrot_gc_finish_lazy_sweeps(PARROT_INTERP)>
+
+Finishes the pending lazy sweeps of all pools. Must be called before the
+next mark, which relies on the live bits cleared by the sweep.
+
+=item C<static int finish_lazy_sweep_cb(PARROT_INTERP, Fixed_Size_Pool *pool,
+int flag, void *arg)>
+
+Pool iteration callback for C<Parrot_gc_finish_lazy_sweeps>.
+
+=cut
+
+*/
+
+void
+Parrot_gc_finish_lazy_sweeps(PARROT_INTERP)
+{
+    ASSERT_ARGS(Parrot_gc_finish_lazy_sweeps)
+    header_pools_iterate_callback(interp, POOL_BUFFER | POOL_PMC, NULL,
+        finish_lazy_sweep_cb);
+}
+
+static int
+finish_lazy_sweep_cb(PARROT_INTERP, ARGMOD(Fixed_Size_Pool *pool),
+        SHIM(int flag), SHIM(void *arg))
+{
+    ASSERT_ARGS(finish_lazy_sweep_cb)
+    Parrot_gc_lazy_sweep_finish(interp, pool);
+    return 0;
 }
 
 
@@ -390,6 +732,7 @@ void
 mark_special(PARROT_INTERP, ARGIN(PMC *obj))
 {
     ASSERT_ARGS(mark_special)
+    UINTVAL set, clear;
 
     /*
      * If the object is shared, we have to use the arena and gc
@@ -410,11 +753,26 @@ mark_special(PARROT_INTERP, ARGIN(PMC *obj))
             interp->mem_pools->gc_mark_ptr = obj;
     }
 
-    PObj_get_FLAGS(obj) |= PObj_custom_GC_FLAG;
+    set   = PObj_custom_GC_FLAG;
+    clear = 0;
+
+    /* clearing the flag is much more expensive then testing; this is
+     * PObj_high_priority_gc_CLEAR, spelled out as flags to change */
+    if (!PObj_needs_early_gc_TEST(obj)) {
+        clear = PObj_high_priority_gc_FLAG;
+
+        if (PObj_get_FLAGS(obj)
+        & (PObj_custom_destroy_FLAG | PObj_custom_mark_FLAG))
+            set   |= PObj_is_special_PMC_FLAG;
+        else
+            clear |= PObj_is_special_PMC_FLAG;
+    }
 
-    /* clearing the flag is much more expensive then testing */
-    if (!PObj_needs_early_gc_TEST(obj))
-        PObj_high_priority_gc_CLEAR(obj);
+    /* other threads of a parallel mark may be setting the live bit of obj,
+     * so the flags have to be changed atomically then */
+    if (!interp->mem_pools->mark_workers
+    ||  !Parrot_gc_parallel_mark_flags(interp, (PObj *)obj, set, clear))
+        PObj_get_FLAGS(obj) = (PObj_get_FLAGS(obj) | set) & ~clear;
 
     /* mark properties */
     Parrot_gc_mark_PMC_alive(interp, PMC_metadata(obj));
@@ -541,6 +899,145 @@ Parrot_append_arena_in_pool(PARROT_INTERP,
 
     pool->last_Arena = new_arena;
     interp->mem_pools->header_allocs_since_last_collect++;
+    interp->mem_pools->header_memory_allocated += size;
+}
+
+/*
+
+=item C<void Parrot_gc_release_empty_arenas(PARROT_INTERP, Fixed_Size_Pool
+*pool)>
+
+Frees the arenas of C<pool> in which every object is on the free list,
+once C<GC_RELEASE_AFTER_SWEEPS> sweeps in a row have left at most
+1/C<GC_RELEASE_OCCUPANCY> of the pool in use, or right away when the heap
+is over its maximum size. Keeps at least as many free objects as there are
+live ones, and never frees the newest arena, which holds the region of the
+lazy allocator. Must be called right after a full sweep of the pool.
+
+=cut
+
+*/
+
+void
+Parrot_gc_release_empty_arenas(PARROT_INTERP, ARGMOD(Fixed_Size_Pool *pool))
+{
+    ASSERT_ARGS(Parrot_gc_release_empty_arenas)
+    Memory_Pools * const mem_pools = interp->mem_pools;
+    const size_t         live      = pool->total_objects - pool->num_free_objects;
+    Fixed_Size_Arena    *released  = NULL;
+    Fixed_Size_Arena    *arena;
+    GC_MS_PObj_Wrapper **next_ptr;
+
+    if (live * GC_RELEASE_OCCUPANCY < pool->total_objects)
+        pool->low_occupancy_sweeps++;
+    else
+        pool->low_occupancy_sweeps = 0;
+
+    if (pool->low_occupancy_sweeps < GC_RELEASE_AFTER_SWEEPS
+    && !Parrot_gc_heap_exceeds_max(interp, 0))
+        return;
+
+    pool->low_occupancy_sweeps = 0;
+
+    if (!pool->last_Arena)
+        return;
+
+    for (arena = pool->last_Arena->prev; arena;) {
+        Fixed_Size_Arena * const prev = arena->prev;
+        const size_t             size = arena->total_objects * pool->object_size;
+        PObj                    *b    = (PObj *)arena->start_objects;
+        size_t                   i;
+
+        if (pool->num_free_objects < live + arena->used
+        ||  pool->total_objects    < arena->total_objects) {
+            arena = prev;
+            continue;
+        }
+
+        for (i = arena->used; i; i--) {
+            if (!PObj_on_free_list_TEST(b))
+                break;
+            b = (PObj *)((char *)b + pool->object_size);
+        }
+
+        if (!i) {
+            /* the arena is empty; take its objects off the free list below
+             * by clearing their flags */
+            b = (PObj *)arena->start_objects;
+            for (i = arena->used; i; i--) {
+                PObj_flags_SETTO(b, 0);
+                b = (PObj *)((char *)b + pool->object_size);
+            }
+
+            arena->next->prev = prev;
+            if (prev)
+                prev->next = arena->next;
+
+            arena->next = released;
+            released    = arena;
+
+            pool->num_free_objects -= arena->used;
+            pool->total_objects    -= arena->total_objects;
+
+            if (mem_pools->header_memory_allocated >= size)
+                mem_pools->header_memory_allocated -= size;
+        }
+
+        arena = prev;
+    }
+
+    if (!released)
+        return;
+
+    next_ptr = &pool->free_list;
+
+    while (*next_ptr) {
+        GC_MS_PObj_Wrapper * const object = *next_ptr;
+
+        if (PObj_on_free_list_TEST((PObj *)object))
+            next_ptr = &object->next_ptr;
+        else
+            *next_ptr = object->next_ptr;
+    }
+
+    while (released) {
+        Fixed_Size_Arena * const next = released->next;
+
+        mem_internal_free(released->start_objects);
+        mem_internal_free(released);
+        released = next;
+    }
+
+    pool->replenish_level =
+        (size_t)(pool->total_objects * REPLENISH_LEVEL_FACTOR);
+}
+
+/*
+
+=item C<int Parrot_gc_heap_exceeds_max(PARROT_INTERP, size_t growth)>
+
+Returns whether growing the heap by C<growth> bytes would take it over the
+maximum size set with C<PARROT_GC_MAX_HEAP>. The heap is the memory of the
+header arenas and of the string and buffer blocks. The limit is soft: the
+collectors run before growing past it, but grow anyway if that does not
+free enough.
+
+=cut
+
+*/
+
+PARROT_WARN_UNUSED_RESULT
+int
+Parrot_gc_heap_exceeds_max(PARROT_INTERP, size_t growth)
+{
+    ASSERT_ARGS(Parrot_gc_heap_exceeds_max)
+    const Memory_Pools * const mem_pools = interp->mem_pools;
+
+    if (!mem_pools->max_heap)
+        return 0;
+
+    return mem_pools->memory_allocated + mem_pools->header_memory_allocated
+         + growth > mem_pools->max_heap;
 }
 
 /*
@@ -720,10 +1217,14 @@ The buffer is not freed if the reference count is greater then 1.
 */
 
 static void
-free_buffer_malloc(SHIM_INTERP, SHIM(Fixed_Size_Pool *pool),
+free_buffer_malloc(PARROT_INTERP, SHIM(Fixed_Size_Pool *pool),
         ARGMOD(Buffer *b))
 {
     ASSERT_ARGS(free_buffer_malloc)
+
+    if (PObj_is_string_TEST(b) && PObj_get_FLAGS(b) & STRING_indexed_FLAG)
+        Parrot_utf8_forget_index(interp, (STRING *)b);
+
     /* free allocated space at (int *)bufstart - 1, but not if it used COW or is
      * external */
     Buffer_buflen(b) = 0;
@@ -755,11 +1256,15 @@ reuse later.
 */
 
 static void
-free_buffer(SHIM_INTERP, ARGMOD(Fixed_Size_Pool *pool), ARGMOD(Buffer *b))
+free_buffer(PARROT_INTERP, ARGMOD(Fixed_Size_Pool *pool), ARGMOD(Buffer *b))
 {
     ASSERT_ARGS(free_buffer)
     Variable_Size_Pool * const mem_pool = (Variable_Size_Pool *)pool->mem_pool;
 
+    /* the string's index must not outlive it */
+    if (PObj_is_string_TEST(b) && PObj_get_FLAGS(b) & STRING_indexed_FLAG)
+        Parrot_utf8_forget_index(interp, (STRING *)b);
+
     /* XXX Jarkko reported that on irix pool->mem_pool was NULL, which really
      * shouldn't happen */
     if (mem_pool) {
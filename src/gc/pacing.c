@@ -0,0 +1,286 @@
+/*
+Copyright (C) 2001-2009, Parrot Foundation.
+$Id$
+
+=head1 NAME
+
+src/gc/pacing.c - When to collect
+
+=head1 DESCRIPTION
+
+Whenever a pool of the MS core runs out of free objects, the collector has
+the choice between a collection and a new arena. A I<pacer> makes that
+choice. The pacer in use is C<interp-E<gt>mem_pools-E<gt>pacer>.
+
+The I<fixed> pacer, the default, keeps the heuristics Parrot always had: a
+pool out of free objects is collected, and gets a new arena if fewer than
+its C<replenish_level> objects were freed. On a small heap with much
+garbage, this collects far too often; on a large heap with little garbage,
+the replenish level lets the heap grow without bound.
+
+The I<ratio> pacer sets the next collection threshold from the PMCs which
+survived the last one: the PMC pool is collected once it holds the live
+PMCs found by its last sweep plus a ratio of them, and grows until then. A
+ratio of 100 lets the pool grow to twice the live PMCs before collecting
+again. The ratio is given with the I<--gc-ratio> command line option or the
+C<PARROT_GC_RATIO> environment variable.
+
+New STRING headers are born live, see C<Parrot_gc_new_string_header>, so
+the sweep of a buffer pool counts every one allocated since the last
+collection as a survivor. A threshold set from that count would grow with
+the allocation rate instead of the live data. The ratio pacer leaves the
+buffer pools, and the string memory they point to, to the fixed heuristics.
+
+With either pacer, C<PARROT_GC_MAX_HEAP> has the last word.
+
+=cut
+
+*/
+
+#include "parrot/parrot.h"
+#include "gc_private.h"
+
+/* HEADERIZER HFILE: src/gc/gc_private.h */
+
+/* The ratio pacer lets a pool grow by at least this many objects between
+ * collections, so that small pools don't collect all the time */
+#define GC_PACING_MIN_OBJECTS 1024
+
+/* HEADERIZER BEGIN: static */
+/* Don't modify between HEADERIZER BEGIN / HEADERIZER END.  Your changes will be lost. */
+
+static int fixed_collect_headers(SHIM_INTERP, SHIM(Fixed_Size_Pool *pool));
+static int fixed_grow_headers(SHIM_INTERP, ARGIN(Fixed_Size_Pool *pool))
+        __attribute__nonnull__(2);
+
+static void fixed_swept(SHIM_INTERP, SHIM(Fixed_Size_Pool *pool));
+static int ratio_collect_headers(PARROT_INTERP, ARGIN(Fixed_Size_Pool *pool))
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2);
+
+static int ratio_grow_headers(PARROT_INTERP, ARGIN(Fixed_Size_Pool *pool))
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2);
+
+static void ratio_swept(PARROT_INTERP, ARGMOD(Fixed_Size_Pool *pool))
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2)
+        FUNC_MODIFIES(*pool);
+
+#define ASSERT_ARGS_fixed_collect_headers __attribute__unused__ int _ASSERT_ARGS_CHECK = (0)
+#define ASSERT_ARGS_fixed_grow_headers __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(pool))
+#define ASSERT_ARGS_fixed_swept __attribute__unused__ int _ASSERT_ARGS_CHECK = (0)
+#define ASSERT_ARGS_ratio_collect_headers __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp) \
+    , PARROT_ASSERT_ARG(pool))
+#define ASSERT_ARGS_ratio_grow_headers __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp) \
+    , PARROT_ASSERT_ARG(pool))
+#define ASSERT_ARGS_ratio_swept __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp) \
+    , PARROT_ASSERT_ARG(pool))
+/* Don't modify between HEADERIZER BEGIN / HEADERIZER END.  Your changes will be lost. */
+/* HEADERIZER END: static */
+
+static const GC_Pacer fixed_pacer = {
+    "fixed",
+    fixed_collect_headers,
+    fixed_grow_headers,
+    fixed_swept
+};
+
+static const GC_Pacer ratio_pacer = {
+    "ratio",
+    ratio_collect_headers,
+    ratio_grow_headers,
+    ratio_swept
+};
+
+/*
+
+=head2 Pacing API
+
+=over 4
+
+=item C<void Parrot_gc_pacing_set_ratio(PARROT_INTERP, UINTVAL ratio)>
+
+Selects the ratio pacer, letting the PMC pool grow by C<ratio> percent of
+the live PMCs between collections. A ratio of 0 selects the fixed pacer.
+
+=cut
+
+*/
+
+void
+Parrot_gc_pacing_set_ratio(PARROT_INTERP, UINTVAL ratio)
+{
+    ASSERT_ARGS(Parrot_gc_pacing_set_ratio)
+    Memory_Pools * const mem_pools = interp->mem_pools;
+
+    mem_pools->gc_ratio = ratio;
+    mem_pools->pacer    = ratio ? &ratio_pacer : &fixed_pacer;
+}
+
+/*
+
+=item C<void Parrot_gc_pacing_swept(PARROT_INTERP, Fixed_Size_Pool *pool)>
+
+Called once the sweep of C<pool> is complete, after its empty arenas were
+released. Records how many of the PMCs in use when the sweep began
+survived it, and tells the pacer about the live objects.
+
+=cut
+
+*/
+
+void
+Parrot_gc_pacing_swept(PARROT_INTERP, ARGMOD(Fixed_Size_Pool *pool))
+{
+    ASSERT_ARGS(Parrot_gc_pacing_swept)
+    Memory_Pools * const mem_pools = interp->mem_pools;
+
+    if (pool == mem_pools->pmc_pool) {
+        mem_pools->gc_headers_in_use   = pool->in_use_at_sweep;
+        mem_pools->gc_headers_survived = pool->swept_live;
+    }
+
+    mem_pools->pacer->swept(interp, pool);
+}
+
+/*
+
+=back
+
+=head2 The fixed pacer
+
+=over 4
+
+=item C<static int fixed_collect_headers(PARROT_INTERP, Fixed_Size_Pool *pool)>
+
+A pool out of free objects is always collected.
+
+=item C<static int fixed_grow_headers(PARROT_INTERP, Fixed_Size_Pool *pool)>
+
+A pool gets a new arena if fewer than C<replenish_level> objects are free.
+
+=item C<static void fixed_swept(PARROT_INTERP, Fixed_Size_Pool *pool)>
+
+Nothing to do.
+
+=cut
+
+*/
+
+static int
+fixed_collect_headers(SHIM_INTERP, SHIM(Fixed_Size_Pool *pool))
+{
+    ASSERT_ARGS(fixed_collect_headers)
+    return 1;
+}
+
+static int
+fixed_grow_headers(SHIM_INTERP, ARGIN(Fixed_Size_Pool *pool))
+{
+    ASSERT_ARGS(fixed_grow_headers)
+    return pool->num_free_objects < pool->replenish_level;
+}
+
+static void
+fixed_swept(SHIM_INTERP, SHIM(Fixed_Size_Pool *pool))
+{
+    ASSERT_ARGS(fixed_swept)
+}
+
+/*
+
+=back
+
+=head2 The ratio pacer
+
+=over 4
+
+=item C<static int ratio_collect_headers(PARROT_INTERP, Fixed_Size_Pool *pool)>
+
+The PMC pool is collected once it holds C<gc_threshold> objects, and gets a
+new arena before that. Other pools are always collected.
+
+=item C<static int ratio_grow_headers(PARROT_INTERP, Fixed_Size_Pool *pool)>
+
+The PMC pool grows while it is below its threshold, even if a collection
+left free objects, so that it reaches the threshold instead of collecting
+early. Other pools grow as with the fixed pacer.
+
+=cut
+
+*/
+
+static int
+ratio_collect_headers(PARROT_INTERP, ARGIN(Fixed_Size_Pool *pool))
+{
+    ASSERT_ARGS(ratio_collect_headers)
+
+    if (pool != interp->mem_pools->pmc_pool)
+        return fixed_collect_headers(interp, pool);
+
+    return pool->total_objects >= pool->gc_threshold;
+}
+
+static int
+ratio_grow_headers(PARROT_INTERP, ARGIN(Fixed_Size_Pool *pool))
+{
+    ASSERT_ARGS(ratio_grow_headers)
+
+    if (pool != interp->mem_pools->pmc_pool)
+        return fixed_grow_headers(interp, pool);
+
+    return pool->total_objects < pool->gc_threshold;
+}
+
+/*
+
+=item C<static void ratio_swept(PARROT_INTERP, Fixed_Size_Pool *pool)>
+
+Sets the threshold of the swept PMC pool to the PMCs its sweep found alive
+plus the ratio. A lazy sweep may end long after the mark, so the objects in
+use by then would count those allocated in the meantime as survivors.
+
+=cut
+
+*/
+
+static void
+ratio_swept(PARROT_INTERP, ARGMOD(Fixed_Size_Pool *pool))
+{
+    ASSERT_ARGS(ratio_swept)
+    const size_t live   = pool->swept_live;
+    size_t       growth = live / 100 * interp->mem_pools->gc_ratio;
+
+    if (pool != interp->mem_pools->pmc_pool)
+        return;
+
+    if (growth < GC_PACING_MIN_OBJECTS)
+        growth = GC_PACING_MIN_OBJECTS;
+
+    pool->gc_threshold = live + growth;
+}
+
+/*
+
+=back
+
+=head1 SEE ALSO
+
+F<src/gc/gc_ms.c>, F<src/gc/mark_sweep.c>
+
+=cut
+
+*/
+
+
+/*
+ * Local variables:
+ *   c-file-style: "parrot"
+ * End:
+ * vim: expandtab shiftwidth=4:
+ */
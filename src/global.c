@@ -804,6 +804,7 @@ Parrot_store_sub_in_namespace(PARROT_INTERP, ARGIN(PMC *sub_pmc))
 
     /* attach a namespace to the sub for lookups */
     sub->namespace_stash = ns;
+    GC_WRITE_BARRIER(interp, sub_pmc, NULL, ns);
 
     /* store a :multi sub */
     if (!PMC_IS_NULL(sub->multi_signature))
@@ -16,6 +16,17 @@ hashing functions can be set.
 This hash implementation uses just one piece of malloced memory. The
 C<< hash->bs >> bucket store points to this region.
 
+Setting the C<PARROT_HASH_INDEX> environment variable to C<open> gives new
+hashes an open addressing index C<< hash->slots >> in place of the chains.
+Each slot holds the offset of a bucket and the mixed hash value of its key,
+so a probe compares keys only on a matching hash. Slots are kept in Robin
+Hood order by linear probing: a key which is further from its home slot
+than the one in a slot takes that slot over, and a lookup stops as soon as
+it meets a key closer to home than itself. A deleted key leaves a deleted
+slot behind, so no key moves while an iterator walks the index. Both kinds
+hand out buckets from the same free list, so C<OrderedHash> sees the same
+bucket store either way.
+
 This hash doesn't move during GC, therefore a lot of the old caveats
 don't apply.
 
@@ -35,11 +46,27 @@ don't apply.
 #define SMALL_HASH_SIZE  4
 #define INITIAL_BUCKETS  4
 
+/* the size of one slot of the index of a hash */
+#define HASH_SLOT_SIZE(h) ((h)->slots ? sizeof (HashIndex) : sizeof (HashBucket *))
+
+/* the open index is rebuilt without its deleted slots when it would have
+ * fewer free slots than this leaves */
+#define MAX_USED_SLOTS(n) (N_BUCKETS(n) + (n)/8)
+
 /* HEADERIZER HFILE: include/parrot/hash.h */
 
 /* HEADERIZER BEGIN: static */
 /* Don't modify between HEADERIZER BEGIN / HEADERIZER END.  Your changes will be lost. */
 
+static void add_free_buckets(
+    ARGMOD(Hash *hash),
+    ARGMOD(HashBucket *first),
+    UINTVAL n)
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2)
+        FUNC_MODIFIES(*hash)
+        FUNC_MODIFIES(*first);
+
 PARROT_WARN_UNUSED_RESULT
 PARROT_PURE_FUNCTION
 static int cstring_compare(SHIM_INTERP,
@@ -61,6 +88,54 @@ static void hash_freeze(PARROT_INTERP,
         __attribute__nonnull__(3)
         FUNC_MODIFIES(*info);
 
+static void hash_index_clear_deleted(ARGMOD(Hash *hash))
+        __attribute__nonnull__(1)
+        FUNC_MODIFIES(*hash);
+
+static void hash_index_delete(PARROT_INTERP,
+    ARGMOD(Hash *hash),
+    ARGIN(void *key))
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2)
+        __attribute__nonnull__(3)
+        FUNC_MODIFIES(*hash);
+
+PARROT_WARN_UNUSED_RESULT
+static INTVAL hash_index_find(PARROT_INTERP,
+    ARGIN(const Hash *hash),
+    ARGIN_NULLOK(const void *key),
+    UINTVAL hashval)
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2);
+
+PARROT_CONST_FUNCTION
+static UINTVAL hash_index_hashval(UINTVAL hashval);
+
+static void hash_index_insert(
+    ARGMOD(Hash *hash),
+    UINTVAL hashval,
+    UINTVAL bucket)
+        __attribute__nonnull__(1)
+        FUNC_MODIFIES(*hash);
+
+PARROT_CANNOT_RETURN_NULL
+static HashBucket * hash_index_put(PARROT_INTERP,
+    ARGMOD(Hash *hash),
+    ARGIN_NULLOK(void *key),
+    ARGIN_NULLOK(void *value),
+    UINTVAL hashval)
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2)
+        FUNC_MODIFIES(*hash);
+
+static void hash_index_rebuild(
+    ARGMOD(Hash *hash),
+    ARGIN(const HashIndex *old_slots),
+    UINTVAL old_size)
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2)
+        FUNC_MODIFIES(*hash);
+
 static void hash_thaw(PARROT_INTERP,
     ARGMOD(Hash *hash),
     ARGMOD(visit_info *info))
@@ -96,6 +171,9 @@ static void parrot_mark_hash_values(PARROT_INTERP, ARGIN(Hash *hash))
         __attribute__nonnull__(1)
         __attribute__nonnull__(2);
 
+#define ASSERT_ARGS_add_free_buckets __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(hash) \
+    , PARROT_ASSERT_ARG(first))
 #define ASSERT_ARGS_cstring_compare __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
        PARROT_ASSERT_ARG(a) \
     , PARROT_ASSERT_ARG(b))
@@ -106,6 +184,24 @@ static void parrot_mark_hash_values(PARROT_INTERP, ARGIN(Hash *hash))
        PARROT_ASSERT_ARG(interp) \
     , PARROT_ASSERT_ARG(hash) \
     , PARROT_ASSERT_ARG(info))
+#define ASSERT_ARGS_hash_index_clear_deleted __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(hash))
+#define ASSERT_ARGS_hash_index_delete __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp) \
+    , PARROT_ASSERT_ARG(hash) \
+    , PARROT_ASSERT_ARG(key))
+#define ASSERT_ARGS_hash_index_find __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp) \
+    , PARROT_ASSERT_ARG(hash))
+#define ASSERT_ARGS_hash_index_hashval __attribute__unused__ int _ASSERT_ARGS_CHECK = (0)
+#define ASSERT_ARGS_hash_index_insert __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(hash))
+#define ASSERT_ARGS_hash_index_put __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp) \
+    , PARROT_ASSERT_ARG(hash))
+#define ASSERT_ARGS_hash_index_rebuild __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(hash) \
+    , PARROT_ASSERT_ARG(old_slots))
 #define ASSERT_ARGS_hash_thaw __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
        PARROT_ASSERT_ARG(interp) \
     , PARROT_ASSERT_ARG(hash) \
@@ -447,7 +543,7 @@ parrot_mark_hash_keys(PARROT_INTERP, ARGIN(Hash *hash))
     INTVAL  i;
 
     for (i = hash->mask; i >= 0; --i) {
-        HashBucket *bucket = hash->bi[i];
+        HashBucket *bucket = HASH_INDEX_BUCKET(hash, i);
 
         while (bucket) {
             if (++found > entries)
@@ -483,7 +579,7 @@ parrot_mark_hash_values(PARROT_INTERP, ARGIN(Hash *hash))
     INTVAL  i;
 
     for (i = hash->mask; i >= 0; --i) {
-        HashBucket *bucket = hash->bi[i];
+        HashBucket *bucket = HASH_INDEX_BUCKET(hash, i);
 
         while (bucket) {
             if (++found > entries)
@@ -519,7 +615,7 @@ parrot_mark_hash_both(PARROT_INTERP, ARGIN(Hash *hash))
     INTVAL  i;
 
     for (i = hash->mask; i >= 0; --i) {
-        HashBucket *bucket = hash->bi[i];
+        HashBucket *bucket = HASH_INDEX_BUCKET(hash, i);
 
         while (bucket) {
             if (++found > entries)
@@ -699,6 +795,304 @@ parrot_hash_visit(PARROT_INTERP, ARGMOD(Hash *hash), ARGMOD(void *pinfo))
 }
 
 
+/*
+
+=item C<static UINTVAL hash_index_hashval(UINTVAL hashval)>
+
+Returns the hash value which the open index keeps for a key with the hash
+value C<hashval>. Integer and pointer keys differ mostly in their higher
+bits, while the low bits pick the home slot, so they are mixed in first.
+
+=cut
+
+*/
+
+PARROT_CONST_FUNCTION
+static UINTVAL
+hash_index_hashval(UINTVAL hashval)
+{
+    ASSERT_ARGS(hash_index_hashval)
+    const Parrot_UInt4 h = (Parrot_UInt4)hashval * 0x9E3779B1U;
+
+    return h ^ (h >> 16);
+}
+
+
+/*
+
+=item C<static INTVAL hash_index_find(PARROT_INTERP, const Hash *hash, const
+void *key, UINTVAL hashval)>
+
+Returns the slot of the open index which holds C<key>, or -1 if C<key> isn't
+in the hash. C<hashval> is the index hash value of C<key>, see
+C<hash_index_hashval>.
+
+The probe starts at the home slot of the key and stops at a free slot, or at
+a key which is closer to its own home slot than C<key> would be: Robin Hood
+insertion would have put C<key> in front of that one. Deleted slots keep
+their hash value, so they count as keys here, but never match.
+
+=cut
+
+*/
+
+PARROT_WARN_UNUSED_RESULT
+static INTVAL
+hash_index_find(PARROT_INTERP, ARGIN(const Hash *hash), ARGIN_NULLOK(const void *key),
+        UINTVAL hashval)
+{
+    ASSERT_ARGS(hash_index_find)
+    const UINTVAL      mask = hash->mask;
+    const Parrot_UInt4 h    = (Parrot_UInt4)hashval;
+    UINTVAL            i    = h & mask;
+    UINTVAL            dist = 0;
+
+    for (;;) {
+        const HashIndex * const slot = hash->slots + i;
+
+        if (!slot->bucket || ((i - slot->hashval) & mask) < dist)
+            return -1;
+
+        if (slot->hashval == h && slot->bucket != HASH_SLOT_DELETED) {
+            const HashBucket * const bucket = hash->bs + slot->bucket - 1;
+
+            /* key equality is always a match, so it's worth checking */
+            if (bucket->key == key
+
+            /* ... but the slower comparison is more accurate */
+            || ((hash->compare)(interp, key, bucket->key) == 0))
+                return (INTVAL)i;
+        }
+
+        i = (i + 1) & mask;
+        ++dist;
+    }
+}
+
+
+/*
+
+=item C<static void hash_index_insert(Hash *hash, UINTVAL hashval, UINTVAL
+bucket)>
+
+Enters the bucket at offset C<bucket> of the bucket store, whose key has the
+index hash value C<hashval>, in the open index. The key must not be in the
+index yet, and the index must have a free slot.
+
+A deleted slot is reused by a key which is at least as far from its home
+slot as the deleted key was, so that the probes of the keys after it still
+stop in the right place.
+
+=cut
+
+*/
+
+static void
+hash_index_insert(ARGMOD(Hash *hash), UINTVAL hashval, UINTVAL bucket)
+{
+    ASSERT_ARGS(hash_index_insert)
+    const UINTVAL mask = hash->mask;
+    UINTVAL       dist = 0;
+    UINTVAL       i;
+    HashIndex     entry;
+
+    entry.hashval = (Parrot_UInt4)hashval;
+    entry.bucket  = (Parrot_UInt4)(bucket + 1);
+    i             = entry.hashval & mask;
+
+    for (;;) {
+        HashIndex * const slot = hash->slots + i;
+        UINTVAL           slot_dist;
+
+        if (!slot->bucket) {
+            *slot = entry;
+            return;
+        }
+
+        slot_dist = (i - slot->hashval) & mask;
+
+        if (slot->bucket == HASH_SLOT_DELETED) {
+            if (slot_dist <= dist) {
+                *slot = entry;
+                hash->deleted--;
+                return;
+            }
+        }
+
+        /* take the slot from a key which is closer to its home */
+        else if (slot_dist < dist) {
+            const HashIndex displaced = *slot;
+            *slot = entry;
+            entry = displaced;
+            dist  = slot_dist;
+        }
+
+        i = (i + 1) & mask;
+        ++dist;
+    }
+}
+
+
+/*
+
+=item C<static void hash_index_rebuild(Hash *hash, const HashIndex *old_slots,
+UINTVAL old_size)>
+
+Enters the keys of the C<old_size> slots of the open index C<old_slots> in
+the cleared index of C<hash>, leaving out the deleted ones. This needs no
+call of the hash function.
+
+=cut
+
+*/
+
+static void
+hash_index_rebuild(ARGMOD(Hash *hash), ARGIN(const HashIndex *old_slots),
+        UINTVAL old_size)
+{
+    ASSERT_ARGS(hash_index_rebuild)
+    UINTVAL i;
+
+    for (i = 0; i < old_size; ++i) {
+        if (HASH_SLOT_USED(old_slots + i))
+            hash_index_insert(hash, old_slots[i].hashval, old_slots[i].bucket - 1);
+    }
+}
+
+
+/*
+
+=item C<static void hash_index_clear_deleted(Hash *hash)>
+
+Rebuilds the open index of C<hash> at its size without the deleted slots.
+
+=cut
+
+*/
+
+static void
+hash_index_clear_deleted(ARGMOD(Hash *hash))
+{
+    ASSERT_ARGS(hash_index_clear_deleted)
+    const UINTVAL     size      = hash->mask + 1;
+    HashIndex * const old_slots = mem_allocate_n_typed(size, HashIndex);
+
+    memcpy(old_slots, hash->slots, size * sizeof (HashIndex));
+    memset(hash->slots, 0, size * sizeof (HashIndex));
+    hash->deleted = 0;
+
+    hash_index_rebuild(hash, old_slots, size);
+    mem_sys_free(old_slots);
+}
+
+
+/*
+
+=item C<static HashBucket * hash_index_put(PARROT_INTERP, Hash *hash, void *key,
+void *value, UINTVAL hashval)>
+
+Puts the key and value into a hash with an open index, and returns their
+bucket. C<hashval> is the index hash value of C<key>.
+
+=cut
+
+*/
+
+PARROT_CANNOT_RETURN_NULL
+static HashBucket *
+hash_index_put(PARROT_INTERP, ARGMOD(Hash *hash), ARGIN_NULLOK(void *key),
+        ARGIN_NULLOK(void *value), UINTVAL hashval)
+{
+    ASSERT_ARGS(hash_index_put)
+    const INTVAL  slot = hash_index_find(interp, hash, key, hashval);
+    HashBucket   *bucket;
+
+    if (slot >= 0) {
+        bucket        = HASH_INDEX_BUCKET(hash, slot);
+        bucket->value = value;
+        return bucket;
+    }
+
+    bucket = hash->free_list;
+
+    if (!bucket) {
+        expand_hash(interp, hash);
+        bucket = hash->free_list;
+    }
+    else if (hash->entries + hash->deleted >= MAX_USED_SLOTS(hash->mask + 1))
+        hash_index_clear_deleted(hash);
+
+    hash->entries++;
+    hash->free_list = bucket->next;
+    bucket->next    = NULL;
+    bucket->key     = key;
+    bucket->value   = value;
+    hash_index_insert(hash, hashval, bucket - hash->bs);
+
+    return bucket;
+}
+
+
+/*
+
+=item C<static void hash_index_delete(PARROT_INTERP, Hash *hash, void *key)>
+
+Deletes the key from a hash with an open index. Its slot is marked deleted
+and its bucket goes back onto the free list.
+
+=cut
+
+*/
+
+static void
+hash_index_delete(PARROT_INTERP, ARGMOD(Hash *hash), ARGIN(void *key))
+{
+    ASSERT_ARGS(hash_index_delete)
+    const UINTVAL hashval =
+        hash_index_hashval((hash->hash_val)(interp, key, hash->seed));
+    const INTVAL  slot    = hash_index_find(interp, hash, key, hashval);
+    HashBucket   *bucket;
+
+    if (slot < 0)
+        return;
+
+    bucket                   = HASH_INDEX_BUCKET(hash, slot);
+    hash->slots[slot].bucket = HASH_SLOT_DELETED;
+    hash->deleted++;
+    hash->entries--;
+
+    bucket->next    = hash->free_list;
+    bucket->key     = NULL;
+    hash->free_list = bucket;
+}
+
+
+/*
+
+=item C<static void add_free_buckets(Hash *hash, HashBucket *first, UINTVAL n)>
+
+Clears the C<n> buckets from C<first> on and puts them onto the free list in
+reverse order, so that the lowest bucket is top on the free list and will be
+used first.
+
+=cut
+
+*/
+
+static void
+add_free_buckets(ARGMOD(Hash *hash), ARGMOD(HashBucket *first), UINTVAL n)
+{
+    ASSERT_ARGS(add_free_buckets)
+    HashBucket *b;
+
+    for (b = first + n - 1; n > 0; --n, --b) {
+        b->next         = hash->free_list;
+        b->key          = b->value         = NULL;
+        hash->free_list = b;
+    }
+}
+
+
 /*
 
 =item C<static void expand_hash(PARROT_INTERP, Hash *hash)>
@@ -726,6 +1120,9 @@ happy because the hashtable accesses will be two parallel sequential scans.
 (Of course, this also mucks with the C<< ->next >> pointers, and they'll be
 all over memory.)
 
+An open index is rebuilt from the hash values it holds instead, which drops
+its deleted slots too.
+
 =cut
 
 */
@@ -742,6 +1139,7 @@ expand_hash(PARROT_INTERP, ARGMOD(Hash *hash))
     const UINTVAL old_size   = hash->mask + 1;
     const UINTVAL new_size   = old_size << 1;
     const UINTVAL old_nb     = N_BUCKETS(old_size);
+    const size_t  slot_size  = HASH_SLOT_SIZE(hash);
     size_t        offset, i, new_loc;
 
     /*
@@ -758,12 +1156,33 @@ expand_hash(PARROT_INTERP, ARGMOD(Hash *hash))
     /* resize mem */
     if (old_offset != old_mem) {
         /* This buffer has been reallocated at least once before. */
-        new_mem = (HashBucket *)mem_sys_realloc(old_mem, HASH_ALLOC_SIZE(new_size));
+        new_mem = (HashBucket *)mem_sys_realloc(old_mem,
+                HASH_ALLOC_SIZE(new_size, slot_size));
     }
     else {
         /* Allocate a new buffer. */
-        new_mem = (HashBucket *)mem_sys_allocate(HASH_ALLOC_SIZE(new_size));
-        memcpy(new_mem, old_mem, HASH_ALLOC_SIZE(old_size));
+        new_mem = (HashBucket *)mem_sys_allocate(HASH_ALLOC_SIZE(new_size, slot_size));
+        memcpy(new_mem, old_mem, HASH_ALLOC_SIZE(old_size, slot_size));
+    }
+
+    bs = new_mem;
+
+    if (hash->slots) {
+        /* The buckets keep their offset in the store, so the open index is
+         * rebuilt from the hash values in the old one. That lies within the
+         * new buckets, so it is read before they go onto the free list. */
+        HashIndex * const old_slots = (HashIndex *)(bs + old_nb);
+
+        hash->slots   = (HashIndex *)(bs + N_BUCKETS(new_size));
+        hash->bs      = bs;
+        hash->mask    = new_size - 1;
+        hash->deleted = 0;
+
+        memset(hash->slots, 0, new_size * sizeof (HashIndex));
+        hash_index_rebuild(hash, old_slots, old_size);
+
+        add_free_buckets(hash, bs + old_nb, old_nb);
+        return;
     }
 
     /*
@@ -773,7 +1192,6 @@ expand_hash(PARROT_INTERP, ARGMOD(Hash *hash))
            ^                       ^
          | new_mem                 | hash->bi
     */
-    bs     = new_mem;
     old_bi = (HashBucket **)(bs + old_nb);
     new_bi = (HashBucket **)(bs + N_BUCKETS(new_size));
 
@@ -827,13 +1245,7 @@ expand_hash(PARROT_INTERP, ARGMOD(Hash *hash))
         }
     }
 
-    /* add new buckets to free_list in reverse order
-     * lowest bucket is top on free list and will be used first */
-    for (i = 0, b = (HashBucket *)new_bi - 1; i < old_nb; ++i, --b) {
-        b->next         = hash->free_list;
-        b->key          = b->value         = NULL;
-        hash->free_list = b;
-    }
+    add_free_buckets(hash, bs + old_nb, old_nb);
 }
 
 
@@ -958,8 +1370,11 @@ parrot_create_hash(PARROT_INTERP, PARROT_DATA_TYPE val_type, Hash_key_type hkey_
         ARGIN(hash_comp_fn compare), ARGIN(hash_hash_key_fn keyhash))
 {
     ASSERT_ARGS(parrot_create_hash)
+    const int    open      = interp->hash_index_type == Hash_index_open;
+    const size_t slot_size = open ? sizeof (HashIndex) : sizeof (HashBucket *);
     HashBucket  *bp;
-    void        *alloc = mem_sys_allocate(sizeof (Hash) + HASH_ALLOC_SIZE(INITIAL_BUCKETS));
+    void        *alloc = mem_sys_allocate(sizeof (Hash)
+                       + HASH_ALLOC_SIZE(INITIAL_BUCKETS, slot_size));
     Hash * const hash  = (Hash*)alloc;
     size_t       i;
 
@@ -972,6 +1387,7 @@ parrot_create_hash(PARROT_INTERP, PARROT_DATA_TYPE val_type, Hash_key_type hkey_
     hash->seed       = interp->hash_seed;
     hash->mask       = INITIAL_BUCKETS - 1;
     hash->entries    = 0;
+    hash->deleted    = 0;
     hash->container  = PMCNULL;
 
     /*
@@ -988,18 +1404,21 @@ parrot_create_hash(PARROT_INTERP, PARROT_DATA_TYPE val_type, Hash_key_type hkey_
      * was deleted */
 
     hash->bs  = bp;
+    add_free_buckets(hash, bp, N_BUCKETS(INITIAL_BUCKETS));
     bp       += N_BUCKETS(INITIAL_BUCKETS);
-    hash->bi  = (HashBucket **)bp;
 
-    for (i = 0, --bp; i < N_BUCKETS(INITIAL_BUCKETS); ++i, --bp) {
-        bp->next        = hash->free_list;
-        bp->key         = NULL;
-        bp->value       = NULL;
-        hash->free_list = bp;
+    if (open) {
+        hash->bi    = NULL;
+        hash->slots = (HashIndex *)bp;
+        memset(hash->slots, 0, INITIAL_BUCKETS * sizeof (HashIndex));
     }
+    else {
+        hash->bi    = (HashBucket **)bp;
+        hash->slots = NULL;
 
-    for (i = 0; i < INITIAL_BUCKETS; ++i)
-        hash->bi[i] = NULL;
+        for (i = 0; i < INITIAL_BUCKETS; ++i)
+            hash->bi[i] = NULL;
+    }
 
     return hash;
 }
@@ -1046,7 +1465,7 @@ parrot_chash_destroy(PARROT_INTERP, ARGMOD(Hash *hash))
     UINTVAL i;
 
     for (i = 0; i <= hash->mask; i++) {
-        HashBucket *bucket = hash->bi[i];
+        HashBucket *bucket = HASH_INDEX_BUCKET(hash, i);
         while (bucket) {
             mem_sys_free(bucket->key);
             mem_sys_free(bucket->value);
@@ -1081,7 +1500,7 @@ parrot_chash_destroy_values(PARROT_INTERP, ARGMOD(Hash *hash),
     UINTVAL i;
 
     for (i = 0; i <= hash->mask; i++) {
-        HashBucket *bucket = hash->bi[i];
+        HashBucket *bucket = HASH_INDEX_BUCKET(hash, i);
         while (bucket) {
             mem_sys_free(bucket->key);
             func(bucket->value);
@@ -1218,7 +1637,15 @@ parrot_hash_get_bucket(PARROT_INTERP, ARGIN(const Hash *hash), ARGIN_NULLOK(cons
     }
 
     /* if the fast search didn't work, try the normal hashing search */
-    {
+    if (hash->slots) {
+        const UINTVAL hashval =
+            hash_index_hashval((hash->hash_val)(interp, key, hash->seed));
+        const INTVAL  slot    = hash_index_find(interp, hash, key, hashval);
+
+        if (slot >= 0)
+            return HASH_INDEX_BUCKET(hash, slot);
+    }
+    else {
         const UINTVAL hashval = (hash->hash_val)(interp, key, hash->seed);
         HashBucket   *bucket  = hash->bi[hashval & hash->mask];
 
@@ -1286,6 +1713,7 @@ parrot_hash_exists(PARROT_INTERP, ARGIN(Hash *hash), ARGIN(void *key))
 *value)>
 
 Puts the key and value into the hash. Note that C<key> is B<not> copied.
+The container PMC, if any, is passed to the GC write barrier.
 
 =cut
 
@@ -1300,7 +1728,7 @@ parrot_hash_put(PARROT_INTERP, ARGMOD(Hash *hash),
 {
     ASSERT_ARGS(parrot_hash_put)
     const UINTVAL hashval = (hash->hash_val)(interp, key, hash->seed);
-    HashBucket   *bucket  = hash->bi[hashval & hash->mask];
+    HashBucket   *bucket  = hash->slots ? NULL : hash->bi[hashval & hash->mask];
 
     /* Very complex assert that we'll not put non-constant stuff into constant hash */
     PARROT_ASSERT(
@@ -1315,32 +1743,39 @@ parrot_hash_put(PARROT_INTERP, ARGMOD(Hash *hash),
                 || PObj_constant_TEST((PObj *)value)))
         || !"Use non-constant key or value in constant hash");
 
-    while (bucket) {
-        /* store hash_val or not */
-        if ((hash->compare)(interp, key, bucket->key) == 0)
-            break;
-        bucket = bucket->next;
-    }
-
-    if (bucket)
-        bucket->value = value;
+    if (hash->slots)
+        bucket = hash_index_put(interp, hash, key, value, hash_index_hashval(hashval));
     else {
+        while (bucket) {
+            /* store hash_val or not */
+            if ((hash->compare)(interp, key, bucket->key) == 0)
+                break;
+            bucket = bucket->next;
+        }
 
-        bucket = hash->free_list;
+        if (bucket)
+            bucket->value = value;
+        else {
 
-        if (!bucket) {
-            expand_hash(interp, hash);
             bucket = hash->free_list;
-        }
 
-        hash->entries++;
-        hash->free_list                = bucket->next;
-        bucket->key                    = key;
-        bucket->value                  = value;
-        bucket->next                   = hash->bi[hashval & hash->mask];
-        hash->bi[hashval & hash->mask] = bucket;
+            if (!bucket) {
+                expand_hash(interp, hash);
+                bucket = hash->free_list;
+            }
+
+            hash->entries++;
+            hash->free_list                = bucket->next;
+            bucket->key                    = key;
+            bucket->value                  = value;
+            bucket->next                   = hash->bi[hashval & hash->mask];
+            hash->bi[hashval & hash->mask] = bucket;
+        }
     }
 
+    if (!PMC_IS_NULL(hash->container))
+        GC_WRITE_BARRIER(interp, hash->container, NULL, NULL);
+
     return bucket;
 }
 
@@ -1362,7 +1797,14 @@ parrot_hash_delete(PARROT_INTERP, ARGMOD(Hash *hash), ARGIN(void *key))
     ASSERT_ARGS(parrot_hash_delete)
     HashBucket   *bucket;
     HashBucket   *prev    = NULL;
-    const UINTVAL hashval = (hash->hash_val)(interp, key, hash->seed) & hash->mask;
+    UINTVAL       hashval;
+
+    if (hash->slots) {
+        hash_index_delete(interp, hash, key);
+        return;
+    }
+
+    hashval = (hash->hash_val)(interp, key, hash->seed) & hash->mask;
 
     for (bucket = hash->bi[hashval]; bucket; bucket = bucket->next) {
         if ((hash->compare)(interp, key, bucket->key) == 0) {
@@ -30,6 +30,9 @@ Create or destroy a Parrot interpreter
 /* HEADERIZER BEGIN: static */
 /* Don't modify between HEADERIZER BEGIN / HEADERIZER END.  Your changes will be lost. */
 
+PARROT_WARN_UNUSED_RESULT
+static INTVAL get_hash_index_type_from_env(void);
+
 PARROT_WARN_UNUSED_RESULT
 static int is_env_var_set(ARGIN(const char* var))
         __attribute__nonnull__(1);
@@ -37,6 +40,7 @@ static int is_env_var_set(ARGIN(const char* var))
 static void setup_default_compreg(PARROT_INTERP)
         __attribute__nonnull__(1);
 
+#define ASSERT_ARGS_get_hash_index_type_from_env __attribute__unused__ int _ASSERT_ARGS_CHECK = (0)
 #define ASSERT_ARGS_is_env_var_set __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
        PARROT_ASSERT_ARG(var))
 #define ASSERT_ARGS_setup_default_compreg __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
@@ -76,6 +80,42 @@ is_env_var_set(ARGIN(const char* var))
 
 /*
 
+=item C<static INTVAL get_hash_index_type_from_env(void)>
+
+Returns the bucket index of new hashes named by the C<PARROT_HASH_INDEX>
+environment variable: C<chained>, the default, or C<open>. See
+F<src/hash.c>.
+
+=cut
+
+*/
+
+PARROT_WARN_UNUSED_RESULT
+static INTVAL
+get_hash_index_type_from_env(void)
+{
+    ASSERT_ARGS(get_hash_index_type_from_env)
+    INTVAL       type = Hash_index_chained;
+    int          free_it;
+    char * const name = Parrot_getenv("PARROT_HASH_INDEX", &free_it);
+
+    if (!name)
+        return type;
+
+    if (STREQ(name, "open"))
+        type = Hash_index_open;
+    else if (*name && !STREQ(name, "chained"))
+        fprintf(stderr, "PARROT_HASH_INDEX: unknown hash index '%s' ignored\n",
+                name);
+
+    if (free_it)
+        mem_sys_free(name);
+
+    return type;
+}
+
+/*
+
 =item C<static void setup_default_compreg(PARROT_INTERP)>
 
 Setup default compiler for PASM.
@@ -134,6 +174,13 @@ make_interpreter(ARGIN_NULLOK(Interp *parent), INTVAL flags)
     /* Must initialize flags before Parrot_gc_initialize() is called
      * so the GC_DEBUG stuff is available. */
     interp->flags = flags;
+
+    /* Hashes are made from here on, so pick their bucket index first */
+    if (parent)
+        interp->hash_index_type = parent->hash_index_type;
+    else
+        interp->hash_index_type = get_hash_index_type_from_env();
+
     /* Set up the memory allocation system */
     Parrot_gc_initialize(interp, (void*)&stacktop);
     Parrot_block_GC_mark(interp);
@@ -209,8 +256,6 @@ make_interpreter(ARGIN_NULLOK(Interp *parent), INTVAL flags)
     interp->op_func_table   = interp->op_lib->op_func_table;
     interp->op_info_table   = interp->op_lib->op_info_table;
     interp->all_op_libs     = NULL;
-    interp->evc_func_table  = NULL;
-    interp->save_func_table = NULL;
     interp->code            = NULL;
 
     /* create the root set registry */
@@ -335,6 +380,9 @@ Parrot_really_destroy(PARROT_INTERP, SHIM(int exit_code), SHIM(void *arg))
 
     Parrot_gc_mark_and_sweep(interp, GC_finish_FLAG);
 
+    /* the last interpreter doesn't get to Parrot_gc_finalize */
+    Parrot_gc_write_event_log(interp);
+
     /*
      * that doesn't get rid of constant PMCs like these in vtable->data
      * so if such a PMC needs destroying, we get a memory leak, like for
@@ -393,6 +441,9 @@ Parrot_really_destroy(PARROT_INTERP, SHIM(int exit_code), SHIM(void *arg))
     /* buffer headers, PMCs */
     Parrot_gc_destroy_header_pools(interp);
 
+    /* register frames of the destroyed Contexts */
+    destroy_context(interp);
+
     /* memory pools in resources */
     Parrot_gc_destroy_memory_pools(interp);
 
@@ -403,11 +454,6 @@ Parrot_really_destroy(PARROT_INTERP, SHIM(int exit_code), SHIM(void *arg))
     /* cache structure */
     destroy_object_cache(interp);
 
-    if (interp->evc_func_table) {
-        mem_sys_free(interp->evc_func_table);
-        interp->evc_func_table = NULL;
-    }
-
     /* strings, charsets, encodings - only once */
     Parrot_str_finish(interp);
 
@@ -252,6 +252,15 @@ interpinfo(PARROT_INTERP, INTVAL what)
         case IMPATIENT_PMCS:
             ret = Parrot_gc_impatient_pmcs(interp);
             break;
+        case GC_RATIO:
+            ret = Parrot_gc_ratio(interp);
+            break;
+        case GC_SURVIVAL_RATE:
+            ret = Parrot_gc_survival_rate(interp);
+            break;
+        case GC_PMC_THRESHOLD:
+            ret = Parrot_gc_pmc_threshold(interp);
+            break;
         case CURRENT_RUNCORE:
         {
             STRING *name = interp->run_core->name;
@@ -316,6 +325,8 @@ interpinfo_p(PARROT_INTERP, INTVAL what)
             return Parrot_pcc_get_object(interp, CURRENT_CONTEXT(interp));
         case CURRENT_LEXPAD:
             return Parrot_pcc_get_lex_pad(interp, CURRENT_CONTEXT(interp));
+        case GC_EVENTS:
+            return Parrot_gc_event_log(interp);
         default:        /* or a warning only? */
             Parrot_ex_throw_from_c_args(interp, NULL, EXCEPTION_UNIMPLEMENTED,
                 "illegal argument in interpinfo");
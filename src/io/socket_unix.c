@@ -161,6 +161,7 @@ Parrot_io_connect_unix(PARROT_INTERP, ARGMOD(PMC *socket), ARGIN(PMC *r))
         return -1;
 
     PARROT_SOCKET(socket)->remote = r;
+    GC_WRITE_BARRIER(interp, socket, NULL, r);
 
 AGAIN:
     if ((connect(io->os_handle, (struct sockaddr *)SOCKADDR_REMOTE(socket),
@@ -201,6 +202,7 @@ Parrot_io_bind_unix(PARROT_INTERP, ARGMOD(PMC *socket), ARGMOD(PMC *sockaddr))
         return -1;
 
     PARROT_SOCKET(socket)->local = sockaddr;
+    GC_WRITE_BARRIER(interp, socket, NULL, sockaddr);
 
     saddr = SOCKADDR_LOCAL(socket);
 
@@ -108,6 +108,7 @@ Parrot_io_connect_win32(PARROT_INTERP, ARGMOD(PMC *socket), ARGIN(PMC *r))
         return -1;
 
     PARROT_SOCKET(socket)->remote = r;
+    GC_WRITE_BARRIER(interp, socket, NULL, r);
 
 AGAIN:
     if ((connect((int)io->os_handle, (struct sockaddr *)SOCKADDR_REMOTE(socket),
@@ -148,6 +149,7 @@ Parrot_io_bind_win32(PARROT_INTERP, ARGMOD(PMC *socket), ARGMOD(PMC *sockaddr))
         return -1;
 
     PARROT_SOCKET(socket)->local = sockaddr;
+    GC_WRITE_BARRIER(interp, socket, NULL, sockaddr);
 
     saddr = SOCKADDR_LOCAL(socket);
 
@@ -356,7 +356,8 @@ items, UINTVAL size)>
 Makes a new chunk, and allocates C<size> bytes for buffer storage from the
 generic memory pool. The chunk holds C<items> items. Marks the chunk as
 being part of C<< list->container >>, if it exists, for the purposes of GC. Does
-not install the chunk into C<< list->container >> yet.
+not install the chunk into C<< list->container >> yet, but runs the write
+barrier for it.
 
 =cut
 
@@ -386,6 +387,11 @@ allocate_chunk(PARROT_INTERP, ARGIN(List *list), UINTVAL items, UINTVAL size)
     Parrot_unblock_GC_mark(interp);
 
     /* Parrot_unblock_GC_sweep(interp); */
+
+    /* the caller links the chunk in before the next allocation */
+    if (list->container)
+        GC_WRITE_BARRIER(interp, list->container, NULL, NULL);
+
     return chunk;
 }
 
@@ -1233,6 +1239,9 @@ Parrot_pmc_array_set(PARROT_INTERP, ARGMOD(List *list), ARGIN_NULLOK(void *item)
         Parrot_ex_throw_from_c_args(interp, NULL, 1, "Unknown list entry type\n");
         break;
     }
+
+    if (list->container)
+        GC_WRITE_BARRIER(interp, list->container, NULL, NULL);
 }
 
 
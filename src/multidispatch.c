@@ -463,7 +463,7 @@ Parrot_mmd_arg_tuple_func(PARROT_INTERP)
     PARROT_ASSERT(*args_op == PARROT_OP_set_args_pc);
     constants  = interp->code->const_table->constants;
     ++args_op;
-    args_array = constants[*args_op]->u.key;
+    args_array = PF_CONST_PMC(interp, constants[*args_op]);
 
     ASSERT_SIG_PMC(args_array);
 
@@ -493,7 +493,7 @@ Parrot_mmd_arg_tuple_func(PARROT_INTERP)
                 {
                 const int idx = *args_op;
                 if ((type & PARROT_ARG_CONSTANT))
-                    arg = constants[idx]->u.key;
+                    arg = PF_CONST_PMC(interp, constants[idx]);
                 else
                     arg = REG_PMC(interp, idx);
 
@@ -826,6 +826,7 @@ Parrot_mmd_get_cached_multi_sig(PARROT_INTERP, ARGIN(PMC *sub_pmc))
                 return PMCNULL;
 
             multi_sig = sub->multi_signature = converted_sig;
+            GC_WRITE_BARRIER(interp, sub_pmc, NULL, multi_sig);
         }
 
         return multi_sig;
@@ -1275,6 +1276,7 @@ Parrot_mmd_add_multi_from_long_sig(PARROT_INTERP,
          ||  VTABLE_isa(interp, sub_obj, closure_str)) {
         PMC_get_sub(interp, sub_obj, sub);
         sub->multi_signature = multi_sig;
+        GC_WRITE_BARRIER(interp, sub_obj, NULL, multi_sig);
     }
 
     mmd_add_multi_to_namespace(interp, ns_name, sub_name, sub_obj);
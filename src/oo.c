@@ -38,6 +38,20 @@ static PMC* C3_merge(PARROT_INTERP, ARGIN(PMC *merge_list))
         __attribute__nonnull__(1)
         __attribute__nonnull__(2);
 
+PARROT_WARN_UNUSED_RESULT
+static INTVAL attrib_index_at_call_site(PARROT_INTERP,
+    ARGMOD(PackFile_ByteCode *code),
+    size_t offset,
+    ARGIN(PMC *_class),
+    ARGIN(STRING *name),
+    ARGIN(STRING *vtable_name))
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2)
+        __attribute__nonnull__(4)
+        __attribute__nonnull__(5)
+        __attribute__nonnull__(6)
+        FUNC_MODIFIES(*code);
+
 static void debug_trace_find_meth(PARROT_INTERP,
     ARGIN(const PMC *_class),
     ARGIN(const STRING *name),
@@ -59,6 +73,17 @@ static PMC * find_method_direct_1(PARROT_INTERP,
         __attribute__nonnull__(2)
         __attribute__nonnull__(3);
 
+PARROT_CANNOT_RETURN_NULL
+PARROT_WARN_UNUSED_RESULT
+static Call_site_cache * get_call_site(PARROT_INTERP,
+    ARGMOD(PackFile_ByteCode *code),
+    size_t offset,
+    ARGIN(STRING *name))
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2)
+        __attribute__nonnull__(4)
+        FUNC_MODIFIES(*code);
+
 PARROT_INLINE
 PARROT_CANNOT_RETURN_NULL
 PARROT_WARN_UNUSED_RESULT
@@ -74,6 +99,12 @@ static void invalidate_type_caches(PARROT_INTERP, UINTVAL type)
 #define ASSERT_ARGS_C3_merge __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
        PARROT_ASSERT_ARG(interp) \
     , PARROT_ASSERT_ARG(merge_list))
+#define ASSERT_ARGS_attrib_index_at_call_site __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp) \
+    , PARROT_ASSERT_ARG(code) \
+    , PARROT_ASSERT_ARG(_class) \
+    , PARROT_ASSERT_ARG(name) \
+    , PARROT_ASSERT_ARG(vtable_name))
 #define ASSERT_ARGS_debug_trace_find_meth __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
        PARROT_ASSERT_ARG(interp) \
     , PARROT_ASSERT_ARG(_class) \
@@ -85,6 +116,10 @@ static void invalidate_type_caches(PARROT_INTERP, UINTVAL type)
        PARROT_ASSERT_ARG(interp) \
     , PARROT_ASSERT_ARG(_class) \
     , PARROT_ASSERT_ARG(method_name))
+#define ASSERT_ARGS_get_call_site __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp) \
+    , PARROT_ASSERT_ARG(code) \
+    , PARROT_ASSERT_ARG(name))
 #define ASSERT_ARGS_get_pmc_proxy __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
        PARROT_ASSERT_ARG(interp))
 #define ASSERT_ARGS_invalidate_all_caches __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
@@ -541,6 +576,73 @@ Parrot_oo_find_vtable_override(PARROT_INTERP,
 }
 
 
+/*
+
+=item C<INTVAL Parrot_oo_find_attrib_index(PARROT_INTERP, PMC *_class, STRING
+*name)>
+
+Finds the index of the attribute C<name> in the attribute store of the
+objects of C<_class>, or returns -1 if the class has no such attribute.
+
+=cut
+
+*/
+
+PARROT_EXPORT
+PARROT_WARN_UNUSED_RESULT
+INTVAL
+Parrot_oo_find_attrib_index(PARROT_INTERP, ARGIN(PMC *_class), ARGIN(STRING *name))
+{
+    ASSERT_ARGS(Parrot_oo_find_attrib_index)
+    Parrot_Class_attributes * const class_info = PARROT_CLASS(_class);
+    const INTVAL                    cur_hll    = Parrot_pcc_get_HLL(interp, CURRENT_CONTEXT(interp));
+    int                             num_classes, i;
+    INTVAL                          retval;
+
+    Parrot_pcc_set_HLL(interp, CURRENT_CONTEXT(interp), 0);
+
+    /* First see if we can find it in the cache. */
+    retval                       = VTABLE_get_integer_keyed_str(interp,
+                                         class_info->attrib_cache, name);
+
+    /* there's a semi-predicate problem with a retval of 0 */
+    if (retval
+    || VTABLE_exists_keyed_str(interp, class_info->attrib_cache, name)) {
+        Parrot_pcc_set_HLL(interp, CURRENT_CONTEXT(interp), cur_hll);
+        return retval;
+    }
+
+    /* No hit. We need to walk up the list of parents to try and find the
+     * attribute. */
+    num_classes = VTABLE_elements(interp, class_info->all_parents);
+
+    for (i = 0; i < num_classes; i++) {
+        /* Get the class and its attribute metadata hash. */
+        PMC * const cur_class = VTABLE_get_pmc_keyed_int(interp,
+            class_info->all_parents, i);
+
+        /* Build a string representing the fully qualified attribute name. */
+        STRING *fq_name = VTABLE_get_string(interp, cur_class);
+        fq_name         = Parrot_str_append(interp, fq_name, name);
+
+        /* Look up. */
+        if (VTABLE_exists_keyed_str(interp, class_info->attrib_index, fq_name)) {
+            /* Found it. Get value, cache it and we're done. */
+            const INTVAL index = VTABLE_get_integer_keyed_str(interp,
+                class_info->attrib_index, fq_name);
+            VTABLE_set_integer_keyed_str(interp, class_info->attrib_cache, name,
+                index);
+
+            Parrot_pcc_set_HLL(interp, CURRENT_CONTEXT(interp), cur_hll);
+            return index;
+        }
+    }
+
+    Parrot_pcc_set_HLL(interp, CURRENT_CONTEXT(interp), cur_hll);
+    return -1;
+}
+
+
 /*
 
 =item C<INTVAL Parrot_get_vtable_index(PARROT_INTERP, const STRING *name)>
@@ -877,6 +979,8 @@ Parrot_invalidate_method_cache(PARROT_INTERP, ARGIN_NULLOK(STRING *_class))
     ASSERT_ARGS(Parrot_invalidate_method_cache)
     INTVAL type;
 
+    Parrot_invalidate_call_site_caches(interp);
+
     /* during interp creation and NCI registration the class_hash
      * isn't yet up */
     if (!interp->class_hash)
@@ -1023,6 +1127,290 @@ Parrot_find_method_with_cache(PARROT_INTERP, ARGIN(PMC *_class), ARGIN(STRING *m
 }
 
 
+/*
+
+=item C<static Call_site_cache * get_call_site(PARROT_INTERP, PackFile_ByteCode
+*code, size_t offset, STRING *name)>
+
+Returns the cache of the op at C<offset> in C<code>, which uses the constant
+C<name>. The cache is empty if the op hasn't used it with C<name> in the
+current class epoch. A site shares its slot in the table of C<code> with the
+sites at the same offset modulo the table size, and drops the cache of the
+last one.
+
+=cut
+
+*/
+
+PARROT_CANNOT_RETURN_NULL
+PARROT_WARN_UNUSED_RESULT
+static Call_site_cache *
+get_call_site(PARROT_INTERP, ARGMOD(PackFile_ByteCode *code), size_t offset,
+        ARGIN(STRING *name))
+{
+    ASSERT_ARGS(get_call_site)
+    Caches * const   mc = interp->caches;
+    Call_site_cache *site;
+
+    if (!code->call_sites) {
+        /* a call op has at least 3 words, most ops in between aren't calls */
+        size_t n = 8;
+
+        while (n < 65536 && n < code->base.size / 8)
+            n <<= 1;
+
+        code->call_sites     = mem_allocate_n_zeroed_typed(n, Call_site_cache *);
+        code->call_site_mask = n - 1;
+    }
+
+    site = code->call_sites[offset & code->call_site_mask];
+
+    if (!site) {
+        site = mem_allocate_zeroed_typed(Call_site_cache);
+        code->call_sites[offset & code->call_site_mask] = site;
+    }
+
+    /* another site with the same slot, or a stale cache */
+    if (site->offset != offset || site->epoch != mc->epoch || site->name != name) {
+        site->offset = offset;
+        site->epoch  = mc->epoch;
+        site->name   = name;
+        site->used   = 0;
+    }
+
+    return site;
+}
+
+
+/*
+
+=item C<PMC * Parrot_find_method_at_call_site(PARROT_INTERP, PMC *object,
+STRING *method_name, size_t offset)>
+
+Find the method PMC named C<method_name> of C<object> for the callmethod op
+at C<offset> in the current bytecode segment, like C<VTABLE_find_method>.
+
+Each call site caches the methods it found for up to
+C<CALL_SITE_CACHE_SIZE> classes of invocants, keyed on the class of objects
+and on the vtable of other PMCs, so that a repeated call from the same site
+just compares pointers. The cache of a site is dropped when it sees a new
+method name or a new class epoch, see C<Parrot_invalidate_call_site_caches>.
+Once a site has seen more classes, it looks up the methods of the others
+every time.
+
+Only constant method names, and PMCs whose C<find_method> is the one of
+C<default> or C<Object> without a C<find_method> override, are cached.
+
+=cut
+
+*/
+
+PARROT_EXPORT
+PARROT_CAN_RETURN_NULL
+PARROT_WARN_UNUSED_RESULT
+PMC *
+Parrot_find_method_at_call_site(PARROT_INTERP, ARGIN(PMC *object),
+        ARGIN(STRING *method_name), size_t offset)
+{
+    ASSERT_ARGS(Parrot_find_method_at_call_site)
+    PackFile_ByteCode * const code = interp->code;
+    Caches            * const mc   = interp->caches;
+    Call_site_cache   *site;
+    const void        *type;
+    PMC               *_class = PMCNULL;
+    PMC               *method;
+    UINTVAL            i;
+
+    if (!code || !PObj_constant_TEST(method_name))
+        return VTABLE_find_method(interp, object, method_name);
+
+    if (PObj_is_object_TEST(object)
+    &&  object->vtable->find_method == interp->vtables[enum_class_Object]->find_method)
+        type = _class = PARROT_OBJECT(object)->_class;
+    else if (object->vtable->find_method == interp->vtables[enum_class_default]->find_method)
+        type = object->vtable;
+    else
+        return VTABLE_find_method(interp, object, method_name);
+
+    site = get_call_site(interp, code, offset, method_name);
+
+    for (i = 0; i < site->used; ++i) {
+        if (site->entries[i].type == type)
+            return site->entries[i].method;
+    }
+
+    method = VTABLE_find_method(interp, object, method_name);
+
+    /* the lookup may have run code which changed a class, or reused the site */
+    if (PMC_IS_NULL(method) || site->used == CALL_SITE_CACHE_SIZE
+    ||  site->epoch != mc->epoch || site->offset != offset
+    ||  site->name != method_name)
+        return method;
+
+    /* an override may find another method every time */
+    if (!PMC_IS_NULL(_class)) {
+        STRING * const find_method = CONST_STRING(interp, "find_method");
+
+        if (!PMC_IS_NULL(Parrot_oo_find_vtable_override(interp, _class, find_method)))
+            return method;
+    }
+
+    site->entries[site->used].type   = type;
+    site->entries[site->used].method = method;
+    site->used++;
+
+    return method;
+}
+
+
+/*
+
+=item C<static INTVAL attrib_index_at_call_site(PARROT_INTERP, PackFile_ByteCode
+*code, size_t offset, PMC *_class, STRING *name, STRING *vtable_name)>
+
+Returns the index of the attribute C<name> in the objects of C<_class> for
+the op at C<offset> in C<code>, caching it at the site. Returns -1 if the
+class has no such attribute, or overrides the vtable function
+C<vtable_name>, which has to be called instead.
+
+=cut
+
+*/
+
+PARROT_WARN_UNUSED_RESULT
+static INTVAL
+attrib_index_at_call_site(PARROT_INTERP, ARGMOD(PackFile_ByteCode *code),
+        size_t offset, ARGIN(PMC *_class), ARGIN(STRING *name),
+        ARGIN(STRING *vtable_name))
+{
+    ASSERT_ARGS(attrib_index_at_call_site)
+    Call_site_cache * const site = get_call_site(interp, code, offset, name);
+    INTVAL                  slot;
+    UINTVAL                 i;
+
+    for (i = 0; i < site->used; ++i) {
+        if (site->entries[i].type == _class)
+            return site->entries[i].slot;
+    }
+
+    if (!PMC_IS_NULL(Parrot_oo_find_vtable_override(interp, _class, vtable_name)))
+        return -1;
+
+    /* the layout of a class is fixed once it has objects */
+    slot = Parrot_oo_find_attrib_index(interp, _class, name);
+
+    if (slot >= 0 && site->used < CALL_SITE_CACHE_SIZE) {
+        site->entries[site->used].type = _class;
+        site->entries[site->used].slot = slot;
+        site->used++;
+    }
+
+    return slot;
+}
+
+
+/*
+
+=item C<PMC * Parrot_get_attr_at_call_site(PARROT_INTERP, PMC *object, STRING
+*name, size_t offset)>
+
+Gets the attribute C<name> of C<object> for the getattribute op at
+C<offset> in the current bytecode segment, like C<VTABLE_get_attr_str>.
+
+Like C<Parrot_find_method_at_call_site>, each site caches the attribute
+index for up to C<CALL_SITE_CACHE_SIZE> classes, so that a repeated access
+from the same site doesn't look up the name. Only constant names of
+attributes of objects are cached.
+
+=cut
+
+*/
+
+PARROT_EXPORT
+PARROT_CAN_RETURN_NULL
+PARROT_WARN_UNUSED_RESULT
+PMC *
+Parrot_get_attr_at_call_site(PARROT_INTERP, ARGIN(PMC *object),
+        ARGIN(STRING *name), size_t offset)
+{
+    ASSERT_ARGS(Parrot_get_attr_at_call_site)
+    PackFile_ByteCode * const code = interp->code;
+
+    if (code && PObj_constant_TEST(name) && PObj_is_object_TEST(object)
+    &&  object->vtable->get_attr_str == interp->vtables[enum_class_Object]->get_attr_str) {
+        Parrot_Object_attributes * const obj = PARROT_OBJECT(object);
+        STRING * const vtable_name = CONST_STRING(interp, "get_attr_str");
+        const INTVAL   slot        = attrib_index_at_call_site(interp, code,
+                                        offset, obj->_class, name, vtable_name);
+
+        if (slot >= 0)
+            return VTABLE_get_pmc_keyed_int(interp, obj->attrib_store, slot);
+    }
+
+    return VTABLE_get_attr_str(interp, object, name);
+}
+
+
+/*
+
+=item C<void Parrot_set_attr_at_call_site(PARROT_INTERP, PMC *object, STRING
+*name, PMC *value, size_t offset)>
+
+Sets the attribute C<name> of C<object> to C<value> for the setattribute op
+at C<offset> in the current bytecode segment, like C<VTABLE_set_attr_str>,
+caching the attribute index like C<Parrot_get_attr_at_call_site>.
+
+=cut
+
+*/
+
+PARROT_EXPORT
+void
+Parrot_set_attr_at_call_site(PARROT_INTERP, ARGIN(PMC *object),
+        ARGIN(STRING *name), ARGIN_NULLOK(PMC *value), size_t offset)
+{
+    ASSERT_ARGS(Parrot_set_attr_at_call_site)
+    PackFile_ByteCode * const code = interp->code;
+
+    if (code && PObj_constant_TEST(name) && PObj_is_object_TEST(object)
+    &&  object->vtable->set_attr_str == interp->vtables[enum_class_Object]->set_attr_str) {
+        Parrot_Object_attributes * const obj = PARROT_OBJECT(object);
+        STRING * const vtable_name = CONST_STRING(interp, "set_attr_str");
+        const INTVAL   slot        = attrib_index_at_call_site(interp, code,
+                                        offset, obj->_class, name, vtable_name);
+
+        if (slot >= 0) {
+            VTABLE_set_pmc_keyed_int(interp, obj->attrib_store, slot, value);
+            return;
+        }
+    }
+
+    VTABLE_set_attr_str(interp, object, name, value);
+}
+
+
+/*
+
+=item C<void Parrot_invalidate_call_site_caches(PARROT_INTERP)>
+
+Start a new class epoch, which invalidates the method caches of all call
+sites. Call it whenever the method a class finds for a name may change.
+
+=cut
+
+*/
+
+PARROT_EXPORT
+void
+Parrot_invalidate_call_site_caches(PARROT_INTERP)
+{
+    ASSERT_ARGS(Parrot_invalidate_call_site_caches)
+
+    if (interp->caches)
+        interp->caches->epoch++;
+}
+
+
 /*
 
 =item C<static void debug_trace_find_meth(PARROT_INTERP, const PMC *_class,
@@ -100,6 +100,7 @@ PARROT_OBSERVER static const char * const flag_bit_names[] =
     "private7",
     "is_string",
     "is_PMC",
+    "GC_remembered",
     "is_shared",
     "constant",
     "external",
@@ -113,8 +114,9 @@ PARROT_OBSERVER static const char * const flag_bit_names[] =
     "custom_GC",
     "custom_destroy",
     "report",
-    "data_is_PMC_array",
+    "GC_old",
     "need_finalize",
+    "is_special_PMC",
     "high_priority_gc",
     "needs_early_gc",
     "is_class",
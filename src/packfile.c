@@ -34,6 +34,10 @@ about the structure of the frozen bytecode.
 #include "pmc/pmc_sub.h"
 #include "pmc/pmc_key.h"
 
+#ifdef WIN32
+#  define getpid _getpid
+#endif
+
 /* HEADERIZER HFILE: include/parrot/packfile.h */
 
 /* HEADERIZER BEGIN: static */
@@ -185,14 +189,21 @@ static PackFile_Constant ** find_constants(PARROT_INTERP,
         __attribute__nonnull__(1)
         __attribute__nonnull__(2);
 
+PARROT_WARN_UNUSED_RESULT
+static int find_debug_mapping(
+    ARGIN(const PackFile_Debug *debug),
+    opcode_t offset)
+        __attribute__nonnull__(1);
+
 PARROT_WARN_UNUSED_RESULT
 PARROT_CAN_RETURN_NULL
-static PackFile_FixupEntry * find_fixup(
+static PackFile_FixupEntry * find_fixup(PARROT_INTERP,
     ARGMOD(PackFile_FixupTable *ft),
     INTVAL type,
     ARGIN(const char *name))
         __attribute__nonnull__(1)
-        __attribute__nonnull__(3)
+        __attribute__nonnull__(2)
+        __attribute__nonnull__(4)
         FUNC_MODIFIES(*ft);
 
 static INTVAL find_fixup_iter(PARROT_INTERP,
@@ -239,6 +250,15 @@ static const opcode_t * fixup_unpack(PARROT_INTERP,
         __attribute__nonnull__(2)
         __attribute__nonnull__(3);
 
+PARROT_WARN_UNUSED_RESULT
+static INTVAL frozen_pmc_type(PARROT_INTERP,
+    ARGIN(PackFile *pf),
+    ARGMOD(const opcode_t **cursor))
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2)
+        __attribute__nonnull__(3)
+        FUNC_MODIFIES(*cursor);
+
 PARROT_CANNOT_RETURN_NULL
 static PMC * make_annotation_value_pmc(PARROT_INTERP,
     ARGIN(PackFile_Annotations *self),
@@ -266,6 +286,37 @@ static void PackFile_set_header(ARGOUT(PackFile_Header *header))
         __attribute__nonnull__(1)
         FUNC_MODIFIES(*header);
 
+PARROT_WARN_UNUSED_RESULT
+PARROT_CAN_RETURN_NULL
+static char * pbc_cache_file(PARROT_INTERP, ARGIN(const char *filename))
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2);
+
+PARROT_WARN_UNUSED_RESULT
+static UHUGEINTVAL pbc_cache_hash(
+    UHUGEINTVAL hash,
+    ARGIN(const void *data),
+    size_t size)
+        __attribute__nonnull__(2);
+
+PARROT_WARN_UNUSED_RESULT
+static int pbc_cache_hash_file(PARROT_INTERP,
+    ARGMOD(UHUGEINTVAL *hash),
+    ARGIN(const char *path),
+    int depth)
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2)
+        __attribute__nonnull__(3)
+        FUNC_MODIFIES(*hash);
+
+static void pbc_cache_store(PARROT_INTERP,
+    ARGMOD(PackFile_ByteCode *cs),
+    ARGIN(const char *cache_file))
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2)
+        __attribute__nonnull__(3)
+        FUNC_MODIFIES(*cs);
+
 static void pf_debug_destroy(SHIM_INTERP, ARGMOD(PackFile_Segment *self))
         __attribute__nonnull__(2)
         FUNC_MODIFIES(*self);
@@ -336,6 +387,17 @@ static int sub_pragma(PARROT_INTERP,
         __attribute__nonnull__(1)
         __attribute__nonnull__(3);
 
+PARROT_CANNOT_RETURN_NULL
+static const opcode_t * thaw_constant_pmc(PARROT_INTERP,
+    ARGIN(PackFile_ConstTable *constt),
+    ARGMOD(PackFile_Constant *self),
+    ARGIN(const opcode_t *cursor))
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2)
+        __attribute__nonnull__(3)
+        __attribute__nonnull__(4)
+        FUNC_MODIFIES(*self);
+
 #define ASSERT_ARGS_byte_code_destroy __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
        PARROT_ASSERT_ARG(interp) \
     , PARROT_ASSERT_ARG(self))
@@ -395,8 +457,11 @@ static int sub_pragma(PARROT_INTERP,
 #define ASSERT_ARGS_find_constants __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
        PARROT_ASSERT_ARG(interp) \
     , PARROT_ASSERT_ARG(ct))
+#define ASSERT_ARGS_find_debug_mapping __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(debug))
 #define ASSERT_ARGS_find_fixup __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
-       PARROT_ASSERT_ARG(ft) \
+       PARROT_ASSERT_ARG(interp) \
+    , PARROT_ASSERT_ARG(ft) \
     , PARROT_ASSERT_ARG(name))
 #define ASSERT_ARGS_find_fixup_iter __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
        PARROT_ASSERT_ARG(interp) \
@@ -417,6 +482,10 @@ static int sub_pragma(PARROT_INTERP,
        PARROT_ASSERT_ARG(interp) \
     , PARROT_ASSERT_ARG(seg) \
     , PARROT_ASSERT_ARG(cursor))
+#define ASSERT_ARGS_frozen_pmc_type __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp) \
+    , PARROT_ASSERT_ARG(pf) \
+    , PARROT_ASSERT_ARG(cursor))
 #define ASSERT_ARGS_make_annotation_value_pmc __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
        PARROT_ASSERT_ARG(interp) \
     , PARROT_ASSERT_ARG(self))
@@ -429,6 +498,19 @@ static int sub_pragma(PARROT_INTERP,
        PARROT_ASSERT_ARG(interp))
 #define ASSERT_ARGS_PackFile_set_header __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
        PARROT_ASSERT_ARG(header))
+#define ASSERT_ARGS_pbc_cache_file __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp) \
+    , PARROT_ASSERT_ARG(filename))
+#define ASSERT_ARGS_pbc_cache_hash __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(data))
+#define ASSERT_ARGS_pbc_cache_hash_file __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp) \
+    , PARROT_ASSERT_ARG(hash) \
+    , PARROT_ASSERT_ARG(path))
+#define ASSERT_ARGS_pbc_cache_store __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp) \
+    , PARROT_ASSERT_ARG(cs) \
+    , PARROT_ASSERT_ARG(cache_file))
 #define ASSERT_ARGS_pf_debug_destroy __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
        PARROT_ASSERT_ARG(self))
 #define ASSERT_ARGS_pf_debug_dump __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
@@ -459,6 +541,11 @@ static int sub_pragma(PARROT_INTERP,
 #define ASSERT_ARGS_sub_pragma __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
        PARROT_ASSERT_ARG(interp) \
     , PARROT_ASSERT_ARG(sub_pmc))
+#define ASSERT_ARGS_thaw_constant_pmc __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp) \
+    , PARROT_ASSERT_ARG(constt) \
+    , PARROT_ASSERT_ARG(self) \
+    , PARROT_ASSERT_ARG(cursor))
 /* Don't modify between HEADERIZER BEGIN / HEADERIZER END.  Your changes will be lost. */
 /* HEADERIZER END: static */
 
@@ -479,6 +566,13 @@ static int sub_pragma(PARROT_INTERP,
 /* pad to 16 in bytes */
 #define PAD_16_B(size) ((size) % 16 ? 16 - (size) % 16 : 0)
 
+/* 64-bit FNV-1a, naming the files in the bytecode cache */
+#define PBC_CACHE_FNV_BASIS (((UHUGEINTVAL)0xcbf29ce4 << 32) | 0x84222325)
+#define PBC_CACHE_FNV_PRIME (((UHUGEINTVAL)0x100 << 32) | 0x1b3)
+
+/* how deep .include files may nest for a file to be cached */
+#define PBC_CACHE_MAX_INCLUDE_DEPTH 16
+
 #if TRACE_PACKFILE
 
 /*
@@ -925,6 +1019,7 @@ do_sub_pragmas(PARROT_INTERP, ARGIN(PackFile_ByteCode *self),
                 sub_pmc       = ct->constants[ci]->u.key;
                 PMC_get_sub(interp, sub_pmc, sub);
                 sub->eval_pmc = eval_pmc;
+                GC_WRITE_BARRIER(interp, sub_pmc, NULL, eval_pmc);
 
                 if (((PObj_get_FLAGS(sub_pmc) & SUB_FLAG_PF_MASK)
                 ||   (Sub_comp_get_FLAGS(sub) & SUB_COMP_FLAG_MASK))
@@ -1073,6 +1168,11 @@ PackFile_unpack(PARROT_INTERP, ARGMOD(PackFile *self),
     /* Set what transforms we need to do when reading the rest of the file. */
     PackFile_assign_transforms(self);
 
+    /* A PMC constant left frozen points into the image, which isn't kept
+     * after unpacking when it has to be transformed. */
+    if (self->need_endianize || self->need_wordsize)
+        self->options &= ~PFOPT_LAZY;
+
     /* Directory format. */
     header->dir_format = PF_fetch_opcode(self, &cursor);
 
@@ -1113,6 +1213,9 @@ PackFile_unpack(PARROT_INTERP, ARGMOD(PackFile *self),
     }
 #endif
 
+    if (!cursor)
+        return 0;
+
     TRACE_PRINTF(("PackFile_unpack: Unpack done.\n"));
 
     return cursor - packed;
@@ -2070,6 +2173,14 @@ directory_unpack(PARROT_INTERP, ARGMOD(PackFile_Segment *segp), ARGIN(const opco
         seg->op_count    = PF_fetch_opcode(pf, &cursor);
         TRACE_PRINTF_VAL(("Segment op_count %ld.\n", seg->op_count));
 
+        /* a truncated file */
+        if ((size_t)OFFS(pf, cursor) > pf->size
+        ||  (seg->file_offset + seg->op_count) * pf->header->wordsize > pf->size) {
+            fprintf(stderr, "directory_unpack failed: segment '%s' "
+                    "ends past the end of the file\n", seg->name);
+            return NULL;
+        }
+
         if (pf->need_wordsize) {
 #if OPCODE_T_SIZE == 8
             if (pf->header->wordsize == 4)
@@ -2560,11 +2671,19 @@ byte_code_destroy(PARROT_INTERP, ARGMOD(PackFile_Segment *self))
     if (byte_code->prederef.code) {
         Parrot_free_memalign(byte_code->prederef.code);
         byte_code->prederef.code = NULL;
+    }
 
-        if (byte_code->prederef.branches) {
-            mem_sys_free(byte_code->prederef.branches);
-            byte_code->prederef.branches = NULL;
-        }
+    if (byte_code->exec_code)
+        Parrot_exec_free_code(interp, byte_code);
+
+    if (byte_code->call_sites) {
+        size_t i;
+
+        for (i = 0; i <= byte_code->call_site_mask; ++i)
+            mem_sys_free(byte_code->call_sites[i]);
+
+        mem_sys_free(byte_code->call_sites);
+        byte_code->call_sites = NULL;
     }
 
     byte_code->fixups      = NULL;
@@ -2885,6 +3004,40 @@ Parrot_new_debug_seg(PARROT_INTERP, ARGMOD(PackFile_ByteCode *cs), size_t size)
 }
 
 
+/*
+
+=item C<static int find_debug_mapping(const PackFile_Debug *debug, opcode_t
+offset)>
+
+Returns the index of the last mapping in C<debug> starting at or before
+C<offset>, or -1 if they all start after it.  Mappings are kept sorted by
+offset, so this is a binary search.
+
+=cut
+
+*/
+
+PARROT_WARN_UNUSED_RESULT
+static int
+find_debug_mapping(ARGIN(const PackFile_Debug *debug), opcode_t offset)
+{
+    ASSERT_ARGS(find_debug_mapping)
+    int lo = 0;
+    int hi = debug->num_mappings;
+
+    while (lo < hi) {
+        const int mid = lo + (hi - lo) / 2;
+
+        if (debug->mappings[mid]->offset <= offset)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return lo - 1;
+}
+
+
 /*
 
 =item C<void Parrot_debug_add_mapping(PARROT_INTERP, PackFile_Debug *debug,
@@ -2915,16 +3068,9 @@ Parrot_debug_add_mapping(PARROT_INTERP, ARGMOD(PackFile_Debug *debug),
         insert_pos = debug->num_mappings;
     else {
         /* Find the right place and shift stuff that's after it. */
-        int i;
-
-        for (i = 0; i < debug->num_mappings; i++) {
-            if (debug->mappings[i]->offset > offset) {
-                insert_pos = i;
-                memmove(debug->mappings + i + 1, debug->mappings + i,
-                    debug->num_mappings - i);
-                break;
-            }
-        }
+        insert_pos = find_debug_mapping(debug, offset) + 1;
+        memmove(debug->mappings + insert_pos + 1, debug->mappings + insert_pos,
+            (debug->num_mappings - insert_pos) * sizeof (PackFile_DebugFilenameMapping *));
     }
 
     /* Need to put filename in constants table. */
@@ -2939,11 +3085,26 @@ Parrot_debug_add_mapping(PARROT_INTERP, ARGMOD(PackFile_Debug *debug),
 
         mapping->offset       = offset;
 
-        /* Check if there is already a constant with this filename */
-        for (i= 0; i < count; ++i) {
-            if (ct->constants[i]->type == PFC_STRING &&
-                    Parrot_str_equal(interp, namestr, ct->constants[i]->u.string))
-                break;
+        /* Check if there is already a constant with this filename, trying
+         * the previous mapping's first: it's usually the same file */
+        i = count;
+
+        if (debug->num_mappings) {
+            const opcode_t last =
+                debug->mappings[debug->num_mappings - 1]->filename;
+
+            if ((size_t)last < count
+            &&  ct->constants[last]->type == PFC_STRING
+            &&  Parrot_str_equal(interp, namestr, ct->constants[last]->u.string))
+                i = last;
+        }
+
+        if (i == count) {
+            for (i = 0; i < count; ++i) {
+                if (ct->constants[i]->type == PFC_STRING &&
+                        Parrot_str_equal(interp, namestr, ct->constants[i]->u.string))
+                    break;
+            }
         }
         if (i < count) {
             /* There is one, use it */
@@ -2990,22 +3151,20 @@ Parrot_debug_pc_to_filename(PARROT_INTERP, ARGIN(const PackFile_Debug *debug),
     opcode_t pc)
 {
     ASSERT_ARGS(Parrot_debug_pc_to_filename)
-    /* Look through mappings until we find one that maps the passed
-       bytecode offset. */
-
+    /* Find the last mapping at or before the passed bytecode offset; one
+       before the first mapping falls back to the last, as it always has. */
     int i;
-    for (i = 0; i < debug->num_mappings; i++) {
-        /* If this is the last mapping or the current position is
-           between this mapping and the next one, return a filename. */
-       if (i + 1                          == debug->num_mappings
-       || (debug->mappings[i]->offset     <= pc
-       &&  debug->mappings[i + 1]->offset >  pc))
-            return PF_CONST(debug->code,
-                    debug->mappings[i]->filename)->u.string;
-    }
 
-    /* Otherwise, no mappings == no filename. */
-    return string_from_literal(interp, "(unknown file)");
+    /* No mappings == no filename. */
+    if (debug->num_mappings == 0)
+        return string_from_literal(interp, "(unknown file)");
+
+    i = find_debug_mapping(debug, pc);
+
+    if (i < 0)
+        i = debug->num_mappings - 1;
+
+    return PF_CONST(debug->code, debug->mappings[i]->filename)->u.string;
 }
 
 
@@ -3116,10 +3275,10 @@ clone_constant(PARROT_INTERP, ARGIN(PackFile_Constant *old_const))
     STRING * const _sub = CONST_STRING(interp, "Sub");
 
     if (old_const->type == PFC_PMC
-    &&  VTABLE_isa(interp, old_const->u.key, _sub)) {
+    &&  VTABLE_isa(interp, PF_CONST_PMC(interp, old_const), _sub)) {
         PMC        *old_sub_pmc, *new_sub_pmc;
         Parrot_Sub_attributes *old_sub,     *new_sub;
-        PackFile_Constant * const ret = mem_allocate_typed(PackFile_Constant);
+        PackFile_Constant * const ret = mem_allocate_zeroed_typed(PackFile_Constant);
 
         ret->type = old_const->type;
         old_sub_pmc   = old_const->u.key;
@@ -3225,7 +3384,7 @@ Parrot_destroy_constants(PARROT_INTERP)
         return;
 
     for (i = 0; i <= hash->mask; ++i) {
-        HashBucket *bucket = hash->bi[i];
+        HashBucket *bucket = HASH_INDEX_BUCKET(hash, i);
 
         while (bucket) {
             PackFile_ConstTable * const table      =
@@ -3291,6 +3450,11 @@ PackFile_FixupTable_clear(PARROT_INTERP, ARGMOD(PackFile_FixupTable *self))
         self->fixups = NULL;
     }
 
+    if (self->index) {
+        parrot_hash_destroy(interp, self->index);
+        self->index = NULL;
+    }
+
     self->fixups      = NULL;
     self->fixup_count = 0;
 
@@ -3539,17 +3703,25 @@ PackFile_FixupTable_new_entry(PARROT_INTERP,
     self->fixups[i]->name   = mem_sys_strdup(label);
     self->fixups[i]->offset = offs;
     self->fixups[i]->seg    = self->code;
+
+    /* keep the first entry of each name, as a linear search would find */
+    if (self->index && !parrot_hash_exists(interp, self->index, self->fixups[i]->name))
+        parrot_hash_put(interp, self->index, self->fixups[i]->name, self->fixups[i]);
 }
 
 
 /*
 
-=item C<static PackFile_FixupEntry * find_fixup(PackFile_FixupTable *ft, INTVAL
-type, const char *name)>
+=item C<static PackFile_FixupEntry * find_fixup(PARROT_INTERP,
+PackFile_FixupTable *ft, INTVAL type, const char *name)>
 
 Finds the fix-up entry in a given FixupTable C<ft> for C<type> and C<name> and
 returns it.
 
+The first lookup indexes the table by name, so later lookups don't have to
+scan it.  Only an entry whose type doesn't match (such as a sub fixup cleared
+by C<Eval>) falls back to the scan.
+
 This ignores directories. For a recursive version see
 C<PackFile_find_fixup_entry()>.
 
@@ -3560,19 +3732,44 @@ C<PackFile_find_fixup_entry()>.
 PARROT_WARN_UNUSED_RESULT
 PARROT_CAN_RETURN_NULL
 static PackFile_FixupEntry *
-find_fixup(ARGMOD(PackFile_FixupTable *ft), INTVAL type, ARGIN(const char *name))
+find_fixup(PARROT_INTERP, ARGMOD(PackFile_FixupTable *ft), INTVAL type,
+        ARGIN(const char *name))
 {
     ASSERT_ARGS(find_fixup)
-    opcode_t i;
-    for (i = 0; i < ft->fixup_count; i++) {
-        if ((INTVAL)((enum_fixup_t)ft->fixups[i]->type) == type
-        &&  STREQ(ft->fixups[i]->name, name)) {
-            ft->fixups[i]->seg = ft->code;
-            return ft->fixups[i];
+    PackFile_FixupEntry *e;
+    opcode_t             i;
+
+    if (!ft->index) {
+        ft->index = parrot_new_cstring_hash(interp);
+
+        for (i = 0; i < ft->fixup_count; i++) {
+            char * const key = ft->fixups[i]->name;
+
+            if (key && !parrot_hash_exists(interp, ft->index, key))
+                parrot_hash_put(interp, ft->index, key, ft->fixups[i]);
         }
     }
 
-    return NULL;
+    e = (PackFile_FixupEntry *)parrot_hash_get(interp, ft->index, name);
+
+    if (!e)
+        return NULL;
+
+    if ((INTVAL)((enum_fixup_t)e->type) != type) {
+        for (i = 0, e = NULL; i < ft->fixup_count; i++) {
+            if ((INTVAL)((enum_fixup_t)ft->fixups[i]->type) == type
+            &&  STREQ(ft->fixups[i]->name, name)) {
+                e = ft->fixups[i];
+                break;
+            }
+        }
+
+        if (!e)
+            return NULL;
+    }
+
+    e->seg = ft->code;
+    return e;
 }
 
 
@@ -3598,7 +3795,7 @@ find_fixup_iter(PARROT_INTERP, ARGIN(PackFile_Segment *seg), ARGIN(void *user_da
     }
     else if (seg->type == PF_FIXUP_SEG) {
         PackFile_FixupEntry ** const e  = (PackFile_FixupEntry **)user_data;
-        PackFile_FixupEntry *  const fe = (PackFile_FixupEntry *)find_fixup(
+        PackFile_FixupEntry *  const fe = find_fixup(interp,
                 (PackFile_FixupTable *) seg, (*e)->type, (*e)->name);
 
         if (fe) {
@@ -3634,14 +3831,15 @@ PackFile_find_fixup_entry(PARROT_INTERP, INTVAL type, ARGIN(char *name))
 {
     ASSERT_ARGS(PackFile_find_fixup_entry)
 
-    /* TODO make a hash of all fixups */
     PackFile_Directory  * const dir = interp->code->base.dir;
-    PackFile_FixupEntry * const ep  = mem_allocate_typed(PackFile_FixupEntry);
+    PackFile_FixupEntry         key;
+    PackFile_FixupEntry        *ep  = &key;
 
-    ep->type = type;
-    ep->name = name;
+    key.type = type;
+    key.name = name;
 
-    if (PackFile_map_segments(interp, dir, find_fixup_iter, (void *) ep))
+    /* find_fixup_iter replaces ep with the entry it finds */
+    if (PackFile_map_segments(interp, dir, find_fixup_iter, (void *) &ep))
         return ep;
 
     return NULL;
@@ -3970,6 +4168,55 @@ PackFile_Constant_unpack(PARROT_INTERP, ARGIN(PackFile_ConstTable *constt),
 }
 
 
+/*
+
+=item C<static INTVAL frozen_pmc_type(PARROT_INTERP, PackFile *pf, const
+opcode_t **cursor)>
+
+Skips the frozen PMC image at C<*cursor> without thawing it, and returns the
+type of the PMC it holds, or 0 if that can't be told.  The image is a string
+holding a packfile header, padded to 16 bytes, and then the id of the PMC,
+followed by its type (see C<thaw_pmc()> in F<src/pmc_freeze.c>).  It was
+frozen by the Parrot that wrote C<pf>, so it's read like the rest of C<pf>.
+
+=cut
+
+*/
+
+PARROT_WARN_UNUSED_RESULT
+static INTVAL
+frozen_pmc_type(PARROT_INTERP, ARGIN(PackFile *pf), ARGMOD(const opcode_t **cursor))
+{
+    ASSERT_ARGS(frozen_pmc_type)
+    const size_t header_length = PACKFILE_HEADER_BYTES +
+        (PACKFILE_HEADER_BYTES % 16 ? 16 - PACKFILE_HEADER_BYTES % 16 : 0);
+    const size_t    wordsize = pf->header->wordsize;
+    const char     *image;
+    size_t          size;
+    INTVAL          type     = 0;
+    opcode_t        skip;
+
+    skip  = PF_fetch_opcode(pf, cursor);  /* flags */
+    skip  = PF_fetch_opcode(pf, cursor);  /* charset */
+    UNUSED(skip);
+    size  = (size_t)PF_fetch_opcode(pf, cursor);
+    image = (const char *)*cursor;
+
+    if (size >= header_length + 2 * wordsize) {
+        const opcode_t *item = (const opcode_t *)(image + header_length);
+        const INTVAL    id   = PF_fetch_integer(pf, &item);
+
+        /* neither seen before, nor the same type as the last one */
+        if ((id & 3) == 0)
+            type = PF_fetch_integer(pf, &item);
+    }
+
+    *cursor = (const opcode_t *)(image + (size + wordsize - 1) / wordsize * wordsize);
+
+    return type;
+}
+
+
 /*
 
 =item C<const opcode_t * PackFile_Constant_unpack_pmc(PARROT_INTERP,
@@ -3977,6 +4224,12 @@ PackFile_ConstTable *constt, PackFile_Constant *self, const opcode_t *cursor)>
 
 Unpacks a constant PMC.
 
+With C<PFOPT_LAZY>, plain data PMCs, such as the call signatures IMCC
+stores as C<FixedIntegerArray>s, are left frozen in the packfile until
+C<PackFile_Constant_thaw_pmc()> is first asked for them, usually through
+C<PF_CONST_PMC>.  Anything else is thawed now: a Sub has to go into its
+namespace, and thawing a C<ParrotInterpreter> sets up HLLs.
+
 =cut
 
 */
@@ -3989,6 +4242,78 @@ PackFile_Constant_unpack_pmc(PARROT_INTERP, ARGIN(PackFile_ConstTable *constt),
         ARGMOD(PackFile_Constant *self), ARGIN(const opcode_t *cursor))
 {
     ASSERT_ARGS(PackFile_Constant_unpack_pmc)
+    PackFile * const pf = constt->base.pf;
+
+    if (pf->options & PFOPT_LAZY) {
+        const opcode_t * const frozen = cursor;
+
+        switch (frozen_pmc_type(interp, pf, &cursor)) {
+            case enum_class_FixedIntegerArray:
+            case enum_class_FixedFloatArray:
+            case enum_class_FixedStringArray:
+            case enum_class_Integer:
+            case enum_class_Float:
+            case enum_class_String:
+                self->type   = PFC_PMC;
+                self->u.key  = NULL;
+                self->frozen = frozen;
+                self->table  = constt;
+                return cursor;
+            default:
+                break;
+        }
+
+        cursor = frozen;
+    }
+
+    return thaw_constant_pmc(interp, constt, self, cursor);
+}
+
+
+/*
+
+=item C<PMC * PackFile_Constant_thaw_pmc(PARROT_INTERP, PackFile_Constant
+*self)>
+
+Thaws the PMC constant C<self> left frozen by a lazy
+C<PackFile_Constant_unpack_pmc()>, and returns it.
+
+=cut
+
+*/
+
+PARROT_EXPORT
+PARROT_CANNOT_RETURN_NULL
+PMC *
+PackFile_Constant_thaw_pmc(PARROT_INTERP, ARGMOD(PackFile_Constant *self))
+{
+    ASSERT_ARGS(PackFile_Constant_thaw_pmc)
+
+    if (self->frozen)
+        thaw_constant_pmc(interp, self->table, self, self->frozen);
+
+    return self->u.key;
+}
+
+
+/*
+
+=item C<static const opcode_t * thaw_constant_pmc(PARROT_INTERP,
+PackFile_ConstTable *constt, PackFile_Constant *self, const opcode_t *cursor)>
+
+Thaws the constant PMC frozen at C<cursor> into C<self>, and places a Sub into
+its namespace.  Returns the cursor past the image.
+
+=cut
+
+*/
+
+PARROT_CANNOT_RETURN_NULL
+static const opcode_t *
+thaw_constant_pmc(PARROT_INTERP, ARGIN(PackFile_ConstTable *constt),
+        ARGMOD(PackFile_Constant *self), ARGIN(const opcode_t *cursor))
+{
+    ASSERT_ARGS(thaw_constant_pmc)
     PackFile * const pf   = constt->base.pf;
     STRING          *_sub = CONST_STRING(interp, "Sub");
     STRING          *image;
@@ -4008,8 +4333,9 @@ PackFile_Constant_unpack_pmc(PARROT_INTERP, ARGIN(PackFile_ConstTable *constt),
     pmc         = Parrot_thaw(interp, image);
 
     /* place item in const_table */
-    self->type  = PFC_PMC;
-    self->u.key = pmc;
+    self->type   = PFC_PMC;
+    self->u.key  = pmc;
+    self->frozen = NULL;
 
     /* finally place the sub into some namespace stash
      * XXX place this code in Sub.thaw ?  */
@@ -4594,7 +4920,8 @@ PackFile_Annotations_lookup(PARROT_INTERP, ARGIN(PackFile_Annotations *self),
     ASSERT_ARGS(PackFile_Annotations_lookup)
     PMC   *result;
     INTVAL start_entry = 0;
-    INTVAL i;
+    INTVAL end_entry;
+    INTVAL i, lo, hi;
 
     /* If we have a key, look up its ID; if we don't find one. */
     opcode_t key_id = -1;
@@ -4612,16 +4939,37 @@ PackFile_Annotations_lookup(PARROT_INTERP, ARGIN(PackFile_Annotations *self),
             return PMCNULL;
     }
 
-    /* Use groups to find search start point. */
-    for (i = 0; i < self->num_groups; i++)
-        if (offset < self->groups[i]->bytecode_offset)
-            break;
+    /* Groups and entries are both sorted by bytecode offset.  Search start
+     * point is the last group starting at or before the offset; the entries
+     * in force are those from there up to the first one at the offset. */
+    lo = 0;
+    hi = self->num_groups;
 
+    while (lo < hi) {
+        const INTVAL mid = lo + (hi - lo) / 2;
 
-    /* Check if the found file was actually bytecode (.pbc extension), or a
-     * source file (.pir or .pasm extension). */
+        if (self->groups[mid]->bytecode_offset <= offset)
+            lo = mid + 1;
         else
-            start_entry = self->groups[i]->entries_offset;
+            hi = mid;
+    }
+
+    if (lo > 0)
+        start_entry = self->groups[lo - 1]->entries_offset;
+
+    lo = start_entry;
+    hi = self->num_entries;
+
+    while (lo < hi) {
+        const INTVAL mid = lo + (hi - lo) / 2;
+
+        if (self->entries[mid]->bytecode_offset < offset)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    end_entry = lo;
 
     if (key_id == -1) {
         /* Look through entries, storing what we find by key and tracking those
@@ -4629,10 +4977,7 @@ PackFile_Annotations_lookup(PARROT_INTERP, ARGIN(PackFile_Annotations *self),
         opcode_t *latest_values = mem_allocate_n_zeroed_typed(self->num_keys, opcode_t);
         opcode_t *have_values   = mem_allocate_n_zeroed_typed(self->num_keys, opcode_t);
 
-        for (i = start_entry; i < self->num_entries; i++) {
-            if (self->entries[i]->bytecode_offset >= offset)
-                break;
-
+        for (i = start_entry; i < end_entry; i++) {
             latest_values[self->entries[i]->key] = self->entries[i]->value;
             have_values[self->entries[i]->key]   = 1;
         }
@@ -4657,13 +5002,11 @@ PackFile_Annotations_lookup(PARROT_INTERP, ARGIN(PackFile_Annotations *self),
         opcode_t latest_value = 0;
         opcode_t found_value  = 0;
 
-        for (i = start_entry; i < self->num_entries; i++) {
-            if (self->entries[i]->bytecode_offset >= offset)
-                break;
-
+        for (i = end_entry - 1; i >= start_entry; i--) {
             if (self->entries[i]->key == key_id) {
                 latest_value = self->entries[i]->value;
                 found_value  = 1;
+                break;
             }
         }
 
@@ -4678,6 +5021,272 @@ PackFile_Annotations_lookup(PARROT_INTERP, ARGIN(PackFile_Annotations *self),
     return result;
 }
 
+/*
+
+=item C<static UHUGEINTVAL pbc_cache_hash(UHUGEINTVAL hash, const void *data,
+size_t size)>
+
+Adds C<size> bytes at C<data> to the 64-bit FNV-1a C<hash>.
+
+=cut
+
+*/
+
+PARROT_WARN_UNUSED_RESULT
+static UHUGEINTVAL
+pbc_cache_hash(UHUGEINTVAL hash, ARGIN(const void *data), size_t size)
+{
+    ASSERT_ARGS(pbc_cache_hash)
+    const unsigned char *bytes = (const unsigned char *)data;
+    size_t               i;
+
+    for (i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= PBC_CACHE_FNV_PRIME;
+    }
+
+    return hash;
+}
+
+
+/*
+
+=item C<static int pbc_cache_hash_file(PARROT_INTERP, UHUGEINTVAL *hash, const
+char *path, int depth)>
+
+Adds C<path> and the contents of the file to C<*hash>, then each file it
+C<.include>s, found the way IMCC finds it.  The scan is textual, so a
+C<.include> in a comment or a string is hashed too.  Returns 0 if a file
+can't be read, an included file can't be found, or includes nest deeper
+than C<PBC_CACHE_MAX_INCLUDE_DEPTH>.
+
+=cut
+
+*/
+
+PARROT_WARN_UNUSED_RESULT
+static int
+pbc_cache_hash_file(PARROT_INTERP, ARGMOD(UHUGEINTVAL *hash),
+        ARGIN(const char *path), int depth)
+{
+    ASSERT_ARGS(pbc_cache_hash_file)
+    FILE * const fp   = fopen(path, "rb");
+    char        *text = NULL;
+    size_t       size = 0, len = 0, i;
+    int          ok;
+
+    if (!fp)
+        return 0;
+
+    for (;;) {
+        size_t read;
+
+        if (len == size) {
+            size = size ? size * 2 : 4096;
+            text = (char *)mem_sys_realloc(text, size);
+        }
+
+        read = fread(text + len, 1, size - len, fp);
+
+        if (!read)
+            break;
+
+        len += read;
+    }
+
+    ok = !ferror(fp);
+    fclose(fp);
+
+    *hash = pbc_cache_hash(*hash, path, strlen(path) + 1);
+    *hash = pbc_cache_hash(*hash, text, len);
+
+    /* as the lexer takes it: .include, blanks, then a quoted name */
+    for (i = 0; ok && i + 8 < len; i++) {
+        size_t start, end;
+        char   quote;
+
+        if (text[i] != '.' || memcmp(text + i, ".include", 8))
+            continue;
+
+        for (start = i + 8; start < len
+        && (text[start] == ' ' || text[start] == '\t'); start++)
+            ;
+
+        if (start == len || (text[start] != '"' && text[start] != '\''))
+            continue;
+
+        quote = text[start++];
+
+        for (end = start; end < len
+        && text[end] != quote && text[end] != '\n'; end++)
+            ;
+
+        if (end == len || text[end] != quote)
+            continue;
+
+        if (depth >= PBC_CACHE_MAX_INCLUDE_DEPTH)
+            ok = 0;
+        else {
+            char * const name = (char *)mem_sys_allocate(end - start + 1);
+            char        *found;
+
+            memcpy(name, text + start, end - start);
+            name[end - start] = '\0';
+            found = Parrot_locate_runtime_file(interp, name,
+                        PARROT_RUNTIME_FT_INCLUDE);
+            mem_sys_free(name);
+
+            if (found) {
+                ok = pbc_cache_hash_file(interp, hash, found, depth + 1);
+                mem_sys_free(found);
+            }
+            else
+                ok = 0;
+        }
+
+        i = end;
+    }
+
+    mem_sys_free(text);
+    return ok;
+}
+
+
+/*
+
+=item C<static char * pbc_cache_file(PARROT_INTERP, const char *filename)>
+
+Returns the name of the cached bytecode of the PIR or PASM file C<filename>,
+or NULL if there is no cache or C<filename> can't be read.  The cache is the
+directory named by the C<PARROT_PBC_CACHE> environment variable.  The name is
+a hash of C<filename>, its contents, the files it includes, and the version
+and bytecode format of this Parrot, so a changed source or another Parrot
+never finds an old file.  Files loaded with C<load_bytecode> at run time are
+cached under names of their own.  The caller frees the name with
+C<mem_sys_free()>.
+
+=cut
+
+*/
+
+PARROT_WARN_UNUSED_RESULT
+PARROT_CAN_RETURN_NULL
+static char *
+pbc_cache_file(PARROT_INTERP, ARGIN(const char *filename))
+{
+    ASSERT_ARGS(pbc_cache_file)
+    int          free_it;
+    char * const dir        = Parrot_getenv("PARROT_PBC_CACHE", &free_it);
+    char        *cache_file = NULL;
+
+    if (!dir)
+        return NULL;
+
+    if (*dir) {
+        PackFile_Header header;
+        UHUGEINTVAL     hash = PBC_CACHE_FNV_BASIS;
+
+        /* set_header leaves the UUID fields alone */
+        memset(&header, 0, sizeof (header));
+        PackFile_set_header(&header);
+        hash = pbc_cache_hash(hash, &header, PACKFILE_HEADER_BYTES);
+        hash = pbc_cache_hash(hash, PARROT_VERSION, sizeof (PARROT_VERSION));
+        hash = pbc_cache_hash(hash, &interp->op_count, sizeof (interp->op_count));
+
+        if (pbc_cache_hash_file(interp, &hash, filename, 0)) {
+            const size_t len = strlen(dir) + 22;
+
+            cache_file = (char *)mem_sys_allocate(len);
+            snprintf(cache_file, len, "%s/%08lx%08lx.pbc", dir,
+                (unsigned long)(hash >> 32), (unsigned long)(hash & 0xffffffff));
+        }
+    }
+
+    if (free_it)
+        mem_sys_free(dir);
+
+    return cache_file;
+}
+
+
+/*
+
+=item C<static void pbc_cache_store(PARROT_INTERP, PackFile_ByteCode *cs, const
+char *cache_file)>
+
+Writes the code segment C<cs> just compiled, with its fixups, constants, debug
+information and annotations, to C<cache_file> as a bytecode file of its own.
+The file is written under a temporary name and then renamed, so other
+processes never load a partial file.  If it can't be written, there's just no
+cache.
+
+=cut
+
+*/
+
+static void
+pbc_cache_store(PARROT_INTERP, ARGMOD(PackFile_ByteCode *cs),
+        ARGIN(const char *cache_file))
+{
+    ASSERT_ARGS(pbc_cache_store)
+    PackFile * const    pf = PackFile_new(interp, 0);
+    PackFile_Segment   *segs[5];
+    PackFile_Directory *dirs[5];
+    PackFile           *owners[5];
+    opcode_t           *packed;
+    size_t              n = 0, i, size, len;
+    char               *temp_file;
+    FILE               *fp;
+    int                 ok;
+
+    segs[n++] = &cs->base;
+    segs[n++] = &cs->fixups->base;
+    segs[n++] = &cs->const_table->base;
+
+    if (cs->debugs)
+        segs[n++] = &cs->debugs->base;
+
+    if (cs->annotations)
+        segs[n++] = &cs->annotations->base;
+
+    /* lend the segments to a packfile of their own while packing them */
+    for (i = 0; i < n; i++) {
+        dirs[i]   = segs[i]->dir;
+        owners[i] = segs[i]->pf;
+        PackFile_add_segment(interp, &pf->directory, segs[i]);
+        segs[i]->pf = pf;
+    }
+
+    size   = PackFile_pack_size(interp, pf) * sizeof (opcode_t);
+    packed = (opcode_t *)mem_sys_allocate(size);
+    PackFile_pack(interp, pf, packed);
+
+    for (i = 0; i < n; i++) {
+        segs[i]->dir = dirs[i];
+        segs[i]->pf  = owners[i];
+    }
+
+    pf->directory.num_segments = 0;
+    PackFile_destroy(interp, pf);
+
+    len       = strlen(cache_file) + 24;
+    temp_file = (char *)mem_sys_allocate(len);
+    snprintf(temp_file, len, "%s.%d", cache_file, (int)getpid());
+
+    fp = fopen(temp_file, "wb");
+    ok = fp && fwrite(packed, 1, size, fp) == size;
+
+    if (fp && fclose(fp))
+        ok = 0;
+
+    if (!ok || rename(temp_file, cache_file))
+        remove(temp_file);
+
+    mem_sys_free(temp_file);
+    mem_sys_free(packed);
+}
+
+
 /*
 
 =item C<static void compile_or_load_file(PARROT_INTERP, STRING *path,
@@ -4686,6 +5295,10 @@ enum_runtime_ft file_type)>
 Either load a bytecode file and append it to the current packfile directory, or
 compile a PIR or PASM file from source.
 
+A PIR or PASM file is loaded from the bytecode cache instead, if
+C<PARROT_PBC_CACHE> names one and it holds the file; otherwise the bytecode
+compiled from it is put there.
+
 =cut
 
 */
@@ -4712,24 +5325,50 @@ compile_or_load_file(PARROT_INTERP, ARGIN(STRING *path),
             Parrot_ex_throw_from_c_args(interp, NULL, 1,
                 "Unable to append PBC to the current directory");
 
-        mem_sys_free(pf->header);
-        pf->header = NULL;
+        /* the header is kept to thaw PMC constants left frozen */
         mem_sys_free(pf->dirp);
         pf->dirp   = NULL;
 
     }
     else {
-        STRING *err;
-        PackFile_ByteCode * const cs =
-            (PackFile_ByteCode *)IMCC_compile_file_s(interp,
-                filename, &err);
-        Parrot_str_free_cstring(filename);
+        char     * const cache_file = pbc_cache_file(interp, filename);
+        PackFile        *pf         = NULL;
+
+        /* a cached file which doesn't unpack is compiled and stored again */
+        if (cache_file && Parrot_stat_info_intval(interp,
+                string_make(interp, cache_file, strlen(cache_file), NULL, 0),
+                STAT_EXISTS))
+            pf = PackFile_append_pbc(interp, cache_file);
+
+        if (pf) {
+            Parrot_str_free_cstring(filename);
+            mem_sys_free(pf->dirp);
+            pf->dirp = NULL;
+        }
+        else {
+            STRING *err;
+            PackFile_ByteCode * const cs =
+                (PackFile_ByteCode *)IMCC_compile_file_s(interp,
+                    filename, &err);
+            Parrot_str_free_cstring(filename);
+
+            if (!cs) {
+                if (cache_file)
+                    mem_sys_free(cache_file);
+                Parrot_ex_throw_from_c_args(interp, NULL,
+                    EXCEPTION_LIBRARY_ERROR,
+                    "compiler returned NULL ByteCode '%Ss' - %Ss", path, err);
+            }
+
+            /* cache it before :load subs can change its constants */
+            if (cache_file)
+                pbc_cache_store(interp, cs, cache_file);
 
-        if (cs)
             do_sub_pragmas(interp, cs, PBC_LOADED, NULL);
-        else
-            Parrot_ex_throw_from_c_args(interp, NULL, EXCEPTION_LIBRARY_ERROR,
-                "compiler returned NULL ByteCode '%Ss' - %Ss", path, err);
+        }
+
+        if (cache_file)
+            mem_sys_free(cache_file);
     }
 
     Parrot_pop_context(interp);
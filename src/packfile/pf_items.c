@@ -1296,6 +1296,9 @@ Opcode format is:
 
 When used for freeze/thaw the C<pf> argument might be NULL.
 
+If C<pf> is C<mmap()>ed and needs no transforms, the C<STRING> points into
+the mapping instead of holding a copy.
+
 =cut
 
 */
@@ -1323,6 +1326,12 @@ PF_fetch_string(PARROT_INTERP, ARGIN_NULLOK(PackFile *pf), ARGIN(const opcode_t
     TRACE_PRINTF(("charset_nr=%ld, ", charset_nr));
     TRACE_PRINTF(("size=%ld.\n", size));
 
+    /* Strings in a mapped packfile that needs no transforms are used in
+     * place, so their pages stay shared with every other process mapping
+     * the file.  The mapping lives as long as the packfile does. */
+    if (pf && pf->is_mmap_ped && !pf->need_endianize && !pf->need_wordsize)
+        flags |= PObj_external_FLAG;
+
     s            = string_make_from_charset(interp, (const char *)*cursor,
                         size, charset_nr, flags);
 
@@ -162,8 +162,13 @@ PackFile_ConstTable_pack_size(PARROT_INTERP, ARGIN(PackFile_Segment *seg))
     const PackFile_ConstTable* const self = (const PackFile_ConstTable *) seg;
     size_t size = 1;    /* const_count */
 
-    for (i = 0; i < self->const_count; i++)
+    for (i = 0; i < self->const_count; i++) {
+        /* a PMC left frozen by a lazy unpack is thawed to freeze it again */
+        if (self->constants[i]->frozen)
+            (void)PackFile_Constant_thaw_pmc(interp, self->constants[i]);
+
         size += PackFile_Constant_pack_size(interp, self->constants[i]);
+    }
     return size;
 }
 
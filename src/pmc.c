@@ -163,6 +163,9 @@ pmc_new(PARROT_INTERP, INTVAL base_type)
         else {
             PMC * const pmc = get_new_pmc_header(interp, base_type, 0);
             VTABLE_init(interp, pmc);
+
+            /* init stores without a barrier, and may have promoted pmc */
+            GC_WRITE_BARRIER(interp, pmc, NULL, NULL);
             return pmc;
         }
     }
@@ -199,6 +202,9 @@ pmc_reuse(PARROT_INTERP, ARGIN(PMC *pmc), INTVAL new_type,
        be called on Object PMCs. */
     VTABLE_init(interp, pmc);
 
+    /* The new value is stored through init, which has no barrier */
+    GC_WRITE_BARRIER(interp, pmc, NULL, NULL);
+
     return pmc;
 }
 
@@ -233,6 +239,9 @@ pmc_reuse_init(PARROT_INTERP, ARGIN(PMC *pmc), INTVAL new_type, ARGIN(PMC *init)
        be called on Object PMCs. */
     VTABLE_init_pmc(interp, pmc, init);
 
+    /* The new value is stored through init_pmc, which has no barrier */
+    GC_WRITE_BARRIER(interp, pmc, NULL, NULL);
+
     return pmc;
 }
 
@@ -263,6 +272,9 @@ pmc_reuse_no_init(PARROT_INTERP, ARGIN(PMC *pmc), INTVAL new_type,
     /* Singleton/const PMCs/types are not eligible */
     check_pmc_reuse_flags(interp, pmc->vtable->flags, new_vtable->flags);
 
+    /* Keep the PMC in its GC generation */
+    new_flags |= PObj_get_FLAGS(pmc) & (PObj_GC_old_FLAG | PObj_live_FLAG);
+
     /* Free the old PMC resources. */
     Parrot_pmc_destroy(interp, pmc);
 
@@ -312,6 +324,9 @@ pmc_reuse_by_class(PARROT_INTERP, ARGMOD(PMC *pmc), ARGIN(PMC *class_),
     /* Singleton/const PMCs/types are not eligible */
     check_pmc_reuse_flags(interp, pmc->vtable->flags, new_vtable->flags);
 
+    /* Keep the PMC in its GC generation */
+    new_flags |= PObj_get_FLAGS(pmc) & (PObj_GC_old_FLAG | PObj_live_FLAG);
+
     Parrot_pmc_destroy(interp, pmc);
 
     PObj_flags_SETTO(pmc, PObj_is_PMC_FLAG | new_flags);
@@ -319,6 +334,9 @@ pmc_reuse_by_class(PARROT_INTERP, ARGMOD(PMC *pmc), ARGIN(PMC *class_),
     /* Set the right vtable */
     pmc->vtable = new_vtable;
 
+    /* The new value is stored through init, which has no barrier */
+    GC_WRITE_BARRIER(interp, pmc, NULL, NULL);
+
     if (new_vtable->attr_size)
         Parrot_gc_allocate_pmc_attributes(interp, pmc);
     else
@@ -565,6 +583,9 @@ pmc_new_init(PARROT_INTERP, INTVAL base_type, ARGOUT(PMC *init))
     else {
         PMC * const pmc = get_new_pmc_header(interp, base_type, 0);
         VTABLE_init_pmc(interp, pmc, init);
+
+        /* init_pmc stores without a barrier, and may have promoted pmc */
+        GC_WRITE_BARRIER(interp, pmc, NULL, NULL);
         return pmc;
     }
 }
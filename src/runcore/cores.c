@@ -185,6 +185,17 @@ The caveat of course is that the predereferenced computed goto core is only
 available with compilers that support computed goto, such as GCC. Parrot
 will not have access to this core if it is built with a different compiler.
 
+=head2 Exec Core
+
+The exec core goes one step further and removes the dispatch altogether.
+The first time it runs a bytecode segment, it translates the whole segment
+to machine code.  The simple integer and number ops, such as C<add>,
+C<set>, C<inc> and the compare-and-branch ops, are copied in from templates
+which work on the registers directly.  Every other op becomes a call to its
+op function, followed by a jump to wherever that function says to go next.
+The code is generated for x86-64 only; elsewhere the exec core runs like the
+fast core.  See F<src/runcore/exec.c>.
+
 =head2 Tracing Core
 
 To come.
@@ -291,15 +302,6 @@ static opcode_t * runops_debugger_core(PARROT_INTERP,
         __attribute__nonnull__(2)
         __attribute__nonnull__(3);
 
-PARROT_WARN_UNUSED_RESULT
-PARROT_CAN_RETURN_NULL
-static opcode_t * runops_exec_core(PARROT_INTERP,
-    ARGIN(Parrot_runcore_t *runcore),
-    ARGIN(opcode_t *pc))
-        __attribute__nonnull__(1)
-        __attribute__nonnull__(2)
-        __attribute__nonnull__(3);
-
 PARROT_WARN_UNUSED_RESULT
 PARROT_CAN_RETURN_NULL
 static opcode_t * runops_fast_core(PARROT_INTERP,
@@ -357,10 +359,6 @@ static opcode_t * runops_trace_core(PARROT_INTERP,
        PARROT_ASSERT_ARG(interp) \
     , PARROT_ASSERT_ARG(runcore) \
     , PARROT_ASSERT_ARG(pc))
-#define ASSERT_ARGS_runops_exec_core __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
-       PARROT_ASSERT_ARG(interp) \
-    , PARROT_ASSERT_ARG(runcore) \
-    , PARROT_ASSERT_ARG(pc))
 #define ASSERT_ARGS_runops_fast_core __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
        PARROT_ASSERT_ARG(interp) \
     , PARROT_ASSERT_ARG(runcore) \
@@ -475,34 +473,6 @@ Parrot_runcore_switch_init(PARROT_INTERP)
 }
 
 
-/*
-
-=item C<void Parrot_runcore_exec_init(PARROT_INTERP)>
-
-Registers the exec runcore with Parrot.
-
-=cut
-
-*/
-
-void
-Parrot_runcore_exec_init(PARROT_INTERP)
-{
-    ASSERT_ARGS(Parrot_runcore_exec_init)
-
-    Parrot_runcore_t *coredata = mem_allocate_typed(Parrot_runcore_t);
-    coredata->name             = CONST_STRING(interp, "exec");
-    coredata->id               = PARROT_EXEC_CORE;
-    coredata->opinit           = PARROT_CORE_OPLIB_INIT;
-    coredata->runops           = runops_exec_core;
-    coredata->destroy          = NULL;
-    coredata->prepare_run      = NULL;
-    coredata->flags            = 0;
-
-    Parrot_runcore_register(interp, coredata);
-}
-
-
 /*
 
 =item C<void Parrot_runcore_gc_debug_init(PARROT_INTERP)>
@@ -1088,31 +1058,6 @@ get_core_op_lib_init(PARROT_INTERP, ARGIN(Parrot_runcore_t *runcore))
 }
 
 
-/*
-
-=item C<static opcode_t * runops_exec_core(PARROT_INTERP, Parrot_runcore_t
-*runcore, opcode_t *pc)>
-
-Runs the native executable version of the specified opcode.
-
-=cut
-
-*/
-
-PARROT_WARN_UNUSED_RESULT
-PARROT_CAN_RETURN_NULL
-static opcode_t *
-runops_exec_core(PARROT_INTERP, ARGIN(Parrot_runcore_t *runcore), ARGIN(opcode_t *pc))
-{
-    ASSERT_ARGS(runops_exec_core)
-
-    UNUSED(interp);
-    UNUSED(pc);
-
-    return NULL;
-}
-
-
 /*
 
 =item C<static opcode_t * runops_cgp_core(PARROT_INTERP, Parrot_runcore_t
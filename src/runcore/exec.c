@@ -0,0 +1,1135 @@
+/*
+Copyright (C) 2009, Parrot Foundation.
+$Id$
+
+=head1 NAME
+
+src/runcore/exec.c - The exec runcore
+
+=head1 DESCRIPTION
+
+The exec core translates a bytecode segment to x86-64 machine code the first
+time it runs it.  The common integer and number register ops -- C<add>,
+C<sub>, C<mul>, C<set>, C<inc>, C<dec>, the C<eq>, C<ne>, C<lt> and C<le>
+branches, C<if>, C<unless> and C<branch> -- are stitched together from
+templates which work on the registers in place.  Every other op becomes a
+call to its op function, through C<< interp->op_func_table >> as in the fast
+core.
+
+While it runs the native code keeps the interpreter in C<rbx>, the start of
+the bytecode in C<r12>, the table of the native address of each op in C<r13>
+and the register frame of the current context in C<r14>, which is loaded
+again after each op function call because that may change the context.  An
+op function returning anything but the next op is looked up in the table;
+when the new C<pc> is in another segment, or is not an op in this one, the
+native code returns it and the core runs that op through the op function
+table and goes on from there.  Backward branches pass a safepoint the same
+way: when C<enable_event_checking()> has asked for one, they return to the
+core, which handles the pending tasks.
+
+Where there is no native code generator (see C<--jitcapable> in
+F<Configure.pl>) the exec core runs the op functions like the fast core.
+
+=head2 Functions
+
+=over 4
+
+=cut
+
+*/
+
+#include "parrot/runcore_api.h"
+#include "parrot/embed.h"
+#include "parrot/oplib/ops.h"
+#include "parrot/oplib/core_ops.h"
+#include "exec.str"
+
+#if PARROT_JIT_CAPABLE && defined(__x86_64__) && defined(PARROT_HAS_HEADER_SYSMMAN) \
+ && INTVAL_SIZE == 8 && NUMVAL_SIZE == 8 && OPCODE_T_SIZE == 8
+#  define EXEC_NATIVE 1
+#  include <sys/mman.h>
+#endif
+
+typedef opcode_t *(*exec_native_fn_t)(PARROT_INTERP, opcode_t *pc);
+
+/* the native code of a bytecode segment */
+typedef struct _exec_code {
+    opcode_t         *base;         /* the bytecode it was made from */
+    size_t            size;         /* ... and its size in opcodes */
+    void            **map;          /* native address of each op, by offset */
+    unsigned char    *native;       /* the machine code, NULL if there's none */
+    size_t            native_size;
+    exec_native_fn_t  entry;
+} Exec_code;
+
+/* a jump to an op which is patched once the op is emitted */
+typedef struct exec_fixup {
+    size_t at;                      /* offset of the rel32 to patch */
+    size_t op;                      /* target op */
+    int    check_events;            /* go through an event checking stub */
+} Exec_fixup;
+
+/* the machine code while it is emitted */
+typedef struct exec_buffer {
+    unsigned char *code;
+    size_t         size;
+    size_t         alloc;
+    size_t        *op_offs;         /* code offset of each op, by offset */
+    Exec_fixup    *fixups;
+    size_t         n_fixups;
+    size_t         alloc_fixups;
+    size_t         exit;            /* code offset of the epilogue */
+    size_t         dispatch;        /* ... and of the pc lookup */
+} Exec_buffer;
+
+#define EXEC_NO_OP         ((size_t)-1)
+
+/* condition codes of jcc; EXEC_JMP stands for an unconditional jump */
+#define EXEC_CC_A          0x7
+#define EXEC_CC_AE         0x3
+#define EXEC_CC_E          0x4
+#define EXEC_CC_NE         0x5
+#define EXEC_CC_L          0xc
+#define EXEC_CC_LE         0xe
+#define EXEC_CC_P          0xa
+#define EXEC_JMP           -1
+
+/* the scratch registers of the templates */
+#define EXEC_RAX           0
+#define EXEC_RCX           1
+#define EXEC_XMM0          0
+#define EXEC_XMM1          1
+
+/* HEADERIZER HFILE: include/parrot/runcore_api.h */
+
+/* HEADERIZER BEGIN: static */
+/* Don't modify between HEADERIZER BEGIN / HEADERIZER END.  Your changes will be lost. */
+
+static void emit_branch(
+    ARGMOD(Exec_buffer *buf),
+    int cc,
+    size_t target,
+    size_t from)
+        __attribute__nonnull__(1)
+        FUNC_MODIFIES(*buf);
+
+static void emit_bytes(
+    ARGMOD(Exec_buffer *buf),
+    ARGIN(const char *bytes),
+    size_t n)
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2)
+        FUNC_MODIFIES(*buf);
+
+static void emit_int32(ARGMOD(Exec_buffer *buf), INTVAL value)
+        __attribute__nonnull__(1)
+        FUNC_MODIFIES(*buf);
+
+static void emit_int64(ARGMOD(Exec_buffer *buf), UHUGEINTVAL value)
+        __attribute__nonnull__(1)
+        FUNC_MODIFIES(*buf);
+
+static void emit_jump(ARGMOD(Exec_buffer *buf), int cc, size_t to)
+        __attribute__nonnull__(1)
+        FUNC_MODIFIES(*buf);
+
+static void emit_load_int(
+    ARGMOD(Exec_buffer *buf),
+    int reg,
+    int type,
+    opcode_t arg)
+        __attribute__nonnull__(1)
+        FUNC_MODIFIES(*buf);
+
+static void emit_load_num(
+    ARGMOD(Exec_buffer *buf),
+    ARGIN(const PackFile_ByteCode *cs),
+    int reg,
+    int type,
+    opcode_t arg)
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2)
+        FUNC_MODIFIES(*buf);
+
+static void emit_load_regs(ARGMOD(Exec_buffer *buf))
+        __attribute__nonnull__(1)
+        FUNC_MODIFIES(*buf);
+
+static void emit_num_const(ARGMOD(Exec_buffer *buf), int reg, FLOATVAL value)
+        __attribute__nonnull__(1)
+        FUNC_MODIFIES(*buf);
+
+static void emit_op_call(ARGMOD(Exec_buffer *buf), size_t i, size_t n)
+        __attribute__nonnull__(1)
+        FUNC_MODIFIES(*buf);
+
+static void emit_store_int(ARGMOD(Exec_buffer *buf), int reg, opcode_t arg)
+        __attribute__nonnull__(1)
+        FUNC_MODIFIES(*buf);
+
+static void emit_store_num(ARGMOD(Exec_buffer *buf), int reg, opcode_t arg)
+        __attribute__nonnull__(1)
+        FUNC_MODIFIES(*buf);
+
+PARROT_WARN_UNUSED_RESULT
+static int emit_template(
+    ARGMOD(Exec_buffer *buf),
+    ARGIN(const PackFile_ByteCode *cs),
+    ARGIN(const op_info_t *info),
+    ARGIN(const opcode_t *pc),
+    size_t i)
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2)
+        __attribute__nonnull__(3)
+        __attribute__nonnull__(4)
+        FUNC_MODIFIES(*buf);
+
+PARROT_CANNOT_RETURN_NULL
+static Exec_code * exec_compile(PARROT_INTERP, ARGMOD(PackFile_ByteCode *cs))
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2)
+        FUNC_MODIFIES(*cs);
+
+static int exec_translate(PARROT_INTERP,
+    ARGIN(const PackFile_ByteCode *cs),
+    ARGMOD(Exec_code *code))
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2)
+        __attribute__nonnull__(3)
+        FUNC_MODIFIES(*code);
+
+PARROT_WARN_UNUSED_RESULT
+PARROT_CAN_RETURN_NULL
+static opcode_t * runops_exec_core(PARROT_INTERP,
+    ARGIN(Parrot_runcore_t *runcore),
+    ARGIN(opcode_t *pc))
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2)
+        __attribute__nonnull__(3);
+
+#define ASSERT_ARGS_emit_branch __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(buf))
+#define ASSERT_ARGS_emit_bytes __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(buf) \
+    , PARROT_ASSERT_ARG(bytes))
+#define ASSERT_ARGS_emit_int32 __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(buf))
+#define ASSERT_ARGS_emit_int64 __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(buf))
+#define ASSERT_ARGS_emit_jump __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(buf))
+#define ASSERT_ARGS_emit_load_int __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(buf))
+#define ASSERT_ARGS_emit_load_num __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(buf) \
+    , PARROT_ASSERT_ARG(cs))
+#define ASSERT_ARGS_emit_load_regs __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(buf))
+#define ASSERT_ARGS_emit_num_const __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(buf))
+#define ASSERT_ARGS_emit_op_call __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(buf))
+#define ASSERT_ARGS_emit_store_int __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(buf))
+#define ASSERT_ARGS_emit_store_num __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(buf))
+#define ASSERT_ARGS_emit_template __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(buf) \
+    , PARROT_ASSERT_ARG(cs) \
+    , PARROT_ASSERT_ARG(info) \
+    , PARROT_ASSERT_ARG(pc))
+#define ASSERT_ARGS_exec_compile __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp) \
+    , PARROT_ASSERT_ARG(cs))
+#define ASSERT_ARGS_exec_translate __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp) \
+    , PARROT_ASSERT_ARG(cs) \
+    , PARROT_ASSERT_ARG(code))
+#define ASSERT_ARGS_runops_exec_core __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp) \
+    , PARROT_ASSERT_ARG(runcore) \
+    , PARROT_ASSERT_ARG(pc))
+/* Don't modify between HEADERIZER BEGIN / HEADERIZER END.  Your changes will be lost. */
+/* HEADERIZER END: static */
+
+
+/*
+
+=item C<void Parrot_runcore_exec_init(PARROT_INTERP)>
+
+Registers the exec runcore with Parrot.
+
+=cut
+
+*/
+
+void
+Parrot_runcore_exec_init(PARROT_INTERP)
+{
+    ASSERT_ARGS(Parrot_runcore_exec_init)
+
+    Parrot_runcore_t *coredata = mem_allocate_typed(Parrot_runcore_t);
+    coredata->name             = CONST_STRING(interp, "exec");
+    coredata->id               = PARROT_EXEC_CORE;
+    coredata->opinit           = PARROT_CORE_OPLIB_INIT;
+    coredata->runops           = runops_exec_core;
+    coredata->destroy          = NULL;
+    coredata->prepare_run      = NULL;
+    coredata->flags            = 0;
+
+    PARROT_RUNCORE_FUNC_TABLE_SET(coredata);
+    PARROT_RUNCORE_JIT_OPS_SET(coredata);
+
+    Parrot_runcore_register(interp, coredata);
+}
+
+
+/*
+
+=item C<void Parrot_exec_free_code(PARROT_INTERP, PackFile_ByteCode *cs)>
+
+Frees the native code of the segment C<cs>, if the exec core made any.
+
+=cut
+
+*/
+
+void
+Parrot_exec_free_code(PARROT_INTERP, ARGMOD(PackFile_ByteCode *cs))
+{
+    ASSERT_ARGS(Parrot_exec_free_code)
+    Exec_code * const code = cs->exec_code;
+
+    UNUSED(interp);
+
+    if (!code)
+        return;
+
+#ifdef EXEC_NATIVE
+    if (code->native)
+        munmap(code->native, code->native_size);
+#endif
+
+    if (code->map)
+        mem_sys_free(code->map);
+
+    mem_sys_free(code);
+    cs->exec_code = NULL;
+}
+
+
+/*
+
+=item C<static opcode_t * runops_exec_core(PARROT_INTERP, Parrot_runcore_t
+*runcore, opcode_t *pc)>
+
+Runs the native code of the current segment from C<pc>, translating the
+segment first if needed.  Ops the native code hands back are run by their op
+functions.
+
+=cut
+
+*/
+
+PARROT_WARN_UNUSED_RESULT
+PARROT_CAN_RETURN_NULL
+static opcode_t *
+runops_exec_core(PARROT_INTERP, ARGIN(Parrot_runcore_t *runcore), ARGIN(opcode_t *pc))
+{
+    ASSERT_ARGS(runops_exec_core)
+
+    /* disable pc */
+    Parrot_pcc_set_pc(interp, CURRENT_CONTEXT(interp), NULL);
+
+    while (pc) {
+        PackFile_ByteCode * const cs   = interp->code;
+        Exec_code                *code = cs->exec_code;
+
+        if (!code || code->base != cs->base.data || code->size != cs->base.size)
+            code = exec_compile(interp, cs);
+
+        if (code->native && pc >= code->base && pc < code->base + code->size) {
+            pc = (code->entry)(interp, pc);
+
+            if (!pc)
+                break;
+
+            PARROT_SAFEPOINT(interp);
+        }
+
+        DO_OP(pc, interp);
+    }
+
+    return pc;
+}
+
+
+/*
+
+=item C<static Exec_code * exec_compile(PARROT_INTERP, PackFile_ByteCode *cs)>
+
+Translates the segment C<cs> to native code, replacing any older translation.
+If it can't, the C<native> member of the result is NULL.
+
+=cut
+
+*/
+
+PARROT_CANNOT_RETURN_NULL
+static Exec_code *
+exec_compile(PARROT_INTERP, ARGMOD(PackFile_ByteCode *cs))
+{
+    ASSERT_ARGS(exec_compile)
+    Exec_code * const code = mem_allocate_zeroed_typed(Exec_code);
+
+    Parrot_exec_free_code(interp, cs);
+
+    code->base    = cs->base.data;
+    code->size    = cs->base.size;
+    cs->exec_code = code;
+
+    if (!exec_translate(interp, cs, code)) {
+        if (code->map) {
+            mem_sys_free(code->map);
+            code->map = NULL;
+        }
+        code->native = NULL;
+    }
+
+    return code;
+}
+
+
+/*
+
+=item C<static int exec_translate(PARROT_INTERP, const PackFile_ByteCode *cs,
+Exec_code *code)>
+
+Emits the native code for C<cs> and copies it to executable memory.  Returns
+false if the bytecode can't be translated.
+
+=cut
+
+*/
+
+static int
+exec_translate(PARROT_INTERP, ARGIN(const PackFile_ByteCode *cs), ARGMOD(Exec_code *code))
+{
+    ASSERT_ARGS(exec_translate)
+    const size_t  N  = code->size;
+    opcode_t     *pc = code->base;
+    Exec_buffer   buf;
+    size_t        i, entry;
+    int           ok = 1;
+
+#ifndef EXEC_NATIVE
+    /* no code generator for this platform */
+    return 0;
+#endif
+
+    /* the pc lookup compares byte offsets with an imm32 */
+    if (N == 0 || N >= 0x10000000)
+        return 0;
+
+    memset(&buf, 0, sizeof (buf));
+    buf.op_offs = mem_allocate_n_typed(N, size_t);
+
+    for (i = 0; i < N; ++i)
+        buf.op_offs[i] = EXEC_NO_OP;
+
+    /* find the ops first, so templates know which branch targets are ops */
+    for (i = 0; i < N;) {
+        size_t n;
+
+        if (pc[i] < 0 || (size_t)pc[i] >= interp->op_count) {
+            ok = 0;
+            break;
+        }
+
+        n = interp->op_info_table[pc[i]].op_count;
+        ADD_OP_VAR_PART(interp, cs, pc + i, n);
+
+        buf.op_offs[i] = 0;
+        i             += n;
+    }
+
+    if (ok) {
+        /* exit: add rsp, 8; pop r15; pop r14; pop r13; pop r12; pop rbx;
+         * pop rbp; ret */
+        buf.exit = buf.size;
+        emit_bytes(&buf, "\x48\x83\xc4\x08\x41\x5f\x41\x5e\x41\x5d\x41\x5c"
+                         "\x5b\x5d\xc3", 15);
+
+        /* entry: push rbp; mov rbp, rsp; push rbx; push r12; push r13;
+         * push r14; push r15; sub rsp, 8 */
+        entry = buf.size;
+        emit_bytes(&buf, "\x55\x48\x89\xe5\x53\x41\x54\x41\x55\x41\x56\x41\x57"
+                         "\x48\x83\xec\x08", 17);
+
+        /* mov rbx, rdi; mov r12, base; mov r13, map */
+        code->map = (void **)mem_sys_allocate_zeroed(N * sizeof (void *));
+        emit_bytes(&buf, "\x48\x89\xfb\x49\xbc", 5);
+        emit_int64(&buf, (UHUGEINTVAL)PTR2UINTVAL(code->base));
+        emit_bytes(&buf, "\x49\xbd", 2);
+        emit_int64(&buf, (UHUGEINTVAL)PTR2UINTVAL(code->map));
+        emit_load_regs(&buf);
+
+        /* mov rax, rsi */
+        emit_bytes(&buf, "\x48\x89\xf0", 3);
+
+        /* dispatch: mov rcx, rax; sub rcx, r12; cmp rcx, N * 8; jae exit;
+         * mov rcx, [r13 + rcx]; test rcx, rcx; je exit; jmp rcx */
+        buf.dispatch = buf.size;
+        emit_bytes(&buf, "\x48\x89\xc1\x4c\x29\xe1\x48\x81\xf9", 9);
+        emit_int32(&buf, (INTVAL)(N * sizeof (opcode_t)));
+        emit_jump(&buf, EXEC_CC_AE, buf.exit);
+        emit_bytes(&buf, "\x49\x8b\x4c\x0d\x00\x48\x85\xc9", 8);
+        emit_jump(&buf, EXEC_CC_E, buf.exit);
+        emit_bytes(&buf, "\xff\xe1", 2);
+
+        for (i = 0; i < N;) {
+            const op_info_t * const info = &interp->op_info_table[pc[i]];
+            size_t                  n    = info->op_count;
+
+            ADD_OP_VAR_PART(interp, cs, pc + i, n);
+
+            buf.op_offs[i] = buf.size;
+
+            if (!emit_template(&buf, cs, info, pc + i, i))
+                emit_op_call(&buf, i, n);
+
+            i += n;
+        }
+
+        /* patch the forward jumps, emitting the safepoints of backward
+         * ones: cmp dword [rbx + safepoint_requested], 0; je op;
+         * lea rax, [r12 + op * 8]; jmp exit */
+        for (i = 0; i < buf.n_fixups; ++i) {
+            const Exec_fixup * const fixup = &buf.fixups[i];
+            size_t                   to    = buf.op_offs[fixup->op];
+
+            if (fixup->check_events) {
+                to = buf.size;
+                emit_bytes(&buf, "\x83\xbb", 2);
+                emit_int32(&buf, (INTVAL)offsetof(Interp, safepoint_requested));
+                emit_bytes(&buf, "\x00", 1);
+                emit_jump(&buf, EXEC_CC_E, buf.op_offs[fixup->op]);
+                emit_bytes(&buf, "\x49\x8d\x84\x24", 4);
+                emit_int32(&buf, (INTVAL)(fixup->op * sizeof (opcode_t)));
+                emit_jump(&buf, EXEC_JMP, buf.exit);
+            }
+
+            {
+                const INTVAL rel = (INTVAL)to - (INTVAL)(fixup->at + 4);
+                unsigned char * const at = buf.code + fixup->at;
+                at[0] = (unsigned char)(rel & 0xff);
+                at[1] = (unsigned char)((rel >> 8) & 0xff);
+                at[2] = (unsigned char)((rel >> 16) & 0xff);
+                at[3] = (unsigned char)((rel >> 24) & 0xff);
+            }
+        }
+
+#ifdef EXEC_NATIVE
+        /* copy it to memory we can run, then take away write access */
+        code->native_size = buf.size;
+        code->native      = (unsigned char *)mmap(NULL, buf.size,
+                PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+        if (code->native == MAP_FAILED) {
+            code->native = NULL;
+            ok           = 0;
+        }
+        else {
+            memcpy(code->native, buf.code, buf.size);
+
+            if (mprotect(code->native, buf.size, PROT_READ | PROT_EXEC)) {
+                munmap(code->native, buf.size);
+                code->native = NULL;
+                ok           = 0;
+            }
+        }
+#endif
+
+        if (ok) {
+            for (i = 0; i < N; ++i)
+                if (buf.op_offs[i] != EXEC_NO_OP)
+                    code->map[i] = code->native + buf.op_offs[i];
+
+            code->entry = (exec_native_fn_t)D2FPTR(code->native + entry);
+        }
+    }
+
+    if (buf.code)
+        mem_sys_free(buf.code);
+    if (buf.fixups)
+        mem_sys_free(buf.fixups);
+    mem_sys_free(buf.op_offs);
+
+    return ok;
+}
+
+
+/*
+
+=item C<static int emit_template(Exec_buffer *buf, const PackFile_ByteCode
+*cs, const op_info_t *info, const opcode_t *pc, size_t i)>
+
+Emits the template of the op at C<pc>, which is at offset C<i>.  Returns false
+without emitting anything if it has no template, so the op function must be
+called.
+
+=cut
+
+*/
+
+PARROT_WARN_UNUSED_RESULT
+static int
+emit_template(ARGMOD(Exec_buffer *buf), ARGIN(const PackFile_ByteCode *cs),
+        ARGIN(const op_info_t *info), ARGIN(const opcode_t *pc), size_t i)
+{
+    ASSERT_ARGS(emit_template)
+    const char * const name  = info->name;
+    const int          nargs = info->op_count - 1;
+    const char * const types = info->types;
+    int                k, is_int = 0, is_num = 0;
+
+    /* only register and constant INTVAL and FLOATVAL arguments; the
+     * register numbers go to disp32s */
+    for (k = 0; k < nargs; ++k) {
+        if (info->labels[k])
+            continue;
+
+        if (types[k] == PARROT_ARG_I || types[k] == PARROT_ARG_IC)
+            is_int = 1;
+        else if (types[k] == PARROT_ARG_N || types[k] == PARROT_ARG_NC)
+            is_num = 1;
+        else
+            return 0;
+
+        if (!(types[k] & PARROT_ARG_CONSTANT)
+        &&  (pc[k + 1] < 0 || pc[k + 1] >= 0x1000000))
+            return 0;
+    }
+
+    /* branch targets must be ops of this segment */
+    for (k = 0; k < nargs; ++k) {
+        if (info->labels[k]) {
+            const opcode_t to = (opcode_t)i + pc[k + 1];
+
+            if (types[k] != PARROT_ARG_IC
+            ||  to < 0 || (size_t)to >= cs->base.size
+            ||  buf->op_offs[to] == EXEC_NO_OP)
+                return 0;
+        }
+    }
+
+    if (STREQ(name, "add") || STREQ(name, "sub") || STREQ(name, "mul")) {
+        const opcode_t dest = pc[1];
+        const int      a    = nargs == 3 ? 2 : 1;
+        const int      b    = nargs == 3 ? 3 : 2;
+
+        if (nargs < 2 || types[0] & PARROT_ARG_CONSTANT)
+            return 0;
+
+        if (types[0] == PARROT_ARG_I && !is_num) {
+            emit_load_int(buf, EXEC_RAX, types[a - 1], pc[a]);
+            emit_load_int(buf, EXEC_RCX, types[b - 1], pc[b]);
+
+            /* add rax, rcx / sub rax, rcx / imul rax, rcx */
+            if (name[0] == 'a')
+                emit_bytes(buf, "\x48\x01\xc8", 3);
+            else if (name[0] == 's')
+                emit_bytes(buf, "\x48\x29\xc8", 3);
+            else
+                emit_bytes(buf, "\x48\x0f\xaf\xc1", 4);
+
+            emit_store_int(buf, EXEC_RAX, dest);
+            return 1;
+        }
+
+        if (types[0] == PARROT_ARG_N && !is_int) {
+            emit_load_num(buf, cs, EXEC_XMM0, types[a - 1], pc[a]);
+            emit_load_num(buf, cs, EXEC_XMM1, types[b - 1], pc[b]);
+
+            /* addsd / subsd / mulsd xmm0, xmm1 */
+            if (name[0] == 'a')
+                emit_bytes(buf, "\xf2\x0f\x58\xc1", 4);
+            else if (name[0] == 's')
+                emit_bytes(buf, "\xf2\x0f\x5c\xc1", 4);
+            else
+                emit_bytes(buf, "\xf2\x0f\x59\xc1", 4);
+
+            emit_store_num(buf, EXEC_XMM0, dest);
+            return 1;
+        }
+
+        return 0;
+    }
+
+    if (STREQ(name, "inc") || STREQ(name, "dec")) {
+        if (nargs != 1)
+            return 0;
+
+        if (types[0] == PARROT_ARG_I) {
+            /* inc / dec qword [r14 + $1 * 8] */
+            emit_bytes(buf, name[0] == 'i' ? "\x49\xff\x86" : "\x49\xff\x8e", 3);
+            emit_int32(buf, (INTVAL)(pc[1] * sizeof (INTVAL)));
+            return 1;
+        }
+
+        if (types[0] == PARROT_ARG_N) {
+            emit_load_num(buf, cs, EXEC_XMM0, PARROT_ARG_N, pc[1]);
+            emit_num_const(buf, EXEC_XMM1, 1.0);
+
+            /* addsd / subsd xmm0, xmm1 */
+            emit_bytes(buf, name[0] == 'i' ? "\xf2\x0f\x58\xc1" : "\xf2\x0f\x5c\xc1", 4);
+
+            emit_store_num(buf, EXEC_XMM0, pc[1]);
+            return 1;
+        }
+
+        return 0;
+    }
+
+    if (STREQ(name, "set")) {
+        if (nargs != 2)
+            return 0;
+
+        if (types[0] == PARROT_ARG_I) {
+            if (types[1] == PARROT_ARG_N || types[1] == PARROT_ARG_NC) {
+                /* cvttsd2si rax, xmm0 */
+                emit_load_num(buf, cs, EXEC_XMM0, types[1], pc[2]);
+                emit_bytes(buf, "\xf2\x48\x0f\x2c\xc0", 5);
+            }
+            else
+                emit_load_int(buf, EXEC_RAX, types[1], pc[2]);
+
+            emit_store_int(buf, EXEC_RAX, pc[1]);
+            return 1;
+        }
+
+        if (types[0] == PARROT_ARG_N) {
+            if (types[1] == PARROT_ARG_I || types[1] == PARROT_ARG_IC) {
+                /* cvtsi2sd xmm0, rax */
+                emit_load_int(buf, EXEC_RAX, types[1], pc[2]);
+                emit_bytes(buf, "\xf2\x48\x0f\x2a\xc0", 5);
+            }
+            else
+                emit_load_num(buf, cs, EXEC_XMM0, types[1], pc[2]);
+
+            emit_store_num(buf, EXEC_XMM0, pc[1]);
+            return 1;
+        }
+
+        return 0;
+    }
+
+    if (STREQ(name, "eq") || STREQ(name, "ne")
+    ||  STREQ(name, "lt") || STREQ(name, "le")) {
+        const size_t to = i + pc[3];
+
+        if (nargs != 3 || !info->labels[2] || (is_int && is_num))
+            return 0;
+
+        if (is_int) {
+            emit_load_int(buf, EXEC_RAX, types[0], pc[1]);
+            emit_load_int(buf, EXEC_RCX, types[1], pc[2]);
+
+            /* cmp rax, rcx */
+            emit_bytes(buf, "\x48\x39\xc8", 3);
+            emit_branch(buf,
+                name[0] == 'e' ? EXEC_CC_E
+              : name[0] == 'n' ? EXEC_CC_NE
+              : name[1] == 't' ? EXEC_CC_L
+              :                  EXEC_CC_LE, to, i);
+            return 1;
+        }
+
+        emit_load_num(buf, cs, EXEC_XMM0, types[0], pc[1]);
+        emit_load_num(buf, cs, EXEC_XMM1, types[1], pc[2]);
+
+        /* a NaN compares unordered, setting ZF, PF and CF; C's comparisons
+         * are all false then but != */
+        if (name[0] == 'e' || name[0] == 'n') {
+            /* ucomisd xmm0, xmm1 */
+            emit_bytes(buf, "\x66\x0f\x2e\xc1", 4);
+
+            if (name[0] == 'e') {
+                /* jp next op */
+                emit_bytes(buf, "\x7a\x06", 2);
+                emit_branch(buf, EXEC_CC_E, to, i);
+            }
+            else {
+                emit_branch(buf, EXEC_CC_P, to, i);
+                emit_branch(buf, EXEC_CC_NE, to, i);
+            }
+        }
+        else {
+            /* ucomisd xmm1, xmm0: above is b > a, so never when unordered */
+            emit_bytes(buf, "\x66\x0f\x2e\xc8", 4);
+            emit_branch(buf, name[1] == 't' ? EXEC_CC_A : EXEC_CC_AE, to, i);
+        }
+
+        return 1;
+    }
+
+    if (STREQ(name, "if") || STREQ(name, "unless")) {
+        if (nargs != 2 || types[0] != PARROT_ARG_I || !info->labels[1])
+            return 0;
+
+        /* test rax, rax */
+        emit_load_int(buf, EXEC_RAX, PARROT_ARG_I, pc[1]);
+        emit_bytes(buf, "\x48\x85\xc0", 3);
+        emit_branch(buf, name[0] == 'i' ? EXEC_CC_NE : EXEC_CC_E, i + pc[2], i);
+        return 1;
+    }
+
+    if (STREQ(name, "branch")) {
+        if (nargs != 1 || !info->labels[0])
+            return 0;
+
+        emit_branch(buf, EXEC_JMP, i + pc[1], i);
+        return 1;
+    }
+
+    return 0;
+}
+
+
+/*
+
+=item C<static void emit_op_call(Exec_buffer *buf, size_t i, size_t n)>
+
+Emits a call of the op function of the op at offset C<i>, which is C<n>
+opcodes long.  Unless the op function returns the next op, the code goes on
+where it points to.
+
+=cut
+
+*/
+
+static void
+emit_op_call(ARGMOD(Exec_buffer *buf), size_t i, size_t n)
+{
+    ASSERT_ARGS(emit_op_call)
+
+    /* lea rdi, [r12 + i * 8]; mov rsi, rbx; mov rax, [rbx + op_func_table];
+     * mov rcx, [rdi]; call [rax + rcx * 8] */
+    emit_bytes(buf, "\x49\x8d\xbc\x24", 4);
+    emit_int32(buf, (INTVAL)(i * sizeof (opcode_t)));
+    emit_bytes(buf, "\x48\x89\xde\x48\x8b\x83", 6);
+    emit_int32(buf, (INTVAL)offsetof(Interp, op_func_table));
+    emit_bytes(buf, "\x48\x8b\x0f\xff\x14\xc8", 6);
+
+    /* the op may have changed the context */
+    emit_load_regs(buf);
+
+    /* lea rcx, [r12 + (i + n) * 8]; cmp rax, rcx; jne dispatch */
+    emit_bytes(buf, "\x49\x8d\x8c\x24", 4);
+    emit_int32(buf, (INTVAL)((i + n) * sizeof (opcode_t)));
+    emit_bytes(buf, "\x48\x39\xc8", 3);
+    emit_jump(buf, EXEC_CC_NE, buf->dispatch);
+}
+
+
+/*
+
+=item C<static void emit_load_regs(Exec_buffer *buf)>
+
+Emits the load of the register frame of the current context into C<r14>.
+
+=cut
+
+*/
+
+static void
+emit_load_regs(ARGMOD(Exec_buffer *buf))
+{
+    ASSERT_ARGS(emit_load_regs)
+
+    /* mov rcx, [rbx + ctx]; mov rcx, [rcx + data]; mov r14, [rcx + bp] */
+    emit_bytes(buf, "\x48\x8b\x8b", 3);
+    emit_int32(buf, (INTVAL)offsetof(Interp, ctx));
+    emit_bytes(buf, "\x48\x8b\x89", 3);
+    emit_int32(buf, (INTVAL)offsetof(PMC, data));
+    emit_bytes(buf, "\x4c\x8b\xb1", 3);
+    emit_int32(buf, (INTVAL)offsetof(Parrot_Context, bp));
+}
+
+
+/*
+
+=item C<static void emit_load_int(Exec_buffer *buf, int reg, int type,
+opcode_t arg)>
+
+=item C<static void emit_store_int(Exec_buffer *buf, int reg, opcode_t arg)>
+
+Emit the load of the INTVAL argument C<arg> into C<rax> or C<rcx>, and the
+store of one into the register C<arg>.
+
+=cut
+
+*/
+
+static void
+emit_load_int(ARGMOD(Exec_buffer *buf), int reg, int type, opcode_t arg)
+{
+    ASSERT_ARGS(emit_load_int)
+    char op[3];
+
+    if (type & PARROT_ARG_CONSTANT) {
+        /* mov reg, imm64 */
+        op[0] = '\x48';
+        op[1] = (char)(0xb8 + reg);
+        emit_bytes(buf, op, 2);
+        emit_int64(buf, (UHUGEINTVAL)arg);
+    }
+    else {
+        /* mov reg, [r14 + arg * 8] */
+        op[0] = '\x49';
+        op[1] = '\x8b';
+        op[2] = (char)(0x86 | (reg << 3));
+        emit_bytes(buf, op, 3);
+        emit_int32(buf, (INTVAL)(arg * sizeof (INTVAL)));
+    }
+}
+
+static void
+emit_store_int(ARGMOD(Exec_buffer *buf), int reg, opcode_t arg)
+{
+    ASSERT_ARGS(emit_store_int)
+    char op[3];
+
+    /* mov [r14 + arg * 8], reg */
+    op[0] = '\x49';
+    op[1] = '\x89';
+    op[2] = (char)(0x86 | (reg << 3));
+    emit_bytes(buf, op, 3);
+    emit_int32(buf, (INTVAL)(arg * sizeof (INTVAL)));
+}
+
+
+/*
+
+=item C<static void emit_load_num(Exec_buffer *buf, const PackFile_ByteCode
+*cs, int reg, int type, opcode_t arg)>
+
+=item C<static void emit_store_num(Exec_buffer *buf, int reg, opcode_t arg)>
+
+Emit the load of the FLOATVAL argument C<arg> into C<xmm0> or C<xmm1>, and
+the store of one into the register C<arg>.  Number registers are below the
+register frame pointer.
+
+=cut
+
+*/
+
+static void
+emit_load_num(ARGMOD(Exec_buffer *buf), ARGIN(const PackFile_ByteCode *cs),
+        int reg, int type, opcode_t arg)
+{
+    ASSERT_ARGS(emit_load_num)
+    char op[5];
+
+    if (type & PARROT_ARG_CONSTANT)
+        emit_num_const(buf, reg, cs->const_table->constants[arg]->u.number);
+    else {
+        /* movsd reg, [r14 - (arg + 1) * 8] */
+        op[0] = '\xf2';
+        op[1] = '\x41';
+        op[2] = '\x0f';
+        op[3] = '\x10';
+        op[4] = (char)(0x86 | (reg << 3));
+        emit_bytes(buf, op, 5);
+        emit_int32(buf, -(INTVAL)((arg + 1) * sizeof (FLOATVAL)));
+    }
+}
+
+static void
+emit_store_num(ARGMOD(Exec_buffer *buf), int reg, opcode_t arg)
+{
+    ASSERT_ARGS(emit_store_num)
+    char op[5];
+
+    /* movsd [r14 - (arg + 1) * 8], reg */
+    op[0] = '\xf2';
+    op[1] = '\x41';
+    op[2] = '\x0f';
+    op[3] = '\x11';
+    op[4] = (char)(0x86 | (reg << 3));
+    emit_bytes(buf, op, 5);
+    emit_int32(buf, -(INTVAL)((arg + 1) * sizeof (FLOATVAL)));
+}
+
+
+/*
+
+=item C<static void emit_num_const(Exec_buffer *buf, int reg, FLOATVAL value)>
+
+Emits the load of C<value> into C<xmm0> or C<xmm1>, through C<rax>.
+
+=cut
+
+*/
+
+static void
+emit_num_const(ARGMOD(Exec_buffer *buf), int reg, FLOATVAL value)
+{
+    ASSERT_ARGS(emit_num_const)
+    union {
+        FLOATVAL    n;
+        UHUGEINTVAL bits;
+    } imm;
+    char op[5];
+
+    /* mov rax, imm64; movq reg, rax */
+    imm.n = value;
+    emit_bytes(buf, "\x48\xb8", 2);
+    emit_int64(buf, imm.bits);
+
+    op[0] = '\x66';
+    op[1] = '\x48';
+    op[2] = '\x0f';
+    op[3] = '\x6e';
+    op[4] = (char)(0xc0 | (reg << 3));
+    emit_bytes(buf, op, 5);
+}
+
+
+/*
+
+=item C<static void emit_branch(Exec_buffer *buf, int cc, size_t target,
+size_t from)>
+
+Emits a jump on condition C<cc> from the op at offset C<from> to the op at
+C<target>.  A backward jump goes through a check for events, so loops made
+only of templates still handle them.
+
+=cut
+
+*/
+
+static void
+emit_branch(ARGMOD(Exec_buffer *buf), int cc, size_t target, size_t from)
+{
+    ASSERT_ARGS(emit_branch)
+    Exec_fixup *fixup;
+
+    emit_jump(buf, cc, 0);
+
+    if (buf->n_fixups == buf->alloc_fixups) {
+        buf->alloc_fixups = buf->alloc_fixups ? buf->alloc_fixups * 2 : 64;
+        buf->fixups       = (Exec_fixup *)mem_sys_realloc(buf->fixups,
+                                buf->alloc_fixups * sizeof (Exec_fixup));
+    }
+
+    fixup               = &buf->fixups[buf->n_fixups++];
+    fixup->at           = buf->size - 4;
+    fixup->op           = target;
+    fixup->check_events = target <= from;
+}
+
+
+/*
+
+=item C<static void emit_jump(Exec_buffer *buf, int cc, size_t to)>
+
+Emits a jump on condition C<cc>, or C<EXEC_JMP> for always, to the code
+offset C<to>.
+
+=cut
+
+*/
+
+static void
+emit_jump(ARGMOD(Exec_buffer *buf), int cc, size_t to)
+{
+    ASSERT_ARGS(emit_jump)
+    char op[2];
+
+    if (cc == EXEC_JMP) {
+        emit_bytes(buf, "\xe9", 1);
+    }
+    else {
+        op[0] = '\x0f';
+        op[1] = (char)(0x80 | cc);
+        emit_bytes(buf, op, 2);
+    }
+
+    emit_int32(buf, (INTVAL)to - (INTVAL)(buf->size + 4));
+}
+
+
+/*
+
+=item C<static void emit_bytes(Exec_buffer *buf, const char *bytes, size_t n)>
+
+=item C<static void emit_int32(Exec_buffer *buf, INTVAL value)>
+
+=item C<static void emit_int64(Exec_buffer *buf, UHUGEINTVAL value)>
+
+Append machine code to C<buf>, the numbers little-endian.
+
+=cut
+
+*/
+
+static void
+emit_bytes(ARGMOD(Exec_buffer *buf), ARGIN(const char *bytes), size_t n)
+{
+    ASSERT_ARGS(emit_bytes)
+
+    if (buf->size + n > buf->alloc) {
+        buf->alloc = buf->alloc ? buf->alloc * 2 : 4096;
+        buf->code  = (unsigned char *)mem_sys_realloc(buf->code, buf->alloc);
+    }
+
+    memcpy(buf->code + buf->size, bytes, n);
+    buf->size += n;
+}
+
+static void
+emit_int32(ARGMOD(Exec_buffer *buf), INTVAL value)
+{
+    ASSERT_ARGS(emit_int32)
+    char bytes[4];
+    int  k;
+
+    for (k = 0; k < 4; ++k)
+        bytes[k] = (char)((value >> (8 * k)) & 0xff);
+
+    emit_bytes(buf, bytes, 4);
+}
+
+static void
+emit_int64(ARGMOD(Exec_buffer *buf), UHUGEINTVAL value)
+{
+    ASSERT_ARGS(emit_int64)
+    char bytes[8];
+    int  k;
+
+    for (k = 0; k < 8; ++k)
+        bytes[k] = (char)((value >> (8 * k)) & 0xff);
+
+    emit_bytes(buf, bytes, 8);
+}
+
+
+/*
+
+=back
+
+=head1 SEE ALSO
+
+F<src/runcore/cores.c>, F<src/runcore/main.c>
+
+=cut
+
+*/
+
+/*
+ * Local variables:
+ *   c-file-style: "parrot"
+ * End:
+ * vim: expandtab shiftwidth=4:
+ */
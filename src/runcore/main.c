@@ -20,6 +20,10 @@ passed, the runops loop will re-execute the same location, which will
 then have the pointer to the real C<prederef> opfunc and C<prederef>
 args.
 
+As the operands are known at that point, C<do_prederef()> also I<quickens>
+arithmetic on PMCs: if both operands are Integer or Float PMCs, the slot gets
+a variant of the op with a fast path for them instead (see C<quicken_op()>).
+
 Pointer arithmetic is used to determine the index into the bytecode
 corresponding to the currect opcode. The bytecode and prederef arrays
 have the same number of elements because there is a one-to-one mapping.
@@ -67,12 +71,6 @@ static oplib_init_f get_dynamic_op_lib_init(SHIM_INTERP,
     ARGIN(const PMC *lib))
         __attribute__nonnull__(2);
 
-static void notify_func_table(PARROT_INTERP,
-    ARGIN(op_func_t *table),
-    int on)
-        __attribute__nonnull__(1)
-        __attribute__nonnull__(2);
-
 static void prederef_args(
     ARGMOD(void **pc_prederef),
     PARROT_INTERP,
@@ -84,10 +82,15 @@ static void prederef_args(
         __attribute__nonnull__(4)
         FUNC_MODIFIES(*pc_prederef);
 
-static void stop_prederef(PARROT_INTERP)
-        __attribute__nonnull__(1);
+PARROT_WARN_UNUSED_RESULT
+static opcode_t quicken_op(PARROT_INTERP,
+    ARGIN(const opcode_t *pc),
+    ARGIN(const op_info_t *opinfo))
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2)
+        __attribute__nonnull__(3);
 
-static void turn_ev_check(PARROT_INTERP, int on)
+static void stop_prederef(PARROT_INTERP)
         __attribute__nonnull__(1);
 
 #define ASSERT_ARGS_dynop_register_switch __attribute__unused__ int _ASSERT_ARGS_CHECK = (0)
@@ -95,21 +98,36 @@ static void turn_ev_check(PARROT_INTERP, int on)
        PARROT_ASSERT_ARG(interp))
 #define ASSERT_ARGS_get_dynamic_op_lib_init __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
        PARROT_ASSERT_ARG(lib))
-#define ASSERT_ARGS_notify_func_table __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
-       PARROT_ASSERT_ARG(interp) \
-    , PARROT_ASSERT_ARG(table))
 #define ASSERT_ARGS_prederef_args __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
        PARROT_ASSERT_ARG(pc_prederef) \
     , PARROT_ASSERT_ARG(interp) \
     , PARROT_ASSERT_ARG(pc) \
     , PARROT_ASSERT_ARG(opinfo))
+#define ASSERT_ARGS_quicken_op __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp) \
+    , PARROT_ASSERT_ARG(pc) \
+    , PARROT_ASSERT_ARG(opinfo))
 #define ASSERT_ARGS_stop_prederef __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
        PARROT_ASSERT_ARG(interp))
-#define ASSERT_ARGS_turn_ev_check __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
-       PARROT_ASSERT_ARG(interp))
 /* Don't modify between HEADERIZER BEGIN / HEADERIZER END.  Your changes will be lost. */
 /* HEADERIZER END: static */
 
+/* PMC arithmetic ops, and their variants for two Integer or two Float
+ * operands, which the prederefed cores run instead if the operands have
+ * those types the first time the op runs.  See math.ops. */
+static const struct quick_op_t {
+    opcode_t generic;
+    opcode_t integer;
+    opcode_t floatval;
+} quick_ops[] = {
+    { PARROT_OP_add_p_p,   PARROT_OP_quick_add_Integer_p_p,   PARROT_OP_quick_add_Float_p_p   },
+    { PARROT_OP_add_p_p_p, PARROT_OP_quick_add_Integer_p_p_p, PARROT_OP_quick_add_Float_p_p_p },
+    { PARROT_OP_sub_p_p,   PARROT_OP_quick_sub_Integer_p_p,   PARROT_OP_quick_sub_Float_p_p   },
+    { PARROT_OP_sub_p_p_p, PARROT_OP_quick_sub_Integer_p_p_p, PARROT_OP_quick_sub_Float_p_p_p },
+    { PARROT_OP_mul_p_p,   PARROT_OP_quick_mul_Integer_p_p,   PARROT_OP_quick_mul_Float_p_p   },
+    { PARROT_OP_mul_p_p_p, PARROT_OP_quick_mul_Integer_p_p_p, PARROT_OP_quick_mul_Float_p_p_p }
+};
+
 /*
 
 =item C<void Parrot_runcore_init(PARROT_INTERP)>
@@ -315,7 +333,7 @@ prederef_args(ARGMOD(void **pc_prederef), PARROT_INTERP,
                 Parrot_ex_throw_from_c_args(interp, NULL, EXCEPTION_INTERP_ERROR,
                     "Illegal constant number");
 
-            pc_prederef[i] = (void *)const_table->constants[arg]->u.key;
+            pc_prederef[i] = (void *)PF_CONST_PMC(interp, const_table->constants[arg]);
             break;
         default:
             Parrot_ex_throw_from_c_args(interp, NULL, EXCEPTION_ARG_OP_NOT_HANDLED,
@@ -326,6 +344,53 @@ prederef_args(ARGMOD(void **pc_prederef), PARROT_INTERP,
 }
 
 
+/*
+
+=item C<static opcode_t quicken_op(PARROT_INTERP, const opcode_t *pc, const
+op_info_t *opinfo)>
+
+Called from C<do_prederef()> to choose the op to run for the one at C<pc>.
+If it's an arithmetic op on PMCs and both operands are plain Integer or plain
+Float PMCs right now, returns its variant for those, else the op itself.
+
+The variants check the types of the operands every time and fall back to the
+generic code, so a guess that turns out wrong later is only slower.
+
+=cut
+
+*/
+
+PARROT_WARN_UNUSED_RESULT
+static opcode_t
+quicken_op(PARROT_INTERP, ARGIN(const opcode_t *pc), ARGIN(const op_info_t *opinfo))
+{
+    ASSERT_ARGS(quicken_op)
+    const int n = opinfo->op_count;
+    size_t    i;
+
+    for (i = 0; i < sizeof (quick_ops) / sizeof (quick_ops[0]); i++) {
+        if (quick_ops[i].generic == *pc) {
+            /* the operands are the last two arguments */
+            PMC * const a = REG_PMC(interp, pc[n - 2]);
+            PMC * const b = REG_PMC(interp, pc[n - 1]);
+
+            if (PMC_IS_NULL(a) || PMC_IS_NULL(b) || a->vtable != b->vtable)
+                break;
+
+            if (a->vtable == interp->vtables[enum_class_Integer])
+                return quick_ops[i].integer;
+
+            if (a->vtable == interp->vtables[enum_class_Float])
+                return quick_ops[i].floatval;
+
+            break;
+        }
+    }
+
+    return *pc;
+}
+
+
 /*
 
 =item C<void do_prederef(void **pc_prederef, PARROT_INTERP, Parrot_runcore_t
@@ -347,7 +412,6 @@ do_prederef(ARGIN(void **pc_prederef), PARROT_INTERP, ARGIN(Parrot_runcore_t *ru
     const size_t     offset = pc_prederef - interp->code->prederef.code;
     opcode_t * const pc     = ((opcode_t *)interp->code->base.data) + offset;
     const op_info_t *opinfo;
-    size_t           n;
 
     if (*pc < 0 || *pc >= (opcode_t)interp->op_count)
         Parrot_ex_throw_from_c_args(interp, NULL, EXCEPTION_INTERP_ERROR,
@@ -358,82 +422,15 @@ do_prederef(ARGIN(void **pc_prederef), PARROT_INTERP, ARGIN(Parrot_runcore_t *ru
     prederef_args(pc_prederef, interp, pc, opinfo);
 
     if (PARROT_RUNCORE_PREDEREF_OPS_TEST(runcore)) {
+        const opcode_t op = quicken_op(interp, pc, opinfo);
+
         *pc_prederef = PARROT_RUNCORE_CGOTO_OPS_TEST(runcore)
-            ? ((void **)interp->op_lib->op_func_table)[*pc]
-            : (void**)*pc;
+            ? ((void **)interp->op_lib->op_func_table)[op]
+            : (void**)op;
     }
     else
         Parrot_ex_throw_from_c_args(interp, NULL, 1,
             "Tried to prederef wrong core");
-
-    /* now remember backward branches, invoke and similar opcodes */
-    n = opinfo->op_count;
-
-    if (((opinfo->jump & PARROT_JUMP_RELATIVE)
-    &&    opinfo->types[n - 2] == PARROT_ARG_IC
-    &&    pc[n - 1] < 0)                          /* relative backward branch */
-    ||   (opinfo->jump & PARROT_JUMP_ADDRESS)) {
-        Prederef * const pi = &interp->code->prederef;
-
-        /* first time prederef.branches == NULL:
-         * estimate size to 1/16th of opcodes */
-        if (!pi->branches) {
-            size_t nb = interp->code->base.size / 16;
-            if (nb < 8)
-                nb = (size_t)8;
-
-            pi->branches    = mem_allocate_n_typed(nb, Prederef_branch);
-            pi->n_allocated = nb;
-            pi->n_branches  = 0;
-        }
-        else if (pi->n_branches >= pi->n_allocated) {
-            pi->n_allocated = (size_t) (pi->n_allocated * 1.5);
-            mem_realloc_n_typed(pi->branches, pi->n_allocated, Prederef_branch);
-        }
-
-        pi->branches[pi->n_branches].offs = offset;
-        pi->branches[pi->n_branches].op   = *pc_prederef;
-
-        ++pi->n_branches;
-    }
-}
-
-
-/*
-
-=item C<static void turn_ev_check(PARROT_INTERP, int on)>
-
-Turn on or off event checking for prederefed cores.
-
-Fills in the C<event_checker> opcode, or restores original ops in all
-branch locations of the opcode stream.
-
-Note that when C<on> is true, this is being called from the event
-handler thread.
-
-=cut
-
-*/
-
-static void
-turn_ev_check(PARROT_INTERP, int on)
-{
-    ASSERT_ARGS(turn_ev_check)
-    const Prederef * const pi = &interp->code->prederef;
-    size_t i;
-
-    if (!pi->branches)
-        return;
-
-    for (i = 0; i < pi->n_branches; ++i) {
-        const size_t offs = pi->branches[i].offs;
-        if (on)
-            interp->code->prederef.code[offs] =
-                ((void **)interp->op_lib->op_func_table)
-                            [CORE_OPS_check_events__];
-        else
-            interp->code->prederef.code[offs] = pi->branches[i].op;
-    }
 }
 
 
@@ -466,8 +463,8 @@ get_dynamic_op_lib_init(SHIM_INTERP, ARGIN(const PMC *lib))
 =item C<static void stop_prederef(PARROT_INTERP)>
 
 Restore the interpreter's op function tables to their initial state.
-Also recreate the event function pointers. This is only necessary
-for run-core changes, but we don't know the old run core.
+This is only necessary for run-core changes, but we don't know the old
+run core.
 
 =cut
 
@@ -478,13 +475,6 @@ stop_prederef(PARROT_INTERP)
 {
     ASSERT_ARGS(stop_prederef)
     interp->op_func_table = PARROT_CORE_OPLIB_INIT(1)->op_func_table;
-
-    if (interp->evc_func_table) {
-        mem_sys_free(interp->evc_func_table);
-        interp->evc_func_table = NULL;
-    }
-
-    Parrot_setup_event_func_ptrs(interp);
 }
 
 
@@ -527,10 +517,6 @@ runops_int(PARROT_INTERP, size_t offset)
 {
     ASSERT_ARGS(runops_int)
 
-    /* setup event function ptrs */
-    if (!interp->save_func_table)
-        Parrot_setup_event_func_ptrs(interp);
-
     interp->resume_offset = offset;
     interp->resume_flag  |= RESUME_RESTART;
 
@@ -557,46 +543,6 @@ runops_int(PARROT_INTERP, size_t offset)
 }
 
 
-/*
-
-=item C<void Parrot_setup_event_func_ptrs(PARROT_INTERP)>
-
-Setup a C<func_table> containing pointers (or addresses) of the
-C<check_event__> opcode.
-
-TODO: Free it at destroy. Handle run-core changes.
-
-=cut
-
-*/
-
-void
-Parrot_setup_event_func_ptrs(PARROT_INTERP)
-{
-    ASSERT_ARGS(Parrot_setup_event_func_ptrs)
-    const size_t       n         = interp->op_count;
-    const oplib_init_f init_func = get_core_op_lib_init(interp, interp->run_core);
-    op_lib_t * const   lib       = init_func(1);
-
-    /* remember op_func_table */
-    interp->save_func_table      = lib->op_func_table;
-
-    if (!lib->op_func_table)
-        return;
-
-    /* function or CG core - prepare func_table */
-    if (!interp->evc_func_table) {
-        size_t i;
-
-        interp->evc_func_table = mem_allocate_n_typed(n, op_func_t);
-
-        for (i = 0; i < n; ++i)
-            interp->evc_func_table[i] = (op_func_t)
-                D2FPTR(((void**)lib->op_func_table)[CORE_OPS_check_events__]);
-    }
-}
-
-
 /*
 
 =item C<void Parrot_runcore_destroy(PARROT_INTERP)>
@@ -677,7 +623,7 @@ dynop_register(PARROT_INTERP, ARGIN(PMC *lib_pmc))
     ASSERT_ARGS(dynop_register)
     op_lib_t *lib, *core;
     oplib_init_f init_func;
-    op_func_t *new_func_table, *new_evc_func_table;
+    op_func_t *new_func_table;
     op_info_t *new_info_table;
     size_t i, n_old, n_new, n_tot;
 
@@ -715,9 +661,6 @@ dynop_register(PARROT_INTERP, ARGIN(PMC *lib_pmc))
         return;
     }
 
-    /* when called from yyparse, we have to set up the evc_func_table */
-    Parrot_setup_event_func_ptrs(interp);
-
     n_old = interp->op_count;
     n_new = lib->op_count;
     n_tot = n_old + n_new;
@@ -725,8 +668,6 @@ dynop_register(PARROT_INTERP, ARGIN(PMC *lib_pmc))
 
     PARROT_ASSERT(interp->op_count == core->op_count);
 
-    new_evc_func_table = (op_func_t *)mem_sys_realloc(interp->evc_func_table,
-            sizeof (op_func_t) * n_tot);
     if (core->flags & OP_FUNC_IS_ALLOCATED) {
         new_func_table = (op_func_t *)mem_sys_realloc(core->op_func_table,
                 sizeof (op_func_t) * n_tot);
@@ -749,18 +690,8 @@ dynop_register(PARROT_INTERP, ARGIN(PMC *lib_pmc))
     for (i = n_old; i < n_tot; ++i) {
         new_func_table[i] = ((op_func_t*)lib->op_func_table)[i - n_old];
         new_info_table[i] = lib->op_info_table[i - n_old];
-
-        /*
-         * fill new ops of event checker func table
-         * if we are running a different core, entries are
-         * changed below
-         */
-        new_evc_func_table[i] = new_func_table[CORE_OPS_check_events__];
     }
 
-    interp->evc_func_table  = new_evc_func_table;
-    interp->save_func_table = new_func_table;
-
     /* deinit core, so that it gets rehashed */
     (void) PARROT_CORE_OPLIB_INIT(0);
 
@@ -876,16 +807,6 @@ dynop_register_xx(PARROT_INTERP,
             ops_addr[i] = ops_addr[CORE_OPS_wrapper__];
     }
 
-    /* if we are running this core, update event check ops */
-    if (interp->run_core->id == cg_lib->core_type) {
-        size_t i;
-
-        for (i = n_old; i < n_tot; ++i)
-            interp->evc_func_table[i] =
-                (op_func_t)ops_addr[CORE_OPS_check_events__];
-        interp->save_func_table = ops_addr;
-    }
-
     /* tell the cg_core about the new jump table */
     cg_lib->op_func_table = ops_addr;
     cg_lib->op_count      = n_tot;
@@ -914,41 +835,11 @@ dynop_register_switch(size_t n_old, size_t n_new)
 }
 
 
-/*
-
-=item C<static void notify_func_table(PARROT_INTERP, op_func_t *table, int on)>
-
-Tell the interpreter's running core about the new function table.
-
-=cut
-
-*/
-
-static void
-notify_func_table(PARROT_INTERP, ARGIN(op_func_t *table), int on)
-{
-    ASSERT_ARGS(notify_func_table)
-    const oplib_init_f init_func = get_core_op_lib_init(interp, interp->run_core);
-
-    init_func((long) table);
-
-    if (PARROT_RUNCORE_FUNC_TABLE_TEST(interp->run_core)) {
-        PARROT_ASSERT(table);
-        interp->op_func_table = table;
-    }
-
-    if (PARROT_RUNCORE_EVENT_CHECK_TEST(interp->run_core))
-        turn_ev_check(interp, on);
-}
-
-
 /*
 
 =item C<void disable_event_checking(PARROT_INTERP)>
 
-Restore old function table.
-
-XXX This is only implemented for the function core at present.
+Withdraw the request made by C<enable_event_checking()>.
 
 =cut
 
@@ -959,9 +850,7 @@ void
 disable_event_checking(PARROT_INTERP)
 {
     ASSERT_ARGS(disable_event_checking)
-    /* restore func table */
-    PARROT_ASSERT(interp->save_func_table);
-    notify_func_table(interp, interp->save_func_table, 0);
+    interp->safepoint_requested = 0;
 }
 
 
@@ -969,13 +858,16 @@ disable_event_checking(PARROT_INTERP)
 
 =item C<void enable_event_checking(PARROT_INTERP)>
 
-Replace func table with one that does event checking for all opcodes.
+Request that the interpreter handle its pending tasks at the next safepoint:
+the ops check C<< interp->safepoint_requested >> at backward branches and at
+jumps to an address, like sub calls and returns, and call
+C<Parrot_cx_safepoint()> when it's set (see C<PARROT_SAFEPOINT> in
+F<include/parrot/scheduler.h>).  Code that runs straight through without
+branching back or calling a sub never needs to check.
 
 NOTE: C<enable_event_checking()> is called async by the event handler
 thread. All action done from here has to be async safe.
 
-XXX This is only implemented for the function core at present.
-
 =cut
 
 */
@@ -985,8 +877,7 @@ void
 enable_event_checking(PARROT_INTERP)
 {
     ASSERT_ARGS(enable_event_checking)
-    /* put table in place */
-    notify_func_table(interp, interp->evc_func_table, 1);
+    interp->safepoint_requested = 1;
 }
 
 
@@ -324,7 +324,7 @@ ARGIN(opcode_t *pc))
         fprintf(runcore->profile_fd,
             "OP:{x{line:%d}x}{x{time:%li}x}{x{op:%s}x}\n",
             (int)preop_line, (unsigned long)op_time,
-            (interp->op_info_table)[*preop_pc].name);
+            (interp->op_info_table)[*preop_pc].full_name);
     }
 
     /* make it easy to tell separate runloops apart */
@@ -297,7 +297,7 @@ trace_op_dump(PARROT_INTERP,
             *pc == PARROT_OP_get_results_pc ||
             *pc == PARROT_OP_get_params_pc ||
             *pc == PARROT_OP_set_returns_pc) {
-        sig = interp->code->const_table->constants[pc[1]]->u.key;
+        sig = PF_CONST_PMC(interp, interp->code->const_table->constants[pc[1]]);
 
         if (!sig)
             Parrot_ex_throw_from_c_args(interp, NULL, 1,
@@ -424,7 +424,7 @@ trace_op_dump(PARROT_INTERP,
                     break;
                 case PARROT_ARG_PC:
                     Parrot_io_eprintf(debugger, "PC%vd=", o);
-                    trace_pmc_dump(interp, PCONST(o)->u.key);
+                    trace_pmc_dump(interp, PF_CONST_PMC(interp, PCONST(o)));
                     break;
                 case PARROT_ARG_P:
                     Parrot_io_eprintf(debugger, "P%vd=", o);
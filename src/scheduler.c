@@ -32,6 +32,10 @@ exceptions, async I/O, and concurrent tasks (threads).
 /* HEADERIZER BEGIN: static */
 /* Don't modify between HEADERIZER BEGIN / HEADERIZER END.  Your changes will be lost. */
 
+PARROT_CAN_RETURN_NULL
+static void * scheduler_alarm_runloop(ARGIN(void *data))
+        __attribute__nonnull__(1);
+
 static void scheduler_process_messages(PARROT_INTERP,
     ARGMOD(PMC *scheduler))
         __attribute__nonnull__(1)
@@ -44,12 +48,22 @@ static void scheduler_process_wait_list(PARROT_INTERP,
         __attribute__nonnull__(2)
         FUNC_MODIFIES(*scheduler);
 
+static void scheduler_set_alarm(
+    ARGMOD(PMC *scheduler),
+    FLOATVAL alarm_time)
+        __attribute__nonnull__(1)
+        FUNC_MODIFIES(*scheduler);
+
+#define ASSERT_ARGS_scheduler_alarm_runloop __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(data))
 #define ASSERT_ARGS_scheduler_process_messages __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
        PARROT_ASSERT_ARG(interp) \
     , PARROT_ASSERT_ARG(scheduler))
 #define ASSERT_ARGS_scheduler_process_wait_list __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
        PARROT_ASSERT_ARG(interp) \
     , PARROT_ASSERT_ARG(scheduler))
+#define ASSERT_ARGS_scheduler_set_alarm __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(scheduler))
 /* Don't modify between HEADERIZER BEGIN / HEADERIZER END.  Your changes will be lost. */
 /* HEADERIZER END: static */
 
@@ -222,6 +236,58 @@ Parrot_cx_runloop_end(PARROT_INTERP)
     ASSERT_ARGS(Parrot_cx_runloop_end)
     SCHEDULER_terminate_requested_SET(interp->scheduler);
     Parrot_cx_handle_tasks(interp, interp->scheduler);
+    Parrot_cx_stop_alarm(interp, interp->scheduler);
+}
+
+/*
+
+=item C<void Parrot_cx_safepoint(PARROT_INTERP)>
+
+Handle the pending tasks at a safepoint.  The ops call this through
+C<PARROT_SAFEPOINT> at backward branches and sub calls, once
+C<enable_event_checking()> has requested it.
+
+=cut
+
+*/
+
+PARROT_EXPORT
+void
+Parrot_cx_safepoint(PARROT_INTERP)
+{
+    ASSERT_ARGS(Parrot_cx_safepoint)
+    disable_event_checking(interp);
+    Parrot_cx_handle_tasks(interp, interp->scheduler);
+}
+
+/*
+
+=item C<void Parrot_cx_stop_alarm(PARROT_INTERP, PMC *scheduler)>
+
+Stop the scheduler's alarm thread, if it runs, and wait for it to finish.
+Timers don't request safepoints any more after this.
+
+=cut
+
+*/
+
+void
+Parrot_cx_stop_alarm(SHIM_INTERP, ARGMOD(PMC *scheduler))
+{
+    ASSERT_ARGS(Parrot_cx_stop_alarm)
+    Parrot_Scheduler_attributes * const sched_struct = PARROT_SCHEDULER(scheduler);
+    int running;
+
+    LOCK(sched_struct->alarm_lock);
+    running                   = sched_struct->alarm_state == SCHEDULER_ALARM_RUNNING;
+    sched_struct->alarm_state = SCHEDULER_ALARM_STOPPED;
+    COND_SIGNAL(sched_struct->alarm_cond);
+    UNLOCK(sched_struct->alarm_lock);
+
+    if (running) {
+        void *retval;
+        JOIN(sched_struct->alarm_thread, retval);
+    }
 }
 
 /*
@@ -1054,7 +1120,8 @@ Functions that are only used within the scheduler.
 =item C<static void scheduler_process_wait_list(PARROT_INTERP, PMC *scheduler)>
 
 Scheduler maintenance, scan the list of waiting tasks to see if any are ready
-to become active tasks.
+to become active tasks.  Drops the tasks which left the list, and sets the
+alarm for the earliest of the timers still waiting.
 
 =cut
 
@@ -1065,32 +1132,122 @@ scheduler_process_wait_list(PARROT_INTERP, ARGMOD(PMC *scheduler))
 {
     ASSERT_ARGS(scheduler_process_wait_list)
     Parrot_Scheduler_attributes * sched_struct = PARROT_SCHEDULER(scheduler);
-    INTVAL num_tasks, index;
-
-    /* Sweep the wait list for completed timers */
-    num_tasks = VTABLE_elements(interp, sched_struct->wait_index);
-    for (index = 0; index < num_tasks; index++) {
-        INTVAL tid = VTABLE_get_integer_keyed_int(interp, sched_struct->wait_index, index);
+    PMC * const wait_index = sched_struct->wait_index;
+    const FLOATVAL now     = Parrot_floatval_time();
+    FLOATVAL alarm_time    = 0.0;
+    INTVAL num_tasks, index, kept;
+
+    /* Sweep the wait list for completed timers, moving the rest to the
+     * front.  Repeating timers add their next round to the end while we go,
+     * which is kept as well. */
+    num_tasks = VTABLE_elements(interp, wait_index);
+    kept      = 0;
+    for (index = 0; index < VTABLE_elements(interp, wait_index); index++) {
+        INTVAL tid = VTABLE_get_integer_keyed_int(interp, wait_index, index);
         if (tid > 0) {
             PMC *task = VTABLE_get_pmc_keyed_int(interp, sched_struct->task_list, tid);
-            if (PMC_IS_NULL(task)) {
-                /* Cleanup expired tasks. */
-                VTABLE_set_integer_keyed_int(interp, sched_struct->wait_index, index, 0);
-            }
-            else {
+            if (!PMC_IS_NULL(task)) {
                 /* Move the timer to the active task list if the timer has
                  * completed. */
                 FLOATVAL timer_end_time = VTABLE_get_number_keyed_int(interp,
                         task, PARROT_TIMER_NSEC);
-                if (timer_end_time <= Parrot_floatval_time()) {
+                if (index < num_tasks && timer_end_time <= now) {
                     VTABLE_push_integer(interp, sched_struct->task_index, tid);
-                    VTABLE_set_integer_keyed_int(interp, sched_struct->wait_index, index, 0);
                     Parrot_cx_schedule_repeat(interp, task);
                     SCHEDULER_cache_valid_CLEAR(scheduler);
                 }
+                else {
+                    if (alarm_time == 0.0 || timer_end_time < alarm_time)
+                        alarm_time = timer_end_time;
+                    VTABLE_set_integer_keyed_int(interp, wait_index, kept++, tid);
+                }
             }
         }
     }
+
+    /* Cleanup expired tasks. */
+    VTABLE_set_integer_native(interp, wait_index, kept);
+
+    if (alarm_time > 0.0)
+        scheduler_set_alarm(scheduler, alarm_time);
+}
+
+/*
+
+=item C<static void scheduler_set_alarm(PMC *scheduler, FLOATVAL alarm_time)>
+
+Have the scheduler's alarm thread request a safepoint at C<alarm_time>, unless
+it will already do so earlier.  Starts the alarm thread the first time.
+
+=cut
+
+*/
+
+static void
+scheduler_set_alarm(ARGMOD(PMC *scheduler), FLOATVAL alarm_time)
+{
+    ASSERT_ARGS(scheduler_set_alarm)
+    Parrot_Scheduler_attributes * const sched_struct = PARROT_SCHEDULER(scheduler);
+
+    LOCK(sched_struct->alarm_lock);
+
+    if (sched_struct->alarm_state == SCHEDULER_ALARM_NOT_STARTED) {
+        sched_struct->alarm_state = SCHEDULER_ALARM_RUNNING;
+        THREAD_CREATE_JOINABLE(sched_struct->alarm_thread,
+                scheduler_alarm_runloop, scheduler);
+    }
+
+    if (sched_struct->alarm_time == 0.0 || alarm_time < sched_struct->alarm_time) {
+        sched_struct->alarm_time = alarm_time;
+        COND_SIGNAL(sched_struct->alarm_cond);
+    }
+
+    UNLOCK(sched_struct->alarm_lock);
+}
+
+/*
+
+=item C<static void * scheduler_alarm_runloop(void *data)>
+
+The alarm thread of the scheduler C<data>.  It sleeps until the alarm time
+and then requests a safepoint from the scheduler's interpreter with
+C<enable_event_checking()>, so the interpreter doesn't have to poll the
+clock while it runs.
+
+=cut
+
+*/
+
+PARROT_CAN_RETURN_NULL
+static void *
+scheduler_alarm_runloop(ARGIN(void *data))
+{
+    ASSERT_ARGS(scheduler_alarm_runloop)
+    PMC * const scheduler = (PMC *)data;
+    Parrot_Scheduler_attributes * const sched_struct = PARROT_SCHEDULER(scheduler);
+
+    LOCK(sched_struct->alarm_lock);
+
+    while (sched_struct->alarm_state == SCHEDULER_ALARM_RUNNING) {
+        const FLOATVAL alarm_time = sched_struct->alarm_time;
+
+        if (alarm_time == 0.0)
+            COND_WAIT(sched_struct->alarm_cond, sched_struct->alarm_lock);
+        else if (alarm_time <= Parrot_floatval_time()) {
+            sched_struct->alarm_time = 0.0;
+            enable_event_checking(sched_struct->interp);
+        }
+        else {
+            struct timespec time_struct;
+            time_struct.tv_sec  = (time_t)alarm_time;
+            time_struct.tv_nsec = (long)((alarm_time - time_struct.tv_sec) * 1.0e9);
+            COND_TIMED_WAIT(sched_struct->alarm_cond, sched_struct->alarm_lock,
+                    &time_struct);
+        }
+    }
+
+    UNLOCK(sched_struct->alarm_lock);
+    return NULL;
 }
 
 /*
@@ -27,6 +27,7 @@ members, beside setting C<bufstart>/C<buflen> for external strings.
 #include "parrot/compiler.h"
 #include "parrot/string_funcs.h"
 #include "private_cstring.h"
+#include "encoding/utf8.h"
 #include "api.str"
 
 #define nonnull_encoding_name(s) (s) ? (s)->encoding->name : "null string"
@@ -35,11 +36,48 @@ members, beside setting C<bufstart>/C<buflen> for external strings.
     PARROT_ASSERT((s)->charset); \
     PARROT_ASSERT(!PObj_on_free_list_TEST(s))
 
+/* Copies the header of STRING s to d, which stays in its own GC generation */
+#define COPY_STRING_HEADER(d, s) do { \
+    const UINTVAL gc_flags = PObj_get_FLAGS(d) & (PObj_GC_old_FLAG | PObj_live_FLAG); \
+    STRUCT_COPY((d), (s)); \
+    PObj_get_FLAGS(d) = (PObj_get_FLAGS(d) & ~(PObj_GC_old_FLAG | PObj_live_FLAG)) \
+                      | gc_flags; \
+} while (0)
+
+/* SipHash-1-3 over 64-bit words, for Parrot_str_to_hashval */
+#define SIP_ROTL(x, b) (UHUGEINTVAL)(((x) << (b)) | ((x) >> (64 - (b))))
+#define SIP_ROUND(v) do { \
+    (v)[0] += (v)[1]; (v)[1] = SIP_ROTL((v)[1], 13); (v)[1] ^= (v)[0]; \
+    (v)[0]  = SIP_ROTL((v)[0], 32); \
+    (v)[2] += (v)[3]; (v)[3] = SIP_ROTL((v)[3], 16); (v)[3] ^= (v)[2]; \
+    (v)[0] += (v)[3]; (v)[3] = SIP_ROTL((v)[3], 21); (v)[3] ^= (v)[0]; \
+    (v)[2] += (v)[1]; (v)[1] = SIP_ROTL((v)[1], 17); (v)[1] ^= (v)[2]; \
+    (v)[2]  = SIP_ROTL((v)[2], 32); \
+} while (0)
+#define SIP_ABSORB(v, m) do { \
+    (v)[3] ^= (m); \
+    SIP_ROUND(v); \
+    (v)[0] ^= (m); \
+} while (0)
+#define SIP_CONST(hi, lo) (((UHUGEINTVAL)(hi) << 32) | (UHUGEINTVAL)(lo))
+
 /* HEADERIZER HFILE: include/parrot/string_funcs.h */
 
 /* HEADERIZER BEGIN: static */
 /* Don't modify between HEADERIZER BEGIN / HEADERIZER END.  Your changes will be lost. */
 
+PARROT_WARN_UNUSED_RESULT
+static size_t hash_finish(ARGMOD(UHUGEINTVAL *v),
+    UHUGEINTVAL tail,
+    UINTVAL n_bytes)
+        __attribute__nonnull__(1)
+        FUNC_MODIFIES(*v);
+
+static void hash_init(PARROT_INTERP, ARGOUT(UHUGEINTVAL *v), UINTVAL length)
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2)
+        FUNC_MODIFIES(*v);
+
 static void make_writable(PARROT_INTERP,
     ARGMOD(STRING **s),
     const size_t len,
@@ -60,6 +98,11 @@ static const CHARSET * string_rep_compatible(SHIM_INTERP,
         __attribute__nonnull__(4)
         FUNC_MODIFIES(*e);
 
+#define ASSERT_ARGS_hash_finish __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(v))
+#define ASSERT_ARGS_hash_init __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp) \
+    , PARROT_ASSERT_ARG(v))
 #define ASSERT_ARGS_make_writable __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
        PARROT_ASSERT_ARG(interp) \
     , PARROT_ASSERT_ARG(s))
@@ -145,9 +188,9 @@ Parrot_str_new_COW(PARROT_INTERP, ARGMOD(STRING *s))
 
     if (PObj_constant_TEST(s)) {
         d = Parrot_gc_new_string_header(interp,
-            PObj_get_FLAGS(s) & ~PObj_constant_FLAG);
+            PObj_get_FLAGS(s) & ~(PObj_constant_FLAG | PObj_GC_old_FLAG));
         PObj_COW_SET(s);
-        STRUCT_COPY(d, s);
+        COPY_STRING_HEADER(d, s);
         /* we can't move the memory, because constants aren't
          * scanned in compact_pool, therefore the other end
          * would point to garbage.
@@ -156,9 +199,10 @@ Parrot_str_new_COW(PARROT_INTERP, ARGMOD(STRING *s))
         PObj_external_SET(d);
     }
     else {
-        d = Parrot_gc_new_string_header(interp, PObj_get_FLAGS(s));
+        d = Parrot_gc_new_string_header(interp,
+            PObj_get_FLAGS(s) & ~PObj_GC_old_FLAG);
         PObj_COW_SET(s);
-        STRUCT_COPY(d, s);
+        COPY_STRING_HEADER(d, s);
         PObj_sysmem_CLEAR(d);
 #if 0
         /* XXX FIXME hack to avoid cross-interpreter issue until it
@@ -197,13 +241,13 @@ Parrot_str_reuse_COW(SHIM_INTERP, ARGMOD(STRING *s), ARGOUT(STRING *d))
 
     if (PObj_constant_TEST(s)) {
         PObj_COW_SET(s);
-        STRUCT_COPY(d, s);
+        COPY_STRING_HEADER(d, s);
         PObj_constant_CLEAR(d);
         PObj_external_SET(d);
     }
     else {
         PObj_COW_SET(s);
-        STRUCT_COPY(d, s);
+        COPY_STRING_HEADER(d, s);
         PObj_sysmem_CLEAR(d);
     }
     return d;
@@ -275,9 +319,12 @@ Parrot_str_init(PARROT_INTERP)
         interp->hash_seed = interp->parent_interpreter->hash_seed;
     }
     else {
-        /* TT #64 - use an entropy source once available */
+        /* TT #64 - use an entropy source once available; until then, mix
+         * in the fine clock and where the interpreter was allocated */
         Parrot_srand(Parrot_intval_time());
-        interp->hash_seed = Parrot_uint_rand(0);
+        interp->hash_seed = ((UINTVAL)Parrot_uint_rand(0) << 16)
+                          ^ (UINTVAL)Parrot_hires_get_time()
+                          ^ PTR2UINTVAL(interp);
     }
 
     /* initialize the constant string table */
@@ -326,6 +373,8 @@ void
 Parrot_str_finish(PARROT_INTERP)
 {
     ASSERT_ARGS(Parrot_str_finish)
+    Parrot_utf8_destroy_index(interp);
+
     /* all are shared between interpreters */
     if (!interp->parent_interpreter) {
         mem_sys_free(interp->const_cstring_table);
@@ -1344,6 +1393,8 @@ Parrot_str_replace(PARROT_INTERP, ARGIN(STRING *src),
             "replace: subend somehow is less than substart");
 
     /* Now do the replacement */
+    if (PObj_get_FLAGS(src) & STRING_indexed_FLAG)
+        Parrot_utf8_forget_index(interp, src);
 
     /*
      * If the replacement string fits inside the original substring
@@ -1449,6 +1500,9 @@ Parrot_str_chopn_inplace(PARROT_INTERP, ARGMOD(STRING *s), INTVAL n)
 
     s->hashval = 0;
 
+    if (PObj_get_FLAGS(s) & STRING_indexed_FLAG)
+        Parrot_utf8_forget_index(interp, s);
+
     if (!new_length || !s->strlen) {
         s->bufused = s->strlen = 0;
         return;
@@ -1571,6 +1625,9 @@ Parrot_str_equal(PARROT_INTERP, ARGIN_NULLOK(const STRING *s1), ARGIN_NULLOK(con
     else if (s1->strstart == s2->strstart && s1->bufused == s2->bufused) {
         return 1;
     }
+    else if (STRING_IS_SINGLE_BYTE(s1) && STRING_IS_SINGLE_BYTE(s2)) {
+        return memcmp(s1->strstart, s2->strstart, s1->strlen) == 0;
+    }
 
     /*
      * now,
@@ -2564,6 +2621,62 @@ Parrot_str_unpin(PARROT_INTERP, ARGMOD(STRING *s))
 }
 
 
+/*
+
+=item C<static void hash_init(PARROT_INTERP, UHUGEINTVAL *v, UINTVAL length)>
+
+Starts a SipHash-1-3 state C<v> keyed on C<< interp->hash_seed >> and
+absorbs the character count C<length> of the string being hashed.
+
+=cut
+
+*/
+
+static void
+hash_init(PARROT_INTERP, ARGOUT(UHUGEINTVAL *v), UINTVAL length)
+{
+    ASSERT_ARGS(hash_init)
+    const UHUGEINTVAL k0 = interp->hash_seed;
+    const UHUGEINTVAL k1 = SIP_ROTL(k0, 32) ^ SIP_CONST(0x9e3779b9, 0x7f4a7c15);
+
+    v[0] = k0 ^ SIP_CONST(0x736f6d65, 0x70736575);
+    v[1] = k1 ^ SIP_CONST(0x646f7261, 0x6e646f6d);
+    v[2] = k0 ^ SIP_CONST(0x6c796765, 0x6e657261);
+    v[3] = k1 ^ SIP_CONST(0x74656462, 0x79746573);
+
+    SIP_ABSORB(v, (UHUGEINTVAL)length);
+}
+
+
+/*
+
+=item C<static size_t hash_finish(UHUGEINTVAL *v, UHUGEINTVAL tail, UINTVAL
+n_bytes)>
+
+Absorbs the last, partial word C<tail> of the C<n_bytes> hashed and returns
+the final hash value.
+
+=cut
+
+*/
+
+PARROT_WARN_UNUSED_RESULT
+static size_t
+hash_finish(ARGMOD(UHUGEINTVAL *v), UHUGEINTVAL tail, UINTVAL n_bytes)
+{
+    ASSERT_ARGS(hash_finish)
+    const UHUGEINTVAL last = ((UHUGEINTVAL)(n_bytes & 0xff) << 56) | tail;
+
+    SIP_ABSORB(v, last);
+    v[2] ^= 0xff;
+    SIP_ROUND(v);
+    SIP_ROUND(v);
+    SIP_ROUND(v);
+
+    return (size_t)(v[0] ^ v[1] ^ v[2] ^ v[3]);
+}
+
+
 /*
 
 =item C<size_t Parrot_str_to_hashval(PARROT_INTERP, STRING *s)>
@@ -2571,6 +2684,15 @@ Parrot_str_unpin(PARROT_INTERP, ARGMOD(STRING *s))
 Returns the hash value for the specified Parrot string, caching it in
 C<< s->hashval >>.
 
+The hash is SipHash-1-3, keyed on the interpreter's random C<hash_seed>, so
+that colliding keys can't be computed in advance.  Equal strings hash
+equal whatever their encoding, as the message hashed is made from the
+codepoints: each is one byte for as long as all codepoints are below 256,
+and four bytes from the first one above that on.  The character count goes
+first, which makes the message unique to the string.  Strings of
+single-byte characters already are that message and are hashed eight bytes
+at a time.
+
 =cut
 
 */
@@ -2581,24 +2703,73 @@ size_t
 Parrot_str_to_hashval(PARROT_INTERP, ARGMOD_NULLOK(STRING *s))
 {
     ASSERT_ARGS(Parrot_str_to_hashval)
-    String_iter iter;
-    UINTVAL     offs;
-    size_t      hashval = interp->hash_seed;
+    UHUGEINTVAL v[4];
+    UHUGEINTVAL tail = 0;
+    UINTVAL     n_bytes;
+    size_t      hashval;
 
     if (!s)
-        return hashval;
+        return interp->hash_seed;
 
     /* ZZZZZ workaround for something not setting up encodings right */
     saneify_string(s);
 
-    ENCODING_ITER_INIT(interp, s, &iter);
+    hash_init(interp, v, s->strlen);
 
-    for (offs = 0; offs < s->strlen; ++offs) {
-        const UINTVAL c = iter.get_and_advance(interp, &iter);
-        hashval += hashval << 5;
-        hashval += c;
+    if (STRING_IS_SINGLE_BYTE(s)) {
+        const unsigned char *p   = (const unsigned char *)s->strstart;
+        const unsigned char *end = p + (s->strlen & ~(UINTVAL)7);
+        unsigned int         shift;
+
+        for (; p < end; p += 8) {
+            const UHUGEINTVAL m =
+                    (UHUGEINTVAL)p[0]         | ((UHUGEINTVAL)p[1] << 8)
+                 | ((UHUGEINTVAL)p[2] << 16) | ((UHUGEINTVAL)p[3] << 24)
+                 | ((UHUGEINTVAL)p[4] << 32) | ((UHUGEINTVAL)p[5] << 40)
+                 | ((UHUGEINTVAL)p[6] << 48) | ((UHUGEINTVAL)p[7] << 56);
+            SIP_ABSORB(v, m);
+        }
+
+        for (shift = 0; shift < (s->strlen & 7) * 8; shift += 8)
+            tail |= (UHUGEINTVAL)*p++ << shift;
+
+        n_bytes = s->strlen;
+    }
+    else {
+        String_iter  iter;
+        UINTVAL      offs;
+        unsigned int shift = 0;
+        int          wide  = 0;
+
+        n_bytes = 0;
+        ENCODING_ITER_INIT(interp, s, &iter);
+
+        for (offs = 0; offs < s->strlen; ++offs) {
+            const UINTVAL c = iter.get_and_advance(interp, &iter);
+
+            if (c > 0xff)
+                wide = 1;
+
+            tail |= (UHUGEINTVAL)c << shift;
+
+            if (!wide) {
+                shift   += 8;
+                n_bytes += 1;
+            }
+            else {
+                shift   += 32;
+                n_bytes += 4;
+            }
+
+            if (shift >= 64) {
+                SIP_ABSORB(v, tail);
+                shift -= 64;
+                tail   = shift ? (UHUGEINTVAL)c >> (32 - shift) : 0;
+            }
+        }
     }
 
+    hashval    = hash_finish(v, tail, n_bytes);
     s->hashval = hashval;
 
     return hashval;
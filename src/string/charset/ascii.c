@@ -405,7 +405,8 @@ upcase(SHIM_INTERP, ARGIN(STRING *source_string))
         UINTVAL offset;
 
         for (offset = 0; offset < n; offset++) {
-            buffer[offset] = (char)toupper((unsigned char)buffer[offset]);
+            if (buffer[offset] >= 'a' && buffer[offset] <= 'z')
+                buffer[offset] -= 'a' - 'A';
         }
     }
 }
@@ -431,7 +432,8 @@ downcase(SHIM_INTERP, ARGIN(STRING *source_string))
         UINTVAL offset;
 
         for (offset = 0; offset < n; offset++) {
-            buffer[offset] = (char)tolower((unsigned char)buffer[offset]);
+            if (buffer[offset] >= 'A' && buffer[offset] <= 'Z')
+                buffer[offset] += 'a' - 'A';
         }
     }
 }
@@ -550,8 +552,7 @@ ascii_compare(PARROT_INTERP, ARGIN(const STRING *lhs), ARGIN(const STRING *rhs))
     const UINTVAL min_len = l_len > r_len ? r_len : l_len;
     String_iter iter;
 
-    if (lhs->encoding == Parrot_fixed_8_encoding_ptr &&
-            rhs->encoding == Parrot_fixed_8_encoding_ptr) {
+    if (STRING_IS_SINGLE_BYTE(lhs) && STRING_IS_SINGLE_BYTE(rhs)) {
         const int ret_val = memcmp(lhs->strstart, rhs->strstart, min_len);
         if (ret_val)
             return ret_val < 0 ? -1 : 1;
@@ -595,32 +596,43 @@ mixed_cs_index(PARROT_INTERP, ARGIN(STRING *src), ARGIN(STRING *search),
     UINTVAL offs)
 {
     ASSERT_ARGS(mixed_cs_index)
-    String_iter src_iter, search_iter;
-    UINTVAL len;
-    INTVAL start;
+    String_iter   src_iter, search_iter;
+    const UINTVAL len = search->strlen;
+    UINTVAL       first;
+
+    if (!len)
+        return -1;
+
+    if (STRING_IS_SINGLE_BYTE(src) && STRING_IS_SINGLE_BYTE(search))
+        return Parrot_byte_index(interp, src, search, offs);
+
+    ENCODING_ITER_INIT(interp, search, &search_iter);
+    first = search_iter.get_and_advance(interp, &search_iter);
 
     ENCODING_ITER_INIT(interp, src, &src_iter);
     src_iter.set_position(interp, &src_iter, offs);
-    ENCODING_ITER_INIT(interp, search, &search_iter);
-    len = search->strlen;
-
-    start = -1;
-    for (; len && offs < src->strlen; ++offs) {
-        const UINTVAL c1 = src_iter.get_and_advance(interp, &src_iter);
-        const UINTVAL c2 = search_iter.get_and_advance(interp, &search_iter);
-        if (c1 == c2) {
-            --len;
-            if (start == -1)
-                start = offs;
-        }
-        else {
-            len = search->strlen;
-            start = -1;
-            search_iter.set_position(interp, &search_iter, 0);
+
+    /* try each start position in turn, so that a partial match doesn't
+     * hide a match starting inside it */
+    for (; offs + len <= src->strlen; ++offs) {
+        if (src_iter.get_and_advance(interp, &src_iter) == first) {
+            String_iter match_iter = src_iter;
+            UINTVAL     i;
+
+            search_iter.set_position(interp, &search_iter, 1);
+
+            for (i = 1; i < len; ++i) {
+                const UINTVAL c1 = match_iter.get_and_advance(interp, &match_iter);
+                const UINTVAL c2 = search_iter.get_and_advance(interp, &search_iter);
+                if (c1 != c2)
+                    break;
+            }
+
+            if (i == len)
+                return offs;
         }
     }
-    if (len == 0)
-        return start;
+
     return -1;
 }
 
@@ -706,6 +706,9 @@ compare(PARROT_INTERP, ARGIN(const STRING *lhs), ARGIN(const STRING *rhs))
     String_iter l_iter, r_iter;
     UINTVAL offs, cl, cr, min_len, l_len, r_len;
 
+    if (STRING_IS_SINGLE_BYTE(lhs) && STRING_IS_SINGLE_BYTE(rhs))
+        return ascii_compare(interp, lhs, rhs);
+
     /* TODO make optimized equal - strings are equal length then already */
     ENCODING_ITER_INIT(interp, lhs, &l_iter);
     ENCODING_ITER_INIT(interp, rhs, &r_iter);
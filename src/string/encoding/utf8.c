@@ -24,6 +24,29 @@ UTF-8 (L<http://www.utf-8.com/>).
 
 /* HEADERIZER HFILE: src/string/encoding/utf8.h */
 
+/* Random access into a long UTF-8 string goes through an index of the byte
+ * offset of every UTF8_INDEX_STEP'th character, built lazily as far as the
+ * string has been accessed.  The indexes of the last few strings are kept. */
+
+#define UTF8_INDEX_STEP          64
+#define UTF8_INDEX_MIN_LENGTH   256
+#define UTF8_INDEX_CACHE_SIZE     8
+
+typedef struct _utf8_index {
+    const STRING *str;          /* the indexed string */
+    const char   *strstart;     /* the contents it was indexed with */
+    UINTVAL       bufused;
+    UINTVAL       strlen;
+    UINTVAL       filled;       /* offsets found so far */
+    UINTVAL       size;         /* offsets allocated */
+    UINTVAL      *offsets;      /* of characters 0, STEP, 2 * STEP, ... */
+} Utf8_index;
+
+typedef struct _utf8_index_cache {
+    UINTVAL    next;            /* the entry to replace next */
+    Utf8_index entries[UTF8_INDEX_CACHE_SIZE];
+} Utf8_index_cache;
+
 /* HEADERIZER BEGIN: static */
 /* Don't modify between HEADERIZER BEGIN / HEADERIZER END.  Your changes will be lost. */
 
@@ -170,9 +193,22 @@ static void utf8_encode_and_advance(PARROT_INTERP,
         __attribute__nonnull__(2)
         FUNC_MODIFIES(*i);
 
-static void utf8_set_position(SHIM_INTERP,
+PARROT_CANNOT_RETURN_NULL
+static Utf8_index * utf8_find_index(PARROT_INTERP, ARGIN(const STRING *src))
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2);
+
+PARROT_WARN_UNUSED_RESULT
+static UINTVAL utf8_offset(PARROT_INTERP,
+    ARGIN(const STRING *src),
+    UINTVAL pos)
+        __attribute__nonnull__(1)
+        __attribute__nonnull__(2);
+
+static void utf8_set_position(PARROT_INTERP,
     ARGMOD(String_iter *i),
     UINTVAL pos)
+        __attribute__nonnull__(1)
         __attribute__nonnull__(2)
         FUNC_MODIFIES(*i);
 
@@ -244,8 +280,15 @@ static const void * utf8_skip_forward(ARGIN(const void *ptr), UINTVAL n)
 #define ASSERT_ARGS_utf8_encode_and_advance __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
        PARROT_ASSERT_ARG(interp) \
     , PARROT_ASSERT_ARG(i))
+#define ASSERT_ARGS_utf8_find_index __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp) \
+    , PARROT_ASSERT_ARG(src))
+#define ASSERT_ARGS_utf8_offset __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
+       PARROT_ASSERT_ARG(interp) \
+    , PARROT_ASSERT_ARG(src))
 #define ASSERT_ARGS_utf8_set_position __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
-       PARROT_ASSERT_ARG(i))
+       PARROT_ASSERT_ARG(interp) \
+    , PARROT_ASSERT_ARG(i))
 #define ASSERT_ARGS_utf8_skip_backward __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
        PARROT_ASSERT_ARG(ptr))
 #define ASSERT_ARGS_utf8_skip_forward __attribute__unused__ int _ASSERT_ARGS_CHECK = (\
@@ -444,6 +487,114 @@ utf8_skip_backward(ARGIN(const void *ptr), UINTVAL n)
 
 /*
 
+=item C<static Utf8_index * utf8_find_index(PARROT_INTERP, const STRING *src)>
+
+Returns the codepoint index of C<src>, starting a new one in place of the
+oldest index if the string has none or was modified since it was indexed.
+
+=cut
+
+*/
+
+PARROT_CANNOT_RETURN_NULL
+static Utf8_index *
+utf8_find_index(PARROT_INTERP, ARGIN(const STRING *src))
+{
+    ASSERT_ARGS(utf8_find_index)
+    Utf8_index_cache *cache = interp->utf8_index_cache;
+    Utf8_index       *idx   = NULL;
+    UINTVAL           i, size;
+    DECL_CONST_CAST;
+
+    if (!cache)
+        cache = interp->utf8_index_cache = mem_allocate_zeroed_typed(Utf8_index_cache);
+
+    for (i = 0; i < UTF8_INDEX_CACHE_SIZE; i++) {
+        if (cache->entries[i].str == src) {
+            idx = &cache->entries[i];
+
+            if (idx->strstart == src->strstart
+            &&  idx->bufused  == src->bufused
+            &&  idx->strlen   == src->strlen)
+                return idx;
+
+            break;
+        }
+    }
+
+    if (!idx) {
+        idx         = &cache->entries[cache->next];
+        cache->next = (cache->next + 1) % UTF8_INDEX_CACHE_SIZE;
+    }
+
+    size = src->strlen / UTF8_INDEX_STEP + 1;
+    if (idx->size < size) {
+        mem_realloc_n_typed(idx->offsets, size, UINTVAL);
+        idx->size    = size;
+    }
+
+    idx->str        = src;
+    idx->strstart   = src->strstart;
+    idx->bufused    = src->bufused;
+    idx->strlen     = src->strlen;
+    idx->filled     = 1;
+    idx->offsets[0] = 0;
+
+    PObj_get_FLAGS(PARROT_const_cast(STRING *, src)) |= STRING_indexed_FLAG;
+
+    return idx;
+}
+
+/*
+
+=item C<static UINTVAL utf8_offset(PARROT_INTERP, const STRING *src, UINTVAL
+pos)>
+
+Returns the byte offset of the character at C<pos> in C<src>.  All-ASCII
+strings and short strings are handled directly, longer ones through their
+codepoint index, which is extended as needed.
+
+=cut
+
+*/
+
+PARROT_WARN_UNUSED_RESULT
+static UINTVAL
+utf8_offset(PARROT_INTERP, ARGIN(const STRING *src), UINTVAL pos)
+{
+    ASSERT_ARGS(utf8_offset)
+    const utf8_t *u8ptr = (const utf8_t *)src->strstart;
+    Utf8_index   *idx;
+    UINTVAL       n;
+
+    /* only ASCII characters are encoded in a single byte */
+    if (src->bufused == src->strlen)
+        return pos;
+
+    if (pos < UTF8_INDEX_STEP
+    ||  src->strlen < UTF8_INDEX_MIN_LENGTH
+    ||  pos > src->strlen) {
+        u8ptr = (const utf8_t *)utf8_skip_forward(u8ptr, pos);
+        return (const char *)u8ptr - src->strstart;
+    }
+
+    idx = utf8_find_index(interp, src);
+    n   = pos / UTF8_INDEX_STEP;
+
+    while (idx->filled <= n) {
+        const utf8_t * const p = (const utf8_t *)utf8_skip_forward(
+            u8ptr + idx->offsets[idx->filled - 1], UTF8_INDEX_STEP);
+        idx->offsets[idx->filled++] = p - u8ptr;
+    }
+
+    u8ptr = (const utf8_t *)utf8_skip_forward(u8ptr + idx->offsets[n],
+            pos % UTF8_INDEX_STEP);
+
+    return (const char *)u8ptr - src->strstart;
+}
+
+/*
+
 =back
 
 =head2 Iterator Functions
@@ -542,25 +693,21 @@ function.
 */
 
 static void
-utf8_set_position(SHIM_INTERP, ARGMOD(String_iter *i), UINTVAL pos)
+utf8_set_position(PARROT_INTERP, ARGMOD(String_iter *i), UINTVAL pos)
 {
     ASSERT_ARGS(utf8_set_position)
-    const utf8_t *u8ptr = (const utf8_t *)i->str->strstart;
-
-    /* start from last known charpos, if we can */
-    if (i->charpos <= pos) {
-        const UINTVAL old_pos = pos;
-        pos       -= i->charpos;
-        u8ptr     += i->bytepos;
-        i->charpos = old_pos;
+
+    /* start from last known charpos, if it's close, else use the index */
+    if (i->charpos <= pos && pos - i->charpos < UTF8_INDEX_STEP) {
+        const utf8_t * const u8ptr = (const utf8_t *)utf8_skip_forward(
+            (const char *)i->str->strstart + i->bytepos, pos - i->charpos);
+
+        i->bytepos = (const char *)u8ptr - (const char *)i->str->strstart;
     }
     else
-        i->charpos = pos;
+        i->bytepos = utf8_offset(interp, i->str, pos);
 
-    while (pos-- > 0)
-        u8ptr += UTF8SKIP(u8ptr);
-
-    i->bytepos = (const char *)u8ptr - (const char *)i->str->strstart;
+    i->charpos = pos;
 }
 
 
@@ -668,7 +815,8 @@ static UINTVAL
 get_codepoint(PARROT_INTERP, ARGIN(const STRING *src), UINTVAL offset)
 {
     ASSERT_ARGS(get_codepoint)
-    const utf8_t * const start = (const utf8_t *)utf8_skip_forward(src->strstart, offset);
+    const utf8_t * const start =
+        (const utf8_t *)src->strstart + utf8_offset(interp, src, offset);
     return utf8_decode(interp, start);
 }
 
@@ -687,12 +835,8 @@ static void
 set_codepoint(PARROT_INTERP, ARGIN(STRING *src), UINTVAL offset, UINTVAL codepoint)
 {
     ASSERT_ARGS(set_codepoint)
-    const void *start;
-    void *p;
-    DECL_CONST_CAST;
+    void * const p = src->strstart + utf8_offset(interp, src, offset);
 
-    start = utf8_skip_forward(src->strstart, offset);
-    p = PARROT_const_cast(void *, start);
     utf8_encode(interp, p, codepoint);
 }
 
@@ -1064,6 +1208,63 @@ Parrot_encoding_utf8_init(PARROT_INTERP)
 
 /*
 
+=item C<void Parrot_utf8_forget_index(PARROT_INTERP, STRING *s)>
+
+Drops the codepoint index of C<s>.  Called when an indexed string is freed
+or modified in place.
+
+=cut
+
+*/
+
+PARROT_EXPORT
+void
+Parrot_utf8_forget_index(PARROT_INTERP, ARGMOD(STRING *s))
+{
+    ASSERT_ARGS(Parrot_utf8_forget_index)
+    Utf8_index_cache * const cache = interp->utf8_index_cache;
+
+    PObj_get_FLAGS(s) &= ~STRING_indexed_FLAG;
+
+    if (cache) {
+        UINTVAL i;
+
+        for (i = 0; i < UTF8_INDEX_CACHE_SIZE; i++) {
+            if (cache->entries[i].str == s)
+                cache->entries[i].str = NULL;
+        }
+    }
+}
+
+/*
+
+=item C<void Parrot_utf8_destroy_index(PARROT_INTERP)>
+
+Frees the codepoint indexes of the interpreter.
+
+=cut
+
+*/
+
+void
+Parrot_utf8_destroy_index(PARROT_INTERP)
+{
+    ASSERT_ARGS(Parrot_utf8_destroy_index)
+    Utf8_index_cache * const cache = interp->utf8_index_cache;
+
+    if (cache) {
+        UINTVAL i;
+
+        for (i = 0; i < UTF8_INDEX_CACHE_SIZE; i++)
+            mem_sys_free(cache->entries[i].offsets);
+
+        mem_sys_free(cache);
+        interp->utf8_index_cache = NULL;
+    }
+}
+
+/*
+
 =back
 
 =head1 SEE ALSO
@@ -85,6 +85,11 @@ invalidate_retc_context(PARROT_INTERP, ARGMOD(PMC *cont))
     ASSERT_ARGS(invalidate_retc_context)
 
     PMC *ctx = PARROT_CONTINUATION(cont)->from_ctx;
+
+    /* a RetContinuation which returned already has no context left */
+    if (PMC_IS_NULL(ctx))
+        return;
+
     cont = Parrot_pcc_get_continuation(interp, ctx);
 
     while (1) {
@@ -489,6 +494,7 @@ Parrot_capture_lex(PARROT_INTERP, ARGMOD(PMC *sub_pmc))
                 if (Parrot_str_equal(interp, current_sub->subid,
                                       child_outer_sub->subid)) {
                     child_sub->outer_ctx = ctx;
+                    GC_WRITE_BARRIER(interp, child_pmc, NULL, ctx);
                 }
             }
         }
@@ -514,6 +520,7 @@ Parrot_capture_lex(PARROT_INTERP, ARGMOD(PMC *sub_pmc))
 
     /* set the sub's outer context to the current context */
     sub->outer_ctx = ctx;
+    GC_WRITE_BARRIER(interp, sub_pmc, NULL, ctx);
 }
 
 
@@ -589,17 +589,24 @@ Parrot_byte_index(SHIM_INTERP, ARGIN(const STRING *base),
     INTVAL             len_remain = str_len   - start_offset;
     const char        *search_pos;
 
+    if (len_remain < search_len)
+        return -1;
+
     /* find the next position of the first character in the search string
      * Parrot strings can have NULLs, so strchr() won't work here */
     while ((search_pos = (const char *)memchr(str_pos, *search_str, len_remain))) {
         const INTVAL offset = search_pos - str_start;
 
+        /* too close to the end for the entire string to fit */
+        if (str_len - offset < search_len)
+            return -1;
+
         /* now look for the entire string */
         if (memcmp(search_pos, search_str, search_len) == 0)
             return offset;
 
         /* otherwise loop and memchr() with the rest of the string */
-        len_remain = str_len    - offset;
+        len_remain = str_len    - offset - 1;
         str_pos    = search_pos + 1;
 
         if (len_remain < search_len)
@@ -5,7 +5,7 @@
 use strict;
 use warnings;
 use lib qw( . lib ../lib ../../lib );
-use Parrot::Test tests => 78;
+use Parrot::Test tests => 81;
 use Parrot::Config;
 
 my $output;
@@ -1220,6 +1220,70 @@ CODE
 /
 OUT
 
+##############################
+# superinstructions, see src/ops/ops.super
+
+pir_2_pasm_is( <<'CODE', <<'OUT', "superinstruction inc, lt" );
+.sub _main
+    $I0 = 0
+    $I1 = 10
+L1:
+    inc $I0
+    if $I0 < $I1 goto L1
+    end
+.end
+CODE
+# IMCC does produce b0rken PASM files
+# see http://guest@rt.perl.org/rt3/Ticket/Display.html?id=32392
+_main:
+    null I0
+    set I1, 10
+L1:
+    super_inc_lt I0, I0, I1, L1
+    end
+OUT
+
+pir_2_pasm_is( <<'CODE', <<'OUT', "superinstruction - not across a label" );
+.sub _main
+    $I0 = 0
+    $I1 = 10
+    inc $I0
+L1:
+    if $I0 < $I1 goto L1
+    end
+.end
+CODE
+# IMCC does produce b0rken PASM files
+# see http://guest@rt.perl.org/rt3/Ticket/Display.html?id=32392
+_main:
+    null I0
+    set I1, 10
+    inc I0
+L1:
+    lt I0, I1, L1
+    end
+OUT
+
+pir_2_pasm_is( <<'CODE', <<'OUT', "superinstruction with a key" );
+.sub _main
+    $P0 = new 'Hash'
+    $I0 = exists $P0['a']
+    unless $I0 goto L1
+    print "a\n"
+L1:
+    end
+.end
+CODE
+# IMCC does produce b0rken PASM files
+# see http://guest@rt.perl.org/rt3/Ticket/Display.html?id=32392
+_main:
+    new P0, 'Hash'
+    super_exists_unless I0, P0['a'], I0, L1
+    print "a\n"
+L1:
+    end
+OUT
+
 # Local Variables:
 #   mode: cperl
 #   cperl-indent-level: 4
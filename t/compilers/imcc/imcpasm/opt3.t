@@ -0,0 +1,150 @@
+#!perl
+# Copyright (C) 2009, Parrot Foundation.
+# $Id$
+
+use strict;
+use warnings;
+use lib qw( . lib ../lib ../../lib );
+use Parrot::Test tests => 6;
+
+# these tests are run with -O3 by TestCompiler and show
+# generated PASM code for the SSA optimizations at level 3
+
+##############################
+pir_2_pasm_is( <<'CODE', <<'OUT', "copy and constant propagation" );
+.sub _main
+    $I0 = 5
+    $I1 = $I0
+    $I2 = $I1 + 1
+    print $I2
+    end
+.end
+CODE
+# IMCC does produce b0rken PASM files
+# see http://guest@rt.perl.org/rt3/Ticket/Display.html?id=32392
+_main:
+  print 6
+  end
+OUT
+
+##############################
+pir_2_pasm_like( <<'CODE', <<'OUT', "value numbering" );
+.sub _main
+    .param int a
+    .param int b
+    $I0 = a + b
+    $I1 = a + b
+    $I2 = $I0 * $I1
+    print $I2
+.end
+CODE
+/_main:
+ get_params\s*
+ add (I\d+), I\d+, I\d+
+ mul (I\d+), \1, \1
+ print \2
+ set_returns\s*
+ returncc/
+OUT
+
+##############################
+pir_2_pasm_like( <<'CODE', <<'OUT', "unbox a Float temporary" );
+.sub _main
+    .param num x
+    $P0 = new 'Float'
+    $P0 = x
+    $N1 = $P0
+    print $N1
+.end
+CODE
+/_main:
+ get_params\s*
+ print N\d+
+ set_returns\s*
+ returncc/
+OUT
+
+##############################
+pir_2_pasm_like( <<'CODE', <<'OUT', "hoist a loop invariant" );
+.sub _main
+    .param int n
+    .param int k
+    .local int i, sum
+    i = 0
+    sum = 0
+  loop:
+    $I0 = k * 3
+    sum += $I0
+    inc i
+    if i < n goto loop
+    print sum
+.end
+CODE
+/ mul (I\d+), I\d+, 3
+loop:
+ add I\d+, \1
+/
+OUT
+
+##############################
+pir_output_is( <<'CODE', <<'OUT', "optimized loop still computes the sum" );
+.sub main :main
+    $I0 = sum(10, 4)
+    print $I0
+    print "\n"
+    $P0 = new 'Integer'
+    $P0 = 7
+    $I1 = $P0
+    $I1 += $I0
+    print $I1
+    print "\n"
+.end
+
+.sub sum
+    .param int n
+    .param int k
+    .local int i, total
+    i = 0
+    total = 0
+  loop:
+    $I0 = k * 3
+    $I1 = i + $I0
+    total += $I1
+    inc i
+    if i < n goto loop
+    .return (total)
+.end
+CODE
+165
+172
+OUT
+
+##############################
+pir_output_is( <<'CODE', <<'OUT', "registers set in a push_eh try block reach the handler" );
+.sub main :main
+    $P1 = new 'Integer'
+    $I0 = 5
+    push_eh handler
+    $I0 = 6
+    print "a\n"
+    $I0 = 7
+    $P1.'nomethod'()
+    pop_eh
+    print "not reached\n"
+    end
+  handler:
+    .get_results($P9)
+    print $I0
+    print "\n"
+.end
+CODE
+a
+7
+OUT
+
+# Local Variables:
+#   mode: cperl
+#   cperl-indent-level: 4
+#   fill-column: 100
+# End:
+# vim: expandtab shiftwidth=4:
@@ -19,9 +19,12 @@ Tests OO features related to adding and removing attributes.
 .sub main :main
     .include 'test_more.pir'
 
-    plan(3)
+    plan(6)
 
     remove_1()
+    slots_per_class()
+    hidden_attribute()
+    get_attr_str_override()
 .end
 
 .sub remove_1
@@ -71,3 +74,100 @@ Tests OO features related to adding and removing attributes.
     is(message, "No such attribute 'data'", 'class attribute deleted')
 
 .end
+
+.sub slots_per_class
+    .local pmc parent, child, objects
+    parent = newclass 'SlotParent'
+    addattribute parent, 'x'
+    child  = subclass parent, 'SlotChild'
+    addattribute child, 'a'
+    addattribute child, 'b'
+
+    objects = new 'ResizablePMCArray'
+    $P0 = new parent
+    push objects, $P0
+    $P0 = new child
+    push objects, $P0
+    $P0 = new parent
+    push objects, $P0
+    $P0 = new child
+    push objects, $P0
+
+    # 'x' has another index in the objects of each class, at the same ops
+    $I0 = 0
+  set_loop:
+    $P0 = objects[$I0]
+    $P1 = new 'Integer'
+    $P1 = $I0
+    setattribute $P0, 'x', $P1
+    inc $I0
+    if $I0 < 4 goto set_loop
+
+    $S0 = ''
+    $I0 = 0
+  get_loop:
+    $P0 = objects[$I0]
+    $P1 = getattribute $P0, 'x'
+    $S1 = $P1
+    $S0 .= $S1
+    inc $I0
+    if $I0 < 4 goto get_loop
+
+    is($S0, '0123', 'attributes of objects of several classes at the same op')
+.end
+
+.sub hidden_attribute
+    .local pmc parent, child, obj
+    parent = newclass 'HideParent'
+    addattribute parent, 'x'
+    child  = subclass parent, 'HideChild'
+    addattribute child, 'x'
+    obj    = new child
+
+    $P0 = box 'child'
+    setattribute obj, 'x', $P0
+    $P0 = box 'parent'
+    setattribute obj, ['HideParent'], 'x', $P0
+
+    $P1 = getattribute obj, 'x'
+    $S0 = $P1
+    $P1 = getattribute obj, ['HideParent'], 'x'
+    $S1 = $P1
+    $S0 .= ' '
+    $S0 .= $S1
+    is($S0, 'child parent', 'an attribute hides the one of a parent')
+.end
+
+.sub get_attr_str_override
+    .local pmc class, obj
+    class = newclass 'AttrOverride'
+    addattribute class, 'x'
+    obj   = new class
+
+    $S0 = ''
+    $I0 = 0
+  loop:
+    $P1 = getattribute obj, 'x'
+    $S1 = $P1
+    $S0 .= $S1
+    inc $I0
+    if $I0 < 2 goto loop
+
+    is($S0, 'xx', 'getattribute calls a get_attr_str override')
+.end
+
+.namespace ['AttrOverride']
+
+.sub 'get_attr_str' :vtable :method
+    .param string name
+    $P0 = box name
+    .return ($P0)
+.end
+
+.namespace []
+
+# Local Variables:
+#   mode: pir
+#   fill-column: 100
+# End:
+# vim: expandtab shiftwidth=4 ft=pir:
@@ -21,11 +21,13 @@ Tests features related to the creation, addition, and execution of OO methods.
 
     create_library()
 
-    plan(5)
+    plan(9)
 
     loading_methods_from_file()
     loading_methods_from_eval()
     overridden_find_method()
+    polymorphic_call_site()
+    call_site_sees_new_methods()
 
     delete_library()
 
@@ -126,6 +128,92 @@ END
 
 .namespace []
 
+.sub polymorphic_call_site
+    .local pmc objects, name
+    .local string seen
+    objects = new 'ResizablePMCArray'
+
+    $I0 = 0
+  make_classes:
+    $S0 = $I0
+    $S0 = concat 'Poly', $S0
+    $P0 = newclass $S0
+    $P1 = get_global 'poly_name'
+    $P0.'add_method'('name', $P1)
+    $P1 = new $P0
+    push objects, $P1
+    inc $I0
+    if $I0 < 6 goto make_classes
+
+    # more classes than a call site caches, and each of them twice
+    seen = ''
+    $I0 = 0
+  call:
+    $I1 = $I0 % 6
+    $P0 = objects[$I1]
+    $S0 = $P0.'name'()
+    seen .= $S0
+    seen .= ' '
+    inc $I0
+    if $I0 < 12 goto call
+
+    $S0 = 'Poly0 Poly1 Poly2 Poly3 Poly4 Poly5 Poly0 Poly1 Poly2 Poly3 Poly4 Poly5 '
+    is(seen, $S0, 'a call site finds the methods of many classes')
+.end
+
+.sub poly_name :method
+    $P0 = typeof self
+    $S0 = $P0
+    .return ($S0)
+.end
+
+.sub call_site_sees_new_methods
+    .local pmc parent, child, obj, meth
+    .local string seen
+    parent = newclass 'CacheParent'
+    child  = subclass parent, 'CacheChild'
+    meth   = get_global 'parent_who'
+    parent.'add_method'('who', meth)
+    obj    = new child
+
+    seen = ''
+    $I0  = 0
+  call:
+    $S0 = obj.'who'()
+    seen .= $S0
+    inc $I0
+    if $I0 != 2 goto no_override
+    meth = get_global 'child_who'
+    child.'add_method'('who', meth)
+  no_override:
+    if $I0 < 4 goto call
+
+    is(seen, 'ppcc', 'a call site sees a method added to the class')
+
+    $S0 = 'who'
+    $S1 = obj.$S0()
+    is($S1, 'c', '... also for a method name in a register')
+
+    # and an already cached class sees a method removed from it
+    child.'remove_method'('who')
+    seen = ''
+    $I0  = 0
+  call_again:
+    $S0 = obj.'who'()
+    seen .= $S0
+    inc $I0
+    if $I0 < 2 goto call_again
+    is(seen, 'pp', 'a call site sees a method removed from the class')
+.end
+
+.sub parent_who :method
+    .return ('p')
+.end
+
+.sub child_who :method
+    .return ('c')
+.end
+
 # Local Variables:
 #   mode: pir
 #   fill-column: 100
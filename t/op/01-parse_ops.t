@@ -49,6 +49,8 @@ my %parse_errors = map { $_ => 1 } qw(
     ne
     set
     slice
+    super_exists_unless
+    super_set_unless_null
     yield
 );
 
@@ -19,7 +19,7 @@ Test various use cases of the annotate directive.
 .sub main :main
     .include 'test_more.pir'
 
-    plan(33)
+    plan(39)
 
     'no_annotations'()
     'annotations_exception'()
@@ -27,6 +27,7 @@ Test various use cases of the annotate directive.
     'backtrace_annotations'()
     'parrotinterpreter_annotations'()
     'eval_test'()
+    'many_annotations'()
 .end
 
 
@@ -235,6 +236,45 @@ END_PIR
 .end
 
 
+.sub 'many_annotations'
+    .annotate 'file', 'many.pl'
+    .annotate 'line', 1
+    $P0 = 'many_a'()
+    is ($P0, 'a.pl', 'annotation of an earlier sub found')
+    $P0 = 'many_b'()
+    is ($P0, 10, 'annotation of a later sub found')
+
+    .annotate 'line', 2
+    .annotate 'line', 3
+    .annotate 'column', 7
+    .annotate 'line', 4
+    $P0 = annotations 'file'
+    is ($P0, 'many.pl', 'annotation set before others still in force')
+    $P0 = annotations 'line'
+    is ($P0, 4, 'latest of several annotations in force')
+    $P0 = annotations 'column'
+    is ($P0, 7, 'annotation between others in force')
+    .annotate 'line', 5
+    $P0 = annotations
+    $I0 = elements $P0
+    is ($I0, 3, 'all annotations in force')
+.end
+
+.sub 'many_a'
+    .annotate 'file', 'a.pl'
+    $P0 = annotations 'file'
+    .return ($P0)
+.end
+
+.sub 'many_b'
+    .annotate 'line', 9
+    .annotate 'line', 10
+    $P0 = annotations 'line'
+    .annotate 'line', 11
+    .return ($P0)
+.end
+
+
 # Local Variables:
 #   mode: pir 
 #   fill-column: 100
@@ -24,7 +24,7 @@ as well as backtrace tests.
 =cut
 
 $ENV{TEST_PROG_ARGS} ||= '';
-my $nolineno = $ENV{TEST_PROG_ARGS} =~ /--runcore=(fast|cgoto)/
+my $nolineno = $ENV{TEST_PROG_ARGS} =~ /--runcore=(fast|cgoto|exec)/
     ? "\\(unknown file\\)\n-1" : "debuginfo_\\d+\\.pasm\n\\d";
 
 #SKIP: {
@@ -163,7 +163,7 @@ called from Sub 'rec' pc (\d+|-1) \(.*?:(\d+|-1)\)
 called from Sub 'main' pc (\d+|-1) \(.*?:(\d+|-1)\)$/
 OUTPUT
 
-$nolineno = $ENV{TEST_PROG_ARGS} =~ /--runcore=fast/
+$nolineno = $ENV{TEST_PROG_ARGS} =~ /--runcore=(fast|exec)/
     ? '\(\(unknown file\):-1\)' : '\(xyz.pir:126\)';
 
 #SKIP: {
@@ -191,7 +191,7 @@ TODO: {
     local $TODO = q|Not yet passing on 'jit' or 'switch' runcores|
         if $ENV{TEST_PROG_ARGS} =~ /--runcore=(jit|switch)/;
 
-$nolineno = $ENV{TEST_PROG_ARGS} =~ /--runcore=(fast|cgoto|jit|switch)/
+$nolineno = $ENV{TEST_PROG_ARGS} =~ /--runcore=(fast|cgoto|exec|jit|switch)/
     ? '\(\(unknown file\):-1\)' : '\(foo.p6:128\)';
 # See "RT #43269 and .annotate
 pir_error_output_like( <<'CODE', <<"OUTPUT", "setfile and setline" );
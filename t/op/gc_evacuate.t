@@ -0,0 +1,135 @@
+#!perl
+# Copyright (C) 2009, Parrot Foundation.
+# $Id$
+
+use strict;
+use warnings;
+use lib qw( . lib ../lib ../../lib );
+
+use Test::More;
+use Parrot::Test tests => 3;
+
+=head1 NAME
+
+t/op/gc_evacuate.t - Compaction by evacuating fragmented blocks
+
+=head1 SYNOPSIS
+
+    % prove t/op/gc_evacuate.t
+
+=head1 DESCRIPTION
+
+Compacts string memory by evacuating fragmented blocks, selected with the
+C<PARROT_GC_COMPACT> environment variable.
+
+=cut
+
+$ENV{PARROT_GC_COMPACT} = 'evacuate';
+
+pir_output_is( <<'CODE', <<'OUTPUT', 'live strings survive evacuation' );
+.sub main :main
+    .local pmc keep
+    keep = new 'ResizableStringArray'
+
+    $I0 = 0
+  make:
+    $S0 = $I0
+    $S1 = repeat 'x', 200
+    $S1 .= $S0
+    $I1 = $I0 % 10
+    if $I1 goto garbage
+    push keep, $S1
+  garbage:
+    $S2 = repeat 'y', 500
+    inc $I0
+    if $I0 < 20000 goto make
+
+    collect
+
+    $I0 = 0
+  check:
+    $S0 = keep[$I0]
+    $I1 = $I0 * 10
+    $S1 = $I1
+    $S2 = repeat 'x', 200
+    $S2 .= $S1
+    if $S0 != $S2 goto fail
+    inc $I0
+    if $I0 < 2000 goto check
+    say 'ok'
+    end
+  fail:
+    print 'wrong string '
+    say $I0
+.end
+CODE
+ok
+OUTPUT
+
+pir_output_is( <<'CODE', <<'OUTPUT', 'COW substrings survive evacuation' );
+.sub main :main
+    .local pmc keep
+    keep = new 'ResizableStringArray'
+
+    $I0 = 0
+  make:
+    $S0 = repeat 'abcdefghij', 30
+    $S1 = substr $S0, 100, 20
+    $S2 = $S0
+    push keep, $S1
+    push keep, $S2
+    $S3 = repeat 'z', 1000
+    inc $I0
+    if $I0 < 5000 goto make
+
+    collect
+    collect
+
+    $S4 = repeat 'abcdefghij', 30
+    $I0 = 0
+  check:
+    $S0 = keep[$I0]
+    if $S0 != 'abcdefghijabcdefghij' goto fail
+    inc $I0
+    $S0 = keep[$I0]
+    if $S0 != $S4 goto fail
+    inc $I0
+    if $I0 < 10000 goto check
+    say 'ok'
+    end
+  fail:
+    print 'wrong string '
+    say $I0
+.end
+CODE
+ok
+OUTPUT
+
+pir_output_is( <<'CODE', <<'OUTPUT', 'evacuation frees garbage blocks' );
+.include 'interpinfo.pasm'
+.sub main :main
+    $I0 = 0
+  make:
+    $S0 = repeat 'x', 1000
+    inc $I0
+    if $I0 < 100000 goto make
+
+    collect
+    $I0 = interpinfo .INTERPINFO_TOTAL_MEM_ALLOC
+    if $I0 < 10000000 goto ok
+    print 'still holding '
+    say $I0
+    end
+  ok:
+    say 'ok'
+.end
+CODE
+ok
+OUTPUT
+
+# Local Variables:
+#   mode: cperl
+#   cperl-indent-level: 4
+#   fill-column: 100
+# End:
+# vim: expandtab shiftwidth=4:
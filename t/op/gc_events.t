@@ -0,0 +1,212 @@
+#!perl
+# Copyright (C) 2009, Parrot Foundation.
+# $Id$
+
+use strict;
+use warnings;
+use lib qw( . lib ../lib ../../lib );
+
+use Test::More;
+use Parrot::Test tests => 6;
+
+=head1 NAME
+
+t/op/gc_events.t - The log of collections
+
+=head1 SYNOPSIS
+
+    % prove t/op/gc_events.t
+
+=head1 DESCRIPTION
+
+Tests the log of collections and compactions, enabled with the
+C<PARROT_GC_LOG> and C<PARROT_GC_LOG_SIZE> environment variables and read
+with C<interpinfo .INTERPINFO_GC_EVENTS>.
+
+=cut
+
+$ENV{PARROT_GC_CORE} = 'ms';
+delete $ENV{PARROT_GC_LOG};
+delete $ENV{PARROT_GC_LOG_SIZE};
+delete $ENV{PARROT_GC_LAZY_SWEEP};
+delete $ENV{PARROT_GC_COMPACT};
+
+pir_output_is( <<'CODE', <<'OUTPUT', 'no log by default' );
+.include 'interpinfo.pasm'
+.sub main :main
+    sweep 1
+    $P0 = interpinfo .INTERPINFO_GC_EVENTS
+    $I0 = elements $P0
+    say $I0
+.end
+CODE
+0
+OUTPUT
+
+{
+    local $ENV{PARROT_GC_LOG_SIZE} = '64';
+
+    pir_output_is( <<'CODE', <<'OUTPUT', 'a collection is logged' );
+.include 'interpinfo.pasm'
+.sub main :main
+    .local pmc root
+    root = new 'ResizablePMCArray'
+
+    $I1 = 0
+  fill:
+    $P0 = new 'Integer'
+    push root, $P0
+    inc $I1
+    if $I1 < 100000 goto fill
+
+    null root
+    null $P0
+    sweep 1
+    $P0 = interpinfo .INTERPINFO_GC_EVENTS
+    $P1 = $P0[-1]
+    $S0 = $P1['type']
+    say $S0
+
+    $N0 = $P1['start']
+    $N1 = $P1['end']
+    if $N1 < $N0 goto fail
+
+    $I0 = $P1['pmcs_before']
+    if $I0 < 100000 goto fail
+    $I0 = $P1['pmcs_freed']
+    if $I0 < 100000 goto fail
+    $I0 = $P1['buffers_before']
+    if $I0 <= 0 goto fail
+    $I0 = $P1['memory_after']
+    if $I0 <= 0 goto fail
+    say 'ok'
+    end
+  fail:
+    print 'wrong event: '
+    say $I0
+.end
+CODE
+mark
+ok
+OUTPUT
+}
+
+{
+    local $ENV{PARROT_GC_LOG_SIZE} = '4';
+
+    pir_output_is( <<'CODE', <<'OUTPUT', 'the log keeps the latest events' );
+.include 'interpinfo.pasm'
+.sub main :main
+    $I1 = 0
+  loop:
+    sweep 1
+    inc $I1
+    if $I1 < 10 goto loop
+
+    $P0 = interpinfo .INTERPINFO_GC_EVENTS
+    $I0 = elements $P0
+    say $I0
+
+    $P1 = $P0[0]
+    $I0 = $P1['number']
+    $P1 = $P0[-1]
+    $I1 = $P1['number']
+    $I1 -= $I0
+    say $I1
+    if $I0 < 6 goto fail
+    say 'ok'
+    end
+  fail:
+    say 'old events kept'
+.end
+CODE
+4
+3
+ok
+OUTPUT
+}
+
+{
+    local $ENV{PARROT_GC_LOG_SIZE} = '64';
+
+    pir_output_is( <<'CODE', <<'OUTPUT', 'a compaction is logged' );
+.include 'interpinfo.pasm'
+.sub main :main
+    .local pmc keep
+    keep = new 'ResizableStringArray'
+
+    $I1 = 0
+  make:
+    $S0 = repeat 'x', 200
+    push keep, $S0
+    inc $I1
+    if $I1 < 1000 goto make
+
+    collect
+    $P0 = interpinfo .INTERPINFO_GC_EVENTS
+    $P1 = $P0[-1]
+    $S0 = $P1['type']
+    say $S0
+    $I0 = $P1['bytes_copied']
+    if $I0 < 200000 goto fail
+    say 'ok'
+    end
+  fail:
+    print 'too few bytes copied: '
+    say $I0
+.end
+CODE
+compact
+ok
+OUTPUT
+}
+
+my $log = "gc_events_$$.log";
+unlink $log;
+
+{
+    local $ENV{PARROT_GC_LOG} = $log;
+
+    pir_output_is( <<'CODE', <<'OUTPUT', 'PARROT_GC_LOG enables the log' );
+.include 'interpinfo.pasm'
+.sub main :main
+    sweep 1
+    sweep 1
+    $P0 = interpinfo .INTERPINFO_GC_EVENTS
+    $I0 = elements $P0
+    if $I0 < 2 goto fail
+    say 'ok'
+    end
+  fail:
+    say 'no events'
+.end
+CODE
+ok
+OUTPUT
+}
+
+{
+    my @marks;
+    my $columns = '';
+
+    if ( open my $fh, '<', $log ) {
+        while (<$fh>) {
+            $columns = $_ if /^# number\t/;
+            push @marks, $_ if /^\d+\tmark\t/;
+        }
+        close $fh;
+    }
+
+    ok( $columns =~ /\tpmcs_freed\t/ && @marks >= 2
+        && ( split /\t/, $marks[0] ) == ( split /\t/, $columns ),
+        'the log is written on exit' );
+
+    unlink $log;
+}
+
+# Local Variables:
+#   mode: cperl
+#   cperl-indent-level: 4
+#   fill-column: 100
+# End:
+# vim: expandtab shiftwidth=4:
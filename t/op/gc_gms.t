@@ -0,0 +1,221 @@
+#!perl
+# Copyright (C) 2009, Parrot Foundation.
+# $Id$
+
+use strict;
+use warnings;
+use lib qw( . lib ../lib ../../lib );
+
+use Test::More;
+use Parrot::Test tests => 6;
+
+=head1 NAME
+
+t/op/gc_gms.t - Generational garbage collector
+
+=head1 SYNOPSIS
+
+    % prove t/op/gc_gms.t
+
+=head1 DESCRIPTION
+
+Runs the generational mark & sweep GC core, selected with the
+C<PARROT_GC_CORE> environment variable. Each test promotes an aggregate to
+the old generation with C<sweep 1>, and then stores young objects into it
+while allocating enough for many minor collections. The young objects must
+survive.
+
+=cut
+
+$ENV{PARROT_GC_CORE} = 'gms';
+
+pir_output_is( <<'CODE', <<'OUTPUT', 'young PMCs in an old array' );
+.sub main :main
+    .local pmc array
+    array = new 'ResizablePMCArray'
+    sweep 1
+
+    $I0 = 0
+  fill:
+    $P0 = new 'Integer'
+    $P0 = $I0
+    push array, $P0
+    $P1 = new 'String'
+    $P1 = 'garbage'
+    inc $I0
+    if $I0 < 200000 goto fill
+
+    $I0 = 0
+  check:
+    $P0 = array[$I0]
+    if $P0 != $I0 goto fail
+    inc $I0
+    if $I0 < 200000 goto check
+    say 'ok'
+    end
+  fail:
+    say 'lost an element'
+.end
+CODE
+ok
+OUTPUT
+
+pir_output_is( <<'CODE', <<'OUTPUT', 'young STRINGs in an old hash' );
+.sub main :main
+    .local pmc hash
+    hash = new 'Hash'
+    sweep 1
+
+    $I0 = 0
+  fill:
+    $S0 = $I0
+    $S1 = concat 'value ', $S0
+    hash[$S0] = $S1
+    inc $I0
+    if $I0 < 50000 goto fill
+
+    $I0 = 0
+  check:
+    $S0 = $I0
+    $S1 = hash[$S0]
+    $S2 = concat 'value ', $S0
+    if $S1 != $S2 goto fail
+    inc $I0
+    if $I0 < 50000 goto check
+    say 'ok'
+    end
+  fail:
+    say 'lost a value'
+.end
+CODE
+ok
+OUTPUT
+
+pir_output_is( <<'CODE', <<'OUTPUT', 'young attributes of an old object' );
+.sub main :main
+    $P0 = newclass 'Node'
+    addattribute $P0, 'value'
+
+    .local pmc head, node
+    head = new 'Node'
+    sweep 1
+
+    $I0 = 0
+  loop:
+    node = new 'Node'
+    $P1 = new 'Integer'
+    $P1 = $I0
+    setattribute node, 'value', $P1
+    setattribute head, 'value', node
+
+    $I1 = 0
+  garbage:
+    $P2 = new 'String'
+    inc $I1
+    if $I1 < 10 goto garbage
+
+    node = getattribute head, 'value'
+    $P1  = getattribute node, 'value'
+    if $P1 != $I0 goto fail
+    inc $I0
+    if $I0 < 50000 goto loop
+    say 'ok'
+    end
+  fail:
+    say 'lost a node'
+.end
+CODE
+ok
+OUTPUT
+
+pir_output_is( <<'CODE', <<'OUTPUT', 'closures keep their outer context' );
+.sub main :main
+    .local pmc closures
+    closures = new 'ResizablePMCArray'
+    sweep 1
+
+    $I0 = 0
+  fill:
+    $P0 = make_closure($I0)
+    push closures, $P0
+    inc $I0
+    if $I0 < 20000 goto fill
+
+    $I0 = 0
+  check:
+    $P0 = closures[$I0]
+    $I1 = $P0()
+    if $I1 != $I0 goto fail
+    inc $I0
+    if $I0 < 20000 goto check
+    say 'ok'
+    end
+  fail:
+    say 'lost a lexical'
+.end
+
+.sub make_closure
+    .param int n
+    .lex '$n', $P0
+    $P0 = new 'Integer'
+    $P0 = n
+    .const 'Sub' inner = 'inner'
+    $P1 = newclosure inner
+    .return ($P1)
+.end
+
+.sub inner :outer('make_closure')
+    $P0 = find_lex '$n'
+    $I0 = $P0
+    .return ($I0)
+.end
+CODE
+ok
+OUTPUT
+
+pir_output_is( <<'CODE', <<'OUTPUT', 'sweep 1 still finds all dead objects' );
+.include 'interpinfo.pasm'
+.sub main :main
+    sweep 1
+    $I0 = interpinfo .INTERPINFO_ACTIVE_PMCS
+
+    $I1 = 0
+  make_garbage:
+    $P0 = new 'ResizablePMCArray'
+    push $P0, $P0
+    inc $I1
+    if $I1 < 100000 goto make_garbage
+
+    null $P0
+    sweep 1
+    $I1 = interpinfo .INTERPINFO_ACTIVE_PMCS
+    $I2 = $I1 - $I0
+    if $I2 < 100 goto ok
+    print 'leaked '
+    say $I2
+    end
+  ok:
+    say 'ok'
+.end
+CODE
+ok
+OUTPUT
+
+{
+    local $ENV{PARROT_GC_CORE} = 'no such core';
+
+    pir_error_output_like( <<'CODE', <<'OUTPUT', 'unknown core is reported' );
+.sub main :main
+    die 'still running'
+.end
+CODE
+/^PARROT_GC_CORE: unknown GC core 'no such core' ignored\n.*still running/s
+OUTPUT
+}
+
+# Local Variables:
+#   mode: cperl
+#   cperl-indent-level: 4
+#   fill-column: 100
+# End:
+# vim: expandtab shiftwidth=4:
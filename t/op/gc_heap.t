@@ -0,0 +1,105 @@
+#!perl
+# Copyright (C) 2009, Parrot Foundation.
+# $Id$
+
+use strict;
+use warnings;
+use lib qw( . lib ../lib ../../lib );
+
+use Test::More;
+use Parrot::Test tests => 2;
+
+=head1 NAME
+
+t/op/gc_heap.t - Heap size limits
+
+=head1 SYNOPSIS
+
+    % prove t/op/gc_heap.t
+
+=head1 DESCRIPTION
+
+Tests that the MS core gives empty arenas back after a spike, and that
+C<PARROT_GC_MAX_HEAP> keeps the heap from growing while collections can
+still free enough.
+
+=cut
+
+$ENV{PARROT_GC_CORE} = 'ms';
+
+pir_output_is( <<'CODE', <<'OUTPUT', 'empty arenas are released after a spike' );
+.include 'interpinfo.pasm'
+.sub main :main
+    .local pmc root
+    root = new 'ResizablePMCArray'
+
+    $I1 = 0
+  fill:
+    $P0 = new 'Integer'
+    push root, $P0
+    inc $I1
+    if $I1 < 1000000 goto fill
+
+    $I0 = interpinfo .INTERPINFO_TOTAL_PMCS
+    root = new 'ResizablePMCArray'
+
+    sweep 1
+    sweep 1
+    sweep 1
+    sweep 1
+    $I1 = interpinfo .INTERPINFO_TOTAL_PMCS
+    $I2 = $I1 * 2
+    if $I2 < $I0 goto ok
+    print 'still holding '
+    say $I1
+    end
+  ok:
+    say 'ok'
+.end
+CODE
+ok
+OUTPUT
+
+{
+    local $ENV{PARROT_GC_MAX_HEAP} = '16m';
+
+    pir_output_is( <<'CODE', <<'OUTPUT', 'the heap stays under PARROT_GC_MAX_HEAP' );
+.include 'interpinfo.pasm'
+.sub main :main
+    .local pmc root
+    root = new 'ResizablePMCArray'
+
+    $I1 = 0
+  fill:
+    $P0 = new 'Integer'
+    push root, $P0
+    inc $I1
+    if $I1 < 300000 goto fill
+
+    $I1 = 0
+  churn:
+    $P0 = new 'Integer'
+    $I2 = $I1 % 300000
+    root[$I2] = $P0
+    inc $I1
+    if $I1 < 1000000 goto churn
+
+    $I0 = interpinfo .INTERPINFO_TOTAL_PMCS
+    if $I0 < 450000 goto ok
+    print 'heap grew to '
+    say $I0
+    end
+  ok:
+    say 'ok'
+.end
+CODE
+ok
+OUTPUT
+}
+
+# Local Variables:
+#   mode: cperl
+#   cperl-indent-level: 4
+#   fill-column: 100
+# End:
+# vim: expandtab shiftwidth=4:
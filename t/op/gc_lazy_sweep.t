@@ -0,0 +1,154 @@
+#!perl
+# Copyright (C) 2009, Parrot Foundation.
+# $Id$
+
+use strict;
+use warnings;
+use lib qw( . lib ../lib ../../lib );
+
+use Test::More;
+use Parrot::Test tests => 3;
+
+=head1 NAME
+
+t/op/gc_lazy_sweep.t - Lazy sweeping
+
+=head1 SYNOPSIS
+
+    % prove t/op/gc_lazy_sweep.t
+
+=head1 DESCRIPTION
+
+Runs the MS core with lazy sweeping, selected with the
+C<PARROT_GC_LAZY_SWEEP> environment variable.
+
+=cut
+
+$ENV{PARROT_GC_CORE}       = 'ms';
+$ENV{PARROT_GC_LAZY_SWEEP} = 1;
+
+pir_output_is( <<'CODE', <<'OUTPUT', 'live objects survive lazy sweeps' );
+.sub main :main
+    .local pmc root, array
+    root = new 'ResizablePMCArray'
+
+    $I0 = 0
+  outer:
+    array = new 'ResizablePMCArray'
+    push root, array
+    $I1 = 0
+  inner:
+    $P0 = new 'Integer'
+    $P0 = $I1
+    push array, $P0
+    $P1 = new 'String'
+    $P1 = 'garbage'
+    $S0 = $I1
+    $S0 .= 'garbage'
+    inc $I1
+    if $I1 < 100 goto inner
+    inc $I0
+    if $I0 < 1000 goto outer
+
+    $I0 = 0
+  check_outer:
+    array = root[$I0]
+    $I1 = 0
+  check_inner:
+    $P0 = array[$I1]
+    if $P0 != $I1 goto fail
+    inc $I1
+    if $I1 < 100 goto check_inner
+    inc $I0
+    if $I0 < 1000 goto check_outer
+    say 'ok'
+    end
+  fail:
+    say 'lost an element'
+.end
+CODE
+ok
+OUTPUT
+
+pir_output_is( <<'CODE', <<'OUTPUT', 'collections in the middle of a lazy sweep' );
+.sub main :main
+    .local pmc root
+    .local int i, j, k, n
+    root = new 'ResizablePMCArray'
+    n    = 20000
+
+    i = 0
+  fill:
+    $P0 = new 'Integer'
+    $P0 = i
+    push root, $P0
+    $P1 = new 'Integer'
+    inc i
+    if i < n goto fill
+
+    # each round allocates a different number of objects after the
+    # collection, so the next one finds the previous sweep stopped at a
+    # different arena; the new objects replace live ones in old arenas
+    j = 0
+  round:
+    sweep 1
+    k = j * 97
+    k %= 2000
+    i = 0
+  alloc:
+    $I0 = i * 7919
+    $I0 %= n
+    $P0 = new 'Integer'
+    $P0 = $I0
+    root[$I0] = $P0
+    $P1 = new 'String'
+    inc i
+    if i < k goto alloc
+    inc j
+    if j < 40 goto round
+
+    i = 0
+  check:
+    $P0 = root[i]
+    if $P0 != i goto fail
+    inc i
+    if i < n goto check
+    say 'ok'
+    end
+  fail:
+    print 'lost element '
+    say i
+.end
+CODE
+ok
+OUTPUT
+
+pir_output_is( <<'CODE', <<'OUTPUT', 'the heap stays bounded' );
+.include 'interpinfo.pasm'
+.sub main :main
+    $I1 = 0
+  make_garbage:
+    $P0 = new 'Integer'
+    $P1 = new 'ResizablePMCArray'
+    push $P1, $P0
+    inc $I1
+    if $I1 < 1000000 goto make_garbage
+
+    $I0 = interpinfo .INTERPINFO_TOTAL_PMCS
+    if $I0 < 500000 goto ok
+    print 'heap grew to '
+    say $I0
+    end
+  ok:
+    say 'ok'
+.end
+CODE
+ok
+OUTPUT
+
+# Local Variables:
+#   mode: cperl
+#   cperl-indent-level: 4
+#   fill-column: 100
+# End:
+# vim: expandtab shiftwidth=4:
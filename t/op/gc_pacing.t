@@ -0,0 +1,155 @@
+#!perl
+# Copyright (C) 2009, Parrot Foundation.
+# $Id$
+
+use strict;
+use warnings;
+use lib qw( . lib ../lib ../../lib );
+
+use Test::More;
+use Parrot::Test tests => 4;
+
+=head1 NAME
+
+t/op/gc_pacing.t - Collection pacing
+
+=head1 SYNOPSIS
+
+    % prove t/op/gc_pacing.t
+
+=head1 DESCRIPTION
+
+Tests the ratio pacer, which collects once the heap has grown by a ratio of
+the data which survived the last collection. The ratio is set with the
+C<--gc-ratio> option or the C<PARROT_GC_RATIO> environment variable.
+
+=cut
+
+$ENV{PARROT_GC_CORE} = 'ms';
+delete $ENV{PARROT_GC_RATIO};
+delete $ENV{PARROT_GC_MAX_HEAP};
+
+pir_output_is( <<'CODE', <<'OUTPUT', 'fixed heuristics by default' );
+.include 'interpinfo.pasm'
+.sub main :main
+    $I0 = interpinfo .INTERPINFO_GC_RATIO
+    say $I0
+    sweep 1
+    $I0 = interpinfo .INTERPINFO_GC_PMC_THRESHOLD
+    say $I0
+.end
+CODE
+0
+0
+OUTPUT
+
+{
+    local $ENV{TEST_PROG_ARGS} = ( $ENV{TEST_PROG_ARGS} || '' ) . ' --gc-ratio=50';
+
+    pir_output_is( <<'CODE', <<'OUTPUT', '--gc-ratio sets the ratio' );
+.include 'interpinfo.pasm'
+.sub main :main
+    $I0 = interpinfo .INTERPINFO_GC_RATIO
+    say $I0
+.end
+CODE
+50
+OUTPUT
+}
+
+{
+    local $ENV{PARROT_GC_RATIO} = '100';
+
+    pir_output_is( <<'CODE', <<'OUTPUT', 'the threshold follows the survivors' );
+.include 'interpinfo.pasm'
+.sub main :main
+    .local pmc root
+    root = new 'ResizablePMCArray'
+
+    $I1 = 0
+  fill:
+    $P0 = new 'Integer'
+    push root, $P0
+    inc $I1
+    if $I1 < 100000 goto fill
+
+    sweep 1
+    $I0 = interpinfo .INTERPINFO_GC_RATIO
+    say $I0
+
+    $I1 = 0
+  garbage:
+    $P0 = new 'Integer'
+    inc $I1
+    if $I1 < 100000 goto garbage
+
+    # about half of the PMCs in use were garbage
+    sweep 1
+    $I0 = interpinfo .INTERPINFO_GC_SURVIVAL_RATE
+    if $I0 < 40 goto fail
+    if $I0 > 60 goto fail
+
+    # 100000 Integers are alive, so the next collection is due at twice that
+    $I0 = interpinfo .INTERPINFO_GC_PMC_THRESHOLD
+    if $I0 < 200000 goto fail
+    if $I0 > 250000 goto fail
+    say 'ok'
+    end
+  fail:
+    print 'wrong survival rate or threshold '
+    say $I0
+.end
+CODE
+100
+ok
+OUTPUT
+}
+
+{
+    local $ENV{PARROT_GC_RATIO} = '400';
+
+    pir_output_is( <<'CODE', <<'OUTPUT', 'a large ratio collects less often' );
+.include 'interpinfo.pasm'
+.sub main :main
+    .local pmc root
+    root = new 'ResizablePMCArray'
+
+    $I1 = 0
+  fill:
+    $P0 = new 'Integer'
+    push root, $P0
+    inc $I1
+    if $I1 < 200000 goto fill
+
+    $I1 = 0
+  churn:
+    $P0 = new 'Integer'
+    $I2 = $I1 % 200000
+    root[$I2] = $P0
+    inc $I1
+    if $I1 < 2000000 goto churn
+
+    # the fixed heuristics collect about 20 times here
+    $I0 = interpinfo .INTERPINFO_GC_MARK_RUNS
+    if $I0 > 12 goto fail
+
+    # but the heap stays within five times the live PMCs, plus an arena
+    $I0 = interpinfo .INTERPINFO_TOTAL_PMCS
+    if $I0 > 1500000 goto fail
+    say 'ok'
+    end
+  fail:
+    print 'wrong mark runs or heap size '
+    say $I0
+.end
+CODE
+ok
+OUTPUT
+}
+
+# Local Variables:
+#   mode: cperl
+#   cperl-indent-level: 4
+#   fill-column: 100
+# End:
+# vim: expandtab shiftwidth=4:
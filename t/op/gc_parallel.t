@@ -0,0 +1,140 @@
+#!perl
+# Copyright (C) 2009, Parrot Foundation.
+# $Id$
+
+use strict;
+use warnings;
+use lib qw( . lib ../lib ../../lib );
+
+use Test::More;
+use Parrot::Test tests => 5;
+
+=head1 NAME
+
+t/op/gc_parallel.t - Parallel marking
+
+=head1 SYNOPSIS
+
+    % prove t/op/gc_parallel.t
+
+=head1 DESCRIPTION
+
+Runs the MS core with several marking threads, selected with the
+C<PARROT_GC_MARK_THREADS> environment variable.
+
+=cut
+
+$ENV{PARROT_GC_CORE}         = 'ms';
+$ENV{PARROT_GC_MARK_THREADS} = 4;
+
+pir_output_is( <<'CODE', <<'OUTPUT', 'nested arrays survive parallel marks' );
+.sub main :main
+    .local pmc root, array
+    root = new 'ResizablePMCArray'
+
+    $I0 = 0
+  outer:
+    array = new 'ResizablePMCArray'
+    push root, array
+    $I1 = 0
+  inner:
+    $P0 = new 'Integer'
+    $P0 = $I1
+    push array, $P0
+    $P1 = new 'String'
+    $P1 = 'garbage'
+    inc $I1
+    if $I1 < 100 goto inner
+    inc $I0
+    if $I0 < 1000 goto outer
+
+    sweep 1
+
+    $I0 = 0
+  check_outer:
+    array = root[$I0]
+    $I1 = 0
+  check_inner:
+    $P0 = array[$I1]
+    if $P0 != $I1 goto fail
+    inc $I1
+    if $I1 < 100 goto check_inner
+    inc $I0
+    if $I0 < 1000 goto check_outer
+    say 'ok'
+    end
+  fail:
+    say 'lost an element'
+.end
+CODE
+ok
+OUTPUT
+
+# the workers share and steal grey objects differently depending on how
+# many there are; a single long chain gives them little to steal
+for my $threads ( 2, 3, 8, 100 ) {
+    local $ENV{PARROT_GC_MARK_THREADS} = $threads;
+
+    pir_output_is( <<'CODE', <<'OUTPUT', "$threads mark threads keep a long chain, free its garbage" );
+.include 'interpinfo.pasm'
+.sub main :main
+    .local pmc head, node
+    sweep 1
+    $I0 = interpinfo .INTERPINFO_ACTIVE_PMCS
+
+    head = new 'ResizablePMCArray'
+    node = head
+    $I1 = 0
+  grow:
+    $P0 = new 'Integer'
+    $P0 = $I1
+    push node, $P0
+    $P1 = new 'ResizablePMCArray'
+    push node, $P1
+    node = $P1
+    $P2 = new 'ResizablePMCArray'
+    push $P2, $P2
+    inc $I1
+    if $I1 < 20000 goto grow
+
+    null $P2
+    sweep 1
+
+    node = head
+    $I1 = 0
+  walk:
+    $P0 = node[0]
+    if $P0 != $I1 goto lost
+    node = node[1]
+    inc $I1
+    if $I1 < 20000 goto walk
+
+    null head
+    null node
+    null $P0
+    null $P1
+    sweep 1
+    $I1 = interpinfo .INTERPINFO_ACTIVE_PMCS
+    $I2 = $I1 - $I0
+    if $I2 < 100 goto ok
+    print 'kept '
+    say $I2
+    end
+  lost:
+    print 'lost node '
+    say $I1
+    end
+  ok:
+    say 'ok'
+.end
+CODE
+ok
+OUTPUT
+}
+
+# Local Variables:
+#   mode: cperl
+#   cperl-indent-level: 4
+#   fill-column: 100
+# End:
+# vim: expandtab shiftwidth=4:
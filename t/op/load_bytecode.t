@@ -6,7 +6,11 @@ use strict;
 use warnings;
 use lib qw( . lib ../lib ../../lib );
 use Test::More;
-use Parrot::Test tests => 3;
+use Parrot::Test::Util 'create_tempfile';
+use File::Temp 'tempdir';
+
+use Parrot::Test tests => 12;
+use Parrot::Config;
 
 =head1 NAME
 
@@ -46,6 +50,142 @@ CODE
 /"load_bytecode" couldn't find file 'no_file_by_this_name'/
 OUTPUT
 
+my ($TEMP, $temp_pir) = create_tempfile( SUFFIX => '.pir', UNLINK => 1 );
+my (undef, $temp_pbc) = create_tempfile( SUFFIX => '.pbc', UNLINK => 1 );
+
+print $TEMP <<'EOF';
+.sub 'constants'
+    .const 'String' s = 'forty-two'
+    'show'(s, s, 4.2)
+    'show'(1, 'one', 1.5)
+    $I0 = 7
+    $S0 = 'seven'
+    $P0 = new ['ResizablePMCArray']
+    push $P0, 'flat'
+    'show'($I0, $S0, $P0 :flat)
+.end
+
+.sub 'show'
+    .param pmc a
+    .param string b
+    .param pmc c
+    say a
+    say b
+    say c
+.end
+
+.sub 'strings'
+    $S0 = 'abcdef'
+    chopn $S0, 2
+    say $S0
+    $S1 = 'xyz'
+    $S1 .= '!'
+    say $S1
+    $S2 = 'mixed'
+    upcase $S2
+    say $S2
+    $S3 = unicode:"caf\xe9"
+    $I0 = length $S3
+    say $I0
+.end
+EOF
+close $TEMP;
+
+system(".$PConfig{slash}parrot$PConfig{exe}", '-o', $temp_pbc, $temp_pir);
+
+pir_output_is( <<"CODE", <<'OUTPUT', "PMC constants of loaded bytecode" );
+.sub main :main
+    load_bytecode '$temp_pbc'
+    'constants'()
+    'constants'()
+.end
+CODE
+forty-two
+forty-two
+4.2
+1
+one
+1.5
+7
+seven
+flat
+forty-two
+forty-two
+4.2
+1
+one
+1.5
+7
+seven
+flat
+OUTPUT
+
+pir_output_is( <<"CODE", <<'OUTPUT', "string constants of loaded bytecode" );
+.sub main :main
+    load_bytecode '$temp_pbc'
+    'strings'()
+    'strings'()
+.end
+CODE
+abcd
+xyz!
+MIXED
+4
+abcd
+xyz!
+MIXED
+4
+OUTPUT
+
+{
+    local $ENV{PARROT_PBC_CACHE} = tempdir( CLEANUP => 1 );
+    my $code = <<"CODE";
+.sub main :main
+    load_bytecode '$temp_pir'
+    'strings'()
+.end
+CODE
+    my $output = <<'OUTPUT';
+abcd
+xyz!
+MIXED
+4
+OUTPUT
+
+    pir_output_is( $code, $output, "load_bytecode on PIR fills the bytecode cache" );
+    my @cached = glob "$ENV{PARROT_PBC_CACHE}/*.pbc";
+    is( scalar @cached, 1, "one file in the bytecode cache" );
+
+    pir_output_is( $code, $output, "load_bytecode on PIR from the bytecode cache" );
+
+    # a damaged cache file is compiled again
+    truncate $cached[0], 100;
+    pir_output_like( $code, qr/\Q$output\E$/, "load_bytecode on PIR with a truncated cache file" );
+    ok( -s $cached[0] > 100, "truncated cache file is written again" );
+
+    # the cache file of a source depends on the files it includes
+    my ( $INC,  $temp_inc )  = create_tempfile( SUFFIX => '.pir', UNLINK => 1 );
+    my ( $MAIN, $temp_main ) = create_tempfile( SUFFIX => '.pir', UNLINK => 1 );
+    print $MAIN ".include '$temp_inc'\n";
+    close $MAIN;
+
+    my $include_code = <<"CODE";
+.sub main :main
+    load_bytecode '$temp_main'
+    'included'()
+.end
+CODE
+
+    print $INC ".sub 'included'\n    say 'first'\n.end\n";
+    close $INC;
+    pir_output_is( $include_code, "first\n", "load_bytecode on PIR with an include" );
+
+    open $INC, '>', $temp_inc or die "can't write $temp_inc: $!";
+    print $INC ".sub 'included'\n    say 'second'\n.end\n";
+    close $INC;
+    pir_output_is( $include_code, "second\n", "an edited include is compiled again" );
+}
+
 # Local Variables:
 #   mode: cperl
 #   cperl-indent-level: 4
@@ -0,0 +1,173 @@
+#! perl
+# Copyright (C) 2009, Parrot Foundation.
+# $Id$
+
+use strict;
+use warnings;
+use lib qw( . lib ../lib ../../lib );
+
+use Test::More;
+use Parrot::Test tests => 3;
+use Parrot::Config;
+
+=head1 NAME
+
+t/op/quicken.t - Quickened arithmetic
+
+=head1 SYNOPSIS
+
+    % prove t/op/quicken.t
+
+=head1 DESCRIPTION
+
+Runs PMC arithmetic under a prederefed runcore, which replaces B<add>,
+B<sub> and B<mul> on Integer or Float PMCs with their quickened variants.
+Checks the results, and that the variants do the generic thing for other
+operand types, subclasses and overflow.
+
+=cut
+
+my $core = $PConfig{cg_flag} =~ /HAVE/ ? 'cgp' : 'switch';
+$ENV{TEST_PROG_ARGS} = ( $ENV{TEST_PROG_ARGS} || '' ) . " --runcore=$core";
+
+pir_output_is( <<'CODE', <<'OUTPUT', 'Integer and Float' );
+.sub main :main
+    .local pmc a, b, c
+    a = new 'Integer'
+    b = new 'Integer'
+    a = 7
+    b = 5
+    c = a + b
+    say c
+    c = a - b
+    say c
+    c = a * b
+    say c
+    a += b
+    say a
+    a -= b
+    say a
+    a *= b
+    say a
+    $S0 = typeof c
+    say $S0
+
+    .local pmc x, y, z
+    x = new 'Float'
+    y = new 'Float'
+    x = 1.5
+    y = 0.25
+    z = x + y
+    say z
+    z = x - y
+    say z
+    z = x * y
+    say z
+    x += y
+    say x
+    x -= y
+    say x
+    x *= y
+    say x
+    $S0 = typeof z
+    say $S0
+.end
+CODE
+12
+2
+35
+12
+7
+35
+Integer
+1.75
+1.25
+0.375
+1.75
+1.5
+0.375
+Float
+OUTPUT
+
+pir_output_is( <<'CODE', <<'OUTPUT', 'other types after the first run' );
+.sub main :main
+    .local pmc vals, a, b, c
+    .local int i
+    vals = new 'ResizablePMCArray'
+    $P0 = new 'Integer'
+    $P0 = 3
+    push vals, $P0
+    $P0 = new 'Float'
+    $P0 = 2.5
+    push vals, $P0
+    $P0 = new 'String'
+    $P0 = '4'
+    push vals, $P0
+    $P0 = new 'MyInt'
+    $P0 = 10
+    push vals, $P0
+    b = new 'Integer'
+    b = 2
+    i = 0
+  loop:
+    a = vals[i]
+    c = a + b
+    say c
+    c = a * b
+    say c
+    inc i
+    if i < 4 goto loop
+.end
+
+.sub '' :anon :init :load
+    $P0 = subclass 'Integer', 'MyInt'
+.end
+
+.namespace ['MyInt']
+
+.sub 'add' :vtable
+    .param pmc value
+    .param pmc dest
+    dest = new 'Integer'
+    dest = 42
+    .return (dest)
+.end
+CODE
+5
+6
+4.5
+5
+6
+8
+42
+20
+OUTPUT
+
+SKIP: {
+    skip( 'no BigInt without GMP', 1 ) unless $PConfig{gmp};
+
+    pir_output_is( <<'CODE', <<'OUTPUT', 'Integer overflow' );
+.sub main :main
+    .local pmc a, c
+    a = new 'Integer'
+    a = 4611686018427387904
+    c = a + a
+    say c
+    $S0 = typeof c
+    say $S0
+    c = a * a
+    say c
+.end
+CODE
+9223372036854775808
+BigInt
+21267647932558653966460912964485513216
+OUTPUT
+}
+
+# Local Variables:
+#   mode: cperl
+#   cperl-indent-level: 4
+#   fill-column: 100
+# End:
+# vim: expandtab shiftwidth=4:
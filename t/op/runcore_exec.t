@@ -0,0 +1,182 @@
+#! perl
+# Copyright (C) 2009, Parrot Foundation.
+# $Id$
+
+use strict;
+use warnings;
+use lib qw( . lib ../lib ../../lib );
+
+use Test::More;
+use Parrot::Test tests => 5;
+
+=head1 NAME
+
+t/op/runcore_exec.t - Exec runcore
+
+=head1 SYNOPSIS
+
+    % prove t/op/runcore_exec.t
+
+=head1 DESCRIPTION
+
+Runs integer and float arithmetic, compares and branches under the exec
+runcore, which translates them to native code where it can.  On platforms
+without native code the exec core runs like the fast core, and the results
+are the same.
+
+=cut
+
+$ENV{TEST_PROG_ARGS} = ( $ENV{TEST_PROG_ARGS} || '' ) . ' --runcore=exec';
+
+pir_output_is( <<'CODE', <<'OUTPUT', 'integer loop' );
+.sub main :main
+    .local int i, sum, prod
+    i    = 0
+    sum  = 0
+    prod = 1
+  loop:
+    sum  += i
+    $I0  = i - 3
+    sum  = sum - $I0
+    inc i
+    if i > 10 goto skip
+    prod *= 2
+  skip:
+    if i < 1000 goto loop
+    dec sum
+    print sum
+    print ' '
+    print prod
+    print "\n"
+.end
+CODE
+2999 1024
+OUTPUT
+
+pir_output_is( <<'CODE', <<'OUTPUT', 'float arithmetic and conversions' );
+.sub main :main
+    .local num x, y
+    .local int i
+    x = 0.5
+    y = 1.0
+    i = 0
+  loop:
+    x  += y
+    y  *= 1.5
+    x  = x - 0.25
+    inc x
+    inc i
+    unless i == 5 goto loop
+    print x
+    print "\n"
+    i = x
+    print i
+    print "\n"
+    x = i
+    dec x
+    y = x / 2
+    print y
+    print "\n"
+    $N0 = -2.75
+    $I0 = $N0
+    print $I0
+    print "\n"
+.end
+CODE
+17.4375
+17
+8
+-2
+OUTPUT
+
+pir_output_is( <<'CODE', <<'OUTPUT', 'float compares with NaN' );
+.sub main :main
+    .local num nan, one
+    nan = 'NaN'
+    one = 1.0
+
+    if nan == one goto bad
+    if nan <  one goto bad
+    if nan <= one goto bad
+    if one <  nan goto bad
+    if one <= nan goto bad
+    if nan == nan goto bad
+    print "ordered compares false\n"
+
+    unless nan != one goto bad
+    unless nan != nan goto bad
+    print "ne true\n"
+
+    if one >= one goto ge_ok
+    goto bad
+  ge_ok:
+    if one > 0.5 goto gt_ok
+    goto bad
+  gt_ok:
+    print "ok\n"
+    end
+  bad:
+    print "bad\n"
+.end
+CODE
+ordered compares false
+ne true
+ok
+OUTPUT
+
+pir_output_is( <<'CODE', <<'OUTPUT', 'calls and other ops in a loop' );
+.sub main :main
+    .local int i
+    .local string s
+    i = 0
+    s = ''
+  loop:
+    $I0 = 'double'(i)
+    $S0 = $I0
+    s  .= $S0
+    s  .= ' '
+    inc i
+    if i < 5 goto loop
+    print s
+    print "\n"
+.end
+
+.sub 'double'
+    .param int n
+    n *= 2
+    .return (n)
+.end
+CODE
+0 2 4 6 8 
+OUTPUT
+
+pir_output_is( <<'CODE', <<'OUTPUT', 'exception thrown from a loop' );
+.sub main :main
+    .local int i
+    push_eh handler
+    i = 0
+  loop:
+    inc i
+    if i < 100 goto loop
+    $P0 = new ['Exception']
+    $P0 = 'done'
+    throw $P0
+    print "not reached\n"
+  handler:
+    .get_results ($P1)
+    $S0 = $P1
+    print $S0
+    print ' '
+    print i
+    print "\n"
+.end
+CODE
+done 100
+OUTPUT
+
+# Local Variables:
+#   mode: cperl
+#   cperl-indent-level: 4
+#   fill-column: 100
+# End:
+# vim: expandtab shiftwidth=4:
@@ -6,7 +6,7 @@ use strict;
 use warnings;
 use lib qw( . lib ../lib ../../lib );
 use Test::More;
-use Parrot::Test tests => 32;
+use Parrot::Test tests => 35;
 use Parrot::Config;
 
 =head1 NAME
@@ -576,6 +576,152 @@ equal
 OUT
 
 
+pir_output_is( <<'CODE', <<'OUT', 'random access into a long utf8 string' );
+.sub 'main'
+    .local string s
+    s = unicode:"\xe9a\u4e2d"
+    s = repeat s, 1000
+    $I0 = length s
+    say $I0
+
+    # far, then back, then near the end
+    $I0 = ord s, 2999
+    say $I0
+    $I0 = ord s, 1500
+    say $I0
+    $I0 = ord s, 301
+    say $I0
+    $S0 = substr s, 2997, 3
+    $I0 = ord $S0, 0
+    say $I0
+
+    $I0 = index s, unicode:"a\u4e2d\xe9", 1000
+    say $I0
+    $I0 = index s, unicode:"\u4e2d\xe9", 2996
+    say $I0
+
+    # an all-ASCII utf8 string
+    $S0 = repeat "abc", 1000
+    $I0 = find_encoding 'utf8'
+    $S0 = trans_encoding $S0, $I0
+    $S1 = substr $S0, 2500, 2
+    say $S1
+.end
+CODE
+3000
+20013
+233
+97
+233
+1000
+2996
+bc
+OUT
+
+pir_output_is( <<'CODE', <<'OUT', 'access to a long utf8 string after changing it' );
+.sub 'main'
+    .local string s
+    s = unicode:"\xe9a"
+    s = repeat s, 500
+    $I0 = ord s, 705
+    say $I0
+
+    # same length in bytes and characters, different layout
+    substr s, 703, 2, unicode:"\xe9a"
+    $I0 = ord s, 703
+    say $I0
+    $I0 = ord s, 704
+    say $I0
+    $I0 = ord s, 705
+    say $I0
+
+    s = unicode:"\xe9a"
+    s = repeat s, 500
+    $I0 = ord s, 961
+    say $I0
+
+    chopn s, 42
+    s .= unicode:"aa\xe9\xe9"
+    $S0 = unicode:"\xe9a"
+    $S0 = repeat $S0, 19
+    s .= $S0
+    $I0 = length s
+    say $I0
+    $I0 = ord s, 961
+    say $I0
+    $I0 = ord s, 959
+    say $I0
+.end
+CODE
+97
+233
+97
+97
+97
+1000
+233
+97
+OUT
+
+pir_output_is( <<'CODE', <<'OUT', 'ASCII-only utf8 strings mixed with other strings' );
+.sub 'main'
+    $I9 = find_encoding 'utf8'
+    $S0 = trans_encoding "aaab", $I9
+    $S1 = trans_encoding "aab", $I9
+
+    $I0 = index $S0, $S1
+    say $I0
+    $I0 = index $S0, "aab"
+    say $I0
+    $I0 = index "aaab", $S1
+    say $I0
+    $I0 = index $S0, "abb"
+    say $I0
+    $S2 = unicode:"x\xe9aaab"
+    $I0 = index $S2, $S1
+    say $I0
+
+    $I0 = cmp $S0, "aaab"
+    say $I0
+    $I0 = cmp $S0, "aaac"
+    say $I0
+    $I0 = cmp "aaac", $S0
+    say $I0
+    $I0 = cmp $S0, "aaa"
+    say $I0
+    $I0 = iseq $S0, "aaab"
+    say $I0
+    $I0 = iseq $S0, "aaac"
+    say $I0
+
+    $P0 = new 'Hash'
+    $P0["aaab"] = 1
+    $I0 = $P0[$S0]
+    say $I0
+    $P0[$S1] = 2
+    $I0 = $P0["aab"]
+    say $I0
+
+    $S3 = upcase $S0
+    say $S3
+.end
+CODE
+1
+1
+1
+-1
+3
+0
+-1
+1
+1
+1
+0
+1
+2
+AAAB
+OUT
+
 # Local Variables:
 #   mode: cperl
 #   cperl-indent-level: 4
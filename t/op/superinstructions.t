@@ -0,0 +1,147 @@
+#! perl
+# Copyright (C) 2009, Parrot Foundation.
+# $Id$
+
+use strict;
+use warnings;
+use lib qw( . lib ../lib ../../lib );
+
+use Test::More;
+use Parrot::Test tests => 2;
+
+=head1 NAME
+
+t/op/superinstructions.t - Superinstructions
+
+=head1 SYNOPSIS
+
+    % prove t/op/superinstructions.t
+
+=head1 DESCRIPTION
+
+Compiles with C<-O1>, so IMCC replaces the op sequences listed in
+F<src/ops/ops.super> with superinstructions, and checks that the code still
+does the same, with the branches both taken and not taken.
+F<t/compilers/imcc/imcpasm/opt1.t> checks the ops IMCC emits.
+
+=cut
+
+$ENV{TEST_PROG_ARGS} = ( $ENV{TEST_PROG_ARGS} || '' ) . ' -O1';
+
+pir_output_is( <<'CODE', <<'OUTPUT', 'loops' );
+.sub main :main
+    .local int i, j, k, n, m
+    .local string s
+    i = 0
+    n = 5
+    m = 0
+  inc_loop:
+    inc i
+    if i < n goto inc_loop
+    print i
+    print ' '
+  add_loop:
+    j = i + 3
+    if j < n goto add_loop
+    print j
+    print ' '
+    s = 'abc'
+  length_loop:
+    $I0 = length s
+    if $I0 < n goto length_more
+    goto length_done
+  length_more:
+    s .= 'x'
+    goto length_loop
+  length_done:
+    print s
+    print ' '
+    i = 0
+    k = 3
+  mod_loop:
+    $I1 = i % k
+    unless $I1 goto mod_next
+    inc m
+  mod_next:
+    inc i
+    if i < 10 goto mod_loop
+    print m
+    print "\n"
+.end
+CODE
+5 8 abcxx 6
+OUTPUT
+
+pir_output_is( <<'CODE', <<'OUTPUT', 'keys, attributes and strings' );
+.sub main :main
+    .local pmc h, a, p, cl, o
+    h = new 'Hash'
+    h['a'] = 1
+    $I0 = exists h['a']
+    unless $I0 goto no_a
+    print "a "
+  no_a:
+    $I0 = exists h['b']
+    unless $I0 goto no_b
+    print "b "
+  no_b:
+    p = h['a']
+    unless_null p, got_a
+    print "null "
+  got_a:
+    p = h['b']
+    unless_null p, got_b
+    print "null "
+  got_b:
+    a = new 'ResizableIntegerArray'
+    local_branch a, sub1
+    $I0 = isa h, 'Hash'
+    if $I0 goto is_hash
+    print "not "
+  is_hash:
+    print "hash "
+    $I0 = can h, 'foo'
+    if $I0 == 0 goto cannot
+    print "can "
+  cannot:
+    cl = newclass 'Foo'
+    addattribute cl, 'x'
+    o = new 'Foo'
+    $P0 = box 7
+    setattribute o, 'x', $P0
+    $P1 = getattribute o, 'x'
+    $I1 = $P1
+    print $I1
+    print ' '
+    $P1 = getattribute o, 'x'
+    if $P1 == 7 goto seven
+    print "not "
+  seven:
+    print "seven "
+    a = new 'ResizableIntegerArray'
+    push a, 4
+    push a, 3
+    $I0 = pop a
+    if $I0 != 3 goto bad
+    $S0 = 'parrot'
+    $S1 = substr $S0, 1, 2
+    if $S1 != 'ar' goto bad
+    print "ok\n"
+    end
+  bad:
+    print "bad\n"
+    end
+  sub1:
+    print "sub1 "
+    local_return a
+.end
+CODE
+a null sub1 hash 7 seven ok
+OUTPUT
+
+# Local Variables:
+#   mode: cperl
+#   cperl-indent-level: 4
+#   fill-column: 100
+# End:
+# vim: expandtab shiftwidth=4:
@@ -19,7 +19,7 @@ Tests the CodeString class directly.
 
 .sub main :main
     .include 'test_more.pir'
-    plan(38)
+    plan(42)
 
     create_codestring()
     calls_to_unique()
@@ -33,6 +33,7 @@ Tests the CodeString class directly.
     first_char_repl_regression()
     ord_from_name()
     lineof_tests()
+    appends_in_place()
 .end
 
 .sub create_codestring
@@ -44,6 +45,28 @@ Tests the CodeString class directly.
     is(s, "ok", "code string creation succeeded")
 .end
 
+.sub appends_in_place
+    .local pmc code, more
+    .local string s, got
+    code = new ['CodeString']
+    s    = concat 'set ', '$I0, 1'
+    code = s
+    code.'emit'('inc $I0')
+    is(s, 'set $I0, 1', 'string set from is not appended to')
+
+    got = code
+    code .= "say $I0\n"
+    is(got, "set $I0, 1inc $I0\n", 'string got is not appended to')
+
+    more = new ['CodeString']
+    more.'emit'('end')
+    code .= more
+    s = code
+    is(s, "set $I0, 1inc $I0\nsay $I0\nend\n", 'concat appends')
+    $I0 = code.'lineof'(26)
+    is($I0, 2, 'lineof after appending')
+.end
+
 .sub calls_to_unique
     .local pmc code
     .local string s
@@ -23,7 +23,7 @@ well.
     .include 'except_types.pasm'
     .include 'datatypes.pasm'
 
-    plan(168)
+    plan(176)
 
     initial_hash_tests()
     more_than_one_hash()
@@ -65,8 +65,11 @@ well.
     check_whether_interface_is_done()
     iter_over_hash()
     broken_delete()
+    delete_while_iterating()
+    delete_keeps_other_keys()
     unicode_keys_register_rt_39249()
     unicode_keys_literal_rt_39249()
+    keys_in_other_encodings()
 
     integer_keys()
     value_types_convertion()
@@ -1194,6 +1197,74 @@ lp:
 .end
 
 ## thx to azuroth on irc
+.sub delete_while_iterating
+    .local pmc h, it
+    h = new ['Hash']
+
+    $I0 = 0
+  fill:
+    $S0 = $I0
+    h[$S0] = $I0
+    inc $I0
+    if $I0 < 1000 goto fill
+
+    # delete every key just returned by the iterator
+    .local int seen
+    seen = 0
+    it = iter h
+  loop:
+    unless it goto done
+    $S0 = shift it
+    delete h[$S0]
+    inc seen
+    goto loop
+  done:
+
+    is( seen, 1000, 'deleting the current key does not skip any' )
+    $I0 = elements h
+    is( $I0, 0, '... and empties the hash' )
+.end
+
+.sub delete_keeps_other_keys
+    .local pmc h
+    h = new ['Hash']
+
+    # insert 0..2999, deleting half of every third key as we go
+    $I0 = 0
+  fill:
+    $S0 = $I0
+    h[$S0] = $I0
+    $I1 = $I0 % 3
+    if $I1 goto next
+    $I2 = $I0 / 2
+    $S0 = $I2
+    delete h[$S0]
+  next:
+    inc $I0
+    if $I0 < 3000 goto fill
+
+    .local int wrong
+    wrong = 0
+    $I0 = 0
+  check:
+    $S0 = $I0
+    $I1 = exists h[$S0]
+    # the keys 3k and 3k + 1 below 1500 were deleted
+    $I2 = 1
+    if $I0 >= 1500 goto compare
+    $I3 = $I0 % 3
+    if $I3 == 2 goto compare
+    $I2 = 0
+  compare:
+    if $I1 == $I2 goto checked
+    inc wrong
+  checked:
+    inc $I0
+    if $I0 < 3000 goto check
+
+    is( wrong, 0, 'deletes leave the other keys in place' )
+.end
+
 .sub broken_delete
   .include "iterator.pasm"
   .local string result
@@ -1278,6 +1349,48 @@ postit_end:
   is( $S1, 'ok', 'literal unicode key lookup via var' )
 .end
 
+.sub keys_in_other_encodings
+    .local pmc h
+    .local int utf8, latin1
+    h      = new ['Hash']
+    utf8   = find_encoding 'utf8'
+    latin1 = find_charset 'iso-8859-1'
+
+    h['Content-Type'] = 'ascii'
+    $S0 = trans_encoding 'Content-Type', utf8
+    $S1 = h[$S0]
+    is( $S1, 'ascii', 'ascii key found by utf8 key' )
+
+    $S0 = unicode:"caf\xe9 au lait"
+    h[$S0] = 'latin'
+    $S0 = trans_charset $S0, latin1
+    $S1 = h[$S0]
+    is( $S1, 'latin', 'utf8 key found by iso-8859-1 key' )
+
+    $S0 = unicode:"caf\xe9 \u4e2d\u6587 au lait"
+    h[$S0] = 'wide'
+    $I0 = elements h
+    is( $I0, 3, 'no duplicate keys' )
+
+    load_bytecode 'config.pbc'
+    $P0 = _config()
+    $I0 = $P0['has_icu']
+    if $I0 goto has_icu
+    skip(2, 'ICU unavailable')
+    .return ()
+
+  has_icu:
+    .local int ucs2
+    ucs2 = find_encoding 'ucs2'
+    $S0  = trans_encoding 'Content-Type', ucs2
+    $S1  = h[$S0]
+    is( $S1, 'ascii', 'ascii key found by ucs2 key' )
+    $S0  = unicode:"caf\xe9 \u4e2d\u6587 au lait"
+    $S0  = trans_encoding $S0, ucs2
+    $S1  = h[$S0]
+    is( $S1, 'wide', 'utf8 key found by ucs2 key' )
+.end
+
 # Switch to use integer keys instead of strings.
 .sub integer_keys
     .include "hash_key_type.pasm"
@@ -0,0 +1,327 @@
+#!perl
+# Copyright (C) 2009, Parrot Foundation.
+# $Id$
+
+use strict;
+use warnings;
+use lib qw( . lib ../lib ../../lib );
+
+use Test::More;
+use Parrot::Test tests => 6;
+use Parrot::Config;
+
+=head1 NAME
+
+t/pmc/hash_open.t - Hashes with an open addressing index
+
+=head1 SYNOPSIS
+
+    % prove t/pmc/hash_open.t
+
+=head1 DESCRIPTION
+
+Runs hashes with the open addressing index, selected with the
+C<PARROT_HASH_INDEX> environment variable. The tests go through long probe
+sequences, deleted slots and their reuse, and the rebuild of an index full
+of deleted slots, and check that C<OrderedHash> keeps insertion order.
+
+=cut
+
+$ENV{PARROT_HASH_INDEX} = 'open';
+
+SKIP: {
+    skip 'keys with the same low 32 bits need a 64 bit INTVAL', 1
+        unless $PConfig{intvalsize} == 8;
+
+pir_output_is( <<'CODE', <<'OUTPUT', 'keys which all have the same hash value' );
+.include 'hash_key_type.pasm'
+
+.sub main :main
+    .local pmc h
+    .local int i, k, bad
+    h = new ['Hash']
+    h.'set_key_type'(.Hash_key_type_int)
+
+    # the keys only differ above the low 32 bits of their hash value, so
+    # they all probe from the same home slot
+    i = 1
+  fill:
+    k = i << 32
+    h[k] = i
+    inc i
+    if i <= 300 goto fill
+    $I0 = elements h
+    say $I0
+
+    bad = 0
+    i = 1
+  hit:
+    k = i << 32
+    $I0 = h[k]
+    if $I0 == i goto hit_ok
+    inc bad
+  hit_ok:
+    inc i
+    if i <= 300 goto hit
+  miss:
+    k = i << 32
+    $I0 = exists h[k]
+    bad += $I0
+    inc i
+    if i <= 400 goto miss
+    say bad
+
+    # delete the odd keys, then put them back into the deleted slots
+    i = 1
+  del:
+    k = i << 32
+    delete h[k]
+    i += 2
+    if i <= 300 goto del
+    $I0 = elements h
+    say $I0
+
+    bad = 0
+    i = 1
+  check_del:
+    k = i << 32
+    $I0 = exists h[k]
+    $I1 = i % 2
+    if $I0 != $I1 goto check_del_ok
+    inc bad
+  check_del_ok:
+    inc i
+    if i <= 300 goto check_del
+    say bad
+
+    i = 1
+  refill:
+    k = i << 32
+    $I0 = i * 2
+    h[k] = $I0
+    i += 2
+    if i <= 300 goto refill
+    $I0 = elements h
+    say $I0
+
+    bad = 0
+    i = 1
+  check_refill:
+    k = i << 32
+    $I0 = h[k]
+    $I1 = i % 2
+    $I2 = i
+    unless $I1 goto even
+    $I2 = i * 2
+  even:
+    if $I0 == $I2 goto check_refill_ok
+    inc bad
+  check_refill_ok:
+    inc i
+    if i <= 300 goto check_refill
+    say bad
+.end
+CODE
+300
+0
+150
+0
+300
+0
+OUTPUT
+}
+
+pir_output_is( <<'CODE', <<'OUTPUT', 'deleted slots are cleared out without growing' );
+.sub main :main
+    .local pmc h
+    .local int i, bad
+    h = new ['Hash']
+
+    # a window of 50 keys slides over 20000, so the index fills up with
+    # deleted slots again and again while the number of keys stays put
+    i = 0
+  loop:
+    $S0 = i
+    h[$S0] = i
+    $I0 = i - 50
+    if $I0 < 0 goto next
+    $S0 = $I0
+    delete h[$S0]
+  next:
+    inc i
+    if i < 20000 goto loop
+
+    $I0 = elements h
+    say $I0
+
+    bad = 0
+    i = 19900
+  check:
+    $S0 = i
+    $I0 = exists h[$S0]
+    $I1 = i >= 19950
+    if $I0 == $I1 goto check_ok
+    inc bad
+  check_ok:
+    unless $I0 goto check_next
+    $I2 = h[$S0]
+    if $I2 == i goto check_next
+    inc bad
+  check_next:
+    inc i
+    if i < 20000 goto check
+    say bad
+.end
+CODE
+50
+0
+OUTPUT
+
+pir_output_is( <<'CODE', <<'OUTPUT', 'deleting keys while iterating' );
+.sub main :main
+    .local pmc h, it
+    .local int seen
+    h = new ['Hash']
+
+    $I0 = 0
+  fill:
+    $S0 = $I0
+    h[$S0] = $I0
+    inc $I0
+    if $I0 < 1000 goto fill
+
+    seen = 0
+    it = iter h
+  loop:
+    unless it goto done
+    $S0 = shift it
+    delete h[$S0]
+    inc seen
+    goto loop
+  done:
+    say seen
+    $I0 = elements h
+    say $I0
+.end
+CODE
+1000
+0
+OUTPUT
+
+pir_output_is( <<'CODE', <<'OUTPUT', 'OrderedHash keeps insertion order' );
+.sub main :main
+    .local pmc h, it
+    .local int i, bad
+    h = new ['OrderedHash']
+
+    i = 0
+  fill:
+    $S0 = i
+    $S0 = 'k' . $S0
+    h[$S0] = i
+    inc i
+    if i < 500 goto fill
+
+    # delete every third key
+    i = 0
+  del:
+    $S0 = i
+    $S0 = 'k' . $S0
+    delete h[$S0]
+    i += 3
+    if i < 500 goto del
+
+    bad = 0
+    i   = 1
+    it  = iter h
+  loop:
+    unless it goto done
+    $S0 = shift it
+    $S1 = i
+    $S1 = 'k' . $S1
+    if $S0 == $S1 goto loop_ok
+    inc bad
+  loop_ok:
+    inc i
+    $I0 = i % 3
+    if $I0 goto loop
+    inc i
+    goto loop
+  done:
+    say bad
+    say i
+
+    $P0 = h[1]
+    say $P0
+    $P0 = h['k499']
+    say $P0
+.end
+CODE
+0
+500
+1
+499
+OUTPUT
+
+pir_output_is( <<'CODE', <<'OUTPUT', 'freeze, thaw and clone' );
+.sub main :main
+    .local pmc h, t, c
+    .local int i, bad
+    h = new ['Hash']
+
+    i = 0
+  fill:
+    $S0 = i
+    h[$S0] = i
+    inc i
+    if i < 1000 goto fill
+
+    $S0 = freeze h
+    t   = thaw $S0
+    c   = clone h
+
+    $I0 = elements t
+    say $I0
+    $I0 = elements c
+    say $I0
+
+    bad = 0
+    i   = 0
+  check:
+    $S0 = i
+    $I0 = t[$S0]
+    if $I0 == i goto check_clone
+    inc bad
+  check_clone:
+    $I0 = c[$S0]
+    if $I0 == i goto check_next
+    inc bad
+  check_next:
+    inc i
+    if i < 1000 goto check
+    say bad
+.end
+CODE
+1000
+1000
+0
+OUTPUT
+
+{
+    local $ENV{PARROT_HASH_INDEX} = 'no such index';
+
+    pir_error_output_like( <<'CODE', <<'OUTPUT', 'unknown index is reported' );
+.sub main :main
+    die 'still running'
+.end
+CODE
+/^PARROT_HASH_INDEX: unknown hash index 'no such index' ignored\n.*still running/s
+OUTPUT
+}
+
+# Local Variables:
+#   mode: cperl
+#   cperl-indent-level: 4
+#   fill-column: 100
+# End:
+# vim: expandtab shiftwidth=4:
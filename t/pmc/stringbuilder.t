@@ -0,0 +1,107 @@
+#! parrot
+# Copyright (C) 2009, Parrot Foundation.
+# $Id$
+
+=head1 NAME
+
+t/pmc/stringbuilder.t - StringBuilder
+
+=head1 SYNOPSIS
+
+    % prove t/pmc/stringbuilder.t
+
+=head1 DESCRIPTION
+
+Tests the C<StringBuilder> PMC.
+
+=cut
+
+.sub main :main
+    .include 'test_more.pir'
+
+    plan(13)
+
+    create_and_append()
+    shared_string_is_not_changed()
+    mixed_encodings()
+    many_appends()
+.end
+
+.sub 'create_and_append'
+    .local pmc sb
+    sb = new ['StringBuilder']
+
+    $I0 = isa sb, 'StringBuilder'
+    ok($I0, 'isa StringBuilder')
+    nok(sb, 'new StringBuilder is empty')
+
+    push sb, 'foo'
+    sb .= 'bar'
+    $P0 = box 'baz'
+    sb .= $P0
+    $S0 = sb
+    is($S0, 'foobarbaz', 'push and concat append')
+    $I0 = elements sb
+    is($I0, 9, 'elements is the length')
+
+    sb = 'reset'
+    $S0 = sb
+    is($S0, 'reset', 'set replaces the string')
+
+    $P1 = clone sb
+    push $P1, '!'
+    $S0 = sb
+    $S1 = $P1
+    is($S0, 'reset', 'clone is separate...')
+    is($S1, 'reset!', '... and appendable')
+.end
+
+.sub 'shared_string_is_not_changed'
+    .local pmc sb
+    .local string s, got
+    sb = new ['StringBuilder']
+    s  = 'abc'
+    s  = concat s, 'def'
+    sb = s
+    push sb, 'ghi'
+    is(s, 'abcdef', 'string set from is not appended to')
+
+    got = sb
+    push sb, 'jkl'
+    is(got, 'abcdefghi', 'string got is not appended to')
+    $S0 = sb
+    is($S0, 'abcdefghijkl', 'appending after get')
+.end
+
+.sub 'mixed_encodings'
+    .local pmc sb
+    sb = new ['StringBuilder']
+    push sb, 'caf'
+    push sb, unicode:"\xe9 \u4e2d"
+    push sb, '!'
+    $S0 = sb
+    is($S0, unicode:"caf\xe9 \u4e2d!", 'ascii and unicode pieces')
+.end
+
+.sub 'many_appends'
+    .local pmc sb
+    .local int i
+    sb = new ['StringBuilder']
+    i  = 0
+  loop:
+    push sb, 'abcdefghij'
+    inc i
+    if i < 100000 goto loop
+
+    $I0 = sb
+    is($I0, 1000000, '100000 appends')
+    $S0 = sb
+    $S0 = substr $S0, 999990, 10
+    is($S0, 'abcdefghij', 'last piece in place')
+.end
+
+# Local Variables:
+#   mode: pir
+#   fill-column: 100
+# End:
+# vim: expandtab shiftwidth=4 ft=pir:
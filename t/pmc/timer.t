@@ -6,7 +6,7 @@ use strict;
 use warnings;
 use lib qw( . lib ../lib ../../lib );
 use Test::More;
-use Parrot::Test tests => 6;
+use Parrot::Test tests => 7;
 use Parrot::Config;
 
 =head1 NAME
@@ -88,7 +88,7 @@ ok 3
 OUT
 
 SKIP: {
-    skip( "No thread enabled", 3 ) unless ( $PConfig{HAS_THREADS} );
+    skip( "No thread enabled", 4 ) unless ( $PConfig{HAS_THREADS} );
 
     pasm_output_like( <<'CODE', <<'OUT', "Timer setup - initializer/start" );
 .include "timer.pasm"
@@ -174,6 +174,37 @@ ok 2
 ok 2
 ok 2
 ok 3
+OUT
+
+    pir_output_is( <<'CODE', <<'OUT', "Timer fires in a busy loop" );
+.include "timer.pasm"
+.sub main :main
+    $P0 = new ['Integer']
+    set_global 'fired', $P0
+
+    $P1 = new ['Timer']
+    $P2 = get_global 'handler'
+    $P1[.PARROT_TIMER_HANDLER] = $P2
+    $P1[.PARROT_TIMER_NSEC]    = 0.1
+    $P1[.PARROT_TIMER_RUNNING] = 1
+
+    $N0 = time
+  loop:
+    if $P0 goto done
+    $N1 = time
+    $N1 -= $N0
+    if $N1 < 10.0 goto loop
+    print "timed out\n"
+  done:
+    print "ok\n"
+.end
+
+.sub handler
+    $P0 = get_global 'fired'
+    $P0 = 1
+.end
+CODE
+ok
 OUT
 }
 
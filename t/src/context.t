@@ -0,0 +1,168 @@
+#! perl
+# Copyright (C) 2009, Parrot Foundation.
+# $Id$
+
+use strict;
+use warnings;
+use lib qw( . lib ../lib ../../lib );
+use Test::More;
+use Parrot::Test;
+
+plan tests => 2;
+
+=head1 NAME
+
+t/src/context.t - Context register frames
+
+=head1 SYNOPSIS
+
+    % prove t/src/context.t
+
+=head1 DESCRIPTION
+
+Checks that the register frames of Contexts go back to the free lists of
+the interpreter when their subs return, and that the free lists stay short.
+
+=cut
+
+c_output_is( <<'CODE', <<'OUTPUT', "frames are released when a sub returns" );
+
+#include <stdio.h>
+#include "parrot/parrot.h"
+#include "parrot/embed.h"
+#include "parrot/extend.h"
+
+static int
+free_frames(PARROT_INTERP)
+{
+    int slot, n = 0;
+
+    for (slot = 0; slot < interp->ctx_mem.n_free_slots; slot++) {
+        void *ptr;
+        for (ptr = interp->ctx_mem.free_list[slot]; ptr; ptr = *(void **)ptr)
+            n++;
+    }
+
+    return n;
+}
+
+int
+main(int argc, char *argv[])
+{
+    Parrot_Interp interp = Parrot_new(NULL);
+    Parrot_String compiler, errstr;
+    Parrot_PMC    code;
+
+    if (!interp)
+        return 1;
+
+    compiler = Parrot_new_string(interp, "PIR", 3, (const char *)NULL, 0);
+    code     = Parrot_compile_string(interp, compiler,
+".sub main :main\n"
+"  $I0 = 0\n"
+"loop:\n"
+"  $I1 = factorial(10)\n"
+"  inc $I0\n"
+"  if $I0 < 1000 goto loop\n"
+"  say $I1\n"
+".end\n"
+".sub factorial\n"
+"  .param int n\n"
+"  if n > 1 goto rec\n"
+"  .return (1)\n"
+"rec:\n"
+"  $I0 = n - 1\n"
+"  $I0 = factorial($I0)\n"
+"  $I0 *= n\n"
+"  .return ($I0)\n"
+".end\n", &errstr);
+
+    /* with the GC off, only returning subs can fill the free lists */
+    Parrot_block_GC_mark(interp);
+    Parrot_block_GC_sweep(interp);
+    Parrot_call_sub(interp, code, "v");
+
+    printf("%s\n", free_frames(interp) >= 10 ? "released" : "kept");
+    fflush(stdout);
+
+    Parrot_exit(interp, 0);
+    return 0;
+}
+CODE
+3628800
+released
+OUTPUT
+
+c_output_is( <<'CODE', <<'OUTPUT', "free lists are capped" );
+
+#include <stdio.h>
+#include "parrot/parrot.h"
+#include "parrot/embed.h"
+#include "parrot/extend.h"
+
+int
+main(int argc, char *argv[])
+{
+    Parrot_Interp interp = Parrot_new(NULL);
+    Parrot_String compiler, errstr;
+    Parrot_PMC    code;
+    int           slot, longest = 0;
+
+    if (!interp)
+        return 1;
+
+    compiler = Parrot_new_string(interp, "PIR", 3, (const char *)NULL, 0);
+    code     = Parrot_compile_string(interp, compiler,
+".sub main :main\n"
+"  .local pmc keep\n"
+"  keep = new 'ResizablePMCArray'\n"
+"  $I0 = 0\n"
+"loop:\n"
+"  $P0 = capture()\n"
+"  push keep, $P0\n"
+"  inc $I0\n"
+"  if $I0 < 1000 goto loop\n"
+"  keep = new 'ResizablePMCArray'\n"
+"  sweep 1\n"
+"  say 'swept'\n"
+".end\n"
+".sub capture\n"
+"  $P0 = new 'Continuation'\n"
+"  .return ($P0)\n"
+".end\n", &errstr);
+
+    /* the Continuations keep 1000 frames until the GC destroys them */
+    Parrot_call_sub(interp, code, "v");
+
+    for (slot = 0; slot < interp->ctx_mem.n_free_slots; slot++) {
+        void *ptr;
+        int   n = 0;
+
+        for (ptr = interp->ctx_mem.free_list[slot]; ptr; ptr = *(void **)ptr)
+            n++;
+
+        if (n != interp->ctx_mem.n_free[slot])
+            printf("slot %d holds %d frames, counted %d\n",
+                slot, n, interp->ctx_mem.n_free[slot]);
+
+        if (n > longest)
+            longest = n;
+    }
+
+    printf("%s\n", longest > 0 && longest <= 64 ? "capped" : "not capped");
+    fflush(stdout);
+
+    Parrot_exit(interp, 0);
+    return 0;
+}
+CODE
+swept
+capped
+OUTPUT
+
+# Local Variables:
+#   mode: cperl
+#   cperl-indent-level: 4
+#   fill-column: 100
+# End:
+# vim: expandtab shiftwidth=4:
@@ -0,0 +1,140 @@
+#! perl
+# Copyright (C) 2009, Parrot Foundation.
+# $Id$
+# 12-prepare_super_ops.t
+
+use strict;
+use warnings;
+
+BEGIN {
+    use FindBin qw($Bin);
+    use Cwd qw(cwd realpath);
+    realpath($Bin) =~ m{^(.*\/parrot)\/[^/]*\/[^/]*\/[^/]*$};
+    our $topdir = $1;
+    if ( defined $topdir ) {
+        print "\nOK:  Parrot top directory located\n";
+    }
+    else {
+        $topdir = realpath($Bin) . "/../../..";
+    }
+    unshift @INC, qq{$topdir/lib};
+}
+use Test::More tests => 21;
+use Cwd;
+use File::Copy;
+use File::Temp (qw| tempdir |);
+
+use_ok('Parrot::Ops2pm::Base');
+
+ok( chdir $main::topdir, "Positioned at top-level Parrot directory" );
+
+# the superinstructions in src/ops/ops.super
+{
+    my $self = Parrot::Ops2pm::Base->new(
+        {
+            argv    => [ glob("src/ops/*.ops") ],
+            script  => "tools/build/ops2pm.pl",
+            nolines => undef,
+        }
+    );
+    ok( $self->prepare_ops,       "prepare_ops() returned successfully" );
+    ok( $self->prepare_super_ops, "prepare_super_ops() returned successfully" );
+
+    my %op_named = map { $_->full_name => $_ } @{ $self->{ops}{OPS} };
+    my $super    = $op_named{super_inc_lt_i_i_i_ic};
+    ok( defined $super, "super_inc_lt_i_i_i_ic was added" );
+    is_deeply( [ $super->fused_ops ], [qw(inc_i lt_i_i_ic)], "it fuses inc_i and lt_i_i_ic" );
+    is( $super->size, 5, "it takes four arguments" );
+    is_deeply( [ $super->labels ], [ 0, 0, 0, 1 ], "only the last one is a label" );
+    like( $super->body, qr/\{\{\+=5\}\}/, "it goes on past all four" );
+    unlike( $super->body, qr/\{\{\+=2\}\}/, "inc_i doesn't go on by itself" );
+}
+
+# ops that can't be fused
+{
+    my @ops = do {
+        my $self = Parrot::Ops2pm::Base->new(
+            {
+                argv    => [qw( src/ops/core.ops src/ops/math.ops src/ops/cmp.ops )],
+                script  => "tools/build/ops2pm.pl",
+                nolines => undef,
+            }
+        );
+        $self->prepare_ops;
+        @{ $self->{ops}{OPS} };
+    };
+    my %op_named = map { $_->full_name => $_ } @ops;
+
+    eval { Parrot::Op->fuse( $op_named{inc_i} ) };
+    like( $@, qr/can't fuse 'inc_i'/, "a single op can't be fused" );
+
+    eval { Parrot::Op->fuse( @op_named{qw(lt_i_i_ic inc_i)} ) };
+    like( $@, qr/can't fuse 'lt_i_i_ic inc_i'/, "only the last op may branch" );
+
+    my $super = Parrot::Op->fuse( @op_named{qw(inc_i inc_i)} );
+    is( $super->full_name, 'super_inc_inc_i_i', "an op can be fused with itself" );
+    like( $super->body, qr/\{\{\@2\}\}/, "the second op's argument is renumbered" );
+}
+
+# errors in ops.super
+{
+    my $cwd  = cwd();
+    my $tdir = tempdir( CLEANUP => 1 );
+    ok( chdir $tdir,                 'changed to temp directory for testing' );
+    ok( ( mkdir qq{$tdir/src} ),     "able to make tempdir/src" );
+    ok( ( mkdir qq{$tdir/src/ops} ), "able to make tempdir/src/ops" );
+    ok( copy( qq{$cwd/src/ops/core.ops}, qq{$tdir/src/ops/core.ops} ), "copied .ops file" );
+
+    my $self = Parrot::Ops2pm::Base->new(
+        {
+            argv    => [qw( src/ops/core.ops )],
+            script  => "tools/build/ops2pm.pl",
+            nolines => undef,
+        }
+    );
+    $self->prepare_ops;
+    my $count = @{ $self->{ops}{OPS} };
+
+    $self->prepare_super_ops;
+    is( scalar @{ $self->{ops}{OPS} }, $count, "no ops.super, no superinstructions" );
+
+    open my $SUPER, '>', 'src/ops/ops.super' or die "Can't write ops.super: $!";
+    print $SUPER "# comment\nnoop noop\nnoop no_such_op\n";
+    close $SUPER;
+    eval { $self->prepare_super_ops };
+    like( $@, qr{src/ops/ops.super:3: unknown op 'no_such_op'}, "unknown ops are reported" );
+
+    ok( chdir $cwd, 'changed back to starting directory after testing' );
+}
+
+=head1 NAME
+
+12-prepare_super_ops.t - test C<Parrot::Ops2pm::Base::prepare_super_ops()>
+and C<Parrot::Op::fuse()>
+
+=head1 SYNOPSIS
+
+    % prove t/tools/ops2pm/12-prepare_super_ops.t
+
+=head1 DESCRIPTION
+
+The files in this directory test the publicly callable methods of
+F<lib/Parrot/Ops2pm.pm> and F<lib/Parrot/Ops2pm/Auxiliary.pm>.  By doing so,
+they test the functionality of the F<ops2pm.pl> utility.
+
+Tests in this file check that the superinstructions listed in
+F<src/ops/ops.super> are added to the ops, and that sequences which can't be
+fused are refused.
+
+=head1 SEE ALSO
+
+Parrot::Ops2pm::Base, Parrot::Op, F<ops2pm.pl>.
+
+=cut
+
+# Local Variables:
+#   mode: cperl
+#   cperl-indent-level: 4
+#   fill-column: 100
+# End:
+# vim: expandtab shiftwidth=4:
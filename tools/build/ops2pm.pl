@@ -30,6 +30,7 @@ my $self = Parrot::Ops2pm->new(
 );
 
 $self->prepare_ops();
+$self->prepare_super_ops();
 $self->load_op_map_files();
 $self->sort_ops();
 $self->prepare_real_ops();
@@ -56,6 +57,10 @@ F<Parrot::OpLib::core> module containing information about the ops.
 Also outputs F<include/parrot/oplib/ops.h>.  This program is called by Parrot's
 F<make>.
 
+The sequences of ops listed in F<src/ops/ops.super> are fused into
+superinstructions, which are numbered in F<src/ops/ops.num> like any other
+op; F<ops.h> also gets the table IMCC uses to emit them.
+
 If called with the C<--renum> flag, renumbers the file F<src/ops/ops.num>.
 This is mandatory when adding or removing opcodes.
 
@@ -20,6 +20,7 @@ my $self = Parrot::OpsRenumber->new(
 );
 
 $self->prepare_ops();
+$self->prepare_super_ops();
 $self->renum_op_map_file();
 
 exit 0;
@@ -22,9 +22,9 @@ The F<PBC_COMPAT> file is used to maintain Parrot bytecode
 compatibility. During release preparation (and other changes to
 PBC_COMPAT) the fingerprint of existing bytecode files is invalidated.
 
-This utility updates the version and fingerprint information in the bytecode,
-but can of course not assure that it will run correctly, when incompatible
-changes were done.
+This utility updates the Parrot and bytecode version and the fingerprint
+information in the bytecode, but can of course not assure that it will run
+correctly, when incompatible changes were done.
 
 If no options are given, a summary of the PBC header is printed to STDOUT.
 
@@ -35,8 +35,10 @@ headers.
 
 =cut
 
+use lib qw( lib );
 use Getopt::Long;
 use Digest::MD5 qw(md5);
+use Parrot::BuildUtil;
 
 my %opt;
 my $word_size = 4;
@@ -58,6 +60,7 @@ sub update_fp {
     my (@args) = @_;
 
     my ( $major, $minor, $patch ) = get_version();
+    my ( $bc_major, $bc_minor ) = Parrot::BuildUtil::get_bc_version();
     for my $f (@args) {
         my $b;
         open my $F, "+<", "$f" or die "Can't open $f: $!";
@@ -67,6 +70,7 @@ sub update_fp {
         # bc_major bc_minor uuid_type uuid_size
         seek $F, 11, 0;      # pos 11: major, minor, patch
         print $F pack "ccc", $major, $minor, $patch;
+        print $F pack "cc", $bc_major, $bc_minor;    # pos 14: bc_major, bc_minor
         goto SKIP; # disabled
 
         # stamp with the fingerprint UUID
@@ -0,0 +1,125 @@
+#! perl
+
+# Copyright (C) 2009, Parrot Foundation.
+# $Id$
+
+use strict;
+use warnings;
+
+use lib 'lib';
+use Getopt::Long;
+use Parrot::Op;
+use Parrot::OpLib::core;
+
+=head1 Name
+
+tools/dev/pprof2super.pl
+
+=head1 Description
+
+Find the sequences of ops that Parrot runs most often, from the output of the
+profiling runcore, and list those that can be fused into superinstructions in
+the format of F<src/ops/ops.super>.
+
+=head1 Synopsis
+
+perl tools/dev/pprof2super.pl [--length=2] [--count=20] parrot.pprof.1234 ...
+
+=head1 Usage
+
+Generate one or more profiles by passing C<-Rprofiling> to parrot, for
+example C<./parrot -Rprofiling perl6.pbc hello.p6> (see F<tools/dev/pprof2cg.pl>).
+Then run this script on them.  It counts how often each sequence of
+C<--length> ops (2 by default) ran back to back in the same context, drops
+the sequences C<Parrot::Op::fuse()> can't fuse, and prints the C<--count>
+most frequent ones (20 by default), each with the number of times it ran.
+
+Copy the sequences worth having to F<src/ops/ops.super>, add the new
+superinstructions to the end of F<src/ops/ops.num>, and rebuild.  IMCC emits
+superinstructions at C<-O1> and above.
+
+=cut
+
+main();
+
+=head1 Functions
+
+=over 4
+
+=item C<main>
+
+Parses the options, reads each profile and prints the sequences found.
+
+=cut
+
+sub main {
+    my $length = 2;
+    my $count  = 20;
+
+    GetOptions(
+        'length=i' => \$length,
+        'count=i'  => \$count,
+    ) or die "usage: $0 [--length=N] [--count=N] parrot.pprof.XXXX ...\n";
+    die "usage: $0 [--length=N] [--count=N] parrot.pprof.XXXX ...\n"
+        unless @ARGV && $length >= 2;
+
+    my %op_named = map { $_->full_name => $_ } @$Parrot::OpLib::core::ops;
+    my %runs;
+
+    for my $filename (@ARGV) {
+        count_sequences( $filename, $length, \%runs );
+    }
+
+    my @sequences = sort { $runs{$b} <=> $runs{$a} || $a cmp $b } keys %runs;
+    my $printed   = 0;
+
+    for my $sequence (@sequences) {
+        last if $printed >= $count;
+
+        my @ops = map { $op_named{$_} } split / /, $sequence;
+        next if grep { !defined } @ops;
+        next unless eval { Parrot::Op->fuse(@ops) };
+
+        printf "%-40s # %d\n", $sequence, $runs{$sequence};
+        $printed++;
+    }
+}
+
+=item C<count_sequences>
+
+Adds the number of times each sequence of C<$length> ops ran in the profile
+C<$filename> to C<$runs>.  A sequence is only counted if its ops ran in the
+same context and runloop, one after the other.
+
+=cut
+
+sub count_sequences {
+    my ( $filename, $length, $runs ) = @_;
+    my @window;
+
+    open( my $in_fh, '<', $filename ) or die "couldn't open $filename for reading: $!";
+
+    while ( my $line = <$in_fh> ) {
+        if ( $line =~ /^OP:.*\{x\{op:(\w+)\}x\}/ ) {
+            push @window, $1;
+            shift @window if @window > $length;
+            $runs->{"@window"}++ if @window == $length;
+        }
+        elsif ( $line =~ /^(?:CS:|END_OF_RUNLOOP)/ ) {
+            @window = ();
+        }
+    }
+
+    close($in_fh) or die "couldn't close $filename: $!";
+}
+
+=back
+
+=cut
+
+# Local Variables:
+#   mode: cperl
+#   cperl-indent-level: 4
+#   fill-column: 100
+# End:
+# vim: expandtab shiftwidth=4: